@@ -45,6 +45,8 @@ if __name__ == "__main__":
     parser.add_argument("--bordercolor", help="mask border color", default="255,100,100,100")
     parser.add_argument("--border", help="mask border width", default="0")
     parser.add_argument('--offload', help="offload memory to CPU", action='store_true')
+    parser.add_argument("--ffmpeg", help="path for ffmpeg, used to encode the mask video", default="ffmpeg")
+    parser.add_argument("--fps", help="frame rate of the mask video", default="25")
     args = parser.parse_args()
     #if (args.point_coordinates is None or args.labels is None) and args.box_coordinates is None:
     #    config = vars(args)
@@ -118,9 +120,9 @@ model_cfg = configFile
 sam2_model = build_sam2(model_cfg, sam2_checkpoint, device=device)
 predictor = SAM2ImagePredictor(sam2_model)
 
-def save_mask(mask, filename, obj_id=None):
+def mask_image(mask):
     h, w = mask.shape[-2:]
-    mask_image = mask.reshape(h, w, 1) * mask_color.reshape(1, 1, -1)
+    image = mask.reshape(h, w, 1) * mask_color.reshape(1, 1, -1)
     if borders > 0:
         import cv2
         mask = mask.astype(np.uint8)
@@ -130,16 +132,60 @@ def save_mask(mask, filename, obj_id=None):
         # Try to smooth contours
         #contours = [cv2.approxPolyDP(contour, epsilon=0.01, closed=True) for contour in contours]
 
-        mask_image = cv2.drawContours(mask_image.astype(np.uint8),contours,-1,border_color.tolist(),borders)
+        image = cv2.drawContours(image.astype(np.uint8),contours,-1,border_color.tolist(),borders)
 
         #contours, _ = cv2.findContours(mask, cv2.RETR_EXTERNAL, cv2.CHAIN_APPROX_NONE)
         # Try to smooth contours
         #contours = [cv2.approxPolyDP(contour, epsilon=0.01, closed=True) for contour in contours]
 
-    pil_img = Image.fromarray(np.uint8(mask_image))
+    return np.uint8(image)
+
+
+def save_mask(mask, filename, obj_id=None):
+    pil_img = Image.fromarray(mask_image(mask))
     pil_img.save(filename)
 
 
+class PngMaskWriter:
+    """Writes each mask frame as a png image in a folder"""
+    def __init__(self, folder):
+        self.folder = folder
+
+    def write(self, frame_idx, mask):
+        save_mask(mask, self.folder + '/{:05d}'.format(frame_idx) + '.png')
+
+    def close(self):
+        return True
+
+
+class VideoMaskWriter:
+    """Pipes the raw mask frames to a single ffmpeg process encoding the mask video.
+    The first frame is also saved as png next to the video for the thumbnail."""
+    def __init__(self, output_file, ffmpeg_path, fps):
+        self.output_file = output_file
+        self.ffmpeg_path = ffmpeg_path
+        self.fps = fps
+        self.process = None
+
+    def write(self, frame_idx, mask):
+        image = mask_image(mask)
+        if self.process is None:
+            import subprocess
+            h, w = image.shape[:2]
+            Image.fromarray(image).save(os.path.splitext(self.output_file)[0] + '.png')
+            self.process = subprocess.Popen([self.ffmpeg_path, '-y', '-loglevel', 'error',
+                                             '-f', 'rawvideo', '-pix_fmt', 'rgba', '-s', f'{w}x{h}', '-framerate', str(self.fps),
+                                             '-i', '-', '-c:v', 'ffv1', '-pix_fmt', 'yuva420p', self.output_file],
+                                            stdin=subprocess.PIPE)
+        self.process.stdin.write(image.tobytes())
+
+    def close(self):
+        if self.process is None:
+            return False
+        self.process.stdin.close()
+        return self.process.wait() == 0
+
+
 def show_points(coords, labels, ax, marker_size=200):
     pos_points = coords[labels == 1]
     neg_points = coords[labels == 0]
@@ -170,29 +216,25 @@ def generate_preview(predictor):
     save_mask((masks[0]), filename, ann_obj_id)
     print(f"preview ok {preview_frame}", file=sys.stdout, flush=True)
 
-def render_video():
-    # run propagation throughout the video and collect the results in a dict
-    video_segments = {}  # video_segments contains the per-frame segmentation results
+def render_video(writer):
+    # run propagation throughout the video and write the results in frame order as soon as they are available
+    pending_segments = {}  # per-frame segmentation results that cannot be written yet
+    next_frame = 0
     print("INFO:Propagating in video\n", file=sys.stdout, flush=True)
+    framesCount = len(frame_names)
     for out_frame_idx, out_obj_ids, out_mask_logits in videoPredictor.propagate_in_video(inference_state):
-        video_segments[out_frame_idx] = {
+        pending_segments[out_frame_idx] = {
             out_obj_id: (out_mask_logits[i] > 0.0).cpu().numpy()
             for i, out_obj_id in enumerate(out_obj_ids)
         }
-    # render the segmentation results every few frames
-    vis_frame_stride = 1
-    print("INFO:Exporting frames\n", file=sys.stdout, flush=True)
-    framesCount = len(frame_names)
-    for out_frame_idx in range(0, framesCount, vis_frame_stride):
-        #plt.figure(figsize=(6, 4))
-        #plt.title(f"frame {out_frame_idx}")
-        #plt.imshow(Image.open(os.path.join(inputFolder, frame_names[out_frame_idx])))
-        for out_obj_id, out_mask in video_segments[out_frame_idx].items():
-            filename = output_frame + '/{:05d}'.format(out_frame_idx) + '.png'
-            save_mask(out_mask[0], filename, obj_id=out_obj_id)
+        while next_frame in pending_segments:
+            for out_obj_id, out_mask in pending_segments.pop(next_frame).items():
+                writer.write(next_frame, out_mask[0])
+            next_frame += 1
         if framesCount > 100:
             percent = int(100 * out_frame_idx / framesCount)
             print(f"Export {percent}%|\n", file=sys.stderr, flush=True)
+    return writer.close()
 
 # take a look the first video frame
 #frame_idx = 0
@@ -237,15 +279,20 @@ while 1:
             videoPredictor_initialized = True
         continue
 
-    if line.startswith("render="):
+    if line.startswith("render=") or line.startswith("renderfile="):
         if videoPredictor_initialized == False:
             print("INFO:Still loading frames\n", file=sys.stdout, flush=True)
             continue
         # Destroy image predictor
         del predictor
         predictor = None
-        # Generate output frames
-        output_frame = line[7:].rstrip()
+        if line.startswith("renderfile="):
+            # Encode the mask frames directly to a video file
+            writer = VideoMaskWriter(line[11:].rstrip(), args.ffmpeg, args.fps)
+        else:
+            # Generate output frames
+            output_frame = line[7:].rstrip()
+            writer = PngMaskWriter(output_frame)
         first_list = list(points.keys())
         in_first = set(first_list)
         in_second = set(box.keys())
@@ -261,7 +308,9 @@ while 1:
                 points=None if not points else points[frame],
                 labels=None if not labels else labels[frame]
             )
-        render_video()
+        if not render_video(writer):
+            print("Mask encoding failed", file=sys.stderr, flush=True)
+            sys.exit(1)
         print("mask ok", file=sys.stdout, flush=True)
         del videoPredictor
         videoPredictor_initialized = False
@@ -290,5 +339,5 @@ while 1:
 
     #plt.show()
 
-# Transform output png into video with alpha:
+# Transform output png into video with alpha (not needed with renderfile=):
 # ffmpeg -framerate 25 -pattern_type glob -i '*.png' -c:v ffv1 -pix_fmt yuva420p output.mkv
@@ -17,7 +17,7 @@ SetLogLevel(-1)
 
 def main():
     parser = argparse.ArgumentParser("VOSK to text script")
-    parser.add_argument("-S", "--src", help="source audio file")
+    parser.add_argument("-S", "--src", help="source audio file, - to read raw 16kHz mono s16le audio from stdin")
     parser.add_argument("-M", "--model", help="model name")
     parser.add_argument("-D", "--model_directory", help="the folder where the model is")
     parser.add_argument("-I", "--in_point", help="in point if not starting from 0", default="0")
@@ -35,7 +35,7 @@ def main():
 
     source = src.replace('"', '')
     print(f"ANALYSING SOURCE FILE: {source}.")
-    if not os.path.exists(source):
+    if source != '-' and not os.path.exists(source):
         print(f"Source file does not exist: {source}.")
         sys.exit()
 
@@ -53,8 +53,13 @@ def main():
     rec = KaldiRecognizer(voskModel, sample_rate)
     rec.SetWords(True)
 
-    process = subprocess.Popen([ffmpeg_path, '-loglevel', 'quiet', '-i', source,
-                '-ar', str(sample_rate), '-ac', '1', '-f', 's16le', '-'], stdout=subprocess.PIPE)
+    if source == '-':
+        # audio is streamed by Kdenlive
+        stream = sys.stdin.buffer
+    else:
+        process = subprocess.Popen([ffmpeg_path, '-loglevel', 'quiet', '-i', source,
+                    '-ar', str(sample_rate), '-ac', '1', '-f', 's16le', '-'], stdout=subprocess.PIPE)
+        stream = process.stdout
     WORDS_PER_LINE = 7
 
     def transcribe():
@@ -62,7 +67,7 @@ def main():
         subs = []
         progress = 0
         while True:
-            data = process.stdout.read(4000)
+            data = stream.read(4000)
             print("progress:" + str(progress), file=sys.stdout, flush=True)
             progress += 1
             if len(data) == 0:
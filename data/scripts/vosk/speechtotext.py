@@ -17,7 +17,7 @@ SetLogLevel(-1)
 def main():
 
     parser = argparse.ArgumentParser("VOSK to text script")
-    parser.add_argument("-S", "--src", help="source audio file")
+    parser.add_argument("-S", "--src", help="source audio file, - to read raw 16kHz mono s16le audio from stdin")
     parser.add_argument("-M", "--model", help="model name")
     parser.add_argument("-D", "--model_directory", help="the folder where the model is")
     parser.add_argument("-I", "--in_point", help="in point if not starting from 0", default="0")
@@ -34,7 +34,7 @@ def main():
 
     source = src.replace('"', '')
     print(f"ANALYSING SOURCE FILE: {source}.")
-    if not os.path.exists(source):
+    if source != '-' and not os.path.exists(source):
         print(f"Source file does not exist: {source}.")
         sys.exit()
 
@@ -52,8 +52,11 @@ def main():
     rec = KaldiRecognizer(voskModel, sample_rate)
     rec.SetWords(True)
 
+    if source == '-':
+        # audio is streamed by Kdenlive, already cut to the zone
+        process = None
     # zone rendering
-    if (float(args.in_point)>0 or float(args.out_point)>0):
+    elif (float(args.in_point)>0 or float(args.out_point)>0):
         process = subprocess.Popen([ffmpeg_path, '-loglevel', 'quiet', '-i',
                             source, '-ss', args.in_point, '-t', args.out_point,
                             '-ar', str(sample_rate), '-ac', '1', '-f', 's16le', '-'],
@@ -67,7 +70,7 @@ def main():
 
     def transcribe():
         while True:
-            data = process.stdout.read(4000)
+            data = sys.stdin.buffer.read(4000) if process is None else process.stdout.read(4000)
             if len(data) == 0:
                 sys.stdout.buffer.write(rec.FinalResult().encode('utf-8'))
                 sys.stdout.flush()
@@ -9,7 +9,7 @@ import os
 import whispertotext
 
 # Call this script with the following arguments
-# 1. source av file
+# 1. source av file, - to read raw 16kHz mono s16le audio from stdin
 # 2. model name (tiny, base, small, medium, large)
 # 3. output .srt file
 
@@ -24,6 +24,7 @@ import whispertotext
 # zone_out (out point)
 # tmpfile (tmp file name to extract a clip's part)
 # fp16 = False to disable fp16
+# output (output .srt file, required when reading from stdin)
 
 
 def main(source, model, **kwargs):
@@ -40,7 +41,8 @@ def main(source, model, **kwargs):
         'fp16': True,
         'seamless_source': '',
         'seamless_target': '',
-        'ffmpeg_path': ''
+        'ffmpeg_path': '',
+        'output': ''
     }
     assert all(k in kwargs_def for k in kwargs), f"Invalid kwargs: {kwargs.keys()}"
     kwargs = {**kwargs_def, **kwargs}
@@ -55,6 +57,11 @@ def main(source, model, **kwargs):
     fp16 = kwargs['fp16'] != 'False'
     ffmpeg_path = kwargs['ffmpeg_path']
 
+    audio = None
+    if source == '-':
+        # audio is streamed by Kdenlive, the srt file is named after the output
+        audio = whispertotext.stream_stdin_audio()
+        source = kwargs['output']
     outFolder = os.path.dirname(source)
     if tmpfile:
         whispertotext.extract_zone(source, zone_in, zone_out, tmpfile)
@@ -77,7 +84,7 @@ def main(source, model, **kwargs):
         if kwargs['max_line_count'] is not None:
             args += f"max_line_count={kwargs['max_line_count']} "
 
-    result = whispertotext.run_whisper(source, model, device, task, args)
+    result = whispertotext.run_whisper(source, model, device, task, args, audio)
 
     if kwargs['seamless_source']:
         print("0%| initialize", file=sys.stdout, flush=True)
@@ -43,7 +43,30 @@ def extract_zone(source, outfile, in_point, out_point, ffmpeg_path):
                             stdout=subprocess.PIPE)
 
 
-def run_whisper(source, model, device="cpu", task="transcribe", extraparams=""):
+def stream_stdin_audio():
+    # Read the raw 16kHz mono s16le audio streamed by Kdenlive in a thread, so that the model
+    # is loaded while the audio is extracted. Returns a function waiting for the complete audio
+    import threading
+    import numpy as np
+    chunks = []
+
+    def read():
+        while True:
+            data = sys.stdin.buffer.read(65536)
+            if len(data) == 0:
+                break
+            chunks.append(data)
+
+    reader = threading.Thread(target=read)
+    reader.start()
+
+    def wait():
+        reader.join()
+        return np.frombuffer(b''.join(chunks), np.int16).astype(np.float32) / 32768.0
+    return wait
+
+
+def run_whisper(source, model, device="cpu", task="transcribe", extraparams="", audio=None):
 
     # whisper.load_model checks the model's SHA on each run, so directly load the model
     #model = whisper.load_model(model, device)
@@ -124,7 +147,11 @@ def run_whisper(source, model, device="cpu", task="transcribe", extraparams=""):
     if writer_args["max_line_width"] is not None:
         writer_args["max_line_width"] = int(writer_args["max_line_width"])
 
-    result = loadedModel.transcribe(source, **transcribe_kwargs)
+    if audio is None:
+        audio = source
+    elif callable(audio):
+        audio = audio()
+    result = loadedModel.transcribe(audio, **transcribe_kwargs)
     if output_dir is not None:
         writer(result, source, **writer_args)
 
@@ -133,7 +160,7 @@ def run_whisper(source, model, device="cpu", task="transcribe", extraparams=""):
 
 def main():
     parser = argparse.ArgumentParser("Whisper to text script")
-    parser.add_argument("-S", "--src", help="source audio file")
+    parser.add_argument("-S", "--src", help="source audio file, - to read raw 16kHz mono s16le audio from stdin")
     parser.add_argument("-M", "--model", help="model name")
     parser.add_argument("-D", "--device", help="the device on which we operate, cpu or cuda")
     parser.add_argument("-T", "--task", help="transcribe or translate", default="transcribe")
@@ -152,11 +179,14 @@ def main():
 
     source = src.replace('"', '')
     print(f"ANALYSING SOURCE FILE: {source}.")
-    if not os.path.exists(source):
+    audio = None
+    if source == '-':
+        # audio is streamed by Kdenlive, already cut to the zone
+        audio = stream_stdin_audio()
+    elif not os.path.exists(source):
         print(f"Source file does not exist: {source}.")
         sys.exit()
-
-    if float(args.in_point) > 0 or float(args.out_point) > 0:
+    elif float(args.in_point) > 0 or float(args.out_point) > 0:
         tmp_file = args.temporary_file
         extract_zone(source, tmp_file, args.in_point, args.out_point, args.ffmpeg_path)
         source = tmp_file
@@ -172,7 +202,7 @@ def main():
     if language:
         jobArgs += f"language={language} "
 
-    result = run_whisper(source, model, device, task, jobArgs)
+    result = run_whisper(source, model, device, task, jobArgs, audio)
 
     for i in result["segments"]:
         start_time = i["start"]
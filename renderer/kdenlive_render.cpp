@@ -8,6 +8,7 @@
 #include "kdenlive_renderer_debug.h"
 #include "mlt++/Mlt.h"
 #include "renderjob.h"
+#include "stemrenderjob.h"
 
 #include <../config-kdenlive.h>
 #include <QApplication>
@@ -33,7 +34,7 @@ int main(int argc, char **argv)
     parser.addHelpOption();
     parser.addVersionOption();
 
-    parser.addPositionalArgument("mode", "Render mode. Either \"delivery\" or \"preview-chunks\".");
+    parser.addPositionalArgument("mode", "Render mode. Either \"delivery\", \"audio-stems\" or \"preview-chunks\".");
     parser.parse(QCoreApplication::arguments());
     QStringList args = parser.positionalArguments();
     const QString mode = args.isEmpty() ? QString() : args.first();
@@ -170,6 +171,9 @@ int main(int argc, char **argv)
         QCommandLineOption debugOption("debug", "Enable debug mode, doesn't delete log file on render success.");
         parser.addOption(debugOption);
 
+        QCommandLineOption jsonOption("json", "Print the render progress as JSON lines on standard output.");
+        parser.addOption(jsonOption);
+
         parser.process(app);
         args = parser.positionalArguments();
 
@@ -245,6 +249,7 @@ int main(int argc, char **argv)
         bool debugMode = parser.isSet(debugOption);
 
         auto *rJob = new RenderJob(render, playlist, target, pid, in, out, subtitleFile, debugMode, &app);
+        rJob->setJsonProgress(parser.isSet(jsonOption));
         QObject::connect(rJob, &RenderJob::renderingFinished, rJob, [&]() {
             rJob->deleteLater();
             qApp->quit();
@@ -254,6 +259,40 @@ int main(int argc, char **argv)
         return app.exec();
     }
 
+    if (mode == "audio-stems") {
+        parser.clearPositionalArguments();
+        parser.addPositionalArgument("audio-stems", "Mode: Render the audio of each track and the master mix in one pass.");
+        parser.addPositionalArgument("source", "Source file (MLT XML), the tracks to export have a kdenlive:stem_target property.");
+
+        QCommandLineOption pidOption("pid", "Process ID to send back progress.", "pid", QString::number(-1));
+        parser.addOption(pidOption);
+
+        // Accepted like in the delivery mode, audio stems do not write a log file
+        QCommandLineOption debugOption("debug", "Enable debug mode.");
+        parser.addOption(debugOption);
+
+        QCommandLineOption jsonOption("json", "Print the render progress as JSON lines on standard output.");
+        parser.addOption(jsonOption);
+
+        parser.process(app);
+        args = parser.positionalArguments();
+        if (args.count() != 2) {
+            qCritical() << "Error: wrong number of arguments specified\n";
+            parser.showHelp(1);
+            // the command above will quit the app with return 1;
+        }
+        Mlt::Factory::init();
+        LocaleHandling::resetAllLocale();
+        auto *stemJob = new StemRenderJob(args.at(1), parser.value(pidOption).toInt(), &app);
+        stemJob->setJsonProgress(parser.isSet(jsonOption));
+        QObject::connect(stemJob, &StemRenderJob::renderingFinished, stemJob, [&]() {
+            stemJob->deleteLater();
+            qApp->quit();
+        });
+        QMetaObject::invokeMethod(stemJob, "start", Qt::QueuedConnection);
+        return app.exec();
+    }
+
     qCritical() << "Error: unknown mode" << mode << "\n";
     parser.showHelp(1);
     // the command above will quit the app with return 1;
@@ -97,6 +97,17 @@ RenderJob::~RenderJob()
     m_logfile.close();
 }
 
+void RenderJob::setJsonProgress(bool enabled)
+{
+    m_jsonProgress = enabled;
+}
+
+void RenderJob::printJson(const QJsonObject &object)
+{
+    fprintf(stdout, "%s\n", QJsonDocument(object).toJson(QJsonDocument::Compact).constData());
+    fflush(stdout);
+}
+
 void RenderJob::slotAbort(const QString &url)
 {
     if (m_dest == url) {
@@ -106,6 +117,9 @@ void RenderJob::slotAbort(const QString &url)
 
 void RenderJob::sendFinish(int status, const QString &error)
 {
+    if (m_jsonProgress) {
+        printJson({{"event", "finished"}, {"url", m_dest}, {"status", status}, {"error", error}});
+    }
     if (m_kdenlivesocket->state() == QLocalSocket::ConnectedState) {
         QJsonObject method, args;
         args["url"] = m_dest;
@@ -180,7 +194,10 @@ void RenderJob::receivedStderr()
 
 void RenderJob::updateProgress()
 {
-    if (m_kdenlivesocket->state() == QLocalSocket::ConnectedState) {
+    if (m_jsonProgress) {
+        // No Kdenlive instance to report to
+        printJson({{"event", "progress"}, {"url", m_dest}, {"progress", m_progress}, {"frame", m_frame}});
+    } else if (m_kdenlivesocket->state() == QLocalSocket::ConnectedState) {
         QJsonObject method, args;
         args["url"] = m_dest;
         args["progress"] = m_progress;
@@ -279,7 +296,9 @@ void RenderJob::slotIsOver(int exitCode, QProcess::ExitStatus status)
         }
         args << QStringLiteral("--error") << error;
         m_logstream << error << "\n";
-        QProcess::startDetached(QStringLiteral("kdialog"), args);
+        if (!m_jsonProgress) {
+            QProcess::startDetached(QStringLiteral("kdialog"), args);
+        }
     } else {
         m_logstream << "Rendering of " << m_dest << " finished"
                     << "\n";
@@ -394,7 +413,9 @@ void RenderJob::slotCheckSubtitleProcess(int exitCode, QProcess::ExitStatus exit
         }
         args << QStringLiteral("--error") << error;
         m_logstream << error << "\n";
-        QProcess::startDetached(QStringLiteral("kdialog"), args);
+        if (!m_jsonProgress) {
+            QProcess::startDetached(QStringLiteral("kdialog"), args);
+        }
     } else {
         QFile::remove(m_dest);
         QFile::rename(m_temporaryRenderFile, m_dest);
@@ -13,6 +13,7 @@
 #include <QObject>
 #include <QProcess>
 #include <QTimer>
+#include <QJsonObject>
 // Testing
 #include <QTextStream>
 
@@ -25,6 +26,8 @@ public:
               const QString &subtitleFile = QString(), bool debugMode = false, QObject *parent = nullptr);
     RenderJob(const QString &errorMessage, int pid, QObject *parent = nullptr);
     ~RenderJob() override;
+    /** @brief Print the progress and result as JSON lines on stdout, for unattended renders */
+    void setJsonProgress(bool enabled);
 
 public Q_SLOTS:
     void start();
@@ -67,7 +70,9 @@ private:
     /** @brief Used to write to the log file. */
     QTextStream m_logstream;
     QString m_outputData;
+    bool m_jsonProgress{false};
     void fromServer();
+    void printJson(const QJsonObject &object);
     void sendFinish(int status, const QString &error);
     void updateProgress();
     void sendProgress();
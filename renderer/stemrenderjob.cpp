@@ -0,0 +1,343 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "stemrenderjob.h"
+#include "kdenlive_renderer_debug.h"
+#include "mlt++/Mlt.h"
+
+#include <QApplication>
+#include <QDomDocument>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+#include <QThread>
+
+static const QString StemTargetProperty = QStringLiteral("kdenlive:stem_target");
+
+StemRenderJob::StemRenderJob(const QString &scenelist, int pid, QObject *parent)
+    : QObject(parent)
+    , m_scenelist(scenelist)
+    , m_pid(pid)
+{
+    m_progressTimer.setInterval(500);
+    connect(&m_progressTimer, &QTimer::timeout, this, &StemRenderJob::checkProgress);
+}
+
+StemRenderJob::~StemRenderJob()
+{
+    // Consumers must be closed before their producers
+    for (auto &output : m_outputs) {
+        output.consumer.reset();
+    }
+    if (m_kdenlivesocket.state() == QLocalSocket::ConnectedState) {
+        m_kdenlivesocket.disconnectFromServer();
+    }
+}
+
+void StemRenderJob::setJsonProgress(bool enabled)
+{
+    m_jsonProgress = enabled;
+}
+
+static void printJson(const QJsonObject &object)
+{
+    fprintf(stdout, "%s\n", QJsonDocument(object).toJson(QJsonDocument::Compact).constData());
+    fflush(stdout);
+}
+
+/** @brief Find the services of the scene that have a stem target, nested sequences are searched too */
+static void findStems(Mlt::Producer &producer, QMap<QString, Mlt::Producer *> &stems, int depth = 0)
+{
+    const QString target = QString::fromUtf8(producer.get(StemTargetProperty.toUtf8().constData()));
+    if (!target.isEmpty()) {
+        stems.insert(target, new Mlt::Producer(producer));
+        return;
+    }
+    if (depth > 3 || producer.type() != mlt_service_tractor_type) {
+        return;
+    }
+    Mlt::Tractor tractor(producer);
+    for (int i = 0; i < tractor.count(); i++) {
+        std::unique_ptr<Mlt::Producer> track(tractor.track(i));
+        if (track && track->is_valid()) {
+            findStems(*track, stems, depth + 1);
+        }
+    }
+}
+
+QString StemRenderJob::prepare()
+{
+    QFile file(m_scenelist);
+    QDomDocument doc;
+    if (!file.open(QIODevice::ReadOnly) || !doc.setContent(&file)) {
+        return tr("Failed to read file %1").arg(m_scenelist);
+    }
+    file.close();
+    const QDomElement consumerElement = doc.documentElement().firstChildElement(QStringLiteral("consumer"));
+    m_dest = consumerElement.attribute(QStringLiteral("target"));
+    m_in = qMax(0, consumerElement.attribute(QStringLiteral("in"), QStringLiteral("0")).toInt());
+    m_out = consumerElement.attribute(QStringLiteral("out"), QStringLiteral("-1")).toInt();
+
+    // List the producers used by each stem track, tracks sharing a producer cannot be pulled from different threads
+    int stemTracks = 0;
+    QMap<QString, QDomElement> playlists;
+    const QDomNodeList playlistNodes = doc.elementsByTagName(QStringLiteral("playlist"));
+    for (int i = 0; i < playlistNodes.count(); i++) {
+        const QDomElement playlist = playlistNodes.at(i).toElement();
+        playlists.insert(playlist.attribute(QStringLiteral("id")), playlist);
+    }
+    const QDomNodeList tractors = doc.elementsByTagName(QStringLiteral("tractor"));
+    QStringList usedIds;
+    for (int i = 0; i < tractors.count(); i++) {
+        const QDomElement tractor = tractors.at(i).toElement();
+        QString target;
+        const QDomNodeList properties = tractor.elementsByTagName(QStringLiteral("property"));
+        for (int j = 0; j < properties.count(); j++) {
+            const QDomElement property = properties.at(j).toElement();
+            if (property.attribute(QStringLiteral("name")) == StemTargetProperty && property.parentNode() == tractor) {
+                target = property.text();
+                break;
+            }
+        }
+        if (target.isEmpty()) {
+            continue;
+        }
+        QStringList ids;
+        const QDomNodeList tracks = tractor.elementsByTagName(QStringLiteral("track"));
+        for (int j = 0; j < tracks.count(); j++) {
+            const QDomNodeList entries = playlists.value(tracks.at(j).toElement().attribute(QStringLiteral("producer"))).elementsByTagName(QStringLiteral("entry"));
+            for (int k = 0; k < entries.count(); k++) {
+                const QString id = entries.at(k).toElement().attribute(QStringLiteral("producer"));
+                if (!ids.contains(id)) {
+                    ids << id;
+                }
+            }
+        }
+        for (const QString &id : std::as_const(ids)) {
+            if (usedIds.contains(id)) {
+                m_parallel = false;
+            }
+        }
+        usedIds << ids;
+        stemTracks++;
+    }
+    if (stemTracks == 0) {
+        return tr("No audio track to export in %1").arg(m_scenelist);
+    }
+
+    // Load the scene once for all outputs
+    m_profile = std::make_unique<Mlt::Profile>();
+    m_scene = std::make_unique<Mlt::Producer>(*m_profile.get(), "xml", m_scenelist.toUtf8().constData());
+    if (!m_scene->is_valid()) {
+        return tr("Invalid playlist %1").arg(m_scenelist);
+    }
+    m_profile->set_explicit(1);
+    QLocale::setDefault(QLocale(m_scene->get_lcnumeric()));
+    if (m_out < 0 || m_out >= m_scene->get_length()) {
+        m_out = m_scene->get_length() - 1;
+    }
+    QMap<QString, Mlt::Producer *> stems;
+    findStems(*m_scene.get(), stems);
+
+    auto createOutput = [this, &consumerElement](Mlt::Producer &producer, const QString &target) {
+        Output output;
+        output.target = target;
+        // All outputs cover the whole render range, a track ending before the others is padded with silence
+        auto *range = new Mlt::Playlist(*m_profile.get());
+        const int length = m_out - m_in + 1;
+        const int available = qMin(m_out, producer.get_length() - 1) - m_in + 1;
+        if (available > 0) {
+            range->append(producer, m_in, m_in + available - 1);
+        }
+        if (available < length) {
+            range->blank(length - qMax(0, available) - 1);
+        }
+        output.producer.reset(range);
+        output.consumer = std::make_unique<Mlt::Consumer>(*m_profile.get(), "avformat", target.toUtf8().constData());
+        const QDomNamedNodeMap attributes = consumerElement.attributes();
+        for (int i = 0; i < attributes.count(); i++) {
+            const QDomAttr attribute = attributes.item(i).toAttr();
+            const QString name = attribute.name();
+            if (name == QLatin1String("mlt_service") || name == QLatin1String("target") || name == QLatin1String("in") || name == QLatin1String("out") ||
+                name.startsWith(QLatin1String("kdenlive:"))) {
+                continue;
+            }
+            output.consumer->set(name.toUtf8().constData(), attribute.value().toUtf8().constData());
+        }
+        // Only audio is requested from the scene
+        output.consumer->set("video_off", 1);
+        output.consumer->set("terminate_on_pause", 1);
+        output.consumer->connect(*output.producer.get());
+        return output;
+    };
+    for (auto it = stems.cbegin(); it != stems.cend(); ++it) {
+        m_outputs.push_back(createOutput(*it.value(), it.key()));
+    }
+    qDeleteAll(stems);
+    for (const auto &output : m_outputs) {
+        if (!output.consumer->is_valid()) {
+            return tr("Cannot create consumer for %1").arg(output.target);
+        }
+    }
+    if (m_outputs.empty()) {
+        return tr("No audio track to export in %1").arg(m_scenelist);
+    }
+    // The master mix pulls all tracks, it is rendered last
+    m_outputs.push_back(createOutput(*m_scene.get(), m_dest));
+    if (!m_outputs.back().consumer->is_valid()) {
+        return tr("Cannot create consumer for %1").arg(m_dest);
+    }
+    qCDebug(KDENLIVE_RENDERER_LOG) << "Rendering" << m_outputs.size() - 1 << "audio stems" << (m_parallel ? "in parallel" : "sequentially");
+    return QString();
+}
+
+void StemRenderJob::start()
+{
+    if (m_pid > -1) {
+        connect(&m_kdenlivesocket, &QLocalSocket::readyRead, this, &StemRenderJob::gotMessage);
+        m_kdenlivesocket.connectToServer(QStringLiteral("org.kde.kdenlive-%1").arg(m_pid));
+        if (!m_kdenlivesocket.waitForConnected(1000)) {
+            qCDebug(KDENLIVE_RENDERER_LOG) << "==== RENDER SOCKET NOT CONNECTED";
+        }
+    }
+    const QString error = prepare();
+    if (!error.isEmpty()) {
+        qCWarning(KDENLIVE_RENDERER_LOG) << error;
+        finish(-2, error);
+        return;
+    }
+    if (m_kdenlivesocket.state() == QLocalSocket::ConnectedState) {
+        QJsonObject obj;
+        obj["url"] = m_dest;
+        m_kdenlivesocket.write(QJsonDocument(obj).toJson());
+    }
+    sendProgress(0);
+    startOutputs();
+    m_progressTimer.start();
+}
+
+bool StemRenderJob::startOutputs()
+{
+    const int maxRunning = m_parallel ? qMax(1, QThread::idealThreadCount()) : 1;
+    int running = 0;
+    bool stemsFinished = true;
+    for (size_t i = 0; i + 1 < m_outputs.size(); i++) {
+        if (m_outputs[i].started && !m_outputs[i].finished) {
+            running++;
+        }
+        stemsFinished = stemsFinished && m_outputs[i].finished;
+    }
+    for (size_t i = 0; i + 1 < m_outputs.size() && running < maxRunning; i++) {
+        Output &output = m_outputs[i];
+        if (!output.started) {
+            output.consumer->start();
+            output.started = true;
+            running++;
+        }
+    }
+    Output &master = m_outputs.back();
+    if (stemsFinished && !master.started) {
+        master.consumer->start();
+        master.started = true;
+    }
+    return !master.finished;
+}
+
+void StemRenderJob::checkProgress()
+{
+    const int length = m_out - m_in + 1;
+    qint64 done = 0;
+    int frame = 0;
+    for (auto &output : m_outputs) {
+        if (output.started && !output.finished && output.consumer->is_stopped()) {
+            output.consumer->stop();
+            output.finished = true;
+        }
+        if (output.finished) {
+            done += length;
+        } else if (output.started) {
+            const int position = qBound(0, output.consumer->position(), length);
+            done += position;
+            frame = qMax(frame, position);
+        }
+    }
+    if (!startOutputs()) {
+        m_progressTimer.stop();
+        QString error;
+        for (const auto &output : m_outputs) {
+            if (!QFile::exists(output.target)) {
+                error.append(tr("Rendering of %1 aborted, resulting file will probably be corrupted.").arg(output.target) + QLatin1Char('\n'));
+            }
+        }
+        finish(error.isEmpty() ? -1 : -2, error);
+        return;
+    }
+    const int progress = int(100 * done / (qint64(length) * qint64(m_outputs.size())));
+    if (progress > m_progress) {
+        m_progress = progress;
+        sendProgress(m_in + frame);
+    }
+}
+
+void StemRenderJob::gotMessage()
+{
+    if (m_kdenlivesocket.readAll() != "abort") {
+        return;
+    }
+    m_progressTimer.stop();
+    for (auto &output : m_outputs) {
+        if (output.started && !output.finished) {
+            output.consumer->stop();
+        }
+        QFile::remove(output.target);
+    }
+    finish(-3, QString());
+}
+
+void StemRenderJob::sendProgress(int frame)
+{
+    if (m_jsonProgress) {
+        // No Kdenlive instance to report to
+        printJson({{"event", "progress"}, {"url", m_dest}, {"progress", m_progress}, {"frame", frame}});
+        return;
+    }
+    if (m_kdenlivesocket.state() != QLocalSocket::ConnectedState) {
+        qCDebug(KDENLIVE_RENDERER_LOG) << "Progress:" << m_progress << "%,"
+                                       << "frame" << frame;
+        return;
+    }
+    QJsonObject method, args;
+    args["url"] = m_dest;
+    args["progress"] = m_progress;
+    args["frame"] = frame;
+    method["setRenderingProgress"] = args;
+    m_kdenlivesocket.write(QJsonDocument(method).toJson());
+    m_kdenlivesocket.flush();
+}
+
+void StemRenderJob::sendFinish(int status, const QString &error)
+{
+    if (m_jsonProgress) {
+        printJson({{"event", "finished"}, {"url", m_dest}, {"status", status}, {"error", error}});
+    }
+    if (m_kdenlivesocket.state() != QLocalSocket::ConnectedState) {
+        qCDebug(KDENLIVE_RENDERER_LOG) << "Rendering to" << m_dest << "finished. Status:" << status << "Errors:" << error;
+        return;
+    }
+    QJsonObject method, args;
+    args["url"] = m_dest;
+    args["status"] = status;
+    args["error"] = error;
+    method["setRenderingFinished"] = args;
+    m_kdenlivesocket.write(QJsonDocument(method).toJson());
+    m_kdenlivesocket.flush();
+}
+
+void StemRenderJob::finish(int status, const QString &error)
+{
+    sendFinish(status, error);
+    Q_EMIT renderingFinished();
+}
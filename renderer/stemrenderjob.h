@@ -0,0 +1,77 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QLocalSocket>
+#include <QMap>
+#include <QObject>
+#include <QTimer>
+#include <memory>
+#include <vector>
+
+namespace Mlt {
+class Consumer;
+class Producer;
+class Profile;
+} // namespace Mlt
+
+/** @class StemRenderJob
+    @brief Renders the audio of each timeline track (after its track effects) and the master mix from one scene.
+    The tracks to export have a kdenlive:stem_target property with their output file, the master mix is rendered to
+    the consumer target. The scene is loaded once, and each stem only pulls its own track so that the other tracks
+    are not evaluated again. Each stem is padded with silence to the duration of the render range, so that they stay aligned. Tracks that do not share producers are rendered in parallel, the master mix is rendered
+    last because it pulls all the tracks. Video is never requested.
+ */
+class StemRenderJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    StemRenderJob(const QString &scenelist, int pid = -1, QObject *parent = nullptr);
+    ~StemRenderJob() override;
+    /** @brief Print the progress as JSON lines on standard output instead of sending it to Kdenlive */
+    void setJsonProgress(bool enabled);
+
+public Q_SLOTS:
+    void start();
+
+private Q_SLOTS:
+    void checkProgress();
+    void gotMessage();
+
+private:
+    struct Output
+    {
+        QString target;
+        std::unique_ptr<Mlt::Producer> producer;
+        std::unique_ptr<Mlt::Consumer> consumer;
+        bool started{false};
+        bool finished{false};
+    };
+    QString m_scenelist;
+    QString m_dest;
+    int m_pid;
+    int m_in{0};
+    int m_out{-1};
+    int m_progress{0};
+    bool m_parallel{true};
+    bool m_jsonProgress{false};
+    QLocalSocket m_kdenlivesocket;
+    QTimer m_progressTimer;
+    std::unique_ptr<Mlt::Profile> m_profile;
+    std::unique_ptr<Mlt::Producer> m_scene;
+    std::vector<Output> m_outputs;
+    /** @brief Build the consumers of the stems and master mix, returns an error message on failure */
+    QString prepare();
+    /** @brief Start the next outputs that can run now, returns false if all outputs are finished */
+    bool startOutputs();
+    void sendProgress(int frame);
+    void sendFinish(int status, const QString &error);
+    void finish(int status, const QString &error);
+
+Q_SIGNALS:
+    void renderingFinished();
+};
@@ -85,9 +85,10 @@ protected:
     virtual void parseType(Mlt::Properties *metadata, Info &res) = 0;
 
     /** @brief Retrieves additional info about asset from a custom XML file
+       @param doc is the already parsed content of file_name
        The resulting assets are stored in customAssets
      */
-    virtual void parseCustomAssetFile(const QString &file_name, std::unordered_map<QString, Info> &customAssets) const = 0;
+    virtual void parseCustomAssetFile(const QString &file_name, QDomDocument &doc, std::unordered_map<QString, Info> &customAssets) const = 0;
 
     /** @brief Returns the path to custom XML description of the assets*/
     virtual QStringList assetDirs() const = 0;
@@ -101,6 +102,18 @@ protected:
     /** @brief Returns the path to the assets' preferred list*/
     virtual QString assetPreferredListPath() const = 0;
 
+    /** @brief Returns the name of the startup cache file for this repository, an empty name disables the cache*/
+    virtual QString assetCacheName() const { return QString(); }
+
+    /** @brief Compute the startup cache key from the MLT version, the available MLT services and the modification time of all asset files */
+    QByteArray cacheKey(const QStringList &mltAssets, const QStringList &customFiles) const;
+    /** @brief Fill the asset list from the startup cache, returns false if the cache is missing or outdated */
+    bool loadFromCache(const QByteArray &key);
+    /** @brief Serialize the parsed asset list to the startup cache */
+    void saveToCache(const QByteArray &key) const;
+    /** @brief Increase this when the cache content changes */
+    static constexpr int CacheFormatVersion = 1;
+
     std::unordered_map<QString, Info> m_assets;
 
     QSet<QString> m_excludedList;
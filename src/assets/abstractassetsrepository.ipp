@@ -6,12 +6,18 @@
 #include "xml/xml.hpp"
 #include "kdenlivesettings.h"
 #include "core.h"
+#include "utils/startuptimer.h"
 
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QStandardPaths>
 #include <QString>
 #include <QTextStream>
+#include <QtConcurrent/QtConcurrentMap>
 #include <KLocalizedString>
 
 #include <locale>
@@ -23,6 +29,8 @@ template <typename AssetType> AbstractAssetsRepository<AssetType>::AbstractAsset
 
 template <typename AssetType> void AbstractAssetsRepository<AssetType>::init()
 {
+    const QString timingCategory = assetCacheName();
+    StartupTimer::start(timingCategory);
     // Parse include/exclude lists
     parseAssetList(assetExcludedPath(), m_excludedList);
     parseAssetList(assetIncludedPath(), m_includedList);
@@ -32,43 +40,24 @@ template <typename AssetType> void AbstractAssetsRepository<AssetType>::init()
 
     // Retrieve the list of MLT's available assets.
     QScopedPointer<Mlt::Properties> assets(retrieveListFromMlt());
-    QStringList emptyMetaAssets;
+    QStringList mltAssets;
     int max = assets->count();
     QString sox = QStringLiteral("sox.");
     for (int i = 0; i < max; ++i) {
-        Info info;
         QString name = assets->get_name(i);
-        info.id = name;
         if (name.startsWith(sox)) {
             // sox effects are not used directly (parameters not available)
             continue;
         }
         if (!m_excludedList.contains(name)) {
-            if (parseInfoFromMlt(name, info)) {
-                m_assets[name] = info;
-                if (m_includedList.contains(name)) {
-                    info.included = true;
-                }
-                if (info.xml.isNull()) {
-                    // Metadata was invalid
-                    emptyMetaAssets << name;
-                }
-            } else {
-                qWarning() << "Failed to parse" << name;
-            }
+            mltAssets << name;
         }
     }
 
-    // We now parse custom effect xml
+    // Collect the custom effect xml files
     // Set the directories to look into for effects.
     QStringList asset_dirs = assetDirs();
-
-    /* Parsing of custom xml works as follows: we parse all custom files.
-       Each of them contains a tag, which is the corresponding mlt asset, and an id that is the name of the asset. Note that several custom files can correspond
-       to the same tag, and in that case they must have different ids. We do the parsing in a map from ids to parse info, and then we add them to the asset
-       list, while discarding the bare version of each tag (the one with no file associated)
-    */
-    std::unordered_map<QString, Info> customAssets;
+    QStringList customFiles;
     // reverse order to prioritize local install
     QListIterator<QString> dirs_it(asset_dirs);
     for (dirs_it.toBack(); dirs_it.hasPrevious();) { auto dir=dirs_it.previous();
@@ -76,10 +65,73 @@ template <typename AssetType> void AbstractAssetsRepository<AssetType>::init()
         QStringList filter {QStringLiteral("*.xml")};
         QStringList fileList = current_dir.entryList(filter, QDir::Files);
         for (const auto &file : std::as_const(fileList)) {
-            QString path = current_dir.absoluteFilePath(file);
-            parseCustomAssetFile(path, customAssets);
+            customFiles << current_dir.absoluteFilePath(file);
         }
     }
+    StartupTimer::mark(timingCategory, QStringLiteral("list assets"));
+
+    // On warm starts, nothing changed since the last parsing, reuse it
+    const QByteArray key = cacheKey(mltAssets, customFiles);
+    if (loadFromCache(key)) {
+        StartupTimer::mark(timingCategory, QStringLiteral("load cache"));
+        return;
+    }
+
+    // Build the MLT assets info in parallel
+    struct MltAsset
+    {
+        QString name;
+        Info info;
+        bool valid{false};
+    };
+    std::vector<MltAsset> mltInfos;
+    mltInfos.reserve(size_t(mltAssets.size()));
+    for (const auto &name : std::as_const(mltAssets)) {
+        mltInfos.push_back({name, Info(), false});
+    }
+    QtConcurrent::blockingMap(mltInfos, [this](MltAsset &asset) {
+        asset.info.id = asset.name;
+        asset.valid = parseInfoFromMlt(asset.name, asset.info);
+    });
+    QStringList emptyMetaAssets;
+    for (const auto &asset : mltInfos) {
+        if (asset.valid) {
+            m_assets[asset.name] = asset.info;
+            if (asset.info.xml.isNull()) {
+                // Metadata was invalid
+                emptyMetaAssets << asset.name;
+            }
+        } else {
+            qWarning() << "Failed to parse" << asset.name;
+        }
+    }
+    StartupTimer::mark(timingCategory, QStringLiteral("parse MLT metadata"));
+
+    /* Parsing of custom xml works as follows: we parse all custom files.
+       Each of them contains a tag, which is the corresponding mlt asset, and an id that is the name of the asset. Note that several custom files can correspond
+       to the same tag, and in that case they must have different ids. We do the parsing in a map from ids to parse info, and then we add them to the asset
+       list, while discarding the bare version of each tag (the one with no file associated)
+       The xml documents are loaded in parallel, but interpreted in order since effect groups refer to previously parsed assets.
+    */
+    struct CustomFile
+    {
+        QString path;
+        QDomDocument doc;
+        bool valid{false};
+    };
+    std::vector<CustomFile> customDocuments;
+    customDocuments.reserve(size_t(customFiles.size()));
+    for (const auto &path : std::as_const(customFiles)) {
+        customDocuments.push_back({path, QDomDocument(), false});
+    }
+    QtConcurrent::blockingMap(customDocuments, [](CustomFile &file) { file.valid = Xml::docContentFromFile(file.doc, file.path, false); });
+    std::unordered_map<QString, Info> customAssets;
+    for (auto &file : customDocuments) {
+        if (file.valid) {
+            parseCustomAssetFile(file.path, file.doc, customAssets);
+        }
+    }
+    StartupTimer::mark(timingCategory, QStringLiteral("parse custom xml"));
 
     // We add the custom assets
     QStringList missingDependency;
@@ -126,6 +178,107 @@ template <typename AssetType> void AbstractAssetsRepository<AssetType>::init()
     for (const auto &invalid : std::as_const(emptyMetaAssets)) {
         m_assets.erase(invalid);
     }
+    saveToCache(key);
+    StartupTimer::mark(timingCategory, QStringLiteral("save cache"));
+}
+
+template <typename AssetType> QByteArray AbstractAssetsRepository<AssetType>::cacheKey(const QStringList &mltAssets, const QStringList &customFiles) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(CacheFormatVersion));
+    hash.addData(QCoreApplication::applicationVersion().toUtf8());
+    hash.addData(QByteArray(mlt_version_get_string()));
+    // Asset names and descriptions are translated
+    hash.addData(KLocalizedString::languages().join(QLatin1Char(',')).toUtf8());
+    hash.addData(mltAssets.join(QLatin1Char(',')).toUtf8());
+    QStringList files = customFiles;
+    files << assetIncludedPath() << assetExcludedPath() << assetPreferredListPath();
+    for (const auto &file : std::as_const(files)) {
+        QFileInfo info(file);
+        hash.addData(file.toUtf8());
+        hash.addData(QByteArray::number(info.size()));
+        hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    }
+    return hash.result().toHex();
+}
+
+template <typename AssetType> bool AbstractAssetsRepository<AssetType>::loadFromCache(const QByteArray &key)
+{
+    const QString cacheName = assetCacheName();
+    if (cacheName.isEmpty()) {
+        return false;
+    }
+    QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    const QString cacheFile = cacheDir.absoluteFilePath(QStringLiteral("assets/%1.xml").arg(cacheName));
+    if (!QFile::exists(cacheFile)) {
+        return false;
+    }
+    QDomDocument doc;
+    if (!Xml::docContentFromFile(doc, cacheFile, false)) {
+        return false;
+    }
+    QDomElement root = doc.documentElement();
+    if (root.attribute(QStringLiteral("version")).toInt() != CacheFormatVersion || root.attribute(QStringLiteral("key")).toLatin1() != key) {
+        qDebug() << "Outdated asset cache" << cacheFile;
+        return false;
+    }
+    std::unordered_map<QString, Info> assets;
+    for (QDomElement item = root.firstChildElement(QStringLiteral("asset")); !item.isNull(); item = item.nextSiblingElement(QStringLiteral("asset"))) {
+        Info info;
+        info.id = item.attribute(QStringLiteral("id"));
+        info.mltId = item.attribute(QStringLiteral("mltId"));
+        info.name = item.attribute(QStringLiteral("name"));
+        info.description = item.attribute(QStringLiteral("description"));
+        info.author = item.attribute(QStringLiteral("author"));
+        info.version_str = item.attribute(QStringLiteral("versionString"));
+        info.version = item.attribute(QStringLiteral("version")).toInt();
+        info.included = item.attribute(QStringLiteral("included")).toInt() == 1;
+        info.type = static_cast<AssetType>(item.attribute(QStringLiteral("type")).toInt());
+        info.xml = item.firstChildElement();
+        assets[item.attribute(QStringLiteral("entry"))] = info;
+    }
+    if (assets.empty()) {
+        return false;
+    }
+    m_assets = std::move(assets);
+    return true;
+}
+
+template <typename AssetType> void AbstractAssetsRepository<AssetType>::saveToCache(const QByteArray &key) const
+{
+    const QString cacheName = assetCacheName();
+    if (cacheName.isEmpty()) {
+        return;
+    }
+    QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    if (!cacheDir.mkpath(QStringLiteral("assets"))) {
+        qWarning() << "Cannot create asset cache folder in" << cacheDir.absolutePath();
+        return;
+    }
+    QDomDocument doc;
+    QDomElement root = doc.createElement(QStringLiteral("assetcache"));
+    root.setAttribute(QStringLiteral("version"), CacheFormatVersion);
+    root.setAttribute(QStringLiteral("key"), QString::fromLatin1(key));
+    doc.appendChild(root);
+    for (const auto &asset : m_assets) {
+        const Info &info = asset.second;
+        QDomElement item = doc.createElement(QStringLiteral("asset"));
+        item.setAttribute(QStringLiteral("entry"), asset.first);
+        item.setAttribute(QStringLiteral("id"), info.id);
+        item.setAttribute(QStringLiteral("mltId"), info.mltId);
+        item.setAttribute(QStringLiteral("name"), info.name);
+        item.setAttribute(QStringLiteral("description"), info.description);
+        item.setAttribute(QStringLiteral("author"), info.author);
+        item.setAttribute(QStringLiteral("versionString"), info.version_str);
+        item.setAttribute(QStringLiteral("version"), info.version);
+        item.setAttribute(QStringLiteral("included"), info.included ? 1 : 0);
+        item.setAttribute(QStringLiteral("type"), int(info.type));
+        if (!info.xml.isNull()) {
+            item.appendChild(doc.importNode(info.xml, true));
+        }
+        root.appendChild(item);
+    }
+    Xml::docContentToFile(doc, cacheDir.absoluteFilePath(QStringLiteral("assets/%1.xml").arg(cacheName)));
 }
 
 template <typename AssetType> void AbstractAssetsRepository<AssetType>::parseAssetList(const QStringList &filePaths, QSet<QString> &destination)
@@ -149,7 +302,13 @@ template <typename AssetType> void AbstractAssetsRepository<AssetType>::parseAss
 
 template <typename AssetType> bool AbstractAssetsRepository<AssetType>::parseInfoFromMlt(const QString &assetId, Info &res)
 {
-    std::unique_ptr<Mlt::Properties> metadata(getMetadata(assetId));
+    std::unique_ptr<Mlt::Properties> metadata;
+    {
+        // MLT's metadata callbacks of some modules are not reentrant, only the conversion below runs in parallel
+        static std::mutex metadataMutex;
+        std::lock_guard<std::mutex> lock(metadataMutex);
+        metadata.reset(getMetadata(assetId));
+    }
     if (metadata && metadata->is_valid()) {
         if (metadata->property_exists("title") && metadata->property_exists("identifier") && strlen(metadata->get("title")) > 0) {
             QString id = metadata->get("identifier");
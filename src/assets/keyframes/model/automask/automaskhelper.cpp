@@ -217,6 +217,11 @@ void AutomaskHelper::launchSam(const QDir &previewFolder, int offset, const Obje
     if (KdenliveSettings::sam_offload_video()) {
         args << QStringLiteral("--offload");
     }
+    // The way the frames are output is fixed for the lifetime of the process, generateMask() must follow it
+    m_directEncode = KdenliveSettings::maskDirectEncode();
+    if (m_directEncode) {
+        args << QStringLiteral("--ffmpeg") << KdenliveSettings::ffmpegpath() << QStringLiteral("--fps") << QString::number(pCore->getCurrentFps());
+    }
     if (!box.isNull()) {
         args << QStringLiteral("-B") << QStringLiteral("%1=%2,%3,%4,%5").arg(m_lastPos).arg(box.x()).arg(box.y()).arg(box.right()).arg(box.bottom());
     }
@@ -423,14 +428,15 @@ bool AutomaskHelper::generateMask(const QString &binId, const QString &maskName,
             toRemove.removeRecursively();
         }
     }
-    maskSrcFolder.mkpath(outFolder);
-    if (!maskSrcFolder.cd(outFolder)) {
-        return false;
+    m_maskParams.remove(MaskTask::OUTPUTFOLDER);
+    if (!m_directEncode) {
+        // The mask frames are saved as images and encoded by the mask task
+        maskSrcFolder.mkpath(outFolder);
+        if (!maskSrcFolder.cd(outFolder)) {
+            return false;
+        }
+        m_maskParams.insert(MaskTask::OUTPUTFOLDER, maskSrcFolder.absolutePath());
     }
-    // Launch the sam analysis process
-    m_jobStatus = QProcess::Running;
-    m_samProcess.write(QStringLiteral("render=%1\n").arg(maskSrcFolder.absolutePath()).toUtf8());
-    m_maskParams.insert(MaskTask::OUTPUTFOLDER, maskSrcFolder.absolutePath());
     m_maskParams.insert(MaskTask::NAME, maskName);
     // Generate points strings
     QStringList fullIncludePoints;
@@ -489,6 +495,17 @@ bool AutomaskHelper::generateMask(const QString &binId, const QString &maskName,
         }
         m_maskParams.insert(MaskTask::OUTPUTFILE, outputFile);
     }
+    if (m_directEncode && !m_maskParams.contains(MaskTask::OUTPUTFILE)) {
+        return false;
+    }
+    // Launch the sam analysis process
+    m_jobStatus = QProcess::Running;
+    if (!m_directEncode) {
+        m_samProcess.write(QStringLiteral("render=%1\n").arg(m_maskParams.value(MaskTask::OUTPUTFOLDER)).toUtf8());
+    } else {
+        // The script pipes the mask frames to an encoder writing the mask file
+        m_samProcess.write(QStringLiteral("renderfile=%1\n").arg(m_maskParams.value(MaskTask::OUTPUTFILE)).toUtf8());
+    }
     return true;
 }
 
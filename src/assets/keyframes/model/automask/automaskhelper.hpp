@@ -69,6 +69,8 @@ private:
     QString m_binId;
     bool m_killedOnRequest{false};
     bool m_maskCreationMode{false};
+    /** @brief True if the running SAM process was told to pipe the mask frames to an encoder */
+    bool m_directEncode{false};
     ObjectId m_ownerForFilter{KdenliveObjectType::NoItem, {}};
 
 private Q_SLOTS:
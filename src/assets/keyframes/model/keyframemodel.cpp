@@ -515,6 +515,17 @@ bool KeyframeModel::updateKeyframe(int pos, double newVal)
     return false;
 }
 
+void KeyframeModel::setMergeUpdates(bool merge)
+{
+    if (auto ptr = m_undoStack.lock()) {
+        if (merge) {
+            ptr->beginMergeSession();
+        } else {
+            ptr->endMergeSession();
+        }
+    }
+}
+
 bool KeyframeModel::updateKeyframe(GenTime pos, QVariant value)
 {
     QWriteLocker locker(&m_lock);
@@ -524,7 +535,8 @@ bool KeyframeModel::updateKeyframe(GenTime pos, QVariant value)
     Fun redo = []() { return true; };
     bool res = updateKeyframe(pos, value, undo, redo);
     if (res) {
-        PUSH_UNDO(undo, redo, i18n("Update keyframe"));
+        // Repeated updates during a merge session (for example a held key) are merged
+        PUSH_UNDO_MERGEABLE(undo, redo, i18n("Update keyframe"));
     }
     return res;
 }
@@ -904,15 +916,16 @@ QString KeyframeModel::getAnimProperty() const
     }
     int ix = 0;
     bool first = true;
+    const double fps = pCore->getCurrentFps();
     std::shared_ptr<Mlt::Animation> anim(nullptr);
     for (const auto &keyframe : m_keyframeList) {
         switch (m_paramType) {
         case ParamType::AnimatedRect:
         case ParamType::Color:
-            mlt_prop.anim_set("key", keyframe.second.second.toString().toUtf8().constData(), keyframe.first.frames(pCore->getCurrentFps()));
+            mlt_prop.anim_set("key", keyframe.second.second.toString().toUtf8().constData(), keyframe.first.frames(fps));
             break;
         default:
-            mlt_prop.anim_set("key", keyframe.second.second.toDouble(), keyframe.first.frames(pCore->getCurrentFps()));
+            mlt_prop.anim_set("key", keyframe.second.second.toDouble(), keyframe.first.frames(fps));
             break;
         }
         if (first) {
@@ -938,8 +951,10 @@ QString KeyframeModel::getRotoProperty() const
         int in = ptr->data(m_index, AssetParameterModel::ParentInRole).toInt();
         int out = in + ptr->data(m_index, AssetParameterModel::ParentDurationRole).toInt();
         QVariantMap map;
+        const double fps = pCore->getCurrentFps();
+        const int width = int(log10(double(out))) + 1;
         for (const auto &keyframe : m_keyframeList) {
-            map.insert(QString::number(keyframe.first.frames(pCore->getCurrentFps())).rightJustified(int(log10(double(out))) + 1, '0'), keyframe.second.second);
+            map.insert(QString::number(keyframe.first.frames(fps)).rightJustified(width, '0'), keyframe.second.second);
         }
         doc = QJsonDocument::fromVariant(map);
     }
@@ -1178,12 +1193,13 @@ QVariant KeyframeModel::getNormalizedValue(double newVal) const
 
 QVariant KeyframeModel::getInterpolatedValue(const GenTime &pos) const
 {
-    if (m_keyframeList.count(pos) > 0) {
-        return m_keyframeList.at(pos).second;
-    }
-    if (m_keyframeList.size() == 0) {
+    if (m_keyframeList.empty()) {
         return QVariant();
     }
+    auto match = m_keyframeList.find(pos);
+    if (match != m_keyframeList.cend()) {
+        return match->second.second;
+    }
     if (m_paramType == ParamType::Roto_spline) {
         // interpolate
         auto next = m_keyframeList.upper_bound(pos);
@@ -1206,8 +1222,8 @@ QVariant KeyframeModel::getInterpolatedValue(const GenTime &pos) const
         // - equal to 1 on next keyframe
         qreal relPos = 0;
         if (next->first != prev->first) {
-            relPos = (pos.frames(pCore->getCurrentFps()) - prev->first.frames(pCore->getCurrentFps())) /
-                     qreal(((next->first - prev->first).frames(pCore->getCurrentFps())));
+            const double fps = pCore->getCurrentFps();
+            relPos = (pos.frames(fps) - prev->first.frames(fps)) / qreal(((next->first - prev->first).frames(fps)));
         }
         int count = qMin(p1.count(), p2.count());
         QList<QVariant> vlist;
@@ -95,6 +95,8 @@ public:
        @param value is the new value of the param
     */
     Q_INVOKABLE bool updateKeyframe(int pos, double newVal);
+    /** @brief While enabled, the following value updates (for example while a key is held) are merged in one undo entry */
+    Q_INVOKABLE void setMergeUpdates(bool merge);
     bool updateKeyframe(GenTime pos, QVariant value);
     bool updateKeyframeType(GenTime pos, int type, Fun &undo, Fun &redo);
     bool updateKeyframe(GenTime pos, const QVariant &value, Fun &undo, Fun &redo, bool update = true);
@@ -215,6 +217,10 @@ private:
     /** @brief This is a lock that ensures safety in case of concurrent access */
     mutable QReadWriteLock m_lock;
 
+    /** @brief Keyframes keyed by position. Unlike the subtitle and marker frame indexes, this stays keyed by GenTime: the undo lambdas
+     *         and the (de)serialization code rely on its ordering, and positions must survive a frame rate change. Loops over it compute
+     *         the frame rate once instead.
+     */
     std::map<GenTime, std::pair<KeyframeType::KeyframeEnum, QVariant>> m_keyframeList;
     bool moveOneKeyframe(GenTime oldPos, GenTime pos, QVariant newVal, Fun &undo, Fun &redo, bool updateView = true, bool allowedToFail = false);
 
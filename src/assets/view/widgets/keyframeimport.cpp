@@ -1150,7 +1150,8 @@ void KeyframeImport::importSelectedData()
             }
         }
     }
-    pCore->pushUndo(undo, redo, i18n("Import keyframes from clipboard"));
+    // Each imported keyframe captures its value and the previous state in the undo lambdas
+    pCore->pushUndo(undo, redo, i18n("Import keyframes from clipboard"), qint64(anim->key_count()) * 256);
 }
 
 int KeyframeImport::getImportType() const
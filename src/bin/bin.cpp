@@ -53,6 +53,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "projectitemmodel.h"
 #include "projectsortproxymodel.h"
 #include "projectsubclip.h"
+#include "sequenceclip.h"
 #include "tagwidget.hpp"
 #include "titler/titlewidget.h"
 #include "ui_newtimeline_ui.h"
@@ -1713,6 +1714,9 @@ Bin::Bin(std::shared_ptr<ProjectItemModel> model, QWidget *parent, bool isMainBi
     m_messageTimer.setSingleShot(true);
     m_messageTimer.setInterval(3000);
     connect(&m_messageTimer, &QTimer::timeout, m_infoMessage, &KMessageWidget::animatedHide);
+    m_loadVisibleTimer.setSingleShot(true);
+    m_loadVisibleTimer.setInterval(100);
+    connect(&m_loadVisibleTimer, &QTimer::timeout, this, &Bin::loadVisibleClips);
     connect(m_infoMessage, &KMessageWidget::hideAnimationFinished, this, &Bin::slotResetInfoMessage);
     // m_infoMessage->setWordWrap(true);
     m_infoMessage->hide();
@@ -1813,6 +1817,11 @@ void Bin::abortOperations()
 
 bool Bin::eventFilter(QObject *obj, QEvent *event)
 {
+    if (event->type() == QEvent::Paint && m_itemView && obj == m_itemView->viewport() && KdenliveSettings::lazybinloading() &&
+        !m_loadVisibleTimer.isActive()) {
+        // Scrolling, expanding a folder or changing the root folder all repaint the view
+        m_loadVisibleTimer.start();
+    }
     if (event->type() == QEvent::MouseButtonPress) {
         if (m_itemView && m_listType == BinTreeView) {
             // Folder state is only valid in tree view mode
@@ -2997,6 +3006,7 @@ void Bin::selectProxyModel(const QModelIndex &id)
             // don't need to wait for the clip to be ready to get its type
             if (clip) {
                 type = clip->clipType();
+                clip->ensureLoaded();
             }
             if (clip && clip->statusReady()) {
                 Q_EMIT requestShowClipProperties(clip, false);
@@ -3360,6 +3370,44 @@ void Bin::slotInitView(QAction *action)
     m_itemView->setFocus();
 }
 
+void Bin::loadVisibleClips()
+{
+    if (!m_itemView || !m_proxyModel) {
+        return;
+    }
+    const QRect visibleRect = m_itemView->viewport()->rect();
+    auto loadItem = [this](const QModelIndex &ix) {
+        std::shared_ptr<AbstractProjectItem> item = m_itemModel->getBinItemByIndex(m_proxyModel->mapToSource(ix));
+        if (!item) {
+            return;
+        }
+        if (item->itemType() == AbstractProjectItem::ClipItem) {
+            std::static_pointer_cast<ProjectClip>(item)->ensureLoaded();
+        } else if (item->itemType() == AbstractProjectItem::SubClipItem) {
+            std::static_pointer_cast<ProjectSubClip>(item)->ensureLoaded();
+        }
+    };
+    if (m_listType == BinTreeView) {
+        auto *view = static_cast<QTreeView *>(m_itemView);
+        // Walk the displayed rows from the top of the viewport, children of collapsed folders are skipped
+        for (QModelIndex ix = view->indexAt(visibleRect.topLeft()); ix.isValid(); ix = view->indexBelow(ix)) {
+            if (view->visualRect(ix).top() > visibleRect.bottom()) {
+                break;
+            }
+            loadItem(ix);
+        }
+    } else {
+        const QModelIndex root = m_itemView->rootIndex();
+        const int rows = m_proxyModel->rowCount(root);
+        for (int i = 0; i < rows; ++i) {
+            const QModelIndex ix = m_proxyModel->index(i, 0, root);
+            if (m_itemView->visualRect(ix).intersects(visibleRect)) {
+                loadItem(ix);
+            }
+        }
+    }
+}
+
 void Bin::slotSetIconSize(int size)
 {
     if (!m_itemView) {
@@ -6300,6 +6348,7 @@ void Bin::updateSequenceClip(const QUuid &uuid, std::pair<int, int> durations, i
             clip->setProperties(properties);
             // Reset thumbs producer
             m_doc->sequenceThumbUpdated(uuid);
+            std::static_pointer_cast<SequenceClip>(clip)->invalidatePreRender();
             clip->reloadTimeline();
             // Don't update thumb now, it causes too much lag on sequence switch or saving
         }
@@ -418,6 +418,9 @@ private Q_SLOTS:
      * @param action The action whose data defines the view type or nullptr to keep default view */
     void slotInitView(QAction *action);
     void slotSetIconSize(int size);
+    /** @brief Start the deferred thumbnail and audio levels jobs of the clips displayed in the view, see lazybinloading.
+     *  Producers are not deferred, they are all created when the project is loaded. */
+    void loadVisibleClips();
     void selectProxyModel(const QModelIndex &id);
     void slotSaveHeaders();
 
@@ -611,6 +614,8 @@ private:
     /** @brief The info widget for failed jobs. */
     KMessageWidget *m_infoMessage;
     QTimer m_messageTimer;
+    /** @brief Collects view repaints before checking which clips became visible */
+    QTimer m_loadVisibleTimer;
     BinMessage::BinCategory m_currentMessage;
     QStringList m_errorLog;
     /** @brief Dialog listing invalid clips on load. */
@@ -0,0 +1,110 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "binsearchindex.h"
+
+QStringList BinSearchIndex::tokenize(const QString &text)
+{
+    QStringList tokens;
+    const QString lower = text.toLower();
+    int start = -1;
+    for (int i = 0; i <= lower.size(); ++i) {
+        const bool isWordChar = i < lower.size() && lower.at(i).isLetterOrNumber();
+        if (isWordChar && start < 0) {
+            start = i;
+        } else if (!isWordChar && start >= 0) {
+            tokens << lower.mid(start, i - start);
+            start = -1;
+        }
+    }
+    tokens.removeDuplicates();
+    return tokens;
+}
+
+void BinSearchIndex::removeTokens(const QString &binId, const QStringList &tokens)
+{
+    for (const QString &token : tokens) {
+        auto it = m_postings.find(token);
+        if (it == m_postings.end()) {
+            continue;
+        }
+        auto item = it->second.find(binId);
+        if (item != it->second.end() && --item.value() <= 0) {
+            it->second.erase(item);
+        }
+        if (it->second.isEmpty()) {
+            m_postings.erase(it);
+        }
+    }
+}
+
+void BinSearchIndex::setText(const QString &binId, Field field, const QString &text)
+{
+    const QStringList tokens = tokenize(text);
+    auto &fields = m_itemTokens[binId];
+    if (fields[field] == tokens) {
+        return;
+    }
+    removeTokens(binId, fields[field]);
+    for (const QString &token : tokens) {
+        m_postings[token][binId]++;
+    }
+    fields[field] = tokens;
+    m_revision++;
+}
+
+void BinSearchIndex::removeItem(const QString &binId)
+{
+    auto it = m_itemTokens.find(binId);
+    if (it == m_itemTokens.end()) {
+        return;
+    }
+    for (const QStringList &tokens : it.value()) {
+        removeTokens(binId, tokens);
+    }
+    m_itemTokens.erase(it);
+    m_revision++;
+}
+
+void BinSearchIndex::clear()
+{
+    m_postings.clear();
+    m_itemTokens.clear();
+    m_revision++;
+}
+
+QSet<QString> BinSearchIndex::search(const QString &query) const
+{
+    QSet<QString> result;
+    const QStringList words = tokenize(query);
+    bool first = true;
+    for (const QString &word : words) {
+        // All tokens starting with the word are contiguous in the sorted map
+        QSet<QString> matches;
+        for (auto it = m_postings.lower_bound(word); it != m_postings.end() && it->first.startsWith(word); ++it) {
+            for (auto item = it->second.cbegin(); item != it->second.cend(); ++item) {
+                if (first || result.contains(item.key())) {
+                    matches.insert(item.key());
+                }
+            }
+        }
+        result = matches;
+        first = false;
+        if (result.isEmpty()) {
+            break;
+        }
+    }
+    return result;
+}
+
+int BinSearchIndex::count() const
+{
+    return m_itemTokens.size();
+}
+
+int BinSearchIndex::revision() const
+{
+    return m_revision;
+}
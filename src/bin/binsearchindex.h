@@ -0,0 +1,47 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <array>
+#include <map>
+
+/** @class BinSearchIndex
+    @brief Inverted index of the words found in the bin items, used by the bin search.
+    Each item is indexed by several text fields, which can be updated separately. A search returns the ids of
+    the items containing, for each word of the query, a word starting with it. Lookups use a sorted token map,
+    so filtering the bin only requires a membership test per row instead of matching the text of every item.
+ */
+class BinSearchIndex
+{
+public:
+    enum Field { Name, Description, Tags, Markers, FieldCount };
+
+    /** @brief Replace the indexed text of one field of an item */
+    void setText(const QString &binId, Field field, const QString &text);
+    /** @brief Remove all the fields of an item */
+    void removeItem(const QString &binId);
+    void clear();
+    /** @brief Returns the ids of the items matching all the words of the query */
+    QSet<QString> search(const QString &query) const;
+    /** @brief Number of indexed items */
+    int count() const;
+    /** @brief Incremented on each change, so that search results can be cached */
+    int revision() const;
+    /** @brief Split a text in lowercase words */
+    static QStringList tokenize(const QString &text);
+
+private:
+    /** @brief For each token, the items containing it and in how many of their fields */
+    std::map<QString, QHash<QString, int>> m_postings;
+    /** @brief The tokens of each field of an item, to update the postings */
+    QHash<QString, std::array<QStringList, FieldCount>> m_itemTokens;
+    int m_revision{0};
+    void removeTokens(const QString &binId, const QStringList &tokens);
+};
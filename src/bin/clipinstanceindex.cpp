@@ -0,0 +1,146 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "clipinstanceindex.h"
+
+#include <algorithm>
+
+bool ClipInstanceIndex::insert(const QUuid &uuid, int clipId)
+{
+    if (!m_instances[uuid].insert(clipId).second) {
+        return false;
+    }
+    m_totalCount++;
+    return true;
+}
+
+bool ClipInstanceIndex::remove(const QUuid &uuid, int clipId)
+{
+    auto it = m_instances.find(uuid);
+    if (it == m_instances.end() || it->second.erase(clipId) == 0) {
+        return false;
+    }
+    m_totalCount--;
+    if (it->second.empty()) {
+        m_instances.erase(it);
+    }
+    return true;
+}
+
+int ClipInstanceIndex::removeTimeline(const QUuid &uuid)
+{
+    auto it = m_instances.find(uuid);
+    if (it == m_instances.end()) {
+        return 0;
+    }
+    int removed = int(it->second.size());
+    m_totalCount -= removed;
+    m_instances.erase(it);
+    return removed;
+}
+
+void ClipInstanceIndex::clear()
+{
+    m_instances.clear();
+    m_totalCount = 0;
+}
+
+bool ClipInstanceIndex::isEmpty() const
+{
+    return m_totalCount == 0;
+}
+
+bool ClipInstanceIndex::contains(const QUuid &uuid) const
+{
+    return m_instances.count(uuid) > 0;
+}
+
+bool ClipInstanceIndex::contains(const QUuid &uuid, int clipId) const
+{
+    auto it = m_instances.find(uuid);
+    return it != m_instances.end() && it->second.count(clipId) > 0;
+}
+
+int ClipInstanceIndex::count(const QUuid &uuid) const
+{
+    auto it = m_instances.find(uuid);
+    return it == m_instances.end() ? 0 : int(it->second.size());
+}
+
+int ClipInstanceIndex::totalCount() const
+{
+    return m_totalCount;
+}
+
+QList<int> ClipInstanceIndex::instances(const QUuid &uuid) const
+{
+    QList<int> result;
+    auto it = m_instances.find(uuid);
+    if (it != m_instances.end()) {
+        result.reserve(int(it->second.size()));
+        for (int cid : it->second) {
+            result << cid;
+        }
+    }
+    return result;
+}
+
+QList<QUuid> ClipInstanceIndex::timelines() const
+{
+    QList<QUuid> result;
+    result.reserve(int(m_instances.size()));
+    for (const auto &entry : m_instances) {
+        result << entry.first;
+    }
+    return result;
+}
+
+QMap<QUuid, QList<int>> ClipInstanceIndex::toMap() const
+{
+    QMap<QUuid, QList<int>> result;
+    for (const auto &entry : m_instances) {
+        result.insert(entry.first, instances(entry.first));
+    }
+    return result;
+}
+
+ClipInstanceIndex::const_iterator ClipInstanceIndex::begin() const
+{
+    return m_instances.cbegin();
+}
+
+ClipInstanceIndex::const_iterator ClipInstanceIndex::end() const
+{
+    return m_instances.cend();
+}
+
+ClipInstanceIndex::const_iterator ClipInstanceIndex::find(const QUuid &uuid) const
+{
+    return m_instances.find(uuid);
+}
+
+QVector<QPoint> ClipInstanceIndex::mergeBounds(QVector<QPoint> bounds)
+{
+    if (bounds.size() < 2) {
+        return bounds;
+    }
+    std::sort(bounds.begin(), bounds.end(), [](const QPoint &a, const QPoint &b) { return a.x() < b.x() || (a.x() == b.x() && a.y() > b.y()); });
+    QVector<QPoint> merged;
+    merged.reserve(bounds.size());
+    int start = bounds.first().x();
+    int end = start + bounds.first().y();
+    for (int i = 1; i < bounds.size(); ++i) {
+        const QPoint &p = bounds.at(i);
+        if (p.x() <= end) {
+            end = qMax(end, p.x() + p.y());
+            continue;
+        }
+        merged << QPoint(start, end - start);
+        start = p.x();
+        end = start + p.y();
+    }
+    merged << QPoint(start, end - start);
+    return merged;
+}
@@ -0,0 +1,61 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QList>
+#include <QMap>
+#include <QPoint>
+#include <QUuid>
+#include <QVector>
+#include <map>
+#include <set>
+
+/** @class ClipInstanceIndex
+    @brief Keeps track of the timeline clips using a bin clip, grouped by timeline uuid.
+    Instance counts are maintained incrementally so that registering or removing an instance does not require
+    walking all the timelines, which matters for bin clips reused thousands of times.
+ */
+class ClipInstanceIndex
+{
+public:
+    using Instances = std::set<int>;
+    using const_iterator = std::map<QUuid, Instances>::const_iterator;
+
+    /** @brief Register a timeline clip, returns false if it was already registered */
+    bool insert(const QUuid &uuid, int clipId);
+    /** @brief Remove a timeline clip, returns false if it was not registered */
+    bool remove(const QUuid &uuid, int clipId);
+    /** @brief Remove all instances of a timeline, returns the number of removed instances */
+    int removeTimeline(const QUuid &uuid);
+    void clear();
+
+    bool isEmpty() const;
+    bool contains(const QUuid &uuid) const;
+    bool contains(const QUuid &uuid, int clipId) const;
+    /** @brief Number of instances in the given timeline */
+    int count(const QUuid &uuid) const;
+    /** @brief Number of instances in all timelines */
+    int totalCount() const;
+    /** @brief The instances of a timeline, sorted by clip id */
+    QList<int> instances(const QUuid &uuid) const;
+    QList<QUuid> timelines() const;
+    /** @brief Returns a copy of the index, to be used when the loop body might register or remove instances */
+    QMap<QUuid, QList<int>> toMap() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator find(const QUuid &uuid) const;
+
+    /** @brief Build the list of used ranges from the in point and duration of each instance
+     *  @param bounds a list of {in, duration} points, in any order and possibly overlapping
+     *  @returns the sorted list of {in, duration} ranges, where overlapping and adjacent ranges are merged
+     */
+    static QVector<QPoint> mergeBounds(QVector<QPoint> bounds);
+
+private:
+    std::map<QUuid, Instances> m_instances;
+    int m_totalCount{0};
+};
@@ -393,12 +393,14 @@ void MarkerListModel::moveMarkersWithoutUndo(const QVector<int> &markersId, int
     }
     int firstRow = -1;
     int lastRow = -1;
+    const double fps = pCore->getCurrentFps();
+    const GenTime delta(offset, fps);
     for (auto mid : markersId) {
         Q_ASSERT(m_markerList.count(mid) > 0);
         GenTime t = m_markerList.at(mid).time();
-        m_markerPositions.remove(t.frames(pCore->getCurrentFps()));
-        t += GenTime(offset, pCore->getCurrentFps());
-        m_markerPositions.insert(t.frames(pCore->getCurrentFps()), mid);
+        m_markerPositions.remove(t.frames(fps));
+        t += delta;
+        m_markerPositions.insert(t.frames(fps), mid);
         m_markerList[mid].setTime(t);
         if (!updateView) {
             continue;
@@ -640,14 +642,13 @@ QVector<int> MarkerListModel::getMarkersIdInRange(int start, int end) const
     READ_LOCK();
     // First find marker ids in range
     QVector<int> markers;
-    QMap<int, int>::const_iterator i = m_markerPositions.constBegin();
+    // Positions are sorted frames, jump to the first one in range
+    QMap<int, int>::const_iterator i = m_markerPositions.lowerBound(start);
     while (i != m_markerPositions.constEnd()) {
         if (end > -1 && i.key() > end) {
             break;
         }
-        if (i.key() >= start) {
-            markers << i.value();
-        }
+        markers << i.value();
         ++i;
     }
     return markers;
@@ -836,9 +837,10 @@ QString MarkerListModel::toJson(QList<int> categories) const
         }
     }
     std::sort(markers.begin(), markers.end());
+    const double fps = pCore->getCurrentFps();
     for (const auto &marker : std::as_const(markers)) {
         QJsonObject currentMarker;
-        currentMarker.insert(QLatin1String("pos"), QJsonValue(marker.time().frames(pCore->getCurrentFps())));
+        currentMarker.insert(QLatin1String("pos"), QJsonValue(marker.time().frames(fps)));
         currentMarker.insert(QLatin1String("comment"), QJsonValue(marker.comment()));
         currentMarker.insert(QLatin1String("type"), QJsonValue(marker.markerType()));
         list.push_back(currentMarker);
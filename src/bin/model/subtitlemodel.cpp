@@ -417,7 +417,9 @@ void SubtitleModel::importSubtitle(const QString &filePath, int offset, bool ext
     PUSH_LAMBDA(update_model, redo);
     update_model();
     if (externalImport) {
-        pCore->pushUndo(undo, redo, i18n("Edit subtitle"));
+        // Each imported event is captured with its text by the undo/redo lambdas
+        qint64 cost = qint64(m_subtitleList.size() - initialCount) * qint64(sizeof(SubtitleEvent) + 256);
+        pCore->pushUndo(undo, redo, i18n("Edit subtitle"), cost);
     }
 }
 
@@ -640,21 +642,31 @@ std::unordered_set<int> SubtitleModel::getItemsInRange(int layer, int startFrame
     if (isLocked()) {
         return {};
     }
-    GenTime startTime(startFrame, pCore->getCurrentFps());
-    GenTime endTime(endFrame, pCore->getCurrentFps());
+    const double fps = pCore->getCurrentFps();
+    GenTime startTime(startFrame, fps);
+    GenTime endTime(endFrame, fps);
     std::unordered_set<int> matching;
-    for (const auto &subtitles : m_subtitleList) {
+    // The list is sorted by layer then start time, only walk the requested layer
+    auto it = layer == -1 ? m_subtitleList.cbegin() : m_subtitleList.lower_bound({layer, GenTime()});
+    for (; it != m_subtitleList.cend(); ++it) {
+        const auto &subtitles = *it;
+        if (layer != -1 && subtitles.first.first != layer) {
+            break;
+        }
         // if layer is -1, we check all layers
-        if ((endFrame > -1 && subtitles.first.second > endTime) || (layer != -1 && subtitles.first.first != layer)) {
+        if (endFrame > -1 && subtitles.first.second > endTime) {
             // Outside range
+            if (layer != -1) {
+                break;
+            }
             continue;
         }
         if (subtitles.first.second >= startTime || subtitles.second.endTime() > startTime) {
-            int sid = getIdForStartPos(layer, subtitles.first.second);
+            int sid = getIdForStartPos(subtitles.first.first, subtitles.first.second);
             if (sid > -1) {
                 matching.emplace(sid);
             } else {
-                qDebug() << "==== FOUND INVALID SUBTITLE AT: " << subtitles.first.second.frames(pCore->getCurrentFps());
+                qDebug() << "==== FOUND INVALID SUBTITLE AT: " << subtitles.first.second.frames(fps);
             }
         }
     }
@@ -742,8 +754,9 @@ void SubtitleModel::registerSnap(const std::weak_ptr<SnapInterface> &snapModel)
         // ptr is valid, we store it
         m_regSnaps.push_back(snapModel);
         // we now add the already existing subtitles to the snap
+        const double fps = pCore->getCurrentFps();
         for (const auto &subtitle : m_subtitleList) {
-            ptr->addPoint(subtitle.first.second.frames(pCore->getCurrentFps()));
+            ptr->addPoint(subtitle.first.second.frames(fps));
         }
     } else {
         qDebug() << "Error: added snapmodel for subtitle is null";
@@ -896,7 +909,7 @@ bool SubtitleModel::requestResize(int id, int size, bool right, Fun &undo, Fun &
         }
         const SubtitleEvent event = m_subtitleList.at(startPos);
         operation = [this, id, startPos, newStartPos, event, logUndo]() {
-            m_allSubtitles[id] = newStartPos;
+            setStartPosForId(id, newStartPos);
             m_subtitleList.erase(startPos);
             m_subtitleList[newStartPos] = event;
             // Trigger update of the qml view
@@ -918,7 +931,7 @@ bool SubtitleModel::requestResize(int id, int size, bool right, Fun &undo, Fun &
             return true;
         };
         reverse = [this, id, startPos, newStartPos, event, logUndo]() {
-            m_allSubtitles[id] = startPos;
+            setStartPosForId(id, startPos);
             m_subtitleList.erase(newStartPos);
             m_subtitleList[startPos] = event;
             removeSnapPoint(newStartPos.second);
@@ -1051,7 +1064,7 @@ bool SubtitleModel::moveSubtitle(int subId, int newLayer, GenTime newPos, bool u
     if (newLayer > m_maxLayer) {
         setMaxLayer(newLayer);
     }
-    m_allSubtitles[id] = {newLayer, newPos};
+    setStartPosForId(id, {newLayer, newPos});
     m_subtitleList.erase({oldLayer, oldPos});
     m_subtitleList[{newLayer, newPos}] = event;
     m_subtitleList[{newLayer, newPos}].setEndTime(endPos);
@@ -1082,6 +1095,16 @@ bool SubtitleModel::moveSubtitle(int subId, int newLayer, GenTime newPos, bool u
 
 int SubtitleModel::getIdForStartPos(int layer, GenTime startTime) const
 {
+    if (layer > -1) {
+        auto position = m_subtitlePositions.find({layer, startTime.frames(pCore->getCurrentFps())});
+        if (position != m_subtitlePositions.end()) {
+            auto sub = m_allSubtitles.find(position->second);
+            if (sub != m_allSubtitles.end() && sub->second.second == startTime) {
+                return position->second;
+            }
+        }
+    }
+    // Not indexed (sub frame positions or profile change), search all subtitles
     auto findResult = std::find_if(std::begin(m_allSubtitles), std::end(m_allSubtitles), [&](const std::pair<int, std::pair<int, GenTime>> &pair) {
         return pair.second.second == startTime && (pair.second.first == layer || layer == -1);
     });
@@ -1462,9 +1485,10 @@ void SubtitleModel::loadProperties(const QMap<QString, QString> &subProperties)
 
 void SubtitleModel::allSnaps(std::vector<int> &snaps)
 {
+    const double fps = pCore->getCurrentFps();
     for (const auto &subtitle : m_subtitleList) {
-        snaps.push_back(subtitle.first.second.frames(pCore->getCurrentFps()));
-        snaps.push_back(subtitle.second.endTime().frames(pCore->getCurrentFps()));
+        snaps.push_back(subtitle.first.second.frames(fps));
+        snaps.push_back(subtitle.second.endTime().frames(fps));
     }
 }
 
@@ -1499,17 +1523,26 @@ bool SubtitleModel::isBlankAt(int layer, int pos) const
 
 int SubtitleModel::getBlankEnd(int layer, int pos) const
 {
-    GenTime matchPos(pos, pCore->getCurrentFps());
+    const double fps = pCore->getCurrentFps();
+    GenTime matchPos(pos, fps);
+    if (layer > -1) {
+        // The list is sorted by layer then start time, the blank ends at the next subtitle start
+        auto next = m_subtitleList.upper_bound({layer, matchPos});
+        if (next != m_subtitleList.cend() && next->first.first == layer) {
+            return next->first.second.frames(fps);
+        }
+        return 0;
+    }
     bool found = false;
     GenTime min;
     for (const auto &subtitles : m_subtitleList) {
         // if layer is -1, we check all layers
-        if ((layer == -1 || subtitles.first.first == layer) && subtitles.first.second > matchPos && (min == GenTime() || subtitles.first.second < min)) {
+        if (subtitles.first.second > matchPos && (min == GenTime() || subtitles.first.second < min)) {
             min = subtitles.first.second;
             found = true;
         }
     }
-    return found ? min.frames(pCore->getCurrentFps()) : 0;
+    return found ? min.frames(fps) : 0;
 }
 
 int SubtitleModel::getBlankSizeAtPos(int layer, int frame) const
@@ -2009,6 +2042,7 @@ void SubtitleModel::registerSubtitle(int id, std::pair<int, GenTime> startpos, b
 {
     Q_ASSERT(m_allSubtitles.count(id) == 0);
     m_allSubtitles.emplace(id, startpos);
+    m_subtitlePositions[{startpos.first, startpos.second.frames(pCore->getCurrentFps())}] = id;
     if (!temporary) {
         m_timeline->m_groups->createGroupItem(id);
     }
@@ -2020,12 +2054,30 @@ void SubtitleModel::deregisterSubtitle(int id, bool temporary)
     if (!temporary && isSelected(id)) {
         m_timeline->requestClearSelection(true);
     }
+    const std::pair<int, GenTime> startpos = m_allSubtitles.at(id);
+    auto position = m_subtitlePositions.find({startpos.first, startpos.second.frames(pCore->getCurrentFps())});
+    if (position != m_subtitlePositions.end() && position->second == id) {
+        m_subtitlePositions.erase(position);
+    }
     m_allSubtitles.erase(id);
     if (!temporary) {
         m_timeline->m_groups->destructGroupItem(id);
     }
 }
 
+void SubtitleModel::setStartPosForId(int id, std::pair<int, GenTime> startpos)
+{
+    Q_ASSERT(m_allSubtitles.count(id) > 0);
+    const double fps = pCore->getCurrentFps();
+    const std::pair<int, GenTime> oldpos = m_allSubtitles.at(id);
+    auto position = m_subtitlePositions.find({oldpos.first, oldpos.second.frames(fps)});
+    if (position != m_subtitlePositions.end() && position->second == id) {
+        m_subtitlePositions.erase(position);
+    }
+    m_allSubtitles[id] = startpos;
+    m_subtitlePositions[{startpos.first, startpos.second.frames(fps)}] = id;
+}
+
 int SubtitleModel::positionForIndex(int id) const
 {
     return int(std::distance(m_allSubtitles.begin(), m_allSubtitles.find(id)));
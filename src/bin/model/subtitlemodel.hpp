@@ -304,6 +304,8 @@ private:
     QMap<std::pair<int, QString>, QString> m_subtitlesList;
     /** @brief A list of subtitles as: item id, layer, start time */
     std::map<int, std::pair<int, GenTime>> m_allSubtitles;
+    /** @brief A list of {{layer, start frame}, item id}, useful to quickly find a subtitle from its position */
+    std::map<std::pair<int, int>, int> m_subtitlePositions;
     /** @brief The max layer in the subtitle model */
     int m_maxLayer{0};
     /** @brief Default styles for subtitle layers */
@@ -344,6 +346,8 @@ protected:
     void setup();
     void registerSubtitle(int id, std::pair<int, GenTime> startpos, bool temporary = false);
     void deregisterSubtitle(int id, bool temporary = false);
+    /** @brief Change the layer and start time of a registered subtitle, keeping the positions index in sync */
+    void setStartPosForId(int id, std::pair<int, GenTime> startpos);
     /** @brief Returns the index for a subtitle's id (it's position in the list
      */
     int positionForIndex(int id) const;
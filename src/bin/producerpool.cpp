@@ -0,0 +1,164 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "producerpool.h"
+#include "kdenlive_debug.h"
+#include "kdenlivesettings.h"
+
+#include <QThread>
+#include <QtGlobal>
+#include <mlt++/MltProducer.h>
+
+// Name used by the MLT avformat producer for its decoder cache
+static const char *DecoderCacheName = "producer_avformat";
+// Maximum cache size accepted by MLT
+static constexpr int MaxDecoderLimit = 200;
+
+bool ProducerPool::acquire(const Key &key, int clipId)
+{
+    QMutexLocker lock(&m_mutex);
+    Q_ASSERT(!m_clipKeys.contains(clipId));
+    m_clipKeys.insert(clipId, key);
+    const bool wasIdle = m_idle.remove(key);
+    int &count = m_users[key];
+    count++;
+    m_metrics.users++;
+    if (count > 1) {
+        m_metrics.reused++;
+        return false;
+    }
+    m_metrics.producers++;
+    m_metrics.peakProducers = qMax(m_metrics.peakProducers, m_metrics.producers);
+    if (wasIdle) {
+        // The producer was kept after its last user was removed
+        m_metrics.reused++;
+        return false;
+    }
+    m_metrics.created++;
+    return true;
+}
+
+std::optional<ProducerPool::Key> ProducerPool::release(int clipId)
+{
+    QMutexLocker lock(&m_mutex);
+    auto it = m_clipKeys.find(clipId);
+    if (it == m_clipKeys.end()) {
+        return std::nullopt;
+    }
+    const Key key = it.value();
+    m_clipKeys.erase(it);
+    m_metrics.users--;
+    auto count = m_users.find(key);
+    Q_ASSERT(count != m_users.end());
+    if (--count.value() > 0) {
+        return std::nullopt;
+    }
+    m_users.erase(count);
+    m_idle.insert(key);
+    m_metrics.producers--;
+    m_metrics.released++;
+    return key;
+}
+
+QList<ProducerPool::Key> ProducerPool::idleProducers() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_idle.values();
+}
+
+void ProducerPool::forgetIdle(const Key &key)
+{
+    QMutexLocker lock(&m_mutex);
+    m_idle.remove(key);
+}
+
+std::optional<ProducerPool::Key> ProducerPool::keyOf(int clipId) const
+{
+    QMutexLocker lock(&m_mutex);
+    auto it = m_clipKeys.constFind(clipId);
+    if (it == m_clipKeys.constEnd()) {
+        return std::nullopt;
+    }
+    return it.value();
+}
+
+int ProducerPool::users(const Key &key) const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_users.value(key);
+}
+
+void ProducerPool::removeBinClip(const QString &binId)
+{
+    QMutexLocker lock(&m_mutex);
+    for (auto it = m_clipKeys.begin(); it != m_clipKeys.end();) {
+        if (it.value().binId == binId) {
+            it = m_clipKeys.erase(it);
+            m_metrics.users--;
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = m_users.begin(); it != m_users.end();) {
+        if (it.key().binId == binId) {
+            it = m_users.erase(it);
+            m_metrics.producers--;
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = m_idle.begin(); it != m_idle.end();) {
+        if (it->binId == binId) {
+            it = m_idle.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ProducerPool::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    qCDebug(KDENLIVE_LOG) << "Producer pool: created" << m_metrics.created << "track producers, reused" << m_metrics.reused << "times, released" << m_metrics.released
+             << ", peak" << m_metrics.peakProducers << "producers," << m_metrics.closedDecoders << "decoders closed";
+    m_users.clear();
+    m_clipKeys.clear();
+    m_idle.clear();
+    m_metrics = Metrics();
+}
+
+ProducerPool::Metrics ProducerPool::metrics() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_metrics;
+}
+
+void ProducerPool::closeDecoder(const std::shared_ptr<Mlt::Producer> &producer)
+{
+    if (!producer || !producer->is_valid()) {
+        return;
+    }
+    // Cuts kept by the undo stack still reference the producer, only its decoder is released
+    mlt_service_cache_purge(producer->get_service());
+    QMutexLocker lock(&m_mutex);
+    m_metrics.closedDecoders++;
+}
+
+void ProducerPool::setDecoderLimit(int limit)
+{
+    mlt_service_cache_set_size(nullptr, DecoderCacheName, qBound(1, limit, MaxDecoderLimit));
+}
+
+int ProducerPool::decoderLimit()
+{
+    return mlt_service_cache_get_size(nullptr, DecoderCacheName);
+}
+
+void ProducerPool::setDecoderLimitForTracks(int tracksCount)
+{
+    // Playback needs a decoder per track, plus the ones used by the thumbnail and preview threads
+    const int wanted = qMax(4, QThread::idealThreadCount() + (tracksCount + 1) * 2);
+    setDecoderLimit(qMin(wanted, KdenliveSettings::maxopendecoders()));
+}
@@ -0,0 +1,101 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <memory>
+#include <optional>
+
+namespace Mlt {
+class Producer;
+}
+
+/** @class ProducerPool
+    @brief Project wide reference counting of the track producers created by the bin clips.
+    Each bin clip creates one producer per track (and audio stream) on which it is used, so that clips of different
+    tracks do not share a decoder. The pool counts the timeline clips using each of these producers, so that a producer
+    is released once its last clip is deleted or moved instead of staying open until the project is closed.
+    A producer without user closes its decoder and stays idle until the operation is recorded in the undo stack, or
+    longer if it is still referenced by the clips kept in the undo stack, see ProjectItemModel::releaseIdleProducers.
+    An idle producer is reused if a clip of the same track needs it again.
+    The pool can be used from any thread.
+    The number of simultaneously open avformat decoders is capped project wide through the MLT service cache, which
+    closes the least recently used decoders and transparently reopens them on the next frame request.
+ */
+class ProducerPool
+{
+public:
+    struct Key
+    {
+        QString binId;
+        bool audio;
+        /** @brief The track id, offset by the audio stream and negated for the second playlist of the track */
+        int track;
+        bool operator==(const Key &other) const { return track == other.track && audio == other.audio && binId == other.binId; }
+    };
+
+    struct Metrics
+    {
+        /** @brief Number of track producers currently used by timeline clips */
+        int producers{0};
+        /** @brief Number of timeline clips using a track producer */
+        int users{0};
+        int peakProducers{0};
+        /** @brief Number of acquisitions that created a new track producer */
+        quint64 created{0};
+        /** @brief Number of acquisitions that reused an existing track producer */
+        quint64 reused{0};
+        /** @brief Number of track producers released because they had no more user */
+        quint64 released{0};
+        /** @brief Number of decoders explicitly closed by the pool */
+        quint64 closedDecoders{0};
+    };
+
+    /** @brief Register a timeline clip as user of a track producer. The clip must have been released from its previous producer.
+     *  @returns true if the producer had no user yet and was not kept idle, so it has to be created
+     */
+    bool acquire(const Key &key, int clipId);
+    /** @brief Unregister a timeline clip.
+     *  @returns the key of its track producer if the clip was its last user. The producer is then idle until it is used again or forgotten
+     */
+    std::optional<Key> release(int clipId);
+    /** @brief Returns the producers that have no user but were not freed yet */
+    QList<Key> idleProducers() const;
+    /** @brief Stop tracking an idle producer once it was freed */
+    void forgetIdle(const Key &key);
+    /** @brief Returns the producer key currently used by a timeline clip, if any */
+    std::optional<Key> keyOf(int clipId) const;
+    /** @brief Number of timeline clips using a track producer */
+    int users(const Key &key) const;
+    /** @brief Forget all the producers of a bin clip, for example when its producer is replaced */
+    void removeBinClip(const QString &binId);
+    void clear();
+    Metrics metrics() const;
+
+    /** @brief Close the decoder of a producer that is not used anymore. It is reopened if the producer is used again */
+    void closeDecoder(const std::shared_ptr<Mlt::Producer> &producer);
+    /** @brief Set the maximum number of simultaneously open avformat decoders, applied to all producers */
+    static void setDecoderLimit(int limit);
+    static int decoderLimit();
+    /** @brief Size the decoder limit for a timeline with this number of tracks, without exceeding the maxopendecoders setting */
+    static void setDecoderLimitForTracks(int tracksCount);
+
+private:
+    mutable QMutex m_mutex;
+    QHash<Key, int> m_users;
+    QHash<int, Key> m_clipKeys;
+    QSet<Key> m_idle;
+    Metrics m_metrics;
+};
+
+inline size_t qHash(const ProducerPool::Key &key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.binId, key.audio, key.track);
+}
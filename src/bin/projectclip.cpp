@@ -130,16 +130,85 @@ ProjectClip::ProjectClip(const QString &id, const QIcon &thumb, const std::share
     connectEffectStack();
     if (m_clipType != ClipType::Timeline &&
         (m_clipStatus == FileStatus::StatusProxy || m_clipStatus == FileStatus::StatusReady || m_clipStatus == FileStatus::StatusProxyOnly)) {
-        // Generate clip thumbnail
-        ObjectId oid(KdenliveObjectType::BinClip, m_binId.toInt(), QUuid());
-        ClipLoadTask::start(oid, QDomElement(), true, -1, -1, this);
-        // Generate audio thumbnail
-        if (KdenliveSettings::audiothumbnails() && (m_clipType == ClipType::AV || m_clipType == ClipType::Audio || m_hasAudio)) {
-            AudioLevelsTask::start(oid, this, false);
+        if (KdenliveSettings::lazybinloading()) {
+            // Large projects often have thousands of clips in collapsed folders, only process the ones displayed or used.
+            // The producer itself was already opened by the MLT XML loader, only its derived data is deferred
+            m_deferredLoading = true;
+        } else {
+            startLoadingJobs();
         }
     }
 }
 
+void ProjectClip::startLoadingJobs()
+{
+    // Generate clip thumbnail
+    ObjectId oid(KdenliveObjectType::BinClip, m_binId.toInt(), QUuid());
+    ClipLoadTask::start(oid, QDomElement(), true, -1, -1, this);
+    // Generate audio thumbnail
+    if (KdenliveSettings::audiothumbnails() && (m_clipType == ClipType::AV || m_clipType == ClipType::Audio || m_hasAudio)) {
+        AudioLevelsTask::start(oid, this, false);
+    }
+}
+
+void ProjectClip::ensureLoaded()
+{
+    // Can be called from the view and from timeline operations, only start the jobs once
+    if (m_deferredLoading.exchange(false)) {
+        startLoadingJobs();
+    }
+}
+
+bool ProjectClip::isLoadDeferred() const
+{
+    return m_deferredLoading;
+}
+
+void ProjectClip::useTrackProducer(int clipId, bool audio, int trackKey)
+{
+    ProducerPool &pool = pCore->projectItemModel()->producerPool();
+    const ProducerPool::Key key{m_binId, audio, trackKey};
+    const std::optional<ProducerPool::Key> current = pool.keyOf(clipId);
+    if (current && *current == key) {
+        return;
+    }
+    // The clip moved to another track, its previous producer might not be used anymore
+    releaseTrackProducer(clipId);
+    pool.acquire(key, clipId);
+}
+
+void ProjectClip::releaseTrackProducer(int clipId)
+{
+    ProducerPool &pool = pCore->projectItemModel()->producerPool();
+    const std::optional<ProducerPool::Key> unused = pool.release(clipId);
+    if (!unused) {
+        return;
+    }
+    // Only free the decoder for now. The producer is kept until the operation is recorded in the undo stack, so that an item
+    // removed and inserted again by the same operation, like a drop replacing its preview, reuses it. See ProjectItemModel::releaseIdleProducers
+    const auto &producers = unused->audio ? m_audioProducers : m_videoProducers;
+    auto it = producers.find(unused->track);
+    if (it != producers.end()) {
+        pool.closeDecoder(it->second);
+    }
+}
+
+bool ProjectClip::releaseIdleProducer(const ProducerPool::Key &key)
+{
+    auto &producers = key.audio ? m_audioProducers : m_videoProducers;
+    auto it = producers.find(key.track);
+    if (it == producers.end()) {
+        return true;
+    }
+    if (mlt_properties_ref_count(it->second->get_properties()) > 1) {
+        // Still referenced by the cuts of clips kept in the undo stack
+        return false;
+    }
+    m_effectStack->removeService(it->second);
+    producers.erase(it);
+    return true;
+}
+
 // static
 std::shared_ptr<ProjectClip> ProjectClip::construct(const QString &id, const QIcon &thumb, const std::shared_ptr<ProjectItemModel> &model,
                                                     std::shared_ptr<Mlt::Producer> &producer)
@@ -226,6 +295,7 @@ ProjectClip::~ProjectClip()
         m_audioProducers.clear();
         m_videoProducers.clear();
         m_timewarpProducers.clear();
+        discardPreparedProducers();
     }
 }
 
@@ -657,6 +727,8 @@ bool ProjectClip::setProducer(std::shared_ptr<Mlt::Producer> producer, bool gene
     }
     // set parent again (some info need to be stored in producer)
     updateParent(parentItem().lock());
+    // The jobs below replace the ones deferred on project opening
+    m_deferredLoading = false;
     if (generateThumb && m_clipType != ClipType::Audio) {
         // Generate video thumb
         ClipLoadTask::start(ObjectId(KdenliveObjectType::BinClip, m_binId.toInt(), QUuid()), QDomElement(), true, -1, -1, this);
@@ -694,6 +766,8 @@ bool ProjectClip::setProducer(std::shared_ptr<Mlt::Producer> producer, bool gene
         m_audioProducers.clear();
         m_videoProducers.clear();
         m_timewarpProducers.clear();
+        discardPreparedProducers();
+        pCore->projectItemModel()->producerPool().removeBinClip(m_binId);
     }
     Q_EMIT refreshPropertiesPanel();
     if (hasLimitedDuration()) {
@@ -989,12 +1063,13 @@ std::shared_ptr<Mlt::Producer> ProjectClip::getTimelineProducer(int trackId, int
             if (secondPlaylist) {
                 trackId = -trackId;
             }
+            useTrackProducer(clipId, true, trackId);
             if (m_audioProducers.count(trackId) == 0) {
                 if (m_clipType == ClipType::Timeline) {
                     std::shared_ptr<Mlt::Producer> prod(m_masterProducer->cut(0, maxDuration));
                     m_audioProducers[trackId] = prod;
                 } else {
-                    m_audioProducers[trackId] = cloneProducer(true, true);
+                    m_audioProducers[trackId] = takePreparedProducer();
                 }
                 m_audioProducers[trackId]->set("set.test_audio", 0);
                 m_audioProducers[trackId]->set("set.test_image", 1);
@@ -1040,12 +1115,12 @@ std::shared_ptr<Mlt::Producer> ProjectClip::getTimelineProducer(int trackId, int
             if (secondPlaylist) {
                 trackId = -trackId;
             }
+            useTrackProducer(clipId, false, trackId);
             if (m_videoProducers.count(trackId) == 0) {
                 if (m_clipType == ClipType::Timeline) {
-                    std::shared_ptr<Mlt::Producer> prod(m_masterProducer->cut(0, maxDuration));
-                    m_videoProducers[trackId] = prod;
+                    m_videoProducers[trackId] = sequenceVideoProducer(maxDuration);
                 } else {
-                    m_videoProducers[trackId] = cloneProducer(true, true);
+                    m_videoProducers[trackId] = takePreparedProducer();
                 }
                 if (m_masterProducer->property_exists("kdenlive:maxduration")) {
                     m_videoProducers[trackId]->set("kdenlive:maxduration", m_masterProducer->get_int("kdenlive:maxduration"));
@@ -1060,6 +1135,7 @@ std::shared_ptr<Mlt::Producer> ProjectClip::getTimelineProducer(int trackId, int
             return std::shared_ptr<Mlt::Producer>(m_videoProducers[trackId]->cut(-1, duration > 0 ? duration - 1 : -1));
         }
         Q_ASSERT(state == PlaylistState::Disabled);
+        releaseTrackProducer(clipId);
         createDisabledMasterProducer();
         int duration = m_masterProducer->time_to_frames(m_masterProducer->get("kdenlive:duration")) - 1;
         std::shared_ptr<Mlt::Producer> prod(m_disabledProducer->cut(-1, duration > 0 ? duration : -1));
@@ -1071,6 +1147,7 @@ std::shared_ptr<Mlt::Producer> ProjectClip::getTimelineProducer(int trackId, int
     }
 
     // For timewarp clips, we keep one separate producer for each clip.
+    releaseTrackProducer(clipId);
     std::shared_ptr<Mlt::Producer> warpProducer;
     if (m_timewarpProducers.count(clipId) > 0) {
         // remove in all cases, we add it unconditionally anyways
@@ -1230,6 +1307,13 @@ std::pair<std::shared_ptr<Mlt::Producer>, bool> ProjectClip::giveMasterAndGetTim
                 return {std::shared_ptr<Mlt::Producer>(m_disabledProducer->cut(in, out)), false};
             }
             // We have a good id, this clip can be used
+            for (bool audio : {true, false}) {
+                for (const auto &p : audio ? m_audioProducers : m_videoProducers) {
+                    if (p.second->get_producer() == master->parent().get_producer()) {
+                        useTrackProducer(clipId, audio, p.first);
+                    }
+                }
+            }
             return {master, true};
         } else {
             master->parent().set("_loaded", 1);
@@ -1266,6 +1350,7 @@ std::pair<std::shared_ptr<Mlt::Producer>, bool> ProjectClip::giveMasterAndGetTim
                 }
                 m_audioProducers[tid] = std::make_shared<Mlt::Producer>(&master->parent());
                 m_effectStack->loadService(m_audioProducers.at(tid));
+                useTrackProducer(clipId, true, tid);
                 return {master, true};
             }
             if (state == PlaylistState::VideoOnly) {
@@ -1284,6 +1369,7 @@ std::pair<std::shared_ptr<Mlt::Producer>, bool> ProjectClip::giveMasterAndGetTim
                     }
                     m_videoProducers[tid] = std::make_shared<Mlt::Producer>(&master->parent());
                     m_effectStack->loadService(m_videoProducers.at(tid));
+                    useTrackProducer(clipId, false, tid);
                 } else {
                     // Ensure clip out = length - 1 so that effects work correctly
                     if (out != master->parent().get_length() - 1) {
@@ -1474,6 +1560,59 @@ std::shared_ptr<Mlt::Producer> ProjectClip::cloneProducer(bool removeEffects, bo
     return prod;
 }
 
+int ProjectClip::missingTimelineProducers(int trackId) const
+{
+    if (!m_masterProducer || m_clipType == ClipType::Timeline) {
+        return 0;
+    }
+    int count = 0;
+    if (hasVideo() && m_videoProducers.count(trackId) == 0 && m_clipType != ClipType::Color && m_clipType != ClipType::Image &&
+        m_clipType != ClipType::Text && m_clipType != ClipType::TextTemplate && m_clipType != ClipType::Qml) {
+        count++;
+    }
+    if (hasAudio() && m_audioProducers.empty()) {
+        // The audio track is not known yet, only prepare the first audio producer
+        count++;
+    }
+    return count;
+}
+
+void ProjectClip::prepareTimelineProducers(int count)
+{
+    for (int i = 0; i < count; i++) {
+        QMutexLocker lk(&m_producerMutex);
+        const int generation = m_preparedGeneration;
+        lk.unlock();
+        // Cloning is slow, do not block the clip while it runs
+        std::shared_ptr<Mlt::Producer> prod = cloneProducer(true, true);
+        lk.relock();
+        if (generation != m_preparedGeneration) {
+            // The clip was reloaded or the preparation discarded meanwhile, this clone is outdated
+            return;
+        }
+        m_preparedProducers.push_back(prod);
+    }
+}
+
+void ProjectClip::discardPreparedProducers()
+{
+    QMutexLocker lk(&m_producerMutex);
+    m_preparedGeneration++;
+    m_preparedProducers.clear();
+}
+
+std::shared_ptr<Mlt::Producer> ProjectClip::takePreparedProducer()
+{
+    QMutexLocker lk(&m_producerMutex);
+    if (m_preparedProducers.empty()) {
+        lk.unlock();
+        return cloneProducer(true, true);
+    }
+    std::shared_ptr<Mlt::Producer> prod = m_preparedProducers.back();
+    m_preparedProducers.pop_back();
+    return prod;
+}
+
 std::shared_ptr<Mlt::Producer> ProjectClip::cloneProducer(const std::shared_ptr<Mlt::Producer> &producer)
 {
     QReadLocker xmlLock(&pCore->xmlMutex);
@@ -2230,6 +2369,8 @@ void ProjectClip::registerService(std::weak_ptr<TimelineModel> timeline, int cli
 void ProjectClip::registerTimelineClip(std::weak_ptr<TimelineModel> timeline, int clipId)
 {
     Q_ASSERT(!timeline.expired());
+    // Timeline clips need the thumbnails and audio levels
+    ensureLoaded();
     uint currentCount = 0;
     if (auto ptr = timeline.lock()) {
         if (m_hasAudio) {
@@ -2238,24 +2379,12 @@ void ProjectClip::registerTimelineClip(std::weak_ptr<TimelineModel> timeline, in
             }
         }
         const QUuid uuid = ptr->uuid();
-        if (m_registeredClipsByUuid.contains(uuid)) {
-            QList<int> values = m_registeredClipsByUuid.value(uuid);
-            Q_ASSERT(values.contains(clipId) == false);
-            values << clipId;
-            currentCount = values.size();
-            m_registeredClipsByUuid[uuid] = values;
-        } else {
-            m_registeredClipsByUuid.insert(uuid, {clipId});
-            currentCount = 1;
-        }
+        bool inserted = m_registeredClipsByUuid.insert(uuid, clipId);
+        Q_ASSERT(inserted);
+        Q_UNUSED(inserted)
+        currentCount = uint(m_registeredClipsByUuid.count(uuid));
     }
-    uint totalCount = 0;
-    QMapIterator<QUuid, QList<int>> i(m_registeredClipsByUuid);
-    while (i.hasNext()) {
-        i.next();
-        totalCount += i.value().size();
-    }
-    setRefCount(currentCount, totalCount);
+    setRefCount(currentCount, uint(m_registeredClipsByUuid.totalCount()));
     Q_EMIT registeredClipChanged();
 }
 
@@ -2267,28 +2396,20 @@ void ProjectClip::checkClipBounds()
 void ProjectClip::refreshBounds()
 {
     QVector<QPoint> boundaries;
-    uint currentCount = 0;
-    int lastUsedPos = 0;
     const QUuid uuid = pCore->currentTimelineId();
-    if (m_registeredClipsByUuid.contains(uuid)) {
-        const QList<int> clips = m_registeredClipsByUuid.value(uuid);
-        currentCount = clips.size();
+    uint currentCount = 0;
+    auto instances = m_registeredClipsByUuid.find(uuid);
+    if (instances != m_registeredClipsByUuid.end()) {
+        currentCount = uint(instances->second.size());
         auto timeline = pCore->currentDoc()->getTimeline(uuid);
-        for (auto &c : clips) {
-            QPoint point = timeline->getClipInDuration(c);
-            if (!boundaries.contains(point)) {
-                boundaries << point;
-                lastUsedPos = qMax(lastUsedPos, point.x() + point.y());
-            }
+        boundaries.reserve(int(currentCount));
+        for (int c : instances->second) {
+            boundaries << timeline->getClipInDuration(c);
         }
+        // Sort and merge overlapping ranges so that the monitor ruler only draws each used zone once
+        boundaries = ClipInstanceIndex::mergeBounds(boundaries);
     }
-    uint totalCount = 0;
-    QMapIterator<QUuid, QList<int>> i(m_registeredClipsByUuid);
-    while (i.hasNext()) {
-        i.next();
-        totalCount += i.value().size();
-    }
-    setRefCount(currentCount, totalCount);
+    setRefCount(currentCount, uint(m_registeredClipsByUuid.totalCount()));
     Q_EMIT boundsChanged(boundaries);
 }
 
@@ -2305,27 +2426,13 @@ void ProjectClip::deregisterTimelineClip(int clipId, bool audioClip, const QUuid
         m_effectStack->removeService(m_audioProducers[clipId]);
         m_audioProducers.erase(clipId);
     }
+    releaseTrackProducer(clipId);
     // Clip might already have been deregistered
     if (m_registeredClipsByUuid.contains(uuid)) {
-        QList<int> clips = m_registeredClipsByUuid.value(uuid);
-        Q_ASSERT(clips.contains(clipId));
-        clips.removeAll(clipId);
-        if (clips.isEmpty()) {
-            m_registeredClipsByUuid.remove(uuid);
-        } else {
-            m_registeredClipsByUuid[uuid] = clips;
-        }
-        uint currentCount = 0;
-        uint totalCount = 0;
-        QMapIterator<QUuid, QList<int>> i(m_registeredClipsByUuid);
-        while (i.hasNext()) {
-            i.next();
-            totalCount += i.value().size();
-            if (i.key() == pCore->currentTimelineId()) {
-                currentCount = uint(i.value().size());
-            }
-        }
-        setRefCount(currentCount, totalCount);
+        bool removed = m_registeredClipsByUuid.remove(uuid, clipId);
+        Q_ASSERT(removed);
+        Q_UNUSED(removed)
+        setRefCount(uint(m_registeredClipsByUuid.count(pCore->currentTimelineId())), uint(m_registeredClipsByUuid.totalCount()));
         Q_EMIT registeredClipChanged();
     }
 }
@@ -2335,15 +2442,12 @@ QList<int> ProjectClip::timelineInstances(QUuid activeUuid) const
     if (activeUuid.isNull()) {
         activeUuid = pCore->currentTimelineId();
     }
-    if (!m_registeredClipsByUuid.contains(activeUuid)) {
-        return {};
-    }
-    return m_registeredClipsByUuid.value(activeUuid);
+    return m_registeredClipsByUuid.instances(activeUuid);
 }
 
 QMap<QUuid, QList<int>> ProjectClip::getAllTimelineInstances() const
 {
-    return m_registeredClipsByUuid;
+    return m_registeredClipsByUuid.toMap();
 }
 
 QStringList ProjectClip::timelineSequenceExtraResources() const
@@ -2361,7 +2465,7 @@ QStringList ProjectClip::timelineSequenceExtraResources() const
 
 const QString ProjectClip::isReferenced(const QUuid &activeUuid) const
 {
-    if (m_registeredClipsByUuid.contains(activeUuid) && !m_registeredClipsByUuid.value(activeUuid).isEmpty()) {
+    if (m_registeredClipsByUuid.count(activeUuid) > 0) {
         return m_binId;
     }
     return QString();
@@ -2372,30 +2476,17 @@ void ProjectClip::purgeReferences(const QUuid &activeUuid, bool deleteClip)
     if (!m_registeredClipsByUuid.contains(activeUuid)) {
         return;
     }
-    if (deleteClip) {
-        QList<int> toDelete = m_registeredClipsByUuid.value(activeUuid);
+    if (deleteClip && m_hasAudio) {
+        const QList<int> toDelete = m_registeredClipsByUuid.instances(activeUuid);
         auto timeline = pCore->currentDoc()->getTimeline(activeUuid);
-        while (!toDelete.isEmpty()) {
-            int id = toDelete.takeFirst();
-            if (m_hasAudio) {
-                if (timeline->getClipState(id).first == PlaylistState::AudioOnly) {
-                    m_AudioUsage--;
-                }
+        for (int id : toDelete) {
+            if (timeline->getClipState(id).first == PlaylistState::AudioOnly) {
+                m_AudioUsage--;
             }
         }
     }
-    m_registeredClipsByUuid.remove(activeUuid);
-    uint currentCount = 0;
-    uint totalCount = 0;
-    QMapIterator<QUuid, QList<int>> i(m_registeredClipsByUuid);
-    while (i.hasNext()) {
-        i.next();
-        totalCount += i.value().size();
-        if (i.key() == pCore->currentTimelineId()) {
-            currentCount = uint(i.value().size());
-        }
-    }
-    setRefCount(currentCount, totalCount);
+    m_registeredClipsByUuid.removeTimeline(activeUuid);
+    setRefCount(uint(m_registeredClipsByUuid.count(pCore->currentTimelineId())), uint(m_registeredClipsByUuid.totalCount()));
     Q_EMIT registeredClipChanged();
 }
 
@@ -2407,12 +2498,13 @@ bool ProjectClip::selfSoftDelete(Fun &undo, Fun &redo)
         m_disabledProducer.reset();
         m_audioProducers.clear();
         m_videoProducers.clear();
+        pCore->projectItemModel()->producerPool().removeBinClip(m_binId);
         removeSequenceWarpResources();
         m_timewarpProducers.clear();
         return true;
     };
     operation();
-    QMapIterator<QUuid, QList<int>> i(m_registeredClipsByUuid);
+    QMapIterator<QUuid, QList<int>> i(m_registeredClipsByUuid.toMap());
     while (i.hasNext()) {
         i.next();
         const QUuid uuid = i.key();
@@ -2519,6 +2611,7 @@ void ProjectClip::reloadTimeline(std::shared_ptr<EffectStackModel> stack)
     // Release audio producers
     m_audioProducers.clear();
     m_videoProducers.clear();
+    pCore->projectItemModel()->producerPool().removeBinClip(m_binId);
     removeSequenceWarpResources();
     m_timewarpProducers.clear();
     Q_EMIT refreshPropertiesPanel();
@@ -2552,7 +2645,7 @@ void ProjectClip::replaceInTimeline()
     Fun undo = []() { return true; };
     Fun redo = []() { return true; };
     bool pushUndo = false;
-    QMapIterator<QUuid, QList<int>> i(m_registeredClipsByUuid);
+    QMapIterator<QUuid, QList<int>> i(m_registeredClipsByUuid.toMap());
     QMap<QUuid, std::pair<int, int>> sequencesToUpdate;
     while (i.hasNext()) {
         i.next();
@@ -2598,7 +2691,7 @@ void ProjectClip::limitMaxDuration(int maxDuration)
     Fun undo = []() { return true; };
     Fun redo = []() { return true; };
     bool pushUndo = false;
-    QMapIterator<QUuid, QList<int>> i(m_registeredClipsByUuid);
+    QMapIterator<QUuid, QList<int>> i(m_registeredClipsByUuid.toMap());
     QMap<QUuid, std::pair<int, int>> sequencesToUpdate;
     while (i.hasNext()) {
         i.next();
@@ -2630,12 +2723,10 @@ int ProjectClip::lastBound()
 }
 void ProjectClip::updateTimelineClips(const QVector<int> &roles)
 {
-    QMapIterator<QUuid, QList<int>> i(m_registeredClipsByUuid);
-    while (i.hasNext()) {
-        i.next();
-        QList<int> instances = i.value();
-        if (!instances.isEmpty()) {
-            auto timeline = pCore->currentDoc()->getTimeline(i.key());
+    for (const auto &entry : m_registeredClipsByUuid) {
+        const ClipInstanceIndex::Instances &instances = entry.second;
+        if (!instances.empty()) {
+            auto timeline = pCore->currentDoc()->getTimeline(entry.first);
             if (!timeline) {
                 if (pCore->projectItemModel()->closing) {
                     return;
@@ -2960,7 +3051,7 @@ void ProjectClip::updateTimelineOnReload()
 {
     const QUuid uuid = pCore->currentTimelineId();
     if (m_registeredClipsByUuid.contains(uuid)) {
-        QList<int> instances = m_registeredClipsByUuid.value(uuid);
+        QList<int> instances = m_registeredClipsByUuid.instances(uuid);
         if (!instances.isEmpty() && instances.size() < 3) {
             auto timeline = pCore->currentDoc()->getTimeline(uuid);
             if (timeline) {
@@ -3041,7 +3132,7 @@ bool ProjectClip::canBeDropped(const QUuid &) const
 
 const QList<QUuid> ProjectClip::registeredUuids() const
 {
-    return m_registeredClipsByUuid.keys();
+    return m_registeredClipsByUuid.timelines();
 }
 
 const QUuid ProjectClip::getSequenceUuid() const
@@ -3101,6 +3192,11 @@ const QString ProjectClip::getSequenceResource()
 
 void ProjectClip::removeSequenceWarpResources() {}
 
+std::shared_ptr<Mlt::Producer> ProjectClip::sequenceVideoProducer(int maxDuration)
+{
+    return std::shared_ptr<Mlt::Producer>(m_masterProducer->cut(0, maxDuration));
+}
+
 std::pair<int, int> ProjectClip::fpsInfo() const
 {
     if (m_clipStatus == FileStatus::StatusReady) {
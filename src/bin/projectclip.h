@@ -9,6 +9,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #pragma once
 
 #include "abstractprojectitem.h"
+#include "clipinstanceindex.h"
 #include "definitions.h"
 #include "mltcontroller/clipcontroller.h"
 #include "timeline2/model/timelinemodel.hpp"
@@ -19,7 +20,9 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QTemporaryFile>
 #include <QTimer>
 #include <QUuid>
+#include <atomic>
 #include <memory>
+#include <vector>
 
 class ClipPropertiesController;
 class ProjectFolder;
@@ -233,6 +236,16 @@ public:
                                                                                      PlaylistState::ClipState state, int tid, bool secondPlaylist = false);
 
     std::shared_ptr<Mlt::Producer> cloneProducer(bool removeEffects = false, bool timelineProducer = false);
+    /** @brief Returns the number of track producers that would be created by inserting this clip in the given track */
+    int missingTimelineProducers(int trackId) const;
+    /** @brief Clone in advance the track producers used by the next timeline insertions, can be called from a worker thread */
+    void prepareTimelineProducers(int count);
+    /** @brief Release the prepared track producers that were not used */
+    void discardPreparedProducers();
+    /** @brief Free a track producer without user, unless clips kept by the undo stack still reference it.
+     *  @returns true if the producer does not exist anymore
+     */
+    bool releaseIdleProducer(const ProducerPool::Key &key);
     void cloneProducerToFile(const QString &path, bool thumbsProducer = false);
     static std::shared_ptr<Mlt::Producer> cloneProducer(const std::shared_ptr<Mlt::Producer> &producer);
     std::unique_ptr<Mlt::Producer> softClone(const char *list);
@@ -282,6 +295,10 @@ public:
     void copyTimeWarpProducers(const QDir sequenceFolder, bool copy);
     /** @brief Refresh zones of insertion in timeline. */
     void refreshBounds();
+    /** @brief Start the thumbnail and audio levels generation if it was deferred when opening the project. */
+    void ensureLoaded();
+    /** @brief Returns true if the thumbnail and audio levels generation is waiting for the clip to be displayed or used. */
+    bool isLoadDeferred() const;
     /** @brief Returns a list of important enforced parameters in MLT format, for example to disable autorotate. */
     const QStringList enforcedParams() const;
     /** @brief Remove clip references in a timeline. */
@@ -324,12 +341,15 @@ protected:
     std::unordered_map<int, std::shared_ptr<Mlt::Producer>> m_videoProducers;
     std::unordered_map<int, std::shared_ptr<Mlt::Producer>> m_timewarpProducers;
     std::shared_ptr<Mlt::Producer> m_disabledProducer;
-    QMap<QUuid, QList<int>> m_registeredClipsByUuid;
+    /** @brief The timeline clips using this bin clip, by timeline uuid */
+    ClipInstanceIndex m_registeredClipsByUuid;
 
     /** @brief This is a helper function that creates the disabled producer. This is a clone of the original one, with audio and video disabled */
     virtual void createDisabledMasterProducer();
     virtual const QString getSequenceResource();
     virtual void removeSequenceWarpResources();
+    /** @brief Returns the video producer used for the instances of a sequence clip in other timelines */
+    virtual std::shared_ptr<Mlt::Producer> sequenceVideoProducer(int maxDuration);
     /** @brief Generate and store file hash if not available. */
     virtual const QString getFileHash();
     /** @brief This is a call-back called by a ClipModel when it is created
@@ -413,11 +433,19 @@ private Q_SLOTS:
 
 private:
     QMutex m_producerMutex;
+    /** @brief Track producers cloned in advance for a bulk insertion, protected by m_producerMutex */
+    std::vector<std::shared_ptr<Mlt::Producer>> m_preparedProducers;
+    /** @brief Increased each time the prepared producers are discarded, so that a clone started before is not kept */
+    int m_preparedGeneration{0};
+    /** @brief Returns a prepared track producer, or a new clone if none is available */
+    std::shared_ptr<Mlt::Producer> takePreparedProducer();
     QByteArray m_thumbXml;
     const QString geometryWithOffset(const QString &data, int offset);
     QVector<MaskInfo> m_masks;
     /** @brief If true, all timeline occurrences of this clip will be replaced from a fresh producer on reload. */
     bool m_resetTimelineOccurences;
+    /** @brief True if the thumbnail and audio levels jobs have not been started yet, see lazybinloading */
+    std::atomic_bool m_deferredLoading{false};
     QTimer m_boundaryTimer;
 
     // A temporary uuid used to reset thumbnails on producer change
@@ -426,6 +454,12 @@ private:
     void updateDescription();
     /** @brief Load masks data from clip properties. */
     void loadMasks(const QString &maskData);
+    /** @brief Start the thumbnail and audio levels jobs of a clip loaded from the project file. */
+    void startLoadingJobs();
+    /** @brief Register a timeline clip as user of the producer of a track, see ProducerPool. */
+    void useTrackProducer(int clipId, bool audio, int trackKey);
+    /** @brief Unregister a timeline clip from its track producer, releasing the producer if it has no more user. */
+    void releaseTrackProducer(int clipId);
 
 Q_SIGNALS:
     void producerChanged(const QString &, Mlt::Producer prod);
@@ -19,6 +19,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "kdenlivesettings.h"
 #include "lib/localeHandling.h"
 #include "macros.hpp"
+#include "model/markerlistmodel.hpp"
 #include "playlistclip.h"
 #include "playlistsubclip.h"
 #include "profiles/profilemodel.hpp"
@@ -27,6 +28,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "projectfolder.h"
 #include "projectsubclip.h"
 #include "sequenceclip.h"
+#include "sequenceprerender.h"
 #include "utils/thumbnailcache.hpp"
 #include "xml/xml.hpp"
 
@@ -205,6 +207,7 @@ bool ProjectItemModel::setData(const QModelIndex &index, const QVariant &value,
     QWriteLocker locker(&m_lock);
     std::shared_ptr<AbstractProjectItem> item = getBinItemByIndex(index);
     if (item->rename(value.toString(), index.column())) {
+        updateSearchIndex(item);
         Q_EMIT dataChanged(index, index, {role});
         return true;
     }
@@ -454,6 +457,11 @@ QMimeData *ProjectItemModel::mimeData(const QModelIndexList &indices) const
 
 void ProjectItemModel::onItemUpdated(const std::shared_ptr<AbstractProjectItem> &item, const QVector<int> &roles)
 {
+    if (roles.contains(AbstractProjectItem::DataName) || roles.contains(AbstractProjectItem::DataDescription) ||
+        roles.contains(AbstractProjectItem::DataTag)) {
+        QWriteLocker locker(&m_lock);
+        updateSearchIndex(item);
+    }
     int minColumn = -1;
     int maxColumn = -1;
     for (auto &r : roles) {
@@ -635,6 +643,7 @@ void ProjectItemModel::clean(bool quit)
     }
     toDelete.clear();
     Q_ASSERT(rootItem->childCount() == 0);
+    m_producerPool.clear();
     closing = false;
     if (!quit) {
         m_nextId = 1;
@@ -828,9 +837,18 @@ void ProjectItemModel::registerItem(const std::shared_ptr<TreeItem> &item)
     Q_ASSERT(m_binPlaylist != nullptr);
     m_binPlaylist->manageBinItemInsertion(clip);
     m_allIds.append(clip->clipId().toInt());
+    updateSearchIndex(clip);
     if (clip->itemType() == AbstractProjectItem::ClipItem) {
         auto clipItem = std::static_pointer_cast<ProjectClip>(clip);
         m_allClipItems[clip->clipId().toInt()] = clipItem;
+        const QString binId = clip->clipId();
+        m_markerConnections.insert(item->getId(), connect(clipItem->getMarkerModel().get(), &MarkerListModel::modelChanged, this, [this, binId]() {
+                                       QWriteLocker locker(&m_lock);
+                                       auto binClip = getClipByBinID(binId);
+                                       if (binClip) {
+                                           updateSearchIndex(binClip);
+                                       }
+                                   }));
         updateWatcher(clipItem);
         if (clipItem->clipType() == ClipType::Timeline && clipItem->statusReady()) {
             const QString uuid = clipItem->getSequenceUuid().toString();
@@ -848,6 +866,12 @@ void ProjectItemModel::deregisterItem(int id, TreeItem *item)
     m_allIds.removeAll(clip->clipId().toInt());
     m_allClipItems.erase(clip->clipId().toInt());
     m_binPlaylist->manageBinItemDeletion(clip);
+    m_searchIndex.removeItem(clip->clipId());
+    auto connection = m_markerConnections.find(id);
+    if (connection != m_markerConnections.end()) {
+        disconnect(connection.value());
+        m_markerConnections.erase(connection);
+    }
     // TODO : here, we should suspend jobs belonging to the item we delete. They can be restarted if the item is reinserted by undo
     AbstractTreeModel::deregisterItem(id, item);
     if (clip->itemType() == AbstractProjectItem::ClipItem) {
@@ -1744,10 +1768,12 @@ const std::pair<QString, QString> ProjectItemModel::sceneList(const QString &roo
     if (filter) {
         s.detach(*filter.get());
     }
+    // Pre-rendered nested sequences are only used for playback
     if (aspectRatio.isEmpty()) {
-        playlist = QString::fromUtf8(xmlConsumer.get("kdenlive_playlist"));
+        playlist = SequencePreRender::restoreSequences(QString::fromUtf8(xmlConsumer.get("kdenlive_playlist")));
         return {playlist, QString()};
     }
+    SequencePreRender::restoreSequencesInFile(tempFile.fileName());
 
     double targetAspectRatio = 16.0 / 9.0; // default to horizontal (16:9)
     if (aspectRatio == "vertical") {
@@ -2069,3 +2095,66 @@ const QString ProjectItemModel::getBinClipIdByUuid(const QString uuid)
     }
     return QString();
 }
+
+void ProjectItemModel::updateSearchIndex(const std::shared_ptr<AbstractProjectItem> &item)
+{
+    const QString binId = item->clipId();
+    m_searchIndex.setText(binId, BinSearchIndex::Name, item->name());
+    m_searchIndex.setText(binId, BinSearchIndex::Description, item->description());
+    m_searchIndex.setText(binId, BinSearchIndex::Tags, item->tags());
+    if (item->itemType() == AbstractProjectItem::ClipItem) {
+        auto markerModel = std::static_pointer_cast<ProjectClip>(item)->getMarkerModel();
+        QStringList comments;
+        if (markerModel) {
+            const QList<CommentedTime> markers = markerModel->getAllMarkers();
+            for (const CommentedTime &marker : markers) {
+                comments << marker.comment();
+            }
+        }
+        m_searchIndex.setText(binId, BinSearchIndex::Markers, comments.join(QLatin1Char(' ')));
+    }
+}
+
+QSet<QString> ProjectItemModel::searchItems(const QString &text, QSet<QString> *parents)
+{
+    READ_LOCK();
+    const QSet<QString> matches = m_searchIndex.search(text);
+    if (parents != nullptr) {
+        parents->clear();
+        for (const QString &binId : matches) {
+            std::shared_ptr<AbstractProjectItem> item = getItemByBinId(binId);
+            if (!item) {
+                continue;
+            }
+            auto parent = std::static_pointer_cast<AbstractProjectItem>(item->parentItem().lock());
+            // Stop at the root folder, or when reaching a branch that was already walked
+            while (parent && parent->clipId() != QLatin1String("-1") && !parents->contains(parent->clipId())) {
+                parents->insert(parent->clipId());
+                parent = std::static_pointer_cast<AbstractProjectItem>(parent->parentItem().lock());
+            }
+        }
+    }
+    return matches;
+}
+
+int ProjectItemModel::searchRevision() const
+{
+    READ_LOCK();
+    return m_searchIndex.revision();
+}
+
+ProducerPool &ProjectItemModel::producerPool()
+{
+    return m_producerPool;
+}
+
+void ProjectItemModel::releaseIdleProducers()
+{
+    const QList<ProducerPool::Key> idle = m_producerPool.idleProducers();
+    for (const ProducerPool::Key &key : idle) {
+        std::shared_ptr<ProjectClip> clip = getClipByBinID(key.binId);
+        if (!clip || clip->releaseIdleProducer(key)) {
+            m_producerPool.forgetIdle(key);
+        }
+    }
+}
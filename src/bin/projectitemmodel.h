@@ -11,6 +11,8 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #include "abstractmodel/abstracttreemodel.hpp"
 #include "bin/abstractprojectitem.h"
+#include "bin/binsearchindex.h"
+#include "bin/producerpool.h"
 #include "definitions.h"
 #include "undohelper.hpp"
 #include <QDomElement>
@@ -275,6 +277,16 @@ public:
     /** @brief Get the unique and unmutable uuid for this project clip */
     const QString getBinClipUuid(const QString &binId) const;
     const QString getBinClipIdByUuid(const QString uuid);
+    /** @brief Returns the ids of the bin items having, for each word of text, a word starting with it in their name, description, tags or marker comments
+     *  @param parents if not null, filled with the ids of the folders and clips containing a matching item
+     */
+    QSet<QString> searchItems(const QString &text, QSet<QString> *parents = nullptr);
+    /** @brief Changes each time the search index is modified, including when items are moved */
+    int searchRevision() const;
+    /** @brief The reference counting of the track producers of all bin clips */
+    ProducerPool &producerPool();
+    /** @brief Free the idle track producers that are not referenced by the undo stack anymore */
+    void releaseIdleProducers();
 
 protected:
     bool closing;
@@ -319,6 +331,13 @@ private:
     mutable QReadWriteLock m_lock; // This is a lock that ensures safety in case of concurrent access
 
     std::unique_ptr<BinPlaylist> m_binPlaylist;
+    /** @brief Words of the bin items, used by the bin search */
+    BinSearchIndex m_searchIndex;
+    ProducerPool m_producerPool;
+    /** @brief Connections to the marker models of the registered clips, by item id */
+    QHash<int, QMetaObject::Connection> m_markerConnections;
+    /** @brief Refresh all the indexed fields of an item */
+    void updateSearchIndex(const std::shared_ptr<AbstractProjectItem> &item);
 
     std::unique_ptr<FileWatcher> m_fileWatcher;
     std::unordered_map<QString, std::shared_ptr<Mlt::Tractor>> m_extraPlaylists;
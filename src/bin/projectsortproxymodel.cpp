@@ -7,6 +7,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #include "projectsortproxymodel.h"
 #include "abstractprojectitem.h"
+#include "projectitemmodel.h"
 
 #include <QItemSelectionModel>
 
@@ -82,9 +83,13 @@ bool ProjectSortProxyModel::filterAcceptsRowItself(int sourceRow, const QModelIn
         result = true;
     }
 
-    if (result && m_searchString.isEmpty()) {
+    if (m_searchString.isEmpty()) {
         return true;
     }
+    if (updateSearchMatches()) {
+        const QModelIndex index0 = sourceModel()->index(sourceRow, 0, sourceParent);
+        return index0.isValid() && m_searchMatches.contains(sourceModel()->data(index0, AbstractProjectItem::DataId).toString());
+    }
     for (int i = 0; i < 3; i++) {
         QModelIndex index0 = sourceModel()->index(sourceRow, i, sourceParent);
         if (!index0.isValid()) {
@@ -105,6 +110,10 @@ bool ProjectSortProxyModel::hasAcceptedChildren(int sourceRow, const QModelIndex
     if (!item.isValid()) {
         return false;
     }
+    if (hasSearchStringOnly() && updateSearchMatches()) {
+        // The index already knows which items contain a match, no need to walk the children
+        return m_searchParents.contains(sourceModel()->data(item, AbstractProjectItem::DataId).toString());
+    }
 
     // check if there are children
     int childCount = item.model()->rowCount(item);
@@ -164,9 +173,29 @@ QItemSelectionModel *ProjectSortProxyModel::selectionModel()
 void ProjectSortProxyModel::slotSetSearchString(const QString &str)
 {
     m_searchString = str;
+    m_searchRevision = -1;
     invalidateFilter();
 }
 
+bool ProjectSortProxyModel::updateSearchMatches() const
+{
+    auto *model = qobject_cast<ProjectItemModel *>(sourceModel());
+    if (model == nullptr) {
+        return false;
+    }
+    const int revision = model->searchRevision();
+    if (revision != m_searchRevision) {
+        m_searchMatches = model->searchItems(m_searchString, &m_searchParents);
+        m_searchRevision = revision;
+    }
+    return true;
+}
+
+bool ProjectSortProxyModel::hasSearchStringOnly() const
+{
+    return !m_searchString.isEmpty() && m_searchTag.isEmpty() && m_searchRating.isEmpty() && m_searchType.isEmpty() && m_usageFilter == UsageFilter::All;
+}
+
 void ProjectSortProxyModel::slotSetFilters(const QStringList &tagFilters, const QList<int> rateFilters, const QList<int> typeFilters, UsageFilter unusedFilter)
 {
     m_searchType = typeFilters;
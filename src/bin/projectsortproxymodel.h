@@ -8,6 +8,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #pragma once
 
 #include <QCollator>
+#include <QSet>
 #include <QSortFilterProxyModel>
 
 class QItemSelectionModel;
@@ -59,6 +60,17 @@ private:
     QList<int> m_searchRating;
     UsageFilter m_usageFilter{UsageFilter::All};
     QCollator m_collator;
+    /** @brief Ids of the items matching the search string, from the bin search index */
+    mutable QSet<QString> m_searchMatches;
+    /** @brief Ids of the folders and clips containing an item matching the search string */
+    mutable QSet<QString> m_searchParents;
+    /** @brief Revision of the search index used to compute the matches, -1 if they need to be computed */
+    mutable int m_searchRevision{-1};
+    /** @brief Query the bin search index if the search string or the index changed.
+     *  @returns false if the source model has no search index */
+    bool updateSearchMatches() const;
+    /** @brief Returns true if only the search string is used to filter */
+    bool hasSearchStringOnly() const;
 
 Q_SIGNALS:
     /** @brief Emitted when the row changes, used to prepare action for selected item  */
@@ -46,7 +46,21 @@ ProjectSubClip::ProjectSubClip(const QString &id, const std::shared_ptr<ProjectC
     m_tags = zoneProperties.value(QLatin1String("tags"));
     qDebug() << "=== LOADING SUBCLIP WITH RATING: " << m_rating << ", TAGS: " << m_tags;
     m_clipStatus = FileStatus::StatusReady;
-    ClipLoadTask::start(ObjectId(KdenliveObjectType::BinClip, m_parentClipId.toInt(), QUuid()), QDomElement(), true, in, out, this);
+    if (parent->isLoadDeferred()) {
+        // The parent clip thumbnails are not generated yet, wait until this zone is displayed
+        m_deferredThumbnail = true;
+    } else {
+        ClipLoadTask::start(ObjectId(KdenliveObjectType::BinClip, m_parentClipId.toInt(), QUuid()), QDomElement(), true, in, out, this);
+    }
+}
+
+void ProjectSubClip::ensureLoaded()
+{
+    if (!m_deferredThumbnail.exchange(false)) {
+        return;
+    }
+    m_masterClip->ensureLoaded();
+    ClipLoadTask::start(ObjectId(KdenliveObjectType::BinClip, m_parentClipId.toInt(), QUuid()), QDomElement(), true, m_inPoint, m_outPoint, this);
 }
 
 std::shared_ptr<ProjectSubClip> ProjectSubClip::construct(const QString &id, const std::shared_ptr<ProjectClip> &parent,
@@ -9,6 +9,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #include "abstractprojectitem.h"
 #include "definitions.h"
+#include <atomic>
 #include <memory>
 
 class ProjectFolder;
@@ -78,9 +79,13 @@ public:
     /** @brief Set rating on item */
     void setRating(uint rating) override;
 
+    /** @brief Start the thumbnail generation if it was deferred until the zone is displayed. */
+    void ensureLoaded();
+
 private:
     std::shared_ptr<ProjectClip> m_masterClip;
     QString m_parentClipId;
+    std::atomic_bool m_deferredThumbnail{false};
 
 private Q_SLOTS:
     void gotThumb(int pos, const QImage &img);
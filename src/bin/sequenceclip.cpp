@@ -28,6 +28,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "projectfolder.h"
 #include "projectitemmodel.h"
 #include "projectsubclip.h"
+#include "sequenceprerender.h"
 #include "timeline2/model/snapmodel.hpp"
 #include "utils/thumbnailcache.hpp"
 #include "utils/timecode.h"
@@ -94,6 +95,7 @@ SequenceClip::SequenceClip(const QString &id, const QIcon &thumb, const std::sha
         }
     }
     m_sequenceThumbFile.setFileTemplate(QDir::temp().absoluteFilePath(QStringLiteral("thumbs-%1-XXXXXX.mlt").arg(m_binId)));
+    createPreRender();
     // Timeline clip thumbs will be generated later after the tractor has been updated
     qDebug() << "555555555555555555\n\nBUILDING SEQUENCE CLIP\n\n555555555555555555555555555";
 }
@@ -113,6 +115,14 @@ SequenceClip::SequenceClip(const QString &id, const QDomElement &description, co
     : ProjectClip(id, description, thumb, model)
 {
     m_sequenceUuid = QUuid(getXmlProperty(description, QStringLiteral("kdenlive:uuid")));
+    createPreRender();
+}
+
+void SequenceClip::createPreRender()
+{
+    m_preRender = std::make_unique<SequencePreRender>(m_sequenceUuid);
+    // Switch the instances in other timelines to the intermediate
+    connect(m_preRender.get(), &SequencePreRender::intermediateChanged, this, [this]() { reloadTimeline(); });
 }
 
 std::shared_ptr<SequenceClip> SequenceClip::construct(const QString &id, const QDomElement &description, const QIcon &thumb,
@@ -150,6 +160,7 @@ bool SequenceClip::setProducer(std::shared_ptr<Mlt::Producer> producer, bool gen
     if (m_sequenceUuid.isNull()) {
         m_sequenceUuid = QUuid::createUuid();
         producer->parent().set("kdenlive:uuid", m_sequenceUuid.toString().toUtf8().constData());
+        createPreRender();
     }
     if (m_timewarpProducers.size() > 0) {
         bool ok;
@@ -302,13 +313,11 @@ int SequenceClip::lastBound()
     if (m_registeredClipsByUuid.isEmpty()) {
         return pCore->currentDoc()->getSequenceProperty(m_sequenceUuid, QStringLiteral("lastUsedFrame")).toInt();
     }
-    QMapIterator<QUuid, QList<int>> i(m_registeredClipsByUuid);
     int lastUsedFrame = 0;
-    while (i.hasNext()) {
-        i.next();
-        QList<int> instances = i.value();
-        if (!instances.isEmpty()) {
-            auto timeline = pCore->currentDoc()->getTimeline(i.key());
+    for (const auto &entry : m_registeredClipsByUuid) {
+        const ClipInstanceIndex::Instances &instances = entry.second;
+        if (!instances.empty()) {
+            auto timeline = pCore->currentDoc()->getTimeline(entry.first);
             if (!timeline) {
                 qDebug() << "Error while reloading clip: timeline unavailable";
                 Q_ASSERT(false);
@@ -322,6 +331,37 @@ int SequenceClip::lastBound()
     return lastUsedFrame;
 }
 
+std::shared_ptr<Mlt::Producer> SequenceClip::sequenceVideoProducer(int maxDuration)
+{
+    if (KdenliveSettings::nestedprerender()) {
+        const QString &intermediate = m_preRender->intermediate();
+        if (!intermediate.isEmpty()) {
+            Mlt::Producer prod(pCore->getProjectProfile(), "xml", intermediate.toUtf8().constData());
+            if (prod.is_valid() && prod.get_playtime() >= maxDuration) {
+                // Timeline operations identify the bin clip from the producer
+                prod.set("kdenlive:id", m_binId.toUtf8().constData());
+                prod.set("kdenlive:control_uuid", m_controlUuid.toString().toUtf8().constData());
+                // The intermediate is only played, scene lists reference the sequence instead
+                QString sequenceId(m_masterProducer->parent().get("id"));
+                if (sequenceId.isEmpty()) {
+                    sequenceId = m_sequenceUuid.toString();
+                }
+                prod.set(SequencePreRender::SequenceProperty, sequenceId.toUtf8().constData());
+                return std::shared_ptr<Mlt::Producer>(prod.cut(0, maxDuration));
+            }
+        } else if (!m_preRender->isRunning()) {
+            m_preRender->schedule();
+        }
+    }
+    return ProjectClip::sequenceVideoProducer(maxDuration);
+}
+
+void SequenceClip::invalidatePreRender()
+{
+    // A new render is scheduled when the parent timelines request the reloaded producer
+    m_preRender->invalidate();
+}
+
 std::shared_ptr<Mlt::Producer> SequenceClip::sequenceProducer(const QUuid &)
 {
     QReadLocker lock(&m_producerLock);
@@ -20,6 +20,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <memory>
 
 class ClipPropertiesController;
+class SequencePreRender;
 class ProjectClip;
 class QDomElement;
 
@@ -46,6 +47,7 @@ class SequenceClip : public ProjectClip
 
 public:
     friend class Bin;
+    friend class KdenliveTests;
     friend bool TimelineModel::checkConsistency(const std::vector<int> &guideSnaps); // for testing
     /**
      * @brief Constructor; used when loading a project and the producer is already available.
@@ -67,6 +69,8 @@ protected:
     const QString getFileHash() override;
     /** @brief Remove temporary warp producer resource files */
     void removeSequenceWarpResources() override;
+    /** @brief Returns the pre-rendered intermediate if it is up to date, the sequence tractor otherwise */
+    std::shared_ptr<Mlt::Producer> sequenceVideoProducer(int maxDuration) override;
 
 public:
     ~SequenceClip() override;
@@ -86,6 +90,8 @@ public:
     std::unique_ptr<Mlt::Producer> getThumbProducer(const QUuid &) override;
     QDomElement toXml(QDomDocument &document, bool includeMeta = false, bool includeProfile = true) override;
     int getStartTimecode() override;
+    /** @brief The content of the sequence changed, stop using its pre-rendered intermediate */
+    void invalidatePreRender();
 
 public Q_SLOTS:
     bool setProducer(std::shared_ptr<Mlt::Producer> producer, bool generateThumb = false, bool clearTrackProducers = true) override;
@@ -94,4 +100,7 @@ private:
     // The sequence unique identifier
     QUuid m_sequenceUuid;
     QTemporaryFile m_sequenceThumbFile;
+    /** @brief Background render of the sequence, played by the parent timelines when ready */
+    std::unique_ptr<SequencePreRender> m_preRender;
+    void createPreRender();
 };
@@ -0,0 +1,278 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "sequenceprerender.h"
+#include "core.h"
+#include "doc/kdenlivedoc.h"
+#include "kdenlivesettings.h"
+#include "timeline2/model/timelinemodel.hpp"
+#include "timeline2/view/previewmanager.h"
+
+#include <QCryptographicHash>
+#include <QDomDocument>
+#include <QReadWriteLock>
+#include <QSaveFile>
+#include <mlt++/MltConsumer.h>
+#include <mlt++/MltPlaylist.h>
+#include <mlt++/MltProducer.h>
+
+static const QString IntermediateName = QStringLiteral("sequence.mlt");
+static const QString SceneName = QStringLiteral("scene.mlt");
+
+SequencePreRender::SequencePreRender(const QUuid &uuid, QObject *parent)
+    : QObject(parent)
+    , m_uuid(uuid)
+{
+    // Wait for the editing to settle before rendering
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(3000);
+    connect(&m_timer, &QTimer::timeout, this, &SequencePreRender::start);
+    connect(&m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &SequencePreRender::processEnded);
+}
+
+SequencePreRender::~SequencePreRender()
+{
+    abort();
+}
+
+void SequencePreRender::schedule()
+{
+    if (m_process.state() != QProcess::NotRunning) {
+        return;
+    }
+    m_timer.start();
+}
+
+void SequencePreRender::invalidate()
+{
+    abort();
+    m_intermediate.clear();
+}
+
+void SequencePreRender::abort()
+{
+    m_timer.stop();
+    if (m_process.state() != QProcess::NotRunning) {
+        m_process.kill();
+        m_process.waitForFinished();
+    }
+}
+
+bool SequencePreRender::isRunning() const
+{
+    return m_timer.isActive() || m_process.state() != QProcess::NotRunning;
+}
+
+const QString &SequencePreRender::intermediate() const
+{
+    return m_intermediate;
+}
+
+QString SequencePreRender::contentKey(const QString &scene, const QStringList &parameters)
+{
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(scene.toUtf8());
+    hash.addData(parameters.join(QLatin1Char(' ')).toUtf8());
+    return QStringLiteral("nested-%1").arg(QString::fromLatin1(hash.result().toHex()));
+}
+
+QString SequencePreRender::chunkRange(int duration, int chunkSize)
+{
+    if (duration <= 0 || chunkSize <= 0) {
+        return QString();
+    }
+    const int lastChunk = (duration - 1) / chunkSize * chunkSize;
+    if (lastChunk == 0) {
+        return QStringLiteral("0");
+    }
+    return QStringLiteral("0-%1").arg(lastChunk);
+}
+
+/** @brief Remove a service from a scene, along with the services it is the only one to play */
+static void removeService(QDomElement root, QDomElement service)
+{
+    QStringList children;
+    for (const QString &tag : {QStringLiteral("entry"), QStringLiteral("track")}) {
+        const QDomNodeList references = service.elementsByTagName(tag);
+        for (int i = 0; i < references.count(); ++i) {
+            children << references.at(i).toElement().attribute(QStringLiteral("producer"));
+        }
+    }
+    root.removeChild(service);
+    if (children.isEmpty()) {
+        return;
+    }
+    QList<QDomElement> unused;
+    for (QDomElement e = root.firstChildElement(); !e.isNull(); e = e.nextSiblingElement()) {
+        if (children.contains(e.attribute(QStringLiteral("id")))) {
+            unused << e;
+        }
+    }
+    for (const QDomElement &e : std::as_const(unused)) {
+        removeService(root, e);
+    }
+}
+
+bool SequencePreRender::restoreSequences(QDomDocument &scene)
+{
+    QDomElement root = scene.documentElement();
+    QStringList services;
+    for (QDomElement e = root.firstChildElement(); !e.isNull(); e = e.nextSiblingElement()) {
+        services << e.attribute(QStringLiteral("id"));
+    }
+    // Map the id of each intermediate to the id of its sequence
+    QMap<QString, QString> sequences;
+    QList<QDomElement> intermediates;
+    const QDomNodeList properties = scene.elementsByTagName(QStringLiteral("property"));
+    for (int i = 0; i < properties.count(); ++i) {
+        const QDomElement property = properties.at(i).toElement();
+        // A scene of a single timeline does not contain the sequences that are not played, keep their intermediate
+        if (property.attribute(QStringLiteral("name")) == QLatin1String(SequenceProperty) && services.contains(property.text())) {
+            const QDomElement service = property.parentNode().toElement();
+            sequences.insert(service.attribute(QStringLiteral("id")), property.text());
+            intermediates << service;
+        }
+    }
+    if (intermediates.isEmpty()) {
+        return false;
+    }
+    // The intermediate has the same frame numbering as its sequence, only the referenced service changes
+    for (const QString &tag : {QStringLiteral("entry"), QStringLiteral("track")}) {
+        const QDomNodeList references = scene.elementsByTagName(tag);
+        for (int i = 0; i < references.count(); ++i) {
+            QDomElement reference = references.at(i).toElement();
+            auto match = sequences.constFind(reference.attribute(QStringLiteral("producer")));
+            if (match != sequences.constEnd()) {
+                reference.setAttribute(QStringLiteral("producer"), match.value());
+            }
+        }
+    }
+    for (const QDomElement &service : std::as_const(intermediates)) {
+        removeService(root, service);
+    }
+    return true;
+}
+
+QString SequencePreRender::restoreSequences(const QString &scene)
+{
+    if (!scene.contains(QLatin1String(SequenceProperty))) {
+        return scene;
+    }
+    QDomDocument doc;
+    if (!doc.setContent(scene) || !restoreSequences(doc)) {
+        return scene;
+    }
+    return doc.toString();
+}
+
+void SequencePreRender::restoreSequencesInFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QString scene = QString::fromUtf8(file.readAll());
+    file.close();
+    const QString restored = restoreSequences(scene);
+    if (restored == scene) {
+        return;
+    }
+    QSaveFile output(path);
+    if (!output.open(QIODevice::WriteOnly) || output.write(restored.toUtf8()) < 0 || !output.commit()) {
+        qWarning() << "Cannot restore the nested sequences of" << path;
+    }
+}
+
+void SequencePreRender::start()
+{
+    KdenliveDoc *doc = pCore->currentDoc();
+    std::shared_ptr<TimelineModel> timeline = doc ? doc->getTimeline(m_uuid) : nullptr;
+    if (!timeline || m_process.state() != QProcess::NotRunning) {
+        return;
+    }
+    bool ok;
+    const QDir cacheDir = doc->getCacheDir(CachePreview, &ok, m_uuid);
+    QStringList consumerParams;
+    if (!ok || !PreviewManager::renderParameters(m_extension, consumerParams)) {
+        qWarning() << "Cannot pre-render sequence" << m_uuid << ", invalid preview settings";
+        return;
+    }
+    m_duration = timeline->duration();
+    m_chunkSize = KdenliveSettings::timelinechunks();
+    const QString scene = timeline->sceneList(cacheDir.absolutePath());
+    if (scene.isEmpty() || m_duration <= 0) {
+        return;
+    }
+    const QString key =
+        contentKey(scene, QStringList(consumerParams) << m_extension << QString::number(m_chunkSize) << pCore->getCurrentProfilePath());
+    m_dir = cacheDir;
+    if (!m_dir.mkpath(key) || !m_dir.cd(key)) {
+        qWarning() << "Cannot create sequence pre-render folder in" << cacheDir.absolutePath();
+        return;
+    }
+    if (m_dir.exists(IntermediateName)) {
+        // This sequence content was already rendered
+        m_intermediate = m_dir.absoluteFilePath(IntermediateName);
+        Q_EMIT intermediateChanged();
+        return;
+    }
+    QSaveFile file(m_dir.absoluteFilePath(SceneName));
+    if (!file.open(QIODevice::WriteOnly) || file.write(scene.toUtf8()) < 0 || !file.commit()) {
+        qWarning() << "Cannot write sequence pre-render scene" << file.fileName();
+        return;
+    }
+    QStringList args{QStringLiteral("preview-chunks"),
+                     m_dir.absoluteFilePath(SceneName),
+                     m_dir.absolutePath(),
+                     chunkRange(m_duration, m_chunkSize),
+                     QString::number(m_chunkSize - 1),
+                     pCore->getCurrentProfilePath(),
+                     m_extension,
+                     consumerParams.join(QLatin1Char(' '))};
+    if (!KdenliveSettings::hwDecoding().isEmpty()) {
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert(QLatin1String("MLT_AVFORMAT_HWACCEL"), KdenliveSettings::hwDecoding());
+        m_process.setProcessEnvironment(env);
+    }
+    m_process.setProgram(KdenliveSettings::kdenliverendererpath());
+    m_process.setArguments(args);
+    m_process.start(QIODevice::ReadOnly);
+}
+
+void SequencePreRender::processEnded(int exitCode, QProcess::ExitStatus status)
+{
+    m_dir.remove(SceneName);
+    if (status == QProcess::CrashExit || exitCode != 0) {
+        qWarning() << "Sequence pre-render failed:" << m_process.readAllStandardError().right(500);
+        return;
+    }
+    if (buildIntermediate()) {
+        m_intermediate = m_dir.absoluteFilePath(IntermediateName);
+        Q_EMIT intermediateChanged();
+    }
+}
+
+bool SequencePreRender::buildIntermediate()
+{
+    Mlt::Playlist playlist(pCore->getProjectProfile());
+    for (int frame = 0; frame < m_duration; frame += m_chunkSize) {
+        const QString chunk = m_dir.absoluteFilePath(QStringLiteral("%1.%2").arg(frame).arg(m_extension));
+        Mlt::Producer prod(pCore->getProjectProfile(), QStringLiteral("avformat:%1").arg(chunk).toUtf8().constData());
+        // The last chunk is shorter if the sequence duration is not a multiple of the chunk size
+        const int expected = qMin(m_chunkSize, m_duration - frame);
+        if (!prod.is_valid() || prod.get_length() < expected) {
+            qWarning() << "Invalid sequence pre-render chunk" << chunk;
+            return false;
+        }
+        playlist.append(prod, 0, expected - 1);
+    }
+    QWriteLocker lock(&pCore->xmlMutex);
+    Mlt::Consumer xmlConsumer(pCore->getProjectProfile(), "xml", m_dir.absoluteFilePath(IntermediateName).toUtf8().constData());
+    xmlConsumer.set("no_meta", 1);
+    xmlConsumer.set("store", "kdenlive");
+    xmlConsumer.connect(playlist);
+    xmlConsumer.run();
+    return m_dir.exists(IntermediateName);
+}
@@ -0,0 +1,77 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QDir>
+#include <QObject>
+#include <QProcess>
+#include <QTimer>
+#include <QUuid>
+
+class QDomDocument;
+
+/** @class SequencePreRender
+    @brief Renders a sequence used as a clip in other sequences to an intermediate file, in the background.
+    The sequence is rendered in chunks by the timeline preview renderer, in a cache folder named after the hash of the
+    sequence content, so that an unchanged sequence is never rendered twice, even after reopening the project.
+    Once all chunks are available, they are assembled in an MLT playlist that parent timelines can play instead of
+    compositing the nested tracks live. As preview chunks have no audio, the intermediate only replaces the video.
+ */
+class SequencePreRender : public QObject
+{
+    Q_OBJECT
+    friend class KdenliveTests;
+
+public:
+    /** @brief Producer property set on the intermediates played in the timelines, holding the id of the sequence tractor they replace */
+    static constexpr const char *SequenceProperty = "kdenlive:prerenderedsequence";
+    explicit SequencePreRender(const QUuid &uuid, QObject *parent = nullptr);
+    ~SequencePreRender() override;
+    /** @brief Start the pre-render after a short delay, so that successive changes only trigger one render */
+    void schedule();
+    /** @brief The sequence content changed, drop the current intermediate. The caller is responsible for reloading the producers */
+    void invalidate();
+    void abort();
+    bool isRunning() const;
+    /** @brief The playlist of rendered chunks matching the current sequence content, empty if not ready */
+    const QString &intermediate() const;
+    /** @brief The name of the cache folder of a sequence content
+     *  @param scene the MLT xml of the sequence
+     *  @param parameters the encoding parameters, a change of parameters requires a new render
+     */
+    static QString contentKey(const QString &scene, const QStringList &parameters);
+    /** @brief The chunks to render for a sequence duration, in the compressed format of the preview renderer */
+    static QString chunkRange(int duration, int chunkSize);
+    /** @brief Replace the intermediates of an MLT xml scene by the sequences they were rendered from, if the scene contains them.
+     *  Project scenes contain all sequences, so saved projects and render scripts never depend on the pre-render cache.
+     *  @returns true if the scene was modified
+     */
+    static bool restoreSequences(QDomDocument &scene);
+    /** @brief Same as above, for a scene in a string or an MLT xml file */
+    static QString restoreSequences(const QString &scene);
+    static void restoreSequencesInFile(const QString &path);
+
+private:
+    QUuid m_uuid;
+    QProcess m_process;
+    QTimer m_timer;
+    /** @brief The cache folder for the current sequence content */
+    QDir m_dir;
+    QString m_extension;
+    QString m_intermediate;
+    int m_duration{0};
+    int m_chunkSize{0};
+    void start();
+    /** @brief Assemble the rendered chunks in a playlist, returns false if a chunk is missing */
+    bool buildIntermediate();
+
+private Q_SLOTS:
+    void processEnded(int exitCode, QProcess::ExitStatus status);
+
+Q_SIGNALS:
+    /** @brief An intermediate matching the sequence content is ready */
+    void intermediateChanged();
+};
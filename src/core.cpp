@@ -30,6 +30,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "timeline2/model/timelineitemmodel.hpp"
 #include "timeline2/view/timelinecontroller.h"
 #include "timeline2/view/timelinewidget.h"
+#include "utils/startuptimer.h"
 #include <mlt++/MltRepository.h>
 
 #include <KIO/OpenFileManagerWindowJob>
@@ -154,6 +155,7 @@ void Core::initHeadless(const QUrl &url)
 void Core::initGUI(const QString &MltPath, const QUrl &Url, const QString &clipsToLoad)
 {
     m_mainWindow = new MainWindow();
+    StartupTimer::mark(QString(), QStringLiteral("Main window creation"));
 
     // The MLT Factory will be initiated there, all MLT classes will be usable only after this
     bool inSandbox = m_packageType == LinuxPackageType::AppImage || m_packageType == LinuxPackageType::Flatpak || m_packageType == LinuxPackageType::Snap;
@@ -169,6 +171,7 @@ void Core::initGUI(const QString &MltPath, const QUrl &Url, const QString &clips
         // Open connection with Mlt
         MltConnection::construct(MltPath);
     }
+    StartupTimer::mark(QString(), QStringLiteral("MLT initialization"));
 
     // TODO Qt6 see: https://doc.qt.io/qt-6/qtquickcontrols-changes-qt6.html#custom-styles-are-now-proper-qml-modules
 
@@ -192,6 +195,7 @@ void Core::initGUI(const QString &MltPath, const QUrl &Url, const QString &clips
     m_monitorManager = new MonitorManager(this);
     projectManager()->init(Url, clipsToLoad);
     m_mainWindow->init();
+    StartupTimer::mark(QString(), QStringLiteral("Main window setup (assets, docks, actions)"));
 
     // Secondary bins
     m_guiConstructed = true;
@@ -203,6 +207,7 @@ void Core::initGUI(const QString &MltPath, const QUrl &Url, const QString &clips
     m_projectItemModel->buildPlaylist(QUuid());
     // load the profiles from disk
     ProfileRepository::get()->refresh();
+    StartupTimer::mark(QString(), QStringLiteral("Profiles loading"));
     // load default profile
     m_profile = KdenliveSettings::default_profile();
     // load default profile and ask user to select one if not found.
@@ -257,6 +262,8 @@ void Core::initGUI(const QString &MltPath, const QUrl &Url, const QString &clips
     }
     m_mainWindow->show();
     Q_EMIT m_mainWindow->GUISetupDone();
+    StartupTimer::mark(QString(), QStringLiteral("Main window shown"));
+    StartupTimer::report();
     if (!Url.isEmpty()) {
         Q_EMIT loadingMessageNewStage(i18n("Loading project…"));
     }
@@ -602,7 +609,8 @@ bool Core::setCurrentProfile(const QString profilePath)
 {
     if (m_currentProfile == profilePath) {
         // no change required, ensure timecode has correct fps
-        m_timecode.setFormat(getCurrentProfile()->fps());
+        resetFpsCache();
+        m_timecode.setFormat(getCurrentFps());
         Q_EMIT updateProjectTimecode();
         return true;
     }
@@ -611,6 +619,7 @@ bool Core::setCurrentProfile(const QString profilePath)
         taskManager.slotCancelJobs();
         m_currentProfile = profilePath;
         std::unique_ptr<ProfileModel> &currentProfile = getCurrentProfile();
+        resetFpsCache();
         m_projectProfile.set_colorspace(currentProfile->colorspace());
         m_projectProfile.set_frame_rate(currentProfile->frame_rate_num(), currentProfile->frame_rate_den());
         m_projectProfile.set_height(currentProfile->height());
@@ -665,7 +674,20 @@ double Core::getCurrentDar() const
 
 double Core::getCurrentFps() const
 {
-    return getCurrentProfile()->fps();
+    // The cached value is dropped when the profile changes or the profiles are reloaded from disk
+    const int generation = ProfileRepository::get()->generation();
+    QMutexLocker lock(&m_fpsMutex);
+    if (m_fpsGeneration != generation) {
+        m_currentFps = getCurrentProfile()->fps();
+        m_fpsGeneration = generation;
+    }
+    return m_currentFps;
+}
+
+void Core::resetFpsCache()
+{
+    QMutexLocker lock(&m_fpsMutex);
+    m_fpsGeneration = -1;
 }
 
 const QSize Core::getCurrentFrameDisplaySize() const
@@ -981,6 +1003,13 @@ void Core::pushUndo(const Fun &undo, const Fun &redo, const QString &text)
     undoStack()->push(new FunctionalUndoCommand(undo, redo, text));
 }
 
+void Core::pushUndo(const Fun &undo, const Fun &redo, const QString &text, qint64 memoryCost)
+{
+    auto *command = new FunctionalUndoCommand(undo, redo, text);
+    command->addMemoryCost(memoryCost);
+    undoStack()->push(command);
+}
+
 void Core::pushUndo(QUndoCommand *command)
 {
     undoStack()->push(command);
@@ -1100,9 +1129,18 @@ void Core::invalidateItem(ObjectId itemId)
     case KdenliveObjectType::TimelineComposition:
         if (tl) {
             tl->controller()->invalidateItem(itemId.itemId);
+            if (tl == m_mainWindow->getCurrentTimeline() && tl->model()->isItem(itemId.itemId)) {
+                // Only drop the cached monitor frames covered by the item
+                int start = tl->model()->getItemPosition(itemId.itemId);
+                m_monitorManager->projectMonitor()->invalidateFrameCache(start, start + tl->model()->getItemPlaytime(itemId.itemId));
+            } else {
+                // The item is in a nested sequence, we don't know where it is used
+                m_monitorManager->projectMonitor()->invalidateFrameCache(0, -1);
+            }
         }
         break;
     case KdenliveObjectType::TimelineTrack:
+        m_monitorManager->projectMonitor()->invalidateFrameCache(0, -1);
         if (tl) {
             tl->controller()->invalidateTrack(itemId.itemId);
         }
@@ -1403,14 +1441,30 @@ void Core::updateProjectTags(int previousCount, const QMap<int, QStringList> &ta
 
 std::unique_ptr<Mlt::Producer> Core::getMasterProducerInstance()
 {
-    if (m_guiConstructed && m_mainWindow->getCurrentTimeline()) {
-        const QString scene = m_projectManager->projectSceneList(QString(), true).first;
+    const QString scene = getMasterSceneList();
+    if (!scene.isEmpty()) {
         std::unique_ptr<Mlt::Producer> producer(new Mlt::Producer(pCore->getProjectProfile(), "xml-string", scene.toUtf8().constData()));
         return producer;
     }
     return nullptr;
 }
 
+QString Core::getMasterSceneList()
+{
+    if (m_guiConstructed && m_mainWindow->getCurrentTimeline()) {
+        return m_projectManager->projectSceneList(QString(), true).first;
+    }
+    return QString();
+}
+
+QString Core::getTimelineSceneCopy()
+{
+    if (m_guiConstructed && m_mainWindow->getCurrentTimeline() && !m_mainWindow->getCurrentTimeline()->loading) {
+        return m_mainWindow->getCurrentTimeline()->model()->sceneList(QString());
+    }
+    return QString();
+}
+
 std::unique_ptr<Mlt::Producer> Core::getTrackProducerInstance(int tid)
 {
     if (m_guiConstructed && m_mainWindow->getCurrentTimeline()) {
@@ -194,6 +194,8 @@ public:
     /** @brief Create and push and undo object based on the corresponding functions
         Note that if you class permits and requires it, you should use the macro PUSH_UNDO instead*/
     void pushUndo(const Fun &undo, const Fun &redo, const QString &text);
+    /** @brief Same as above, with an estimation in bytes of the data captured by the lambdas, used to enforce the undo memory budget */
+    void pushUndo(const Fun &undo, const Fun &redo, const QString &text, qint64 memoryCost);
     void pushUndo(QUndoCommand *command);
     /** @brief display timeline selection info in statusbar */
     void displaySelectionMessage(const QString &message);
@@ -270,6 +272,10 @@ public:
     Mlt::Profile &getMonitorProfile();
     /** @brief Returns a copy of current timeline's master playlist */
     std::unique_ptr<Mlt::Producer> getMasterProducerInstance();
+    /** @brief Returns the xml of current timeline's master playlist, used to build copies of it in other threads */
+    QString getMasterSceneList();
+    /** @brief Returns the xml of the current timeline tractor. Unlike getMasterSceneList, the project document is not updated */
+    QString getTimelineSceneCopy();
     /** @brief Returns a copy of a track's playlist */
     std::unique_ptr<Mlt::Producer> getTrackProducerInstance(int tid);
     /** @brief Returns the undo stack index (position). */
@@ -361,6 +367,8 @@ private:
 
     /** @brief Makes sure Qt's locale and system locale settings match. */
     void initLocale();
+    /** @brief Makes the next getCurrentFps() call read the frame rate from the profile. */
+    void resetFpsCache();
 
     MainWindow *m_mainWindow{nullptr};
     ProjectManager *m_projectManager{nullptr};
@@ -376,6 +384,12 @@ private:
 
     /** @brief Current project's profile path */
     QString m_currentProfile;
+    /** @brief Frame rate of the current profile, cached as it is queried in many loops */
+    mutable double m_currentFps{0.};
+    /** @brief Profile repository generation m_currentFps was read from, -1 when it must be read again */
+    mutable int m_fpsGeneration{-1};
+    /** @brief Guards m_currentFps and m_fpsGeneration, which must be read and written together */
+    mutable QMutex m_fpsMutex;
 
     QString m_profile;
     LinuxPackageType m_packageType;
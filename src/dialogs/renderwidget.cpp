@@ -575,6 +575,14 @@ RenderWidget::RenderWidget(bool enableProxy, QWidget *parent)
     m_memCheckTimer.setInterval(10000);
     m_memCheckTimer.setSingleShot(false);
 
+    // A render process that exits before connecting to the render server must not block the queue
+    m_launchTimer.setSingleShot(true);
+    m_launchTimer.setInterval(30000);
+    connect(&m_launchTimer, &QTimer::timeout, this, [this]() {
+        m_launchingJob.clear();
+        checkRenderStatus();
+    });
+
     loadConfig();
     refreshView();
     focusItem();
@@ -583,6 +591,12 @@ RenderWidget::RenderWidget(bool enableProxy, QWidget *parent)
     connect(this, &RenderWidget::renderStatusChanged, this, &RenderWidget::updatePowerManagement);
     m_view.keep_log_files->setChecked(KdenliveSettings::keepRenderLogFiles());
     connect(m_view.keep_log_files, &QCheckBox::toggled, this, [](bool enabled) { KdenliveSettings::setKeepRenderLogFiles(enabled); });
+    m_view.job_slots->setMaximum(QThread::idealThreadCount());
+    m_view.job_slots->setValue(KdenliveSettings::renderjobslots());
+    connect(m_view.job_slots, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, [this](int slots) {
+        KdenliveSettings::setRenderjobslots(slots);
+        checkRenderStatus();
+    });
 }
 
 void RenderWidget::slotShareActionFinished(const QJsonObject &output, int error, const QString &message)
@@ -1029,45 +1043,19 @@ void RenderWidget::checkRenderStatus()
         return;
     }
 
-    // Make sure no other rendering is running
-    if (runningJobsCount() > 0) {
-        return;
-    }
-
-    auto *item = static_cast<RenderJobItem *>(m_view.running_jobs->topLevelItem(0));
-
+    int running = runningJobsCount();
     bool waitingJob = false;
 
-    // Find first waiting job
-    while (item != nullptr) {
-        if (item->status() == WAITINGJOB) {
-            QDateTime t = QDateTime::currentDateTime();
-            item->setData(1, StartTimeRole, t);
-            item->setData(1, LastTimeRole, t);
+    // Find first waiting job that can be started
+    auto *item = static_cast<RenderJobItem *>(m_view.running_jobs->topLevelItem(0));
+    while (item != nullptr && m_launchingJob.isEmpty()) {
+        if (item->status() == WAITINGJOB && canStartRendering(item) && launchJob(item)) {
             waitingJob = true;
-            startRendering(item);
-            // Check for 2 pass encoding
-            const QStringList jobData = item->data(1, ParametersRole).toStringList();
-            if (jobData.size() > 2 && jobData.at(2).endsWith(QStringLiteral("-pass2.mlt"))) {
-                // Find and remove 1st pass job
-                QString firstPassName = jobData.at(2);
-                firstPassName.replace(QStringLiteral("-pass2.mlt"), QStringLiteral("-pass1.mlt"));
-                QTreeWidgetItem *above = m_view.running_jobs->itemAbove(item);
-                while (above) {
-                    QStringList aboveData = above->data(1, ParametersRole).toStringList();
-                    if (aboveData.size() > 2 && aboveData.at(2) == firstPassName) {
-                        delete above;
-                        break;
-                    }
-                    above = m_view.running_jobs->itemAbove(above);
-                }
-            }
-            item->setStatus(STARTINGJOB);
             break;
         }
         item = static_cast<RenderJobItem *>(m_view.running_jobs->itemBelow(item));
     }
-    if (!waitingJob) {
+    if (!waitingJob && running == 0) {
         if (m_renderStatus == Rendering) {
             m_renderStatus = NotRendering;
             Q_EMIT renderStatusChanged();
@@ -1078,7 +1066,76 @@ void RenderWidget::checkRenderStatus()
     }
 }
 
-void RenderWidget::startRendering(RenderJobItem *item)
+static bool isTwoPassJob(RenderJobItem *job)
+{
+    const QStringList jobData = job->data(1, RenderWidget::ParametersRole).toStringList();
+    return job->data(1, RenderWidget::TwoPassRole).toInt() == 1 || (jobData.size() > 2 && jobData.at(2).endsWith(QStringLiteral("-pass2.mlt")));
+}
+
+bool RenderWidget::canStartRendering(RenderJobItem *item)
+{
+    // Wait until the last started job is connected, so that a start failure is reported on the correct job
+    if (!m_launchingJob.isEmpty()) {
+        return false;
+    }
+
+    // Make sure we have a free render slot
+    int running = runningJobsCount();
+    if (running == 0) {
+        return true;
+    }
+    if (running >= RenderRequest::renderJobSlots()) {
+        return false;
+    }
+
+    // Only run more jobs if the system has enough memory
+    slotCheckFreeMemory();
+    if (m_lowMemStatus != NoWarning) {
+        return false;
+    }
+
+    // The first pass of a 2 pass job renders to /dev/null, and its progress is found by the TwoPassRole, so only run one at a time
+    if (isTwoPassJob(item)) {
+        auto *job = static_cast<RenderJobItem *>(m_view.running_jobs->topLevelItem(0));
+        while (job != nullptr) {
+            if ((job->status() == RUNNINGJOB || job->status() == STARTINGJOB) && isTwoPassJob(job)) {
+                return false;
+            }
+            job = static_cast<RenderJobItem *>(m_view.running_jobs->itemBelow(job));
+        }
+    }
+    return true;
+}
+
+bool RenderWidget::launchJob(RenderJobItem *item)
+{
+    QDateTime t = QDateTime::currentDateTime();
+    item->setData(1, StartTimeRole, t);
+    item->setData(1, LastTimeRole, t);
+    if (!startRendering(item)) {
+        return false;
+    }
+    // Check for 2 pass encoding
+    const QStringList jobData = item->data(1, ParametersRole).toStringList();
+    if (jobData.size() > 2 && jobData.at(2).endsWith(QStringLiteral("-pass2.mlt"))) {
+        // Find and remove 1st pass job
+        QString firstPassName = jobData.at(2);
+        firstPassName.replace(QStringLiteral("-pass2.mlt"), QStringLiteral("-pass1.mlt"));
+        QTreeWidgetItem *above = m_view.running_jobs->itemAbove(item);
+        while (above) {
+            QStringList aboveData = above->data(1, ParametersRole).toStringList();
+            if (aboveData.size() > 2 && aboveData.at(2) == firstPassName) {
+                delete above;
+                break;
+            }
+            above = m_view.running_jobs->itemAbove(above);
+        }
+    }
+    item->setStatus(STARTINGJOB);
+    return true;
+}
+
+bool RenderWidget::startRendering(RenderJobItem *item)
 {
     auto rendererArgs = item->data(1, ParametersRole).toStringList();
     qDebug() << "starting kdenlive_render process using: " << KdenliveSettings::kdenliverendererpath();
@@ -1095,10 +1152,12 @@ void RenderWidget::startRendering(RenderJobItem *item)
     proc.setArguments(rendererArgs);
     if (!proc.startDetached()) {
         item->setStatus(FAILEDJOB);
-    } else {
-
-        KNotification::event(QStringLiteral("RenderStarted"), i18n("Rendering %1 started", item->text(1)), QPixmap());
+        return false;
     }
+    m_launchingJob = item->text(1);
+    m_launchTimer.start();
+    KNotification::event(QStringLiteral("RenderStarted"), i18n("Rendering %1 started", item->text(1)), QPixmap());
+    return true;
 }
 
 int RenderWidget::waitingJobsCount() const
@@ -1527,6 +1586,12 @@ void RenderWidget::setRenderProgress(const QString &dest, int progress, int fram
         }
     }
     item->setData(1, ProgressRole, progress);
+    if (!m_launchingJob.isEmpty() && item->text(1) == m_launchingJob) {
+        // The job is connected, others can be started
+        m_launchingJob.clear();
+        m_launchTimer.stop();
+        QMetaObject::invokeMethod(this, &RenderWidget::checkRenderStatus, Qt::QueuedConnection);
+    }
     if (progress == 0) {
         item->setStatus(STARTINGJOB);
         item->setIcon(0, QIcon::fromTheme(QStringLiteral("media-record")));
@@ -1657,6 +1722,10 @@ void RenderWidget::setRenderStatus(const QString &dest, int status, const QStrin
     if (!item) {
         return;
     }
+    if (item->text(1) == m_launchingJob || (dest.isEmpty() && status == -2)) {
+        m_launchingJob.clear();
+        m_launchTimer.stop();
+    }
     if (status == -1) {
         // Job finished successfully
         item->setStatus(FINISHEDJOB);
@@ -1734,7 +1803,7 @@ RenderJobItem *RenderWidget::startingJob()
 {
     auto *item = static_cast<RenderJobItem *>(m_view.running_jobs->topLevelItem(0));
     while (item != nullptr) {
-        if (item->status() == STARTINGJOB) {
+        if (item->status() == STARTINGJOB && (m_launchingJob.isEmpty() || item->text(1) == m_launchingJob)) {
             return item;
         }
         item = static_cast<RenderJobItem *>(m_view.running_jobs->itemBelow(item));
@@ -1759,9 +1828,17 @@ void RenderWidget::slotAbortCurrentJob()
 void RenderWidget::slotStartCurrentJob()
 {
     auto *current = static_cast<RenderJobItem *>(m_view.running_jobs->currentItem());
-    if ((current != nullptr) && current->status() == WAITINGJOB) {
-        startRendering(current);
+    if (current == nullptr || current->status() != WAITINGJOB) {
+        return;
+    }
+    if (!canStartRendering(current)) {
+        // The job stays in the queue and is started when resources are available
+        m_view.jobInfo->setMessageType(KMessageWidget::Information);
+        m_view.jobInfo->setText(i18n("The job will start when a render slot is available"));
+        m_view.jobInfo->show();
+        return;
     }
+    launchJob(current);
     m_view.start_job->setEnabled(false);
 }
 
@@ -204,13 +204,22 @@ private:
     MemCheckStatus m_lowMemStatus{NoWarning};
     RenderStatus m_renderStatus{NotRendering};
     QTimer m_memCheckTimer;
+    /** @brief Output of the last started job until it connects to the render server, other jobs are not started meanwhile. */
+    QString m_launchingJob;
+    /** @brief Stops waiting for the last started job if its process never connects to the render server. */
+    QTimer m_launchTimer;
 
     Purpose::Menu *m_shareMenu;
     void parseProfiles(const QString &selectedProfile = QString());
     QUrl filenameWithExtension(QUrl url, const QString &extension);
     /** @brief Check if a job needs to be started. */
     void checkRenderStatus();
-    void startRendering(RenderJobItem *item);
+    /** @brief Returns true if a render slot, enough memory and the 2 pass constraint allow to start this job now. */
+    bool canStartRendering(RenderJobItem *item);
+    /** @brief Start a waiting job and mark it as starting, returns false if it could not be started. */
+    bool launchJob(RenderJobItem *item);
+    /** @brief Start the render process of a job, returns false if it could not be started. */
+    bool startRendering(RenderJobItem *item);
     /** @brief Create a rendering profile from MLT preset. */
     QTreeWidgetItem *loadFromMltPreset(const QString &groupName, const QString &path, QString profileName, bool codecInName = false);
     RenderJobItem *createRenderJob(const RenderRequest::RenderJob &job);
@@ -275,6 +275,8 @@ void KdenliveSettingsDialog::initProxyPage()
     m_configProxy.kcfg_proxyminsize->setEnabled(KdenliveSettings::generateproxy());
     connect(m_configProxy.kcfg_generateimageproxy, &QAbstractButton::toggled, m_configProxy.kcfg_proxyimageminsize, &QWidget::setEnabled);
     m_configProxy.kcfg_proxyimageminsize->setEnabled(KdenliveSettings::generateimageproxy());
+    connect(m_configProxy.kcfg_singlepassingest, &QAbstractButton::toggled, m_configProxy.kcfg_ingestscenedetection, &QWidget::setEnabled);
+    m_configProxy.kcfg_ingestscenedetection->setEnabled(KdenliveSettings::singlepassingest());
     loadExternalProxyProfiles();
     connect(m_configProxy.button_external, &QToolButton::clicked, this, &KdenliveSettingsDialog::configureExternalProxies);
 }
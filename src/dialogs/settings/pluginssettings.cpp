@@ -280,6 +280,10 @@ PluginsSettings::PluginsSettings(QWidget *parent)
             checkSamEnvironement(false);
         }
     });
+    connect(kcfg_speechStreaming, &QAbstractButton::toggled, kcfg_speechWorkers, &QWidget::setEnabled);
+    connect(kcfg_speechStreaming, &QAbstractButton::toggled, label_speechWorkers, &QWidget::setEnabled);
+    kcfg_speechWorkers->setEnabled(KdenliveSettings::speechStreaming());
+    label_speechWorkers->setEnabled(KdenliveSettings::speechStreaming());
 
     // Sam
     PythonDependencyMessage *pythonSamLabel = new PythonDependencyMessage(this, m_samInterface, false);
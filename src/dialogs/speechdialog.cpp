@@ -26,10 +26,15 @@
 #include <QDir>
 #include <QFontDatabase>
 #include <QProcess>
+#include <QUuid>
 
 #include <memory>
 #include <utility>
 
+// Long zones are only split in segments of at least 5 minutes, overlapping by 2 seconds
+static constexpr int MinSegmentSeconds = 300;
+static constexpr int SegmentOverlapSeconds = 2;
+
 SpeechDialog::SpeechDialog(std::shared_ptr<TimelineItemModel> timeline, QPoint zone, int tid, bool, bool, QWidget *parent)
     : QDialog(parent)
     , m_timeline(timeline)
@@ -159,9 +164,7 @@ SpeechDialog::SpeechDialog(std::shared_ptr<TimelineItemModel> timeline, QPoint z
     connect(buttonBox->button(QDialogButtonBox::Apply), &QPushButton::clicked, this, [this]() { slotProcessSpeech(); });
     frame_progress->setVisible(false);
     connect(button_abort, &QToolButton::clicked, this, [this]() {
-        if (m_speechJob && m_speechJob->state() == QProcess::Running) {
-            m_speechJob->kill();
-        }
+        abortJobs();
     });
     if (!KdenliveSettings::speech_system_python()) {
         buttonBox->button(QDialogButtonBox::Apply)->setEnabled(false);
@@ -175,7 +178,15 @@ SpeechDialog::SpeechDialog(std::shared_ptr<TimelineItemModel> timeline, QPoint z
     }
 }
 
-SpeechDialog::~SpeechDialog() {}
+SpeechDialog::~SpeechDialog()
+{
+    for (auto &job : m_jobs) {
+        if (job->process) {
+            job->process->disconnect(this);
+        }
+    }
+    abortJobs();
+}
 
 void SpeechDialog::checkDeps()
 {
@@ -275,42 +286,12 @@ void SpeechDialog::buildSpeechModelsList(SpeechToTextEngine::EngineType engine,
     buttonBox->button(QDialogButtonBox::Apply)->setEnabled(true);
 }
 
-void SpeechDialog::slotProcessSpeech()
+std::unique_ptr<Mlt::Producer> SpeechDialog::loadAudioScene(const QString &sceneList)
 {
-    if (translate_seamless->isChecked()) {
-        KdenliveSettings::setSrtSeamlessTranslate(true);
-        KdenliveSettings::setSeamless_input(seamless_in->currentData().toString());
-        KdenliveSettings::setSeamless_output(seamless_out->currentData().toString());
-    } else {
-        KdenliveSettings::setSrtSeamlessTranslate(false);
-    }
-    buttonBox->button(QDialogButtonBox::Apply)->setEnabled(false);
-    speech_info->clearActions();
-    speech_info->setMessageType(KMessageWidget::Information);
-    speech_info->setText(i18n("Starting audio export"));
-    speech_info->show();
-    qApp->processEvents();
-    QString sceneList;
-    QString audio;
-    QTemporaryFile tmpPlaylist(QDir::temp().absoluteFilePath(QStringLiteral("XXXXXX.mlt")));
-    m_tmpAudio = std::make_unique<QTemporaryFile>(QDir::temp().absoluteFilePath(QStringLiteral("XXXXXX.wav")));
-    if (tmpPlaylist.open()) {
-        sceneList = tmpPlaylist.fileName();
-    }
-    tmpPlaylist.close();
-    if (m_tmpAudio->open()) {
-        audio = m_tmpAudio->fileName();
-    }
-    m_tmpAudio->close();
-    QString speech = QFileInfo(audio).completeBaseName();
-    speech.append(QStringLiteral(".srt"));
-    m_tmpSrtPath = QDir::temp().absoluteFilePath(speech);
-    m_timeline->sceneList(QDir::temp().absolutePath(), sceneList);
-    // TODO: do the rendering in another thread to not block the UI
     QReadLocker lock(&pCore->xmlMutex);
-    Mlt::Producer producer(m_timeline->tractor()->get_profile(), "xml", sceneList.toUtf8().constData());
+    auto producer = std::make_unique<Mlt::Producer>(m_timeline->tractor()->get_profile(), "xml", sceneList.toUtf8().constData());
     int tracksCount = m_timeline->tractor()->count();
-    std::shared_ptr<Mlt::Service> s(new Mlt::Service(producer));
+    std::shared_ptr<Mlt::Service> s(new Mlt::Service(*producer.get()));
     std::shared_ptr<Mlt::Multitrack> multi = nullptr;
     bool multitrackFound = false;
     for (int i = 0; i < 10; i++) {
@@ -345,10 +326,87 @@ void SpeechDialog::slotProcessSpeech()
             tid++;
         }
     }
+    return producer;
+}
+
+void SpeechDialog::slotProcessSpeech()
+{
+    if (translate_seamless->isChecked()) {
+        KdenliveSettings::setSrtSeamlessTranslate(true);
+        KdenliveSettings::setSeamless_input(seamless_in->currentData().toString());
+        KdenliveSettings::setSeamless_output(seamless_out->currentData().toString());
+    } else {
+        KdenliveSettings::setSrtSeamlessTranslate(false);
+    }
+    if (KdenliveSettings::speechEngine() == QLatin1String("whisper")) {
+        if (check_maxchars->isChecked() && check_maxchars->isEnabled()) {
+            KdenliveSettings::setWhisperMaxChars(maxChars->value());
+        }
+        KdenliveSettings::setCutWhisperMaxChars(check_maxchars->isChecked());
+    }
+    abortJobs();
+    m_jobs.clear();
+    buttonBox->button(QDialogButtonBox::Apply)->setEnabled(false);
+    speech_info->clearActions();
+    speech_info->setMessageType(KMessageWidget::Information);
+    speech_info->setText(i18n("Starting audio export"));
+    speech_info->show();
+    qApp->processEvents();
+    QString sceneList;
+    QTemporaryFile tmpPlaylist(QDir::temp().absoluteFilePath(QStringLiteral("XXXXXX.mlt")));
+    if (tmpPlaylist.open()) {
+        sceneList = tmpPlaylist.fileName();
+    }
+    tmpPlaylist.close();
+    m_timeline->sceneList(QDir::temp().absolutePath(), sceneList);
+    speech_progress->setValue(0);
+    m_errorLog.clear();
+    logOutput->clear();
+    frame_progress->setVisible(true);
+
+    if (KdenliveSettings::speechStreaming()) {
+        // Stream the audio to the recognizers, long zones are split between several recognizers
+        const double fps = pCore->getCurrentFps();
+        const QVector<SpeechToText::Segment> segments = SpeechToText::splitZone(m_zone, KdenliveSettings::speechWorkers(), int(MinSegmentSeconds * fps),
+                                                                               int(SegmentOverlapSeconds * fps));
+        for (const auto &segment : segments) {
+            std::unique_ptr<Mlt::Producer> producer = loadAudioScene(sceneList);
+            if (!producer->is_valid()) {
+                m_jobs.clear();
+                speech_info->setMessageType(KMessageWidget::Warning);
+                speech_info->setText(i18n("Audio export failed"));
+                buttonBox->button(QDialogButtonBox::Apply)->setEnabled(true);
+                return;
+            }
+            producer->set_in_and_out(segment.zone.x(), segment.zone.y());
+            auto job = std::make_unique<SpeechJob>();
+            job->segment = segment;
+            // The script creates the file, so only reserve a unique name
+            job->srtPath = QDir::temp().absoluteFilePath(QStringLiteral("kdenlive-speech-%1.srt").arg(QUuid::createUuid().toString(QUuid::Id128)));
+            job->feeder = std::make_unique<SpeechAudioFeeder>(std::move(producer));
+            m_jobs.push_back(std::move(job));
+        }
+        speech_info->setText(i18n("Starting speech recognition"));
+        for (auto &job : m_jobs) {
+            startJob(job.get(), QStringLiteral("-"));
+        }
+        return;
+    }
+
+    // Render the zone to a wav file before starting the recognizer
+    QString audio;
+    m_tmpAudio = std::make_unique<QTemporaryFile>(QDir::temp().absoluteFilePath(QStringLiteral("XXXXXX.wav")));
+    if (m_tmpAudio->open()) {
+        audio = m_tmpAudio->fileName();
+    }
+    m_tmpAudio->close();
+    // TODO: do the rendering in another thread to not block the UI
+    std::unique_ptr<Mlt::Producer> producer = loadAudioScene(sceneList);
+    QReadLocker lock(&pCore->xmlMutex);
     Mlt::Consumer xmlConsumer(m_timeline->tractor()->get_profile(), "avformat", audio.toUtf8().constData());
-    if (!xmlConsumer.is_valid() || !producer.is_valid()) {
+    if (!xmlConsumer.is_valid() || !producer->is_valid()) {
         qDebug() << "=== STARTING CONSUMER ERROR";
-        if (!producer.is_valid()) {
+        if (!producer->is_valid()) {
             qDebug() << "=== PRODUCER INVALID";
         }
         speech_info->setMessageType(KMessageWidget::Warning);
@@ -356,20 +414,13 @@ void SpeechDialog::slotProcessSpeech()
         qApp->processEvents();
         return;
     }
-    speech_progress->setValue(0);
-    m_errorLog.clear();
-    logOutput->clear();
-    speech_info->clearActions();
-    frame_progress->setVisible(true);
-    buttonBox->button(QDialogButtonBox::Apply)->setEnabled(false);
     qApp->processEvents();
     xmlConsumer.set("terminate_on_pause", 1);
     xmlConsumer.set("properties", "WAV");
-    producer.set_in_and_out(m_zone.x(), m_zone.y());
-    xmlConsumer.connect(producer);
+    producer->set_in_and_out(m_zone.x(), m_zone.y());
+    xmlConsumer.connect(*producer.get());
 
     qDebug() << "=== STARTING RENDER C, IN:" << m_zone.x() << " - " << m_zone.y();
-    m_duration = m_zone.y() - m_zone.x();
     qApp->processEvents();
     xmlConsumer.run();
     qApp->processEvents();
@@ -377,22 +428,28 @@ void SpeechDialog::slotProcessSpeech()
     speech_info->setMessageType(KMessageWidget::Information);
     speech_info->setText(i18n("Starting speech recognition"));
     qApp->processEvents();
-    QString modelDirectory = m_stt->modelFolder();
-    m_speechJob = std::make_unique<QProcess>(this);
-    connect(m_speechJob.get(), static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &SpeechDialog::slotProcessSpeechStatus);
+    auto job = std::make_unique<SpeechJob>();
+    job->segment = {m_zone, m_zone.x(), m_zone.y() + 1};
+    job->srtPath = QDir::temp().absoluteFilePath(QFileInfo(audio).completeBaseName() + QStringLiteral(".srt"));
+    m_jobs.push_back(std::move(job));
+    startJob(m_jobs.back().get(), audio);
+}
+
+QStringList SpeechDialog::speechArguments(const QString &audio, const QString &srtPath) const
+{
+    const bool streaming = audio == QLatin1String("-");
     if (KdenliveSettings::speechEngine() == QLatin1String("whisper")) {
         // Whisper
         QString modelName = speech_model->currentData().toString();
-        m_speechJob->setProcessChannelMode(QProcess::MergedChannels);
-        connect(m_speechJob.get(), &QProcess::readyReadStandardOutput, this, &SpeechDialog::slotProcessWhisperProgress);
         QString language = speech_language->isEnabled() ? speech_language->currentData().toString().simplified() : QString();
         int maxCount = 0;
         if (check_maxchars->isChecked() && check_maxchars->isEnabled()) {
             maxCount = maxChars->value();
-            KdenliveSettings::setWhisperMaxChars(maxCount);
         }
-        KdenliveSettings::setCutWhisperMaxChars(check_maxchars->isChecked());
         QStringList arguments = {m_stt->subtitleScript(), audio, modelName, QStringLiteral("ffmpeg_path=%1").arg(KdenliveSettings::ffmpegpath())};
+        if (streaming) {
+            arguments << QStringLiteral("output=%1").arg(srtPath);
+        }
         if (!KdenliveSettings::whisperDevice().isEmpty()) {
             arguments << QStringLiteral("device=%1").arg(KdenliveSettings::whisperDevice());
         }
@@ -412,62 +469,168 @@ void SpeechDialog::slotProcessSpeech()
             arguments << QStringLiteral("max_line_width=%1").arg(maxCount);
             arguments << QStringLiteral("max_line_count=1");
         }
-        qDebug() << "::: PASSING SPEECH ARGS: " << arguments;
+        return arguments;
+    }
+    // Vosk
+    return {m_stt->subtitleScript(),
+            QStringLiteral("--model_directory=%1").arg(m_stt->modelFolder()),
+            QStringLiteral("--model=%1").arg(speech_model->currentText()),
+            streaming ? QStringLiteral("--src=-") : QStringLiteral("--src=\"%1\"").arg(audio),
+            QStringLiteral("--output=%1").arg(srtPath),
+            QStringLiteral("--ffmpeg_path=%1").arg(KdenliveSettings::ffmpegpath())};
+}
 
-        m_speechJob->start(m_stt->venvPythonExecs().python, arguments);
+void SpeechDialog::startJob(SpeechJob *job, const QString &audio)
+{
+    job->process = std::make_unique<QProcess>(this);
+    QProcess *process = job->process.get();
+    connect(process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this,
+            [this, job](int exitCode, QProcess::ExitStatus status) { slotProcessSpeechStatus(job, exitCode, status); });
+    connect(process, &QProcess::errorOccurred, this, [this, job](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            slotProcessSpeechStatus(job, 1, QProcess::CrashExit);
+        }
+    });
+    if (KdenliveSettings::speechEngine() == QLatin1String("whisper")) {
+        process->setProcessChannelMode(QProcess::MergedChannels);
+        connect(process, &QProcess::readyReadStandardOutput, this, [this, job]() { slotProcessWhisperProgress(job); });
     } else {
-        // Vosk
-        QString modelName = speech_model->currentText();
-        connect(m_speechJob.get(), &QProcess::readyReadStandardOutput, this, &SpeechDialog::slotProcessProgress);
-        const QStringList voskArgs = {m_stt->subtitleScript(),
-                                      QStringLiteral("--model_directory=%1").arg(modelDirectory),
-                                      QStringLiteral("--model=%1").arg(modelName),
-                                      QStringLiteral("--src=\"%1\"").arg(audio),
-                                      QStringLiteral("--output=%1").arg(m_tmpSrtPath),
-                                      QStringLiteral("--ffmpeg_path=%1").arg(KdenliveSettings::ffmpegpath())};
-        qDebug() << "::: STARTING VOSK JOB: " << voskArgs;
-        m_speechJob->start(m_stt->venvPythonExecs().python, voskArgs);
+        connect(process, &QProcess::readyReadStandardOutput, this, [this, job]() { slotProcessProgress(job); });
+    }
+    if (job->feeder) {
+        connect(process, &QProcess::started, job->feeder.get(), [job]() { job->feeder->start(job->process.get()); });
+        connect(job->feeder.get(), &SpeechAudioFeeder::finished, this, [this, job](bool success) {
+            if (!success && job->process->state() != QProcess::NotRunning) {
+                m_errorLog.append(i18n("Audio export failed") + QLatin1Char('\n'));
+                job->process->kill();
+            }
+        });
+    }
+    const QStringList arguments = speechArguments(audio, job->srtPath);
+    qDebug() << "::: PASSING SPEECH ARGS: " << arguments;
+    process->start(m_stt->venvPythonExecs().python, arguments);
+}
+
+void SpeechDialog::abortJobs()
+{
+    for (auto &job : m_jobs) {
+        if (job->feeder) {
+            job->feeder->abort();
+        }
+        if (job->process && job->process->state() != QProcess::NotRunning) {
+            job->process->kill();
+        }
     }
 }
 
-void SpeechDialog::slotProcessSpeechStatus(int exitCode, QProcess::ExitStatus status)
+void SpeechDialog::slotProcessSpeechStatus(SpeechJob *job, int exitCode, QProcess::ExitStatus status)
 {
+    if (job->finished) {
+        return;
+    }
+    job->finished = true;
+    job->crashed = status == QProcess::CrashExit;
+    if (!job->crashed && (exitCode == 1 || !QFile::exists(job->srtPath))) {
+        job->error = QString::fromUtf8(job->process->readAllStandardError());
+        if (job->error.isEmpty()) {
+            job->error = i18n("No subtitle generated");
+        }
+    }
+    if (job->crashed || !job->error.isEmpty()) {
+        // The other segments are useless now
+        abortJobs();
+    }
+    for (const auto &j : m_jobs) {
+        if (!j->finished) {
+            return;
+        }
+    }
     if (!m_errorLog.isEmpty()) {
         speech_info->addAction(m_logAction);
     }
     buttonBox->button(QDialogButtonBox::Apply)->setEnabled(true);
-    if (status == QProcess::CrashExit) {
+    QStringList subtitles;
+    QVector<SpeechToText::Segment> segments;
+    QString error;
+    bool crashed = false;
+    for (const auto &j : m_jobs) {
+        crashed = crashed || j->crashed;
+        if (!j->error.isEmpty()) {
+            error = j->error;
+        }
+    }
+    if (crashed && error.isEmpty()) {
         speech_info->setMessageType(KMessageWidget::Warning);
         speech_info->setText(i18n("Speech recognition aborted."));
         speech_info->animatedShow();
+        removeSubtitleFiles();
         return;
     }
-    if (exitCode == 1 || !QFile::exists(m_tmpSrtPath)) {
+    if (!error.isEmpty()) {
         speech_info->setMessageType(KMessageWidget::Warning);
-        speech_info->setText(i18n("Speech recognition failed:\n%1", m_speechJob->readAllStandardError()));
+        speech_info->setText(i18n("Speech recognition failed:\n%1", error));
         speech_info->animatedShow();
+        removeSubtitleFiles();
         return;
     }
 
-    m_timeline->getSubtitleModel()->importSubtitle(m_tmpSrtPath, m_zone.x(), true);
+    if (m_jobs.size() == 1) {
+        m_timeline->getSubtitleModel()->importSubtitle(m_jobs.front()->srtPath, m_zone.x(), true);
+    } else {
+        // Merge the segments, in order
+        for (const auto &j : m_jobs) {
+            QFile file(j->srtPath);
+            if (file.open(QIODevice::ReadOnly)) {
+                subtitles << QString::fromUtf8(file.readAll());
+            }
+            segments << j->segment;
+        }
+        QTemporaryFile merged(QDir::temp().absoluteFilePath(QStringLiteral("XXXXXX.srt")));
+        if (!merged.open() || merged.write(SpeechToText::mergeSubtitles(segments, subtitles, pCore->getCurrentFps()).toUtf8()) < 0) {
+            speech_info->setMessageType(KMessageWidget::Warning);
+            speech_info->setText(i18n("Cannot create temporary file."));
+            removeSubtitleFiles();
+            return;
+        }
+        merged.close();
+        m_timeline->getSubtitleModel()->importSubtitle(merged.fileName(), m_zone.x(), true);
+    }
     speech_info->setMessageType(KMessageWidget::Positive);
     speech_info->setText(i18n("Subtitles imported"));
-    QFile::remove(m_tmpSrtPath);
+    removeSubtitleFiles();
     frame_progress->setVisible(false);
 }
 
-void SpeechDialog::slotProcessProgress()
+void SpeechDialog::removeSubtitleFiles()
+{
+    for (const auto &job : m_jobs) {
+        QFile::remove(job->srtPath);
+    }
+}
+
+void SpeechDialog::updateProgress()
+{
+    int progress = 0;
+    for (const auto &job : m_jobs) {
+        progress += job->finished ? 100 : job->progress;
+    }
+    speech_progress->setValue(m_jobs.empty() ? 0 : progress / int(m_jobs.size()));
+}
+
+void SpeechDialog::slotProcessProgress(SpeechJob *job)
 {
-    const QString saveData = QString::fromUtf8(m_speechJob->readAll());
+    const QString saveData = QString::fromUtf8(job->process->readAll());
     if (saveData.startsWith(QStringLiteral("progress:"))) {
         double prog = saveData.section(QLatin1Char(':'), 1).toInt() * 3.12;
-        speech_progress->setValue(static_cast<int>(100 * prog / m_duration));
+        const int duration = qMax(1, job->segment.zone.y() - job->segment.zone.x());
+        job->progress = qMin(100, static_cast<int>(100 * prog / duration));
+        updateProgress();
     }
 }
 
-void SpeechDialog::slotProcessWhisperProgress()
+void SpeechDialog::slotProcessWhisperProgress(SpeechJob *job)
 {
-    const QString saveData = QString::fromUtf8(m_speechJob->readAll());
+    const QString saveData = QString::fromUtf8(job->process->readAll());
     qDebug() << ":::: GOT SCRIPT OUTPUT: " << saveData;
     if (saveData.contains(QStringLiteral("UserWarning:"))) {
         const QString log = saveData.section(QStringLiteral("UserWarning:"), 1).section(QLatin1String("warnings.warn"), 0, 0).simplified() + QLatin1Char('\n');
@@ -480,7 +643,8 @@ void SpeechDialog::slotProcessWhisperProgress()
     }
     if (saveData.contains(QStringLiteral("%|"))) {
         int prog = saveData.section(QLatin1Char('%'), 0, 0).toInt();
-        speech_progress->setValue(prog);
+        job->progress = prog;
+        updateProgress();
         if (translate_seamless->isChecked() && prog == 0) {
             if (saveData.contains(QStringLiteral("translating"))) {
                 speech_info->setText(i18n("Translating text to %1", seamless_out->currentText()));
@@ -9,9 +9,9 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "ui_speechdialog_ui.h"
 #include "timeline2/model/timelineitemmodel.hpp"
 #include "definitions.h"
+#include "pythoninterfaces/speechaudiofeeder.h"
 #include "pythoninterfaces/speechtotext.h"
 
-
 #include <QProcess>
 #include <QTemporaryFile>
 
@@ -33,25 +33,44 @@ public:
     ~SpeechDialog() override;
 
 private:
-    std::unique_ptr<QProcess> m_speechJob;
+    /** @brief A recognizer process working on a segment of the zone */
+    struct SpeechJob
+    {
+        std::unique_ptr<QProcess> process;
+        /** @brief Streams the audio of the segment to the process, null if the audio was rendered to a file */
+        std::unique_ptr<SpeechAudioFeeder> feeder;
+        SpeechToText::Segment segment;
+        QString srtPath;
+        QString error;
+        int progress{0};
+        bool finished{false};
+        bool crashed{false};
+    };
     const std::shared_ptr<TimelineItemModel> m_timeline;
     QButtonGroup *m_buttonGroup;
     QPoint m_zone;
     int m_tid;
-    int m_duration;
     std::unique_ptr<QTemporaryFile> m_tmpAudio;
-    QString m_tmpSrtPath;
+    std::vector<std::unique_ptr<SpeechJob>> m_jobs;
     QAction *m_speechConfig;
     QAction *m_logAction;
     QString m_errorLog;
     SpeechToText *m_stt;
     void fillSeamlessLanguages();
+    /** @brief Load the timeline scene with only the audio tracks to analyse */
+    std::unique_ptr<Mlt::Producer> loadAudioScene(const QString &sceneList);
+    /** @brief The recognizer arguments, audio is - when the audio is streamed to the process */
+    QStringList speechArguments(const QString &audio, const QString &srtPath) const;
+    void startJob(SpeechJob *job, const QString &audio);
+    void abortJobs();
+    void removeSubtitleFiles();
+    void updateProgress();
+    void slotProcessSpeechStatus(SpeechJob *job, int exitCode, QProcess::ExitStatus status);
+    void slotProcessProgress(SpeechJob *job);
+    void slotProcessWhisperProgress(SpeechJob *job);
 
 private Q_SLOTS:
     void slotProcessSpeech();
-    void slotProcessSpeechStatus(int exitCode, QProcess::ExitStatus status);
-    void slotProcessProgress();
-    void slotProcessWhisperProgress();
     void buildSpeechModelsList(SpeechToTextEngine::EngineType engine, const QStringList models);
     void checkDeps();
 };
@@ -12,6 +12,7 @@
 #include "kdenlivesettings.h"
 #include "mainwindow.h"
 #include "monitor/monitor.h"
+#include "pythoninterfaces/speechaudiofeeder.h"
 #include "timeline2/view/timelinecontroller.h"
 #include "timeline2/view/timelinewidget.h"
 #include "widgets/timecodedisplay.h"
@@ -37,6 +38,7 @@
 #include <QToolButton>
 
 #include <memory>
+#include <mlt++/MltProducer.h>
 
 VideoTextEdit::VideoTextEdit(QWidget *parent)
     : QTextEdit(parent)
@@ -731,6 +733,9 @@ TextBasedEdit::TextBasedEdit(QWidget *parent)
     connect(button_start, &QPushButton::clicked, this, &TextBasedEdit::startRecognition);
     frame_progress->setVisible(false);
     connect(button_abort, &QToolButton::clicked, this, [this]() {
+        if (m_audioFeeder) {
+            m_audioFeeder->abort();
+        }
         if (m_speechJob && m_speechJob->state() == QProcess::Running) {
             m_speechJob->kill();
         } else if (m_tCodeJob && m_tCodeJob->state() == QProcess::Running) {
@@ -1019,6 +1024,7 @@ void TextBasedEdit::buildWhisperModelsList(const QStringList whisperModels)
 
 TextBasedEdit::~TextBasedEdit()
 {
+    m_audioFeeder.reset();
     if (m_speechJob && m_speechJob->state() == QProcess::Running) {
         m_speechJob->kill();
         m_speechJob->waitForFinished();
@@ -1094,6 +1100,7 @@ void TextBasedEdit::startRecognition()
         return;
     }
 
+    m_audioFeeder.reset();
     m_speechJob = std::make_unique<QProcess>(this);
     showMessage(i18n("Starting speech recognition"), KMessageWidget::Information);
     qApp->processEvents();
@@ -1140,7 +1147,53 @@ void TextBasedEdit::startRecognition()
         return;
     }
     clipNameLabel->setText(clipName);
-    if (clip->clipType() == ClipType::Playlist) {
+    if (clip->clipType() == ClipType::Playlist && KdenliveSettings::speechStreaming()) {
+        // Stream the sequence audio to the recognizer instead of extracting it to a wav file
+        std::unique_ptr<Mlt::Producer> producer;
+        {
+            QReadLocker lock(&pCore->xmlMutex);
+            producer = std::make_unique<Mlt::Producer>(pCore->getProjectProfile(), "xml", m_sourceUrl.toUtf8().constData());
+        }
+        if (!producer->is_valid()) {
+            showMessage(i18n("Audio extract failed."), KMessageWidget::Warning);
+            return;
+        }
+        if (endPos > 0) {
+            // Only stream the zone, the recognizer timestamps are relative to its start
+            const int in = GenTime(m_clipOffset).frames(pCore->getCurrentFps());
+            producer->set_in_and_out(in, in + GenTime(m_clipDuration).frames(pCore->getCurrentFps()) - 1);
+        }
+        m_audioFeeder = std::make_unique<SpeechAudioFeeder>(std::move(producer));
+        showMessage(i18n("Starting speech recognition on %1.", clipName), KMessageWidget::Information);
+        connect(m_speechJob.get(), &QProcess::readyReadStandardError, this, &TextBasedEdit::slotProcessSpeechError);
+        connect(m_speechJob.get(), static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this,
+                &TextBasedEdit::slotProcessSpeechStatus);
+        connect(m_speechJob.get(), &QProcess::started, m_audioFeeder.get(), [this]() { m_audioFeeder->start(m_speechJob.get()); });
+        QStringList args;
+        if (KdenliveSettings::speechEngine() == QLatin1String("whisper")) {
+            // Whisper
+            connect(m_speechJob.get(), &QProcess::readyReadStandardOutput, this, &TextBasedEdit::slotProcessWhisperSpeech);
+            args = {m_stt->speechScript(),
+                    QStringLiteral("--src=-"),
+                    QStringLiteral("--model=%1").arg(modelName),
+                    QStringLiteral("--task=%1")
+                        .arg(KdenliveSettings::whisperTranslate() && m_translateAction->isEnabled() ? QStringLiteral("translate") : QStringLiteral("transcribe")),
+                    QStringLiteral("--language=%1").arg(language),
+                    QStringLiteral("--ffmpeg_path=%1").arg(KdenliveSettings::ffmpegpath())};
+            if (!KdenliveSettings::whisperDevice().isEmpty()) {
+                args << QStringLiteral("--device=%1").arg(KdenliveSettings::whisperDevice());
+            }
+        } else {
+            // VOSK
+            connect(m_speechJob.get(), &QProcess::readyReadStandardOutput, this, &TextBasedEdit::slotProcessSpeech);
+            args = {m_stt->speechScript(), QStringLiteral("--model_directory=%1").arg(modelDirectory), QStringLiteral("--model=%1").arg(modelName),
+                    QStringLiteral("--src=-")};
+        }
+        qDebug() << ":::: STARTING SPEECH COMMAND: " << args;
+        m_speechJob->start(m_stt->venvPythonExecs().python, args);
+        speech_progress->setValue(0);
+        frame_progress->setVisible(true);
+    } else if (clip->clipType() == ClipType::Playlist) {
         // We need to extract audio first
         m_playlistWav.remove();
         m_playlistWav.setFileTemplate(QDir::temp().absoluteFilePath(QStringLiteral("kdenlive-XXXXXX.wav")));
@@ -17,6 +17,8 @@
 #include <QTimer>
 #include <QTemporaryFile>
 
+class SpeechAudioFeeder;
+
 class ProjectClip;
 
 /**
@@ -180,6 +182,8 @@ protected:
 private:
     std::unique_ptr<QProcess> m_speechJob;
     std::unique_ptr<QProcess> m_tCodeJob;
+    /** @brief Streams the audio of a sequence clip to the speech job */
+    std::unique_ptr<SpeechAudioFeeder> m_audioFeeder;
     /** @brief Id of the master bin clip on which speech processing is done */
     QString m_binId;
     /** @brief Id of the playlist which is processed from the master clip */
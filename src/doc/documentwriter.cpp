@@ -0,0 +1,239 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "documentwriter.h"
+#include "kdenlivesettings.h"
+
+#include "kdenlive_debug.h"
+#include <KCompressionDevice>
+#include <KLocalizedString>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+
+// Size of the blocks written to disk, used for progress report
+static const qint64 writeBlockSize = 1024 * 1024;
+
+DocumentWriter::DocumentWriter(QObject *parent)
+    : QObject(parent)
+    , m_failed(false)
+{
+    // Jobs must be processed in order
+    m_pool.setMaxThreadCount(1);
+}
+
+DocumentWriter::~DocumentWriter()
+{
+    waitForFinished();
+}
+
+void DocumentWriter::save(const SaveJob &job)
+{
+    m_pool.start([this, job]() {
+        QThread::currentThread()->setPriority(QThread::LowPriority);
+        processJob(job);
+    });
+}
+
+bool DocumentWriter::waitForFinished()
+{
+    m_pool.waitForDone();
+    return !m_failed.exchange(false);
+}
+
+void DocumentWriter::processJob(const SaveJob &job)
+{
+    // Every exit path must end the progress report and emit the result, the document waits for it
+    auto finish = [this, &job](const QString &error) {
+        if (!error.isEmpty()) {
+            m_failed = true;
+        }
+        Q_EMIT progress(100);
+        Q_EMIT saved(job.path, error);
+    };
+    Q_EMIT progress(0);
+    if (!job.backupBaseName.isEmpty()) {
+        const QString error = backupFile(job.path, job.backupBaseName, job.subtitleFiles);
+        if (!error.isEmpty()) {
+            // A failed backup should not prevent saving the project
+            qCWarning(KDENLIVE_LOG) << error;
+        }
+    }
+    Q_EMIT progress(10);
+    // QSaveFile writes to a temporary file, syncs it to disk and renames it on commit
+    QSaveFile file(job.path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qCWarning(KDENLIVE_LOG) << "//////  ERROR writing to file: " << job.path;
+        finish(i18n("Cannot write to file %1", job.path));
+        return;
+    }
+    const qint64 total = job.data.size();
+    qint64 written = 0;
+    while (written < total) {
+        qint64 result = file.write(job.data.constData() + written, qMin(writeBlockSize, total - written));
+        if (result < 0) {
+            file.cancelWriting();
+            break;
+        }
+        written += result;
+        Q_EMIT progress(10 + int(80 * written / qMax(qint64(1), total)));
+    }
+    if (!file.commit()) {
+        qCWarning(KDENLIVE_LOG) << "//////  ERROR writing to file: " << job.path << file.errorString();
+        finish(i18n("Cannot write to file %1", job.path));
+        return;
+    }
+    if (!job.backupBaseName.isEmpty()) {
+        cleanupBackupFiles(job.backupBaseName);
+    }
+    finish(QString());
+}
+
+QDir DocumentWriter::backupFolder()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/.backup"));
+}
+
+QString DocumentWriter::backupFile(const QString &path, const QString &backupBaseName, const QStringList &subtitleFiles)
+{
+    if (path.isEmpty()) {
+        return QString();
+    }
+    QFileInfo info(path);
+    if (!info.exists()) {
+        return QString();
+    }
+    QDir folder = backupFolder();
+    const QString timeStamp = info.lastModified().toString(QStringLiteral("yyyy-MM-dd-hh-mm"));
+    const QString fileName = QStringLiteral("%1-%2.kdenlive").arg(backupBaseName, timeStamp);
+    QString backupPath = folder.absoluteFilePath(fileName);
+    // delete previous backup if it was done less than 60 seconds ago
+    QFile::remove(backupPath);
+    QFile::remove(backupPath + QStringLiteral(".gz"));
+    QString error;
+    if (KdenliveSettings::compressbackups()) {
+        backupPath.append(QStringLiteral(".gz"));
+        QFile source(path);
+        KCompressionDevice target(backupPath, KCompressionDevice::GZip);
+        bool success = source.open(QIODevice::ReadOnly) && target.open(QIODevice::WriteOnly);
+        while (success && !source.atEnd()) {
+            const QByteArray block = source.read(writeBlockSize);
+            success = target.write(block) == block.size();
+        }
+        target.close();
+        if (!success) {
+            QFile::remove(backupPath);
+            error = i18n("Cannot create backup copy:\n%1", backupPath);
+        }
+    } else if (!QFile::copy(path, backupPath)) {
+        error = i18n("Cannot create backup copy:\n%1", backupPath);
+    }
+    // backup subtitle file in case we have one
+    if (!subtitleFiles.isEmpty()) {
+        // Create folder for subtitles backup
+        folder.mkpath(timeStamp);
+        folder.cd(timeStamp);
+        for (auto &s : subtitleFiles) {
+            QFileInfo subInfo(s);
+            if (subInfo.exists()) {
+                const QString targetPath = folder.absoluteFilePath(subInfo.fileName());
+                if (QFileInfo::exists(targetPath)) {
+                    // Remove backup if it was created less than 60 seconds ago
+                    QFile::remove(targetPath);
+                }
+                if (!QFile::copy(s, targetPath)) {
+                    error = i18n("Cannot create backup copy:\n%1", targetPath);
+                }
+            }
+        }
+    }
+    return error;
+}
+
+QStringList DocumentWriter::backupFilters(const QString &backupBaseName)
+{
+    const QString pattern = backupBaseName + QStringLiteral("-????-??-??-??-??.kdenlive");
+    return {pattern, pattern + QStringLiteral(".gz")};
+}
+
+QString DocumentWriter::backupPreviewBase(const QString &backupPath)
+{
+    if (backupPath.endsWith(QStringLiteral(".gz"))) {
+        return backupPath.chopped(3);
+    }
+    return backupPath;
+}
+
+QString DocumentWriter::uncompressedBackup(const QString &path)
+{
+    if (!path.endsWith(QStringLiteral(".gz"))) {
+        return path;
+    }
+    KCompressionDevice source(path, KCompressionDevice::GZip);
+    if (!source.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    const QString target = QDir::temp().absoluteFilePath(QFileInfo(backupPreviewBase(path)).fileName());
+    QFile file(target);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return QString();
+    }
+    while (!source.atEnd()) {
+        file.write(source.read(writeBlockSize));
+    }
+    file.close();
+    return target;
+}
+
+void DocumentWriter::cleanupBackupFiles(const QString &backupBaseName)
+{
+    QDir folder = backupFolder();
+    folder.setNameFilters(backupFilters(backupBaseName));
+    QFileInfoList resultList = folder.entryInfoList(QDir::Files, QDir::Time);
+
+    QDateTime d = QDateTime::currentDateTime();
+    QStringList hourList;
+    QStringList dayList;
+    QStringList weekList;
+    QStringList oldList;
+    for (int i = 0; i < resultList.count(); ++i) {
+        if (d.secsTo(resultList.at(i).lastModified()) < 3600) {
+            // files created in the last hour
+            hourList.append(resultList.at(i).absoluteFilePath());
+        } else if (d.secsTo(resultList.at(i).lastModified()) < 43200) {
+            // files created in the day
+            dayList.append(resultList.at(i).absoluteFilePath());
+        } else if (d.daysTo(resultList.at(i).lastModified()) < 8) {
+            // files created in the week
+            weekList.append(resultList.at(i).absoluteFilePath());
+        } else {
+            // older files
+            oldList.append(resultList.at(i).absoluteFilePath());
+        }
+    }
+    QStringList toRemove;
+    for (QStringList *list : {&hourList, &dayList, &weekList, &oldList}) {
+        if (list->count() > 20) {
+            // Keep one file out of step
+            int step = list->count() / 10;
+            for (int i = 0; i < list->count(); i += step) {
+                list->removeAt(i);
+                --i;
+            }
+            toRemove << *list;
+        }
+    }
+    for (const QString &f : std::as_const(toRemove)) {
+        QFile::remove(f);
+        const QString base = backupPreviewBase(f);
+        QFile::remove(base + QStringLiteral(".png"));
+        QFile::remove(base + QStringLiteral(".jpg"));
+        QFile::remove(base + QStringLiteral(".srt"));
+        QFile::remove(base + QStringLiteral(".ass"));
+    }
+}
@@ -0,0 +1,62 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QDir>
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+
+/** @class DocumentWriter
+    @brief Writes project files and their backup copies in a low priority background thread, so that saving does not block the UI.
+    Jobs are processed in order. Project files are written to a temporary file that is synced to disk and atomically renamed.
+ */
+class DocumentWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct SaveJob
+    {
+        /** @brief The project file to write */
+        QString path;
+        QByteArray data;
+        /** @brief Backup file name prefix (project name and document id), empty to skip the backup */
+        QString backupBaseName;
+        /** @brief Subtitle files to backup along with the project */
+        QStringList subtitleFiles;
+    };
+    explicit DocumentWriter(QObject *parent = nullptr);
+    ~DocumentWriter() override;
+    /** @brief Queue a save operation */
+    void save(const SaveJob &job);
+    /** @brief Block until all queued operations are done, returns false if one of them failed since the last call */
+    bool waitForFinished();
+    /** @brief The folder where project backups are stored */
+    static QDir backupFolder();
+    /** @brief Copy the project file in the backup folder, compressed if enabled
+     *  @return an error message, empty on success */
+    static QString backupFile(const QString &path, const QString &backupBaseName, const QStringList &subtitleFiles);
+    /** @brief Remove old backups of a project, keeping fewer files as they get older */
+    static void cleanupBackupFiles(const QString &backupBaseName);
+    /** @brief Name filters matching the backups of a project, plain and compressed */
+    static QStringList backupFilters(const QString &backupBaseName);
+    /** @brief Returns the path of the backup file without compression suffix */
+    static QString backupPreviewBase(const QString &backupPath);
+    /** @brief If path is a compressed backup, extract it to a temporary file and return its path. Otherwise return path */
+    static QString uncompressedBackup(const QString &path);
+
+Q_SIGNALS:
+    void progress(int percent);
+    /** @brief Emitted when a save operation finished, error is empty on success */
+    void saved(const QString &path, const QString &error);
+
+private:
+    QThreadPool m_pool;
+    std::atomic<bool> m_failed;
+    void processJob(const SaveJob &job);
+};
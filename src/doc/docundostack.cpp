@@ -4,12 +4,39 @@
 */
 
 #include "docundostack.hpp"
+#include "kdenlivesettings.h"
+#include "undohelper.hpp"
 #include <QUndoCommand>
 #include <QUndoGroup>
 
+// Always keep this count of most recent commands, whatever their size
+static const int minimumKeptCommands = 10;
+
 DocUndoStack::DocUndoStack(QUndoGroup *parent)
     : QUndoStack(parent)
+    , m_memoryBudget(qint64(KdenliveSettings::undomemorylimit()) * 1024 * 1024)
+    , m_memoryUsage(0)
+    , m_releasedCount(0)
+    , m_generation(0)
+    , m_mergeSession(-1)
+    , m_lastMergeSession(0)
+    , m_pushing(false)
 {
+    connect(this, &QUndoStack::indexChanged, this, [this]() {
+        m_generation++;
+        if (!m_pushing) {
+            // An undo or redo breaks the current merge session
+            m_mergeSession = -1;
+        }
+        if (count() == 0) {
+            // Stack was cleared
+            m_releasedCount = 0;
+            m_memoryUsage = 0;
+        } else if (index() < m_releasedCount) {
+            // Released commands cannot be undone, go back to the oldest undoable state. Released commands are no-ops so this does not touch the project
+            setIndex(m_releasedCount);
+        }
+    });
 }
 
 // TODO: custom undostack everywhere do that
@@ -18,5 +45,89 @@ void DocUndoStack::push(QUndoCommand *cmd)
     if (index() < count()) {
         Q_EMIT invalidate(index());
     }
+    // The commands after the current index are deleted and the last one might be merged with the new command
+    const int first = qMax(0, index() - 1);
+    for (int i = first; i < count(); ++i) {
+        m_memoryUsage -= FunctionalUndoCommand::estimateCost(command(i));
+    }
+    m_pushing = true;
     QUndoStack::push(cmd);
+    m_pushing = false;
+    for (int i = first; i < count(); ++i) {
+        m_memoryUsage += FunctionalUndoCommand::estimateCost(command(i));
+    }
+    // A merged command does not change the index
+    m_generation++;
+    m_releasedCount = qMin(m_releasedCount, count());
+    compact();
+}
+
+qint64 DocUndoStack::memoryUsage() const
+{
+    return m_memoryUsage;
+}
+
+int DocUndoStack::releasedCount() const
+{
+    return m_releasedCount;
+}
+
+bool DocUndoStack::undoAvailable() const
+{
+    return canUndo() && index() > m_releasedCount;
+}
+
+quint64 DocUndoStack::generation() const
+{
+    return m_generation;
+}
+
+void DocUndoStack::setMemoryBudget(qint64 bytes)
+{
+    m_memoryBudget = bytes;
+    compact();
+}
+
+int DocUndoStack::beginMergeSession()
+{
+    m_mergeSession = ++m_lastMergeSession;
+    return m_mergeSession;
+}
+
+void DocUndoStack::endMergeSession()
+{
+    m_mergeSession = -1;
+}
+
+int DocUndoStack::mergeSession() const
+{
+    return m_mergeSession;
+}
+
+static void releaseCommand(const QUndoCommand *command)
+{
+    // Commands are owned by the stack, we are allowed to modify them
+    if (auto *functional = dynamic_cast<FunctionalUndoCommand *>(const_cast<QUndoCommand *>(command))) {
+        functional->releaseMemory();
+    }
+    for (int i = 0; i < command->childCount(); ++i) {
+        releaseCommand(command->child(i));
+    }
+}
+
+void DocUndoStack::compact()
+{
+    if (m_memoryBudget > 0 && m_memoryUsage > m_memoryBudget) {
+        // Released commands must stay a contiguous block at the bottom of the stack so that undo never skips a step
+        int limit = qMin(count(), index()) - minimumKeptCommands;
+        while (m_memoryUsage > m_memoryBudget && m_releasedCount < limit) {
+            auto *cmd = const_cast<QUndoCommand *>(command(m_releasedCount));
+            qint64 cost = FunctionalUndoCommand::estimateCost(cmd);
+            // The command stays on the stack so that indexes remain stable, it only becomes a no-op
+            releaseCommand(cmd);
+            m_memoryUsage -= cost - FunctionalUndoCommand::estimateCost(cmd);
+            m_releasedCount++;
+        }
+    }
+    Q_EMIT memoryUsageChanged(m_memoryUsage);
 }
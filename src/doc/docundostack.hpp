@@ -16,6 +16,37 @@ class DocUndoStack : public QUndoStack
 public:
     explicit DocUndoStack(QUndoGroup *parent = Q_NULLPTR);
     void push(QUndoCommand *cmd);
+    /** @brief Returns the estimated memory used by the stored undo commands, in bytes */
+    qint64 memoryUsage() const;
+    /** @brief Returns the number of oldest commands that were discarded to stay in the memory budget */
+    int releasedCount() const;
+    /** @brief Returns true if the previous command can be undone, released commands cannot */
+    bool undoAvailable() const;
+    /** @brief Set the maximum memory used by undo history, in bytes. 0 means unlimited */
+    void setMemoryBudget(qint64 bytes);
+    /** @brief Returns a counter increased on each push, undo or redo, allowing to check that the project did not change */
+    quint64 generation() const;
+    /** @brief Start a merge session (for example a slider drag): the following mergeable commands with the same text are merged in one undo entry */
+    int beginMergeSession();
+    /** @brief End the current merge session, the next mergeable command starts a new undo entry */
+    void endMergeSession();
+    /** @brief Returns the id of the current merge session, or -1 if commands should not be merged */
+    int mergeSession() const;
+
+private:
+    qint64 m_memoryBudget;
+    /** @brief Running total of the commands memory cost */
+    qint64 m_memoryUsage;
+    /** @brief The commands before this index had their data released, they cannot be undone anymore */
+    int m_releasedCount;
+    quint64 m_generation;
+    int m_mergeSession;
+    int m_lastMergeSession;
+    bool m_pushing;
+    /** @brief Free the data of the oldest commands until we fit in the memory budget */
+    void compact();
+
 Q_SIGNALS:
     void invalidate(int ix);
+    void memoryUsageChanged(qint64 bytes);
 };
@@ -19,6 +19,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "dialogs/profilesdialog.h"
 #include "documentchecker.h"
 #include "documentvalidator.h"
+#include "documentwriter.h"
 #include "docundostack.hpp"
 #include "effects/effectsrepository.hpp"
 #include "kdenlivesettings.h"
@@ -39,6 +40,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <KJobWidgets>
 #include <KLocalizedString>
 #include <KMessageBox>
+#include <KNotification>
 
 #include "kdenlive_debug.h"
 #include <QCryptographicHash>
@@ -75,12 +77,14 @@ KdenliveDoc::KdenliveDoc(QString projectFolder, QUndoGroup *undoGroup, const QSt
     : QObject(parent)
     , m_autosave(nullptr)
     , m_uuid(QUuid::createUuid())
+    , m_sessionId(QUuid::createUuid())
     , m_clipsCount(0)
     , m_commandStack(std::make_shared<DocUndoStack>(undoGroup))
     , m_modified(false)
     , m_documentOpenStatus(CleanProject)
     , m_url(QUrl())
     , m_projectFolder(std::move(projectFolder))
+    , m_previewLocalCache(KdenliveSettings::previewlocalcache())
 {
     next_id = 0;
     if (parent) {
@@ -88,6 +92,8 @@ KdenliveDoc::KdenliveDoc(QString projectFolder, QUndoGroup *undoGroup, const QSt
     }
     connect(m_commandStack.get(), &QUndoStack::indexChanged, this, &KdenliveDoc::slotModified);
     connect(m_commandStack.get(), &DocUndoStack::invalidate, this, &KdenliveDoc::checkPreviewStack, Qt::DirectConnection);
+    // Deleted undo commands release their references to the track producers
+    connect(m_commandStack.get(), &QUndoStack::indexChanged, pCore->projectItemModel().get(), &ProjectItemModel::releaseIdleProducers);
     pCore->taskManager.unBlock();
     initializeProperties(true, tracks, audioChannels);
 
@@ -115,6 +121,7 @@ KdenliveDoc::KdenliveDoc(const QUrl &url, QDomDocument &newDom, QString projectF
     : QObject(parent)
     , m_autosave(nullptr)
     , m_uuid(QUuid::createUuid())
+    , m_sessionId(QUuid::createUuid())
     , m_document(newDom)
     , m_clipsCount(0)
     , m_commandStack(std::make_shared<DocUndoStack>(undoGroup))
@@ -122,6 +129,7 @@ KdenliveDoc::KdenliveDoc(const QUrl &url, QDomDocument &newDom, QString projectF
     , m_documentOpenStatus(CleanProject)
     , m_url(url)
     , m_projectFolder(std::move(projectFolder))
+    , m_previewLocalCache(KdenliveSettings::previewlocalcache())
 {
     next_id = 0;
     if (parent) {
@@ -129,6 +137,8 @@ KdenliveDoc::KdenliveDoc(const QUrl &url, QDomDocument &newDom, QString projectF
     }
     connect(m_commandStack.get(), &QUndoStack::indexChanged, this, &KdenliveDoc::slotModified);
     connect(m_commandStack.get(), &DocUndoStack::invalidate, this, &KdenliveDoc::checkPreviewStack, Qt::DirectConnection);
+    // Deleted undo commands release their references to the track producers
+    connect(m_commandStack.get(), &QUndoStack::indexChanged, pCore->projectItemModel().get(), &ProjectItemModel::releaseIdleProducers);
     pCore->taskManager.unBlock();
     initializeProperties(false);
     updateClipsCount();
@@ -138,9 +148,11 @@ KdenliveDoc::KdenliveDoc(std::shared_ptr<DocUndoStack> undoStack, std::pair<int,
     : QObject(parent)
     , m_autosave(nullptr)
     , m_uuid(QUuid::createUuid())
+    , m_sessionId(QUuid::createUuid())
     , m_clipsCount(0)
     , m_modified(false)
     , m_documentOpenStatus(CleanProject)
+    , m_previewLocalCache(KdenliveSettings::previewlocalcache())
 {
     next_id = 0;
     m_commandStack = undoStack;
@@ -315,6 +327,8 @@ DocOpenResult KdenliveDoc::Open(const QUrl &url, const QString &projectFolder, Q
 
 KdenliveDoc::~KdenliveDoc()
 {
+    // Make sure pending save operations are finished
+    waitForSave();
     if (m_url.isEmpty()) {
         // Document was never saved, delete cache folder
         QString documentId = QDir::cleanPath(m_documentProperties.value(QStringLiteral("documentid")));
@@ -719,7 +733,7 @@ QDomDocument KdenliveDoc::xmlSceneList(const QString &scene)
     return sceneList;
 }
 
-bool KdenliveDoc::saveSceneList(const QString &path, const QString &scene, bool saveOverExistingFile)
+bool KdenliveDoc::saveSceneList(const QString &path, const QString &scene, bool saveOverExistingFile, bool markClean, bool synchronous)
 {
     QDomDocument sceneList = xmlSceneList(scene);
     if (sceneList.isNull()) {
@@ -727,10 +741,15 @@ bool KdenliveDoc::saveSceneList(const QString &path, const QString &scene, bool
         KMessageBox::error(QApplication::activeWindow(), i18n("Cannot write to file %1, scene list is corrupted.", path));
         return false;
     }
-
-    // Backup current version
-    backupLastSavedVersion(path);
+    const QString backupBaseName = QFileInfo(path).completeBaseName() + QLatin1Char('-') + m_documentProperties.value(QStringLiteral("documentid"));
+    const bool backgroundSave = KdenliveSettings::backgroundsave() && !synchronous;
+    if (!backgroundSave) {
+        // Backup current version
+        backupLastSavedVersion(path);
+    }
     if (m_documentOpenStatus != CleanProject && saveOverExistingFile) {
+        // The previous version must be on disk before we copy it
+        waitForSave();
         // create visible backup file and warn user
         QString baseFile = path.section(QStringLiteral(".kdenlive"), 0, 0);
         int ct = 0;
@@ -760,6 +779,21 @@ bool KdenliveDoc::saveSceneList(const QString &path, const QString &scene, bool
                      backupFile));
         }
     }
+    const QByteArray sceneData = sceneList.toString().toUtf8();
+    if (backgroundSave) {
+        // Backup, write and backup rotation are done in a background thread
+        if (m_writer == nullptr) {
+            m_writer = new DocumentWriter(this);
+            connect(m_writer, &DocumentWriter::progress, this,
+                    [](int percent) { pCore->displayMessage(i18n("Saving project"), percent < 100 ? ProcessingJobMessage : OperationCompletedMessage, percent); });
+            connect(m_writer, &DocumentWriter::saved, this, &KdenliveDoc::slotSaveFinished, Qt::QueuedConnection);
+        }
+        m_pendingSaves.append({markClean, m_commandStack->generation()});
+        m_writer->save({path, sceneData, backupBaseName, getAllSubtitlesPath(true)});
+        return true;
+    }
+    // Previous background saves must not overwrite this file afterwards
+    waitForSave();
     QSaveFile file(path);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
         qCWarning(KDENLIVE_LOG) << "//////  ERROR writing to file: " << path;
@@ -767,22 +801,50 @@ bool KdenliveDoc::saveSceneList(const QString &path, const QString &scene, bool
         return false;
     }
 
-    const QByteArray sceneData = sceneList.toString().toUtf8();
-
     file.write(sceneData);
     if (!file.commit()) {
         KMessageBox::error(QApplication::activeWindow(), i18n("Cannot write to file %1", path));
         return false;
     }
     (void)QtConcurrent::run(&KdenliveDoc::cleanupBackupFiles, this);
+    m_pendingSaves.append({markClean, m_commandStack->generation()});
+    slotSaveFinished(path, QString());
+    return true;
+}
+
+void KdenliveDoc::slotSaveFinished(const QString &path, const QString &error)
+{
+    const std::pair<bool, quint64> saveInfo = m_pendingSaves.isEmpty() ? std::make_pair(false, quint64(0)) : m_pendingSaves.takeFirst();
+    if (!error.isEmpty()) {
+        KNotification::event(QStringLiteral("ErrorMessage"), i18n("Saving project file <br><b>%1</B> failed", path), QPixmap());
+        KMessageBox::error(QApplication::activeWindow(), error);
+        // The document was not saved
+        setModified(true);
+        return;
+    }
+    if (saveInfo.first && saveInfo.second == m_commandStack->generation()) {
+        // The file matches the current state of the document
+        setModified(false);
+        m_commandStack->setClean();
+    }
+    KNotification::event(QStringLiteral("SaveSuccess"), i18n("Saving successful"), QPixmap());
     QFileInfo info(path);
     QString fileName = info.completeBaseName();
     const QString timeStamp = info.lastModified().toString(QStringLiteral("yyyy-MM-dd-hh-mm"));
     fileName.append(QLatin1Char('-') + m_documentProperties.value(QStringLiteral("documentid")));
     fileName.append(QStringLiteral("-%1.kdenlive.jpg").arg(timeStamp));
-    QDir backupFolder(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/.backup"));
-    Q_EMIT pCore->saveTimelinePreview(backupFolder.absoluteFilePath(fileName));
-    return true;
+    Q_EMIT pCore->saveTimelinePreview(DocumentWriter::backupFolder().absoluteFilePath(fileName));
+}
+
+bool KdenliveDoc::waitForSave()
+{
+    if (m_writer == nullptr) {
+        return true;
+    }
+    bool result = m_writer->waitForFinished();
+    // Process the queued results now, they would be lost if the document is closed
+    QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+    return result;
 }
 
 QString KdenliveDoc::projectTempFolder() const
@@ -1422,154 +1484,22 @@ double KdenliveDoc::getDisplayRatio(const QString &path)
 
 void KdenliveDoc::backupLastSavedVersion(const QString &path)
 {
-    // Ensure backup folder exists
     if (path.isEmpty()) {
         return;
     }
-    QFile file(path);
-    QDir backupFolder(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/.backup"));
-    QString fileName = QFileInfo(path).completeBaseName();
-    QFileInfo info(file);
-    fileName.append(QLatin1Char('-') + m_documentProperties.value(QStringLiteral("documentid")));
-    const QString timeStamp = info.lastModified().toString(QStringLiteral("yyyy-MM-dd-hh-mm"));
-    fileName.append(QStringLiteral("-%1.kdenlive").arg(timeStamp));
-    QString backupFile = backupFolder.absoluteFilePath(fileName);
-    if (file.exists()) {
-        // delete previous backup if it was done less than 60 seconds ago
-        QFile::remove(backupFile);
-        if (!QFile::copy(path, backupFile)) {
-            KMessageBox::information(QApplication::activeWindow(), i18n("Cannot create backup copy:\n%1", backupFile));
-        }
-        // backup subtitle file in case we have one
-        QStringList subFiles = getAllSubtitlesPath(true);
-        if (!subFiles.isEmpty()) {
-            // Create folder for subtitles backup
-            backupFolder.mkpath(timeStamp);
-            backupFolder.cd(timeStamp);
-            for (auto &s : subFiles) {
-                QFileInfo info(s);
-                if (info.exists()) {
-                    const QString targetPath = backupFolder.absoluteFilePath(info.fileName());
-                    if (QFileInfo::exists(targetPath)) {
-                        // Remove backup if it was created less than 60 seconds ago
-                        QFile::remove(targetPath);
-                    }
-                    if (!QFile::copy(s, targetPath)) {
-                        KMessageBox::information(QApplication::activeWindow(), i18n("Cannot create backup copy:\n%1", targetPath));
-                    }
-                }
-            }
-        }
+    waitForSave();
+    const QString backupBaseName = QFileInfo(path).completeBaseName() + QLatin1Char('-') + m_documentProperties.value(QStringLiteral("documentid"));
+    const QString error = DocumentWriter::backupFile(path, backupBaseName, getAllSubtitlesPath(true));
+    if (!error.isEmpty()) {
+        KMessageBox::information(QApplication::activeWindow(), error);
     }
 }
 
 void KdenliveDoc::cleanupBackupFiles()
 {
-    QDir backupFolder(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/.backup"));
     QString projectFile = url().fileName().section(QLatin1Char('.'), 0, -2);
     projectFile.append(QLatin1Char('-') + m_documentProperties.value(QStringLiteral("documentid")));
-    projectFile.append(QStringLiteral("-??"));
-    projectFile.append(QStringLiteral("??"));
-    projectFile.append(QStringLiteral("-??"));
-    projectFile.append(QStringLiteral("-??"));
-    projectFile.append(QStringLiteral("-??"));
-    projectFile.append(QStringLiteral("-??.kdenlive"));
-
-    QStringList filter;
-    filter << projectFile;
-    backupFolder.setNameFilters(filter);
-    QFileInfoList resultList = backupFolder.entryInfoList(QDir::Files, QDir::Time);
-
-    QDateTime d = QDateTime::currentDateTime();
-    QStringList hourList;
-    QStringList dayList;
-    QStringList weekList;
-    QStringList oldList;
-    for (int i = 0; i < resultList.count(); ++i) {
-        if (d.secsTo(resultList.at(i).lastModified()) < 3600) {
-            // files created in the last hour
-            hourList.append(resultList.at(i).absoluteFilePath());
-        } else if (d.secsTo(resultList.at(i).lastModified()) < 43200) {
-            // files created in the day
-            dayList.append(resultList.at(i).absoluteFilePath());
-        } else if (d.daysTo(resultList.at(i).lastModified()) < 8) {
-            // files created in the week
-            weekList.append(resultList.at(i).absoluteFilePath());
-        } else {
-            // older files
-            oldList.append(resultList.at(i).absoluteFilePath());
-        }
-    }
-    if (hourList.count() > 20) {
-        int step = hourList.count() / 10;
-        for (int i = 0; i < hourList.count(); i += step) {
-            hourList.removeAt(i);
-            --i;
-        }
-    } else {
-        hourList.clear();
-    }
-    if (dayList.count() > 20) {
-        int step = dayList.count() / 10;
-        for (int i = 0; i < dayList.count(); i += step) {
-            dayList.removeAt(i);
-            --i;
-        }
-    } else {
-        dayList.clear();
-    }
-    if (weekList.count() > 20) {
-        int step = weekList.count() / 10;
-        for (int i = 0; i < weekList.count(); i += step) {
-            weekList.removeAt(i);
-            --i;
-        }
-    } else {
-        weekList.clear();
-    }
-    if (oldList.count() > 20) {
-        int step = oldList.count() / 10;
-        for (int i = 0; i < oldList.count(); i += step) {
-            oldList.removeAt(i);
-            --i;
-        }
-    } else {
-        oldList.clear();
-    }
-
-    QString f;
-    while (hourList.count() > 0) {
-        f = hourList.takeFirst();
-        QFile::remove(f);
-        QFile::remove(f + QStringLiteral(".png"));
-        QFile::remove(f + QStringLiteral(".jpg"));
-        QFile::remove(f + QStringLiteral(".srt"));
-        QFile::remove(f + QStringLiteral(".ass"));
-    }
-    while (dayList.count() > 0) {
-        f = dayList.takeFirst();
-        QFile::remove(f);
-        QFile::remove(f + QStringLiteral(".png"));
-        QFile::remove(f + QStringLiteral(".jpg"));
-        QFile::remove(f + QStringLiteral(".srt"));
-        QFile::remove(f + QStringLiteral(".ass"));
-    }
-    while (weekList.count() > 0) {
-        f = weekList.takeFirst();
-        QFile::remove(f);
-        QFile::remove(f + QStringLiteral(".png"));
-        QFile::remove(f + QStringLiteral(".jpg"));
-        QFile::remove(f + QStringLiteral(".srt"));
-        QFile::remove(f + QStringLiteral(".ass"));
-    }
-    while (oldList.count() > 0) {
-        f = oldList.takeFirst();
-        QFile::remove(f);
-        QFile::remove(f + QStringLiteral(".png"));
-        QFile::remove(f + QStringLiteral(".jpg"));
-        QFile::remove(f + QStringLiteral(".srt"));
-        QFile::remove(f + QStringLiteral(".ass"));
-    }
+    DocumentWriter::cleanupBackupFiles(projectFile);
 }
 
 const QMap<QString, QString> KdenliveDoc::metadata() const
@@ -2279,6 +2209,13 @@ const QDir KdenliveDoc::getCacheDir(CacheType type, bool *ok, const QUuid uuid)
         basePath = kdenliveCacheDir;
         break;
     case CachePreview:
+        if (!m_projectFolder.isEmpty() && m_previewLocalCache) {
+            // Keep the chunks on the local disk, they are read at playback speed
+            const QString localCache = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+            if (!localCache.isEmpty()) {
+                basePath = localCache + QLatin1Char('/') + documentId;
+            }
+        }
         basePath.append(QStringLiteral("/preview"));
         if (!uuid.isNull() && uuid != m_uuid) {
             basePath.append(QStringLiteral("/%1").arg(QString(QCryptographicHash::hash(uuid.toByteArray(), QCryptographicHash::Md5).toHex())));
@@ -2812,6 +2749,15 @@ void KdenliveDoc::cleanupTimelinePreview(const QDateTime &documentDate)
     }
     bool ok;
     QDir cacheDir = getCacheDir(CachePreview, &ok);
+    if (ok && !m_projectFolder.isEmpty()) {
+        // Drop the previews left in the other cache root if the local preview cache setting changed since the last session
+        const QString otherRoot = m_previewLocalCache ? m_projectFolder : QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        const QString documentId = QDir::cleanPath(m_documentProperties.value(QStringLiteral("documentid")));
+        QDir staleDir(QStringLiteral("%1/%2/preview").arg(otherRoot, documentId));
+        if (!otherRoot.isEmpty() && staleDir.exists() && staleDir.absolutePath() != cacheDir.absolutePath()) {
+            staleDir.removeRecursively();
+        }
+    }
     if (cacheDir.exists() && cacheDir.dirName() == QLatin1String("preview") && ok) {
         QFileInfoList chunksList = cacheDir.entryInfoList(QDir::Files, QDir::Time);
         for (auto &chunkFile : chunksList) {
@@ -2879,6 +2825,11 @@ const QUuid KdenliveDoc::uuid() const
     return m_uuid;
 }
 
+const QUuid &KdenliveDoc::sessionId() const
+{
+    return m_sessionId;
+}
+
 void KdenliveDoc::loadSequenceProperties(const QUuid &uuid, Mlt::Properties sequenceProps)
 {
     QMap<QString, QString> sequenceProperties = m_sequenceProperties.take(uuid);
@@ -41,6 +41,7 @@ class MarkerSortModel;
 class QUndoGroup;
 class QUndoCommand;
 class DocUndoStack;
+class DocumentWriter;
 
 namespace Mlt {
 class Profile;
@@ -163,8 +164,12 @@ public:
     double dar() const;
     /** @brief Returns the project file xml. */
     QDomDocument xmlSceneList(const QString &scene);
-    /** @brief Saves the project file xml to a file. */
-    bool saveSceneList(const QString &path, const QString &scene, bool saveOverExistingFile = true);
+    /** @brief Saves the project file xml to a file.
+     *  When background saving is enabled and synchronous is false, the file is written in a worker thread and the result is reported asynchronously.
+     *  @param markClean if true, the document is marked as not modified once the file is written, unless it was edited meanwhile */
+    bool saveSceneList(const QString &path, const QString &scene, bool saveOverExistingFile = true, bool markClean = false, bool synchronous = false);
+    /** @brief Block until pending background save operations are finished and process their result. Returns false if one of them failed */
+    bool waitForSave();
     void setProjectFolder(const QUrl &url);
     void setZone(const QUuid &uuid, int start, int end);
     QPoint zone(const QUuid &uuid) const;
@@ -263,7 +268,7 @@ public:
     QMap <int, QStringList> getProjectTags() const;
     /** @brief Returns the number of audio channels for this project */
     int audioChannels() const;
-    /** @brief Ensure we don't have leftover preview chunks (created after last save */
+    /** @brief Ensure we don't have leftover preview chunks (created after last save or stored in the previous cache root) */
     void cleanupTimelinePreview(const QDateTime &documentDate);
     /** @brief Returns the guides categories for the project in format {name:index:#color} */
     const QStringList guidesCategories();
@@ -318,6 +323,8 @@ public:
     const QString projectName() const;
     /** @brief Returns the project's main uuid.*/
     const QUuid uuid() const;
+    /** @brief Returns an id identifying this loaded instance of the project. Unlike uuid(), it changes when the project is reopened or reverted.*/
+    const QUuid &sessionId() const;
     /** @brief Returns true if a sequence thumbnail needs an update.*/
     bool sequenceThumbRequiresRefresh(const QUuid &uuid) const;
     void setSequenceThumbRequiresUpdate(const QUuid &uuid);
@@ -359,12 +366,17 @@ private:
      */
     void initializeProperties(bool newDocument = true, std::pair<int, int> tracks = {}, int audioChannels = 2);
     QUuid m_uuid;
+    QUuid m_sessionId;
     QDomDocument m_document;
     int m_clipsCount;
     /** @brief MLT's root (base path) that is stripped from urls in saved xml */
     QString m_documentRoot;
     Timecode m_timecode;
     std::shared_ptr<DocUndoStack> m_commandStack;
+    /** @brief Writes the project file in background */
+    DocumentWriter *m_writer{nullptr};
+    /** @brief For each pending save: whether to mark the document clean and the undo stack generation when it was requested */
+    QList<std::pair<bool, quint64>> m_pendingSaves;
     QString m_searchFolder;
 
     /** @brief Tells whether the current document has been changed after being saved. */
@@ -386,6 +398,10 @@ private:
      *         If empty, all files will be saved in a common default location
      */
     QString m_projectFolder;
+    /** @brief True if timeline previews are stored in the local cache folder. Read from the settings when the document is opened so that
+     *         a settings change cannot split the chunks of an open project between two folders
+     */
+    bool m_previewLocalCache{false};
     QList<int> m_undoChunks;
     QMap<QString, QString> m_documentProperties;
     QMap<QString, QString> m_documentMetadata;
@@ -441,6 +457,8 @@ private Q_SLOTS:
     void saveGuideCategories();
     /** @brief Only keep some backup files, delete some */
     void cleanupBackupFiles();
+    /** @brief A project file was written, display error or mark the document clean and save preview image for the backup */
+    void slotSaveFinished(const QString &path, const QString &error);
 
 Q_SIGNALS:
     void resetProjectList();
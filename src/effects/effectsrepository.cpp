@@ -56,13 +56,8 @@ Mlt::Properties *EffectsRepository::getMetadata(const QString &effectId) const
     return pCore->getMltRepository()->metadata(mlt_service_filter_type, effectId.toLatin1().data());
 }
 
-void EffectsRepository::parseCustomAssetFile(const QString &file_name, std::unordered_map<QString, Info> &customAssets) const
+void EffectsRepository::parseCustomAssetFile(const QString &file_name, QDomDocument &doc, std::unordered_map<QString, Info> &customAssets) const
 {
-    QDomDocument doc;
-    if (!Xml::docContentFromFile(doc, file_name, false)) {
-        return;
-    }
-
     QDomElement base = doc.documentElement();
     if (base.tagName() == QLatin1String("effectgroup")) {
         QDomNodeList effects = base.elementsByTagName(QStringLiteral("effect"));
@@ -236,6 +231,11 @@ QString EffectsRepository::assetPreferredListPath() const
     return QStringLiteral(":data/preferred_effects.txt");
 }
 
+QString EffectsRepository::assetCacheName() const
+{
+    return QStringLiteral("effects");
+}
+
 bool EffectsRepository::isPreferred(const QString &effectId) const
 {
     return m_preferred_list.contains(effectId);
@@ -274,7 +274,10 @@ QString EffectsRepository::getCustomPath(const QString &id)
 QPair<QString, QString> EffectsRepository::reloadCustom(const QString &path)
 {
     std::unordered_map<QString, Info> customAssets;
-    parseCustomAssetFile(path, customAssets);
+    QDomDocument doc;
+    if (Xml::docContentFromFile(doc, path, false)) {
+        parseCustomAssetFile(path, doc, customAssets);
+    }
     QPair<QString, QString> result;
     // TODO: handle files with several effects
     for (const auto &custom : customAssets) {
@@ -56,7 +56,7 @@ protected:
     /** @brief Retrieves additional info about effects from a custom XML file
        The resulting assets are stored in customAssets
     */
-    void parseCustomAssetFile(const QString &file_name, std::unordered_map<QString, Info> &customAssets) const override;
+    void parseCustomAssetFile(const QString &file_name, QDomDocument &doc, std::unordered_map<QString, Info> &customAssets) const override;
 
     /** @brief Returns the path to the effects that will be displayed*/
     QStringList assetIncludedPath() const override;
@@ -67,6 +67,8 @@ protected:
     /** @brief Returns the path to the effects' preferred list*/
     QString assetPreferredListPath() const override;
 
+    QString assetCacheName() const override;
+
     QStringList assetDirs() const override;
 
     void parseType(Mlt::Properties *metadata, Info &res) override;
@@ -23,13 +23,14 @@ public:
     static void start(const ObjectId &owner, QObject *object, bool force = false);
     static QVector<int16_t> getLevelsFromCache(const QString &cachePath);
     static void saveLevelsToCache(const QString &cachePath, const QVector<int16_t> &levels);
+    /** @brief Attach the levels of an audio stream to the clip's master producer */
+    static void storeLevels(const std::shared_ptr<ProjectClip> &binClip, int stream, const QVector<int16_t> &levels);
+    static void storeMax(const std::shared_ptr<ProjectClip> &binClip, int stream, const QVector<int16_t> &levels);
 
 protected:
     void run() override;
 
 private:
-    static void storeLevels(const std::shared_ptr<ProjectClip> &binClip, int stream, const QVector<int16_t> &levels);
-    static void storeMax(const std::shared_ptr<ProjectClip> &binClip, int stream, const QVector<int16_t> &levels);
     void progressCallback(const std::shared_ptr<ProjectClip> &binClip, const QVector<int16_t> &levels, int streamIdx, int progress);
     QElapsedTimer m_timer;
 };
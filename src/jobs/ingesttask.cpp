@@ -0,0 +1,367 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "ingesttask.h"
+#include "audio/audioStreamInfo.h"
+#include "audiolevels/audiolevelstask.h"
+#include "audiolevels/generators.h"
+#include "bin/projectclip.h"
+#include "bin/projectitemmodel.h"
+#include "core.h"
+#include "doc/kdenlivedoc.h"
+#include "doc/kthumb.h"
+#include "kdenlivesettings.h"
+#include "proxytask.h"
+#include "utils/thumbnailcache.hpp"
+
+#include <KLocalizedString>
+#include <KMessageWidget>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QtMath>
+#include <mlt++/MltConsumer.h>
+#include <mlt++/MltFrame.h>
+#include <mlt++/MltProducer.h>
+#include <mlt++/MltProfile.h>
+
+IngestTask::IngestTask(const ObjectId &owner, QObject *object)
+    : AbstractTask(owner, AbstractTask::PROXYJOB, object)
+{
+    m_description = i18n("Ingesting clip");
+}
+
+void IngestTask::start(const ObjectId &owner, QObject *object, bool force)
+{
+    if (pCore->taskManager.hasPendingJob(owner, AbstractTask::PROXYJOB)) {
+        return;
+    }
+    // Audio levels will be generated from the same decoding pass
+    pCore->taskManager.discardJobs(owner, AbstractTask::AUDIOTHUMBJOB);
+    IngestTask *task = new IngestTask(owner, object);
+    task->m_isForce = force;
+    pCore->taskManager.startTask(owner.itemId, task);
+}
+
+bool IngestTask::canIngest(const std::shared_ptr<ProjectClip> &binClip)
+{
+    if (!KdenliveSettings::singlepassingest() || binClip == nullptr) {
+        return false;
+    }
+    if (binClip->clipType() != ClipType::AV && binClip->clipType() != ClipType::Video) {
+        return false;
+    }
+    if (binClip->hasProducerProperty(QStringLiteral("kdenlive:camcorderproxy")) || binClip->hasAlpha()) {
+        return false;
+    }
+    // Rotation overrides need the -noautorotate handling of the FFmpeg job
+    if (binClip->hasProducerProperty(QStringLiteral("rotate")) || binClip->getProducerProperty(QStringLiteral("autorotate")) == QLatin1String("0")) {
+        return false;
+    }
+    // Live sources are handled by the FFmpeg job
+    const int length = int(binClip->frameDuration());
+    if (length <= 0 || length == INT_MAX) {
+        return false;
+    }
+    // Thumbnails and audio levels are indexed by project frame
+    if (!qFuzzyCompare(binClip->getOriginalFps(), pCore->getCurrentFps())) {
+        return false;
+    }
+    // The FFmpeg proxy job keeps all audio streams
+    if (binClip->audioInfo() && binClip->audioInfo()->streams().size() > 1) {
+        return false;
+    }
+    QString proxyParams = pCore->currentDoc()->getDocumentProperty(QStringLiteral("proxyparams"));
+    if (proxyParams.isEmpty()) {
+        proxyParams = pCore->currentDoc()->getAutoProxyProfile();
+    }
+    // Hardware encoders requiring an upload filter are only handled by the FFmpeg job
+    return !proxyParams.contains(QLatin1String("vaapi")) && !proxyParams.contains(QLatin1String("qsv"));
+}
+
+void IngestTask::onFrameShow(mlt_consumer, IngestTask *self, mlt_event_data data)
+{
+    auto frame = Mlt::EventData(data).to_frame();
+    if (frame.is_valid() && !self->m_isCanceled) {
+        self->processFrame(frame);
+    }
+}
+
+void IngestTask::processFrame(Mlt::Frame &frame)
+{
+    const int position = frame.get_position();
+    if (position < 0 || position >= m_length) {
+        return;
+    }
+    processImage(frame, position);
+    if (m_generateLevels) {
+        processAudio(frame, position);
+    }
+    int val = qMin(99, 100 * position / m_length);
+    if (m_progress != val) {
+        m_progress = val;
+        QMetaObject::invokeMethod(m_object, "updateJobProgress");
+    }
+}
+
+void IngestTask::processImage(Mlt::Frame &frame, int position)
+{
+    if (m_sceneDetector) {
+        // Use the image already converted for the encoder, without triggering another conversion
+        int size = 0;
+        const auto *image = static_cast<const uint8_t *>(frame.get_data("image", size));
+        const auto format = mlt_image_format(frame.get_int("format"));
+        const int width = frame.get_int("width");
+        const int height = frame.get_int("height");
+        switch (format) {
+        case mlt_image_yuv420p:
+            m_sceneDetector->addFrame(position, image, width, height, width);
+            break;
+        case mlt_image_yuv422:
+            m_sceneDetector->addFrame(position, image, width, height, width * 2, 2);
+            break;
+        case mlt_image_rgb:
+            // Green is used as an approximation of luma
+            m_sceneDetector->addFrame(position, image ? image + 1 : nullptr, width, height, width * 3, 3);
+            break;
+        case mlt_image_rgba:
+            m_sceneDetector->addFrame(position, image ? image + 1 : nullptr, width, height, width * 4, 4);
+            break;
+        default:
+            // Scene detection is not available for this image format
+            m_sceneDetector.reset();
+            break;
+        }
+    }
+    if (m_thumbFrames.count(position) == 0 || ThumbnailCache::get()->hasThumbnail(m_clipId, position)) {
+        return;
+    }
+    // Convert a copy so that the frame used by the encoder is left untouched
+    mlt_frame clone = mlt_frame_clone(frame.get_frame(), 1);
+    Mlt::Frame copy(clone);
+    mlt_frame_close(clone);
+    const QImage result = KThumb::getFrame(&copy, frame.get_int("width"), frame.get_int("height"));
+    if (!result.isNull()) {
+        ThumbnailCache::get()->storeThumbnail(m_clipId, position, result.scaled(m_thumbFullWidth, m_thumbHeight), true);
+    }
+}
+
+void IngestTask::processAudio(Mlt::Frame &frame, int position)
+{
+    int size = 0;
+    const void *buffer = frame.get_data("audio", size);
+    const auto format = mlt_audio_format(frame.get_int("audio_format"));
+    const int samples = frame.get_int("audio_samples");
+    const int channels = frame.get_int("audio_channels");
+    if (buffer == nullptr || samples <= 0) {
+        return;
+    }
+    if (channels != m_audioChannels) {
+        // The proxy profile changes the channel layout, levels will be generated by the audio levels job
+        m_generateLevels = false;
+        m_levelsValid = false;
+        return;
+    }
+    QVector<int16_t> interleaved(samples * channels);
+    const int count = samples * channels;
+    switch (format) {
+    case mlt_audio_s16:
+        memcpy(interleaved.data(), buffer, size_t(count) * sizeof(int16_t));
+        break;
+    case mlt_audio_s32le: {
+        const auto *in = static_cast<const int32_t *>(buffer);
+        for (int i = 0; i < count; ++i) {
+            interleaved[i] = int16_t(in[i] >> 16);
+        }
+        break;
+    }
+    case mlt_audio_s32: {
+        // Planar
+        const auto *in = static_cast<const int32_t *>(buffer);
+        for (int c = 0; c < channels; ++c) {
+            for (int s = 0; s < samples; ++s) {
+                interleaved[s * channels + c] = int16_t(in[c * samples + s] >> 16);
+            }
+        }
+        break;
+    }
+    case mlt_audio_f32le: {
+        const auto *in = static_cast<const float *>(buffer);
+        for (int i = 0; i < count; ++i) {
+            interleaved[i] = int16_t(qBound(-1.f, in[i], 1.f) * 32767);
+        }
+        break;
+    }
+    case mlt_audio_float: {
+        // Planar
+        const auto *in = static_cast<const float *>(buffer);
+        for (int c = 0; c < channels; ++c) {
+            for (int s = 0; s < samples; ++s) {
+                interleaved[s * channels + c] = int16_t(qBound(-1.f, in[c * samples + s], 1.f) * 32767);
+            }
+        }
+        break;
+    }
+    case mlt_audio_u8: {
+        const auto *in = static_cast<const uint8_t *>(buffer);
+        for (int i = 0; i < count; ++i) {
+            interleaved[i] = int16_t((int(in[i]) - 128) << 8);
+        }
+        break;
+    }
+    default:
+        // Audio levels are not available for this audio format
+        m_generateLevels = false;
+        m_levelsValid = false;
+        return;
+    }
+    computePeaks(interleaved.constData(), &m_levels[position * AUDIOLEVELS_POINTS_PER_FRAME * channels], size_t(channels), size_t(samples),
+                 AUDIOLEVELS_POINTS_PER_FRAME);
+}
+
+void IngestTask::run()
+{
+    AbstractTaskDone whenFinished(m_owner.itemId, this);
+    if (m_isCanceled || pCore->taskManager.isBlocked()) {
+        return;
+    }
+    QMutexLocker lock(&m_runMutex);
+    m_progress = 0;
+    m_running = true;
+    auto binClip = pCore->projectItemModel()->getClipByBinID(QString::number(m_owner.itemId));
+    if (binClip == nullptr) {
+        return;
+    }
+    const QString dest = binClip->getProducerProperty(QStringLiteral("kdenlive:proxy"));
+    QFileInfo fInfo(dest);
+    if (binClip->getProducerIntProperty(QStringLiteral("_overwriteproxy")) == 0 && fInfo.exists() && fInfo.size() > 0) {
+        // Proxy clip already created
+        m_progress = 100;
+        QMetaObject::invokeMethod(m_object, "updateJobProgress");
+        QMetaObject::invokeMethod(binClip.get(), "updateProxyProducer", Qt::QueuedConnection, Q_ARG(QString, dest));
+        return;
+    }
+    const QString source = binClip->getProducerProperty(QStringLiteral("kdenlive:originalurl"));
+    m_clipId = QString::number(m_owner.itemId);
+
+    // Decode with the source profile so that the proxy keeps the original frame rate
+    Mlt::Profile profile;
+    Mlt::Producer producer(profile, "avformat", source.toUtf8().constData());
+    if (!producer.is_valid()) {
+        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Cannot load clip %1.", source)),
+                                  Q_ARG(int, int(KMessageWidget::Warning)));
+        return;
+    }
+    profile.from_producer(producer);
+    profile.set_explicit(1);
+    for (const char *prop : {"video_index", "audio_index"}) {
+        const QString value = binClip->getProducerProperty(QString::fromLatin1(prop));
+        if (!value.isEmpty()) {
+            producer.set(prop, value.toUtf8().constData());
+        }
+    }
+    m_length = producer.get_length();
+    if (m_length <= 0 || m_length == INT_MAX) {
+        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Cannot load clip %1.", source)),
+                                  Q_ARG(int, int(KMessageWidget::Warning)));
+        return;
+    }
+
+    // Hover thumbnails, spread like in CacheTask
+    if (KdenliveSettings::hoverPreview()) {
+        const int thumbsCount = 30;
+        int steps = qCeil(qMax(pCore->getCurrentFps(), double(m_length) / thumbsCount));
+        for (int i = 0, pos = 0; i < thumbsCount && pos < m_length; ++i, pos = steps * i) {
+            m_thumbFrames.insert(pos);
+        }
+        m_thumbHeight = pCore->thumbProfile().height();
+        m_thumbFullWidth = qRound(m_thumbHeight * pCore->getCurrentDar());
+        m_thumbFullWidth += m_thumbFullWidth % 2;
+    }
+
+    // Audio levels
+    int audioStream = -1;
+    QString levelsCachePath;
+    if (KdenliveSettings::audiothumbnails() && binClip->audioInfo() && !binClip->audioInfo()->streams().isEmpty() && !binClip->audioThumbCreated()) {
+        audioStream = binClip->audioInfo()->streams().firstKey();
+        levelsCachePath = binClip->getAudioThumbPath(audioStream);
+        if (m_isForce || !QFile::exists(levelsCachePath)) {
+            m_audioChannels = binClip->audioInfo()->channelsForStream(audioStream);
+            m_generateLevels = m_audioChannels > 0;
+            m_levelsValid = m_generateLevels;
+            if (m_generateLevels) {
+                m_levels.resize(m_length * AUDIOLEVELS_POINTS_PER_FRAME * m_audioChannels);
+            }
+        }
+    }
+
+    if (KdenliveSettings::ingestscenedetection()) {
+        m_sceneDetector = std::make_unique<SceneChangeDetector>(KdenliveSettings::scenesplitthreshold() / 100.);
+    }
+
+    Mlt::Consumer consumer(profile, "avformat", dest.toUtf8().constData());
+    const QStringList params = ProxyTask::mltConsumerParameters(binClip, source, binClip->clipType());
+    for (const QString &param : params) {
+        consumer.set(param.section(QLatin1Char('='), 0, 0).toUtf8().constData(), param.section(QLatin1Char('='), 1).toUtf8().constData());
+    }
+    // Render frames in order on a single thread
+    consumer.set("real_time", -1);
+    consumer.connect(producer);
+    std::unique_ptr<Mlt::Event> showEvent(consumer.listen("consumer-frame-show", this, mlt_listener(onFrameShow)));
+    consumer.start();
+    while (!consumer.is_stopped()) {
+        if (m_isCanceled) {
+            break;
+        }
+        QThread::msleep(100);
+    }
+    consumer.stop();
+    showEvent.reset();
+
+    m_progress = 100;
+    if (m_isCanceled || QFileInfo(dest).size() == 0) {
+        QFile::remove(dest);
+        if (!m_isCanceled) {
+            QMetaObject::invokeMethod(pCore.get(), "displayBinLogMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Failed to create proxy clip.")),
+                                      Q_ARG(int, int(KMessageWidget::Warning)), Q_ARG(QString, QString()));
+            binClip->setProducerProperty(QStringLiteral("kdenlive:proxy"), QStringLiteral("-"));
+        }
+        QMetaObject::invokeMethod(m_object, "updateJobProgress");
+        return;
+    }
+    // Proxy
+    QMetaObject::invokeMethod(binClip.get(), "updateProxyProducer", Qt::QueuedConnection, Q_ARG(QString, dest));
+
+    // Audio levels
+    if (m_generateLevels && m_levelsValid) {
+        AudioLevelsTask::storeLevels(binClip, audioStream, m_levels);
+        AudioLevelsTask::storeMax(binClip, audioStream, m_levels);
+        AudioLevelsTask::saveLevelsToCache(levelsCachePath, m_levels);
+        QMetaObject::invokeMethod(m_object, "updateAudioThumbnail", Q_ARG(bool, true));
+    } else if (audioStream >= 0) {
+        // Levels were not generated during ingest, either because they are cached or the audio could not be used
+        QMetaObject::invokeMethod(
+            binClip.get(), [owner = m_owner, object = m_object]() { AudioLevelsTask::start(owner, object, false); }, Qt::QueuedConnection);
+    }
+
+    // Scene cuts
+    if (m_sceneDetector && !m_sceneDetector->cuts().isEmpty()) {
+        QJsonArray list;
+        int ix = 1;
+        for (int pos : m_sceneDetector->cuts()) {
+            QJsonObject currentMarker;
+            currentMarker.insert(QLatin1String("pos"), QJsonValue(pos));
+            currentMarker.insert(QLatin1String("comment"), QJsonValue(i18n("Scene %1", ix)));
+            currentMarker.insert(QLatin1String("type"), QJsonValue(KdenliveSettings::default_marker_type()));
+            list.push_back(currentMarker);
+            ix++;
+        }
+        QJsonDocument json(list);
+        QMetaObject::invokeMethod(m_object, "importJsonMarkers", Q_ARG(QString, QString(json.toJson())));
+    }
+    QMetaObject::invokeMethod(m_object, "updateJobProgress");
+}
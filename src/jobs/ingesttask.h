@@ -0,0 +1,54 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include "abstracttask.h"
+#include "scenechangedetector.h"
+
+#include <QVector>
+#include <mlt++/MltEvent.h>
+#include <memory>
+#include <set>
+
+class ProjectClip;
+namespace Mlt {
+class Frame;
+}
+
+/** @class IngestTask
+    @brief Creates the proxy clip of a video file while generating its other derived data from the same decoding pass.
+    The source is decoded once by an MLT avformat consumer writing the proxy, and each decoded frame is also used
+    to generate the hover thumbnails, the audio levels and optionally detect scene cuts.
+    Since it replaces the proxy job, it is registered in the TaskManager as a PROXYJOB and reports a single combined progress.
+ */
+class IngestTask : public AbstractTask
+{
+public:
+    IngestTask(const ObjectId &owner, QObject *object);
+    static void start(const ObjectId &owner, QObject *object, bool force = false);
+    /** @brief Returns true if the proxy of this clip can be created by a single pass ingest */
+    static bool canIngest(const std::shared_ptr<ProjectClip> &binClip);
+
+protected:
+    void run() override;
+
+private:
+    int m_length{0};
+    int m_audioChannels{0};
+    int m_thumbHeight{0};
+    int m_thumbFullWidth{0};
+    bool m_generateLevels{false};
+    bool m_levelsValid{false};
+    QString m_clipId;
+    std::set<int> m_thumbFrames;
+    QVector<int16_t> m_levels;
+    std::unique_ptr<SceneChangeDetector> m_sceneDetector;
+    static void onFrameShow(mlt_consumer, IngestTask *self, mlt_event_data data);
+    /** @brief Feed a frame rendered by the proxy consumer to the thumbnail, audio levels and scene cut generators */
+    void processFrame(Mlt::Frame &frame);
+    void processImage(Mlt::Frame &frame, int position);
+    void processAudio(Mlt::Frame &frame, int position);
+};
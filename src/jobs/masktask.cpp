@@ -45,6 +45,22 @@ void MaskTask::generateMask()
     }
     const QString outFile = m_properties.value(MaskTask::OUTPUTFILE);
     const QString outFramesFolder = m_properties.value(MaskTask::OUTPUTFOLDER);
+    QString thumbFile = outFile.section(QLatin1Char('.'), 0, -2);
+    thumbFile.append(QStringLiteral(".png"));
+    if (outFramesFolder.isEmpty()) {
+        // The mask frames were piped to the encoder by the analysis script, with the first frame saved as thumbnail
+        if (!QFile::exists(outFile)) {
+            QMetaObject::invokeMethod(pCore.get(), "displayBinLogMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Failed to render mask %1", outFile)),
+                                      Q_ARG(int, int(KMessageWidget::Warning)), Q_ARG(QString, m_logDetails));
+            return;
+        }
+        QImage img(thumbFile);
+        if (!img.isNull() && img.height() > 80) {
+            img.scaledToHeight(80).save(thumbFile);
+        }
+        addMask(outFile);
+        return;
+    }
     m_scriptJob = new QProcess(this);
     QObject::connect(this, &AbstractTask::jobCanceled, m_scriptJob, &QProcess::kill, Qt::DirectConnection);
     QObject::connect(m_scriptJob, &QProcess::readyReadStandardError, this, &MaskTask::processLogInfo);
@@ -75,11 +91,14 @@ void MaskTask::generateMask()
     const QString firstFrame = QStringLiteral("00000.png");
     if (framesFolder.exists(firstFrame)) {
         QImage img(framesFolder.absoluteFilePath(firstFrame));
-        QString thumbFile = outFile.section(QLatin1Char('.'), 0, -2);
-        thumbFile.append(QStringLiteral(".png"));
         img = img.scaledToHeight(80);
         img.save(thumbFile);
     }
+    addMask(outFile);
+}
+
+void MaskTask::addMask(const QString &outFile)
+{
     m_progress = 100;
     if (!m_isCanceled.loadAcquire()) {
         auto binClip = pCore->projectItemModel()->getClipByBinID(QString::number(m_owner.itemId));
@@ -42,6 +42,8 @@ private:
     bool m_isFfmpegJob{false};
     bool m_autoAddFilter{false};
     void generateMask();
+    /** @brief Add the rendered mask file to the clip */
+    void addMask(const QString &outFile);
 
 private Q_SLOTS:
     void processLogInfo();
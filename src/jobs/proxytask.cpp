@@ -10,6 +10,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "bin/projectitemmodel.h"
 #include "core.h"
 #include "doc/kdenlivedoc.h"
+#include "ingesttask.h"
 #include "kdenlive_debug.h"
 #include "kdenlivesettings.h"
 #include "macros.hpp"
@@ -35,12 +36,109 @@ void ProxyTask::start(const ObjectId &owner, QObject *object, bool force)
     if (pCore->taskManager.hasPendingJob(owner, AbstractTask::PROXYJOB)) {
         return;
     }
+    if (IngestTask::canIngest(pCore->projectItemModel()->getClipByBinID(QString::number(owner.itemId)))) {
+        // Create the proxy and other derived data from a single decoding pass
+        IngestTask::start(owner, object, force);
+        return;
+    }
     ProxyTask *task = new ProxyTask(owner, object);
     // Otherwise, start a new proxy generation thread.
     task->m_isForce = force;
     pCore->taskManager.startTask(owner.itemId, task);
 }
 
+QStringList ProxyTask::mltConsumerParameters(const std::shared_ptr<ProjectClip> &binClip, const QString &source, ClipType::ProducerType type)
+{
+    QStringList parameters;
+    QString parameter;
+    if (binClip->hasAlpha()) {
+        // check if this is a VP8/VP9 clip and enforce libvpx codec
+        parameter = KdenliveSettings::proxyalphaparams().simplified();
+        if (parameter.isEmpty()) {
+            // Automatic setting, decide based on hw support
+            parameter = pCore->currentDoc()->getAutoProxyAlphaProfile();
+        }
+    } else {
+        parameter = pCore->currentDoc()->getDocumentProperty(QStringLiteral("proxyparams")).simplified();
+        if (parameter.isEmpty()) {
+            // Automatic setting, decide based on hw support
+            parameter = pCore->currentDoc()->getAutoProxyProfile();
+            bool nvenc = parameter.contains(QStringLiteral("%nvcodec"));
+            if (nvenc) {
+                parameter = parameter.section(QStringLiteral("-i"), 1);
+                parameter.replace(QStringLiteral("scale_cuda"), QStringLiteral("scale"));
+                parameter.replace(QStringLiteral("scale_npp"), QStringLiteral("scale"));
+                parameter.prepend(QStringLiteral("-pix_fmt yuv420p"));
+            }
+        }
+    }
+    int proxyResize = pCore->currentDoc()->getDocumentProperty(QStringLiteral("proxyresize")).toInt();
+    parameter.replace(QStringLiteral("%width"), QString::number(proxyResize));
+    if (parameter.contains(QLatin1String("-i "))) {
+        // Remove the source input if any
+        parameter.remove(QLatin1String("-i "));
+    }
+
+    QStringList params = parameter.split(QLatin1Char('-'), Qt::SkipEmptyParts);
+    double display_ratio;
+    if (source.startsWith(QLatin1String("consumer:"))) {
+        display_ratio = KdenliveDoc::getDisplayRatio(source.section(QLatin1Char(':'), 1));
+    } else {
+        display_ratio = KdenliveDoc::getDisplayRatio(source);
+    }
+    if (display_ratio < 1e-6) {
+        display_ratio = 1;
+    }
+
+    bool skipNext = false;
+    for (const QString &s : std::as_const(params)) {
+        QString t = s.simplified();
+        if (skipNext) {
+            skipNext = false;
+            continue;
+        }
+        if (t.count(QLatin1Char(' ')) == 0) {
+            t.append(QLatin1String("=1"));
+        } else if (t.startsWith(QLatin1String("vf "))) {
+            skipNext = true;
+            bool ok = false;
+            int width = t.section(QLatin1Char('='), 1, 1).section(QLatin1Char(':'), 0, 0).toInt(&ok);
+            if (!ok) {
+                width = 640;
+            }
+            int height = int(width / display_ratio);
+            // Make sure we get an even height
+            height += height % 2;
+            parameters << QStringLiteral("s=%1x%2").arg(width).arg(height);
+            if (t.contains(QStringLiteral("yadif"))) {
+                parameters << QStringLiteral("progressive=1");
+            }
+            continue;
+        } else {
+            t.replace(QLatin1Char(' '), QLatin1String("="));
+            if (t == QLatin1String("acodec=copy") && type == ClipType::Playlist) {
+                // drop this for playlists, otherwise we have no sound in proxies
+                continue;
+            }
+        }
+        parameters << t;
+    }
+    int threadCount = QThread::idealThreadCount();
+    if (threadCount > 2) {
+        threadCount = qMin(threadCount - 1, 4);
+    } else {
+        threadCount = 1;
+    }
+    // real_time parameter seems to cause rendering artifacts with playlist clips
+    // parameters.append(QStringLiteral("real_time=-%1").arg(threadCount));
+    parameters.append(QStringLiteral("threads=%1").arg(threadCount));
+    parameters.append(QStringLiteral("terminate_on_pause=1"));
+
+    // TODO: currently, when rendering an xml file through melt, the display ration is lost, so we enforce it manually
+    parameters << QStringLiteral("aspect=") + QString::number(display_ratio, 'f');
+    return parameters;
+}
+
 void ProxyTask::run()
 {
     AbstractTaskDone whenFinished(m_owner.itemId, this);
@@ -97,92 +195,7 @@ void ProxyTask::run()
         mltParameters << source;
         // set destination
         mltParameters << QStringLiteral("-consumer") << QStringLiteral("avformat:%1").arg(dest) << QStringLiteral("out=%1").arg(binClip->frameDuration());
-        QString parameter;
-        if (binClip->hasAlpha()) {
-            // check if this is a VP8/VP9 clip and enforce libvpx codec
-            parameter = KdenliveSettings::proxyalphaparams().simplified();
-            if (parameter.isEmpty()) {
-                // Automatic setting, decide based on hw support
-                parameter = pCore->currentDoc()->getAutoProxyAlphaProfile();
-            }
-        } else {
-            parameter = pCore->currentDoc()->getDocumentProperty(QStringLiteral("proxyparams")).simplified();
-            if (parameter.isEmpty()) {
-                // Automatic setting, decide based on hw support
-                parameter = pCore->currentDoc()->getAutoProxyProfile();
-                bool nvenc = parameter.contains(QStringLiteral("%nvcodec"));
-                if (nvenc) {
-                    parameter = parameter.section(QStringLiteral("-i"), 1);
-                    parameter.replace(QStringLiteral("scale_cuda"), QStringLiteral("scale"));
-                    parameter.replace(QStringLiteral("scale_npp"), QStringLiteral("scale"));
-                    parameter.prepend(QStringLiteral("-pix_fmt yuv420p"));
-                }
-            }
-        }
-        int proxyResize = pCore->currentDoc()->getDocumentProperty(QStringLiteral("proxyresize")).toInt();
-        parameter.replace(QStringLiteral("%width"), QString::number(proxyResize));
-        if (parameter.contains(QLatin1String("-i "))) {
-            // Remove the source input if any
-            parameter.remove(QLatin1String("-i "));
-        }
-
-        QStringList params = parameter.split(QLatin1Char('-'), Qt::SkipEmptyParts);
-        double display_ratio;
-        if (source.startsWith(QLatin1String("consumer:"))) {
-            display_ratio = KdenliveDoc::getDisplayRatio(source.section(QLatin1Char(':'), 1));
-        } else {
-            display_ratio = KdenliveDoc::getDisplayRatio(source);
-        }
-        if (display_ratio < 1e-6) {
-            display_ratio = 1;
-        }
-
-        bool skipNext = false;
-        for (const QString &s : std::as_const(params)) {
-            QString t = s.simplified();
-            if (skipNext) {
-                skipNext = false;
-                continue;
-            }
-            if (t.count(QLatin1Char(' ')) == 0) {
-                t.append(QLatin1String("=1"));
-            } else if (t.startsWith(QLatin1String("vf "))) {
-                skipNext = true;
-                bool ok = false;
-                int width = t.section(QLatin1Char('='), 1, 1).section(QLatin1Char(':'), 0, 0).toInt(&ok);
-                if (!ok) {
-                    width = 640;
-                }
-                int height = int(width / display_ratio);
-                // Make sure we get an even height
-                height += height % 2;
-                mltParameters << QStringLiteral("s=%1x%2").arg(width).arg(height);
-                if (t.contains(QStringLiteral("yadif"))) {
-                    mltParameters << QStringLiteral("progressive=1");
-                }
-                continue;
-            } else {
-                t.replace(QLatin1Char(' '), QLatin1String("="));
-                if (t == QLatin1String("acodec=copy") && type == ClipType::Playlist) {
-                    // drop this for playlists, otherwise we have no sound in proxies
-                    continue;
-                }
-            }
-            mltParameters << t;
-        }
-        int threadCount = QThread::idealThreadCount();
-        if (threadCount > 2) {
-            threadCount = qMin(threadCount - 1, 4);
-        } else {
-            threadCount = 1;
-        }
-        // real_time parameter seems to cause rendering artifacts with playlist clips
-        // mltParameters.append(QStringLiteral("real_time=-%1").arg(threadCount));
-        mltParameters.append(QStringLiteral("threads=%1").arg(threadCount));
-        mltParameters.append(QStringLiteral("terminate_on_pause=1"));
-
-        // TODO: currently, when rendering an xml file through melt, the display ration is lost, so we enforce it manually
-        mltParameters << QStringLiteral("aspect=") + QString::number(display_ratio, 'f');
+        mltParameters << mltConsumerParameters(binClip, source, type);
 
         // Ask for progress reporting
         mltParameters << QStringLiteral("progress=1");
@@ -8,13 +8,18 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #include "abstracttask.h"
 
+#include <memory>
+
 class QProcess;
+class ProjectClip;
 
 class ProxyTask : public AbstractTask
 {
 public:
     ProxyTask(const ObjectId &owner, QObject* object);
     static void start(const ObjectId &owner, QObject* object, bool force = false);
+    /** @brief Returns the MLT consumer properties, as key=value strings, matching the project's proxy encoding parameters */
+    static QStringList mltConsumerParameters(const std::shared_ptr<ProjectClip> &binClip, const QString &source, ClipType::ProducerType type);
 
 protected:
     void run() override;
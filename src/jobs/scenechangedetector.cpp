@@ -0,0 +1,232 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "scenechangedetector.h"
+
+#include <QtGlobal>
+#include <cmath>
+#include <cstdlib>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCENEDETECT_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define SCENEDETECT_NEON
+#include <arm_neon.h>
+#endif
+
+// Mean luma below which a frame is considered black, for fade detection
+static constexpr double DarkLevel = 32.;
+
+uint32_t SceneChangeDetector::sad(const uint8_t *a, const uint8_t *b, int count)
+{
+    uint32_t result = 0;
+    int i = 0;
+#if defined(SCENEDETECT_SSE2)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+    }
+    result = uint32_t(_mm_cvtsi128_si32(acc)) + uint32_t(_mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+#elif defined(SCENEDETECT_NEON)
+    uint32x4_t acc = vdupq_n_u32(0);
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t diff = vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+        acc = vpadalq_u16(acc, vpaddlq_u8(diff));
+    }
+    result = vaddvq_u32(acc);
+#endif
+    for (; i < count; ++i) {
+        result += uint32_t(std::abs(int(a[i]) - int(b[i])));
+    }
+    return result;
+}
+
+uint32_t SceneChangeDetector::sum(const uint8_t *data, int count)
+{
+    uint32_t result = 0;
+    int i = 0;
+#if defined(SCENEDETECT_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    for (; i + 16 <= count; i += 16) {
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)), zero));
+    }
+    result = uint32_t(_mm_cvtsi128_si32(acc)) + uint32_t(_mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+#elif defined(SCENEDETECT_NEON)
+    uint32x4_t acc = vdupq_n_u32(0);
+    for (; i + 16 <= count; i += 16) {
+        acc = vpadalq_u16(acc, vpaddlq_u8(vld1q_u8(data + i)));
+    }
+    result = vaddvq_u32(acc);
+#endif
+    for (; i < count; ++i) {
+        result += data[i];
+    }
+    return result;
+}
+
+uint32_t SceneChangeDetector::histogramSad(const uint16_t *a, const uint16_t *b, int count)
+{
+    uint32_t result = 0;
+    int i = 0;
+#if defined(SCENEDETECT_SSE2)
+    // Bin counts are below 32768, so the signed multiply-add is safe
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        const __m128i diff = _mm_or_si128(_mm_subs_epu16(va, vb), _mm_subs_epu16(vb, va));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(diff, ones));
+    }
+    acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 8));
+    acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 4));
+    result = uint32_t(_mm_cvtsi128_si32(acc));
+#elif defined(SCENEDETECT_NEON)
+    uint32x4_t acc = vdupq_n_u32(0);
+    for (; i + 8 <= count; i += 8) {
+        acc = vpadalq_u16(acc, vabdq_u16(vld1q_u16(a + i), vld1q_u16(b + i)));
+    }
+    result = vaddvq_u32(acc);
+#endif
+    for (; i < count; ++i) {
+        result += uint32_t(std::abs(int(a[i]) - int(b[i])));
+    }
+    return result;
+}
+
+SceneChangeDetector::SceneChangeDetector(double threshold, bool adaptive, bool detectFades)
+    : m_threshold(threshold)
+    , m_adaptive(adaptive)
+    , m_detectFades(detectFades)
+    , m_current(GridWidth * GridHeight)
+    , m_previous(GridWidth * GridHeight)
+{
+    m_currentHistogram.fill(0);
+    m_previousHistogram.fill(0);
+}
+
+void SceneChangeDetector::downscale(const uint8_t *data, int width, int height, int stride, int pixelStep)
+{
+    // Box filter the frame down to the analysis grid
+    for (int gy = 0; gy < GridHeight; ++gy) {
+        const int y0 = gy * height / GridHeight;
+        const int y1 = qMax(y0 + 1, (gy + 1) * height / GridHeight);
+        for (int gx = 0; gx < GridWidth; ++gx) {
+            const int x0 = gx * width / GridWidth;
+            const int x1 = qMax(x0 + 1, (gx + 1) * width / GridWidth);
+            uint32_t total = 0;
+            for (int y = y0; y < y1; ++y) {
+                const uint8_t *line = data + y * stride + x0 * pixelStep;
+                if (pixelStep == 1) {
+                    total += sum(line, x1 - x0);
+                    continue;
+                }
+                for (int x = x0; x < x1; ++x) {
+                    total += *line;
+                    line += pixelStep;
+                }
+            }
+            m_current[gy * GridWidth + gx] = uint8_t(total / uint32_t((y1 - y0) * (x1 - x0)));
+        }
+    }
+    m_currentHistogram.fill(0);
+    for (uint8_t value : m_current) {
+        m_currentHistogram[value * HistogramBins / 256]++;
+    }
+}
+
+double SceneChangeDetector::adaptiveThreshold() const
+{
+    if (int(m_recentScores.size()) < AdaptiveWindow / 2) {
+        return m_threshold;
+    }
+    double mean = 0.;
+    for (double score : m_recentScores) {
+        mean += score;
+    }
+    mean /= m_recentScores.size();
+    double variance = 0.;
+    for (double score : m_recentScores) {
+        variance += (score - mean) * (score - mean);
+    }
+    variance /= m_recentScores.size();
+    // On high motion sequences, only keep scores clearly above the recent activity
+    return qMax(m_threshold, mean + 3. * std::sqrt(variance));
+}
+
+bool SceneChangeDetector::addFrame(int position, const uint8_t *data, int width, int height, int stride, int pixelStep)
+{
+    if (data == nullptr || width < GridWidth || height < GridHeight) {
+        return false;
+    }
+    downscale(data, width, height, stride, pixelStep);
+    const int count = int(m_current.size());
+    bool isCut = false;
+    if (m_hasPrevious) {
+        const double mafd = double(sad(m_current.data(), m_previous.data(), count)) / count;
+        const double diff = std::fabs(mafd - m_previousMafd);
+        m_lastScore = qBound(0., qMin(mafd, diff) / 100., 1.);
+        m_previousMafd = mafd;
+        // Normalized to 0-1, 1 meaning that no luma value is shared between both frames
+        const double histogramChange = histogramSad(m_currentHistogram.data(), m_previousHistogram.data(), HistogramBins) / (2. * count);
+        const double threshold = m_adaptive ? adaptiveThreshold() : m_threshold;
+        // The histogram rejects large motion that keeps the same content. The first difference has no
+        // previous one to compare to, and the start of the clip is a scene boundary anyway
+        isCut = m_hasPreviousMafd && m_lastScore > threshold && histogramChange > m_threshold / 4.;
+        m_hasPreviousMafd = true;
+        if (!isCut) {
+            m_recentScores.push_back(m_lastScore);
+            if (int(m_recentScores.size()) > AdaptiveWindow) {
+                m_recentScores.pop_front();
+            }
+        }
+    }
+    if (m_detectFades) {
+        const double meanLuma = double(sum(m_current.data(), count)) / count;
+        if (meanLuma < DarkLevel) {
+            m_darkFrames++;
+        } else {
+            // The picture comes back after a fade through black
+            if (m_darkFrames > 0 && m_lastCut < position - m_darkFrames) {
+                isCut = true;
+            }
+            m_darkFrames = 0;
+        }
+    }
+    if (isCut) {
+        m_cuts << position;
+        m_lastCut = position;
+    }
+    m_previous.swap(m_current);
+    m_previousHistogram.swap(m_currentHistogram);
+    m_hasPrevious = true;
+    return isCut;
+}
+
+const QVector<int> &SceneChangeDetector::cuts() const
+{
+    return m_cuts;
+}
+
+double SceneChangeDetector::lastScore() const
+{
+    return m_lastScore;
+}
+
+void SceneChangeDetector::reset()
+{
+    m_hasPrevious = false;
+    m_hasPreviousMafd = false;
+    m_previousMafd = 0.;
+    m_lastScore = 0.;
+    m_darkFrames = 0;
+    m_lastCut = -1;
+    m_recentScores.clear();
+    m_cuts.clear();
+}
@@ -0,0 +1,77 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QVector>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/** @class SceneChangeDetector
+    @brief Detects scene cuts from consecutive decoded frames.
+    Each frame is reduced to a small luma grid. The cut score is computed like FFmpeg's scene filter from the
+    mean absolute frame difference, so that the same threshold can be used for both, and is confirmed by the
+    difference of the luma histograms. Row sums, SAD and histogram distances use SSE2 or NEON when available.
+ */
+class SceneChangeDetector
+{
+public:
+    /** @param threshold the scene score above which a cut is reported, in the 0-1 range
+     *  @param adaptive if true, the threshold is raised on high motion sequences based on the recent scores
+     *  @param detectFades if true, fades through black are also reported as cuts
+     */
+    explicit SceneChangeDetector(double threshold, bool adaptive = true, bool detectFades = false);
+    /** @brief Analyse the next frame.
+     *  @param position the frame position, stored when a cut is detected
+     *  @param data pointer to the first luma sample
+     *  @param width the frame width in pixels
+     *  @param height the frame height in pixels
+     *  @param stride the number of bytes between two lines
+     *  @param pixelStep the number of bytes between two luma samples, for packed formats
+     *  @returns true if a cut was detected on this frame
+     */
+    bool addFrame(int position, const uint8_t *data, int width, int height, int stride, int pixelStep = 1);
+    /** @brief The positions of the detected cuts, in frames */
+    const QVector<int> &cuts() const;
+    /** @brief The score of the last analysed frame */
+    double lastScore() const;
+    void reset();
+
+    static constexpr int GridWidth = 64;
+    static constexpr int GridHeight = 36;
+    static constexpr int HistogramBins = 64;
+    /** @brief Number of previous scores used by the adaptive threshold */
+    static constexpr int AdaptiveWindow = 24;
+
+    /** @brief Sum of absolute differences of two buffers */
+    static uint32_t sad(const uint8_t *a, const uint8_t *b, int count);
+    /** @brief Sum of count bytes */
+    static uint32_t sum(const uint8_t *data, int count);
+    /** @brief Sum of absolute differences of two histograms */
+    static uint32_t histogramSad(const uint16_t *a, const uint16_t *b, int count);
+
+private:
+    using Histogram = std::array<uint16_t, HistogramBins>;
+    double m_threshold;
+    bool m_adaptive;
+    bool m_detectFades;
+    std::vector<uint8_t> m_current;
+    std::vector<uint8_t> m_previous;
+    Histogram m_currentHistogram;
+    Histogram m_previousHistogram;
+    std::deque<double> m_recentScores;
+    double m_previousMafd{0.};
+    double m_lastScore{0.};
+    bool m_hasPrevious{false};
+    bool m_hasPreviousMafd{false};
+    /** @brief Number of consecutive dark frames, for fade detection */
+    int m_darkFrames{0};
+    int m_lastCut{-1};
+    QVector<int> m_cuts;
+    void downscale(const uint8_t *data, int width, int height, int stride, int pixelStep);
+    double adaptiveThreshold() const;
+};
@@ -17,26 +17,28 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "kdenlivesettings.h"
 #include "macros.hpp"
 #include "mainwindow.h"
+#include "scenechangedetector.h"
 #include "ui_scenecutdialog_ui.h"
 
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QPointer>
-#include <QProcess>
-#include <QTemporaryFile>
-#include <QThread>
+#include <mlt++/MltFrame.h>
+#include <mlt++/MltProducer.h>
+#include <mlt++/MltProfile.h>
 
 #include <KLocalizedString>
 #include <project/projectmanager.h>
 
-SceneSplitTask::SceneSplitTask(const ObjectId &owner, double threshold, int markersCategory, bool addSubclips, int minDuration, QObject *object)
+SceneSplitTask::SceneSplitTask(const ObjectId &owner, double threshold, int markersCategory, bool addSubclips, int minDuration, bool detectFades,
+                               QObject *object)
     : AbstractTask(owner, AbstractTask::ANALYSECLIPJOB, object)
     , m_threshold(threshold)
-    , m_jobDuration(0)
     , m_markersType(markersCategory)
     , m_subClips(addSubclips)
     , m_minInterval(minDuration)
+    , m_detectFades(detectFades)
 {
     m_description = i18n("Detecting scene change");
     qDebug() << "Threshold is" << threshold << QString::number(threshold);
@@ -51,6 +53,7 @@ void SceneSplitTask::start(QObject *object, bool force)
     view.threshold->setValue(KdenliveSettings::scenesplitthreshold());
     view.add_markers->setChecked(KdenliveSettings::scenesplitmarkers());
     view.cut_scenes->setChecked(KdenliveSettings::scenesplitsubclips());
+    view.detect_fades->setChecked(KdenliveSettings::scenesplitfades());
     // Set  up categories
     view.marker_category->setMarkerModel(pCore->projectManager()->getGuideModel().get());
     d->setWindowTitle(i18nc("@title:window", "Scene Detection"));
@@ -62,9 +65,11 @@ void SceneSplitTask::start(QObject *object, bool force)
     bool addSubclips = view.cut_scenes->isChecked();
     int markersCategory = addMarkers ? view.marker_category->currentCategory() : -1;
     int minDuration = view.minDuration->value();
+    bool detectFades = view.detect_fades->isChecked();
     KdenliveSettings::setScenesplitthreshold(threshold);
     KdenliveSettings::setScenesplitmarkers(view.add_markers->isChecked());
     KdenliveSettings::setScenesplitsubclips(view.cut_scenes->isChecked());
+    KdenliveSettings::setScenesplitfades(detectFades);
 
     std::vector<QString> binIds = pCore->activeBin()->selectedClipsIds(true);
     for (auto &id : binIds) {
@@ -79,12 +84,12 @@ void SceneSplitTask::start(QObject *object, bool force)
             }
             owner = ObjectId(KdenliveObjectType::BinClip, binData.first().toInt(), QUuid());
             auto binClip = pCore->projectItemModel()->getClipByBinID(binData.first());
-            task = new SceneSplitTask(owner, threshold / 100., markersCategory, addSubclips, minDuration, binClip.get());
+            task = new SceneSplitTask(owner, threshold / 100., markersCategory, addSubclips, minDuration, detectFades, binClip.get());
 
         } else {
             owner = ObjectId(KdenliveObjectType::BinClip, id.toInt(), QUuid());
             auto binClip = pCore->projectItemModel()->getClipByBinID(id);
-            task = new SceneSplitTask(owner, threshold / 100., markersCategory, addSubclips, minDuration, binClip.get());
+            task = new SceneSplitTask(owner, threshold / 100., markersCategory, addSubclips, minDuration, detectFades, binClip.get());
         }
         // See if there is already a task for this MLT service and resource.
         if (task && pCore->taskManager.hasPendingJob(owner, AbstractTask::ANALYSECLIPJOB)) {
@@ -119,62 +124,42 @@ void SceneSplitTask::run()
         qDebug() << "=== ABORT 1";
         return;
     }
-    if (KdenliveSettings::ffmpegpath().isEmpty()) {
-        // FFmpeg not detected, cannot process the Job
-        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection,
-                                  Q_ARG(QString, i18n("FFmpeg not found, please set path in Kdenlive's settings Environment.")),
+    int producerDuration = binClip->frameDuration();
+    // Frames are requested in the project profile, so that positions match the clip markers
+    Mlt::Producer producer(pCore->getProjectProfile(), source.toUtf8().constData());
+    if (!producer.is_valid()) {
+        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Cannot analyse this clip type.")),
                                   Q_ARG(int, int(KMessageWidget::Warning)));
-        qDebug() << "=== ABORT 2";
         return;
     }
-    m_jobDuration = int(binClip->duration().seconds());
-    int producerDuration = binClip->frameDuration();
-    // QStringList parameters =
-    // {QStringLiteral("-loglevel"),QStringLiteral("info"),QStringLiteral("-i"),source,QStringLiteral("-filter:v"),QStringLiteral("scdet"),QStringLiteral("-f"),QStringLiteral("null"),QStringLiteral("-")};
-    QStringList parameters = {QStringLiteral("-y"),
-                              QStringLiteral("-loglevel"),
-                              QStringLiteral("info"),
-                              QStringLiteral("-i"),
-                              source,
-                              QStringLiteral("-filter:v"),
-                              QStringLiteral("select='gt(scene,%1)',showinfo").arg(m_threshold),
-                              QStringLiteral("-vsync"),
-                              QStringLiteral("vfr"),
-                              QStringLiteral("-f"),
-                              QStringLiteral("null"),
-                              QStringLiteral("-")};
-
-    m_jobProcess = new QProcess(this);
-    // m_jobProcess->setStandardErrorFile("/tmp/test_settings.txt");
-    m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
-    qDebug() << "=== READY TO START JOB:" << parameters;
-    QObject::connect(this, &SceneSplitTask::jobCanceled, m_jobProcess, &QProcess::kill, Qt::DirectConnection);
-    QObject::connect(m_jobProcess, &QProcess::readyReadStandardOutput, this, &SceneSplitTask::processLogInfo);
-    QObject::connect(m_jobProcess, &QProcess::readyReadStandardError, this, &SceneSplitTask::processLogErr);
-    m_jobProcess->start(KdenliveSettings::ffmpegpath(), parameters);
-    // m_jobProcess->closeReadChannel(QProcess::StandardError);
-    m_jobProcess->waitForStarted();
-    // QString data;
-    /*while(m_jobProcess->waitForReadyRead()) {
-        //data.append(m_jobProcess->readAll());
-        qDebug()<<"???? READ: \n"<<m_jobProcess->readAll();
-    }*/
-    m_jobProcess->waitForFinished(-1);
-    result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+    const QString videoIndex = binClip->getProducerProperty(QStringLiteral("video_index"));
+    if (!videoIndex.isEmpty()) {
+        producer.set("video_index", videoIndex.toUtf8().constData());
+    }
+    auto progressCallback = [this](int progress) {
+        if (m_progress != progress) {
+            m_progress = progress;
+            QMetaObject::invokeMethod(m_object, "updateJobProgress");
+        }
+    };
+    m_results = detectScenes(producer, m_threshold, m_detectFades, progressCallback, m_isCanceled, &result);
 
-    // remove temporary playlist if it exists
     m_progress = 100;
     QMetaObject::invokeMethod(m_object, "updateJobProgress");
-    if (result && !m_isCanceled) {
-        qDebug() << "========================\n\nGOR RESULTS: " << m_results << "\n\n=========";
+    if (m_isCanceled) {
+        // Don't apply the cuts found before the cancellation
+        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Scene detection canceled.")),
+                                  Q_ARG(int, int(KMessageWidget::Information)));
+        return;
+    }
+    if (result) {
         auto binClip = pCore->projectItemModel()->getClipByBinID(QString::number(m_owner.itemId));
         if (m_markersType >= 0) {
             // Build json data for markers
             QJsonArray list;
             int ix = 1;
             int lastCut = 0;
-            for (auto &marker : m_results) {
-                int pos = GenTime(marker).frames(pCore->getCurrentFps());
+            for (int pos : std::as_const(m_results)) {
                 if (m_minInterval > 0 && ix > 1 && pos - lastCut < m_minInterval) {
                     continue;
                 }
@@ -195,8 +180,7 @@ void SceneSplitTask::run()
             int lastCut = 0;
             QJsonArray list;
             QJsonDocument json;
-            for (double &marker : m_results) {
-                int pos = GenTime(marker).frames(pCore->getCurrentFps());
+            for (int pos : std::as_const(m_results)) {
                 if (pos <= lastCut + 1 || pos - lastCut < m_minInterval) {
                     continue;
                 }
@@ -223,71 +207,48 @@ void SceneSplitTask::run()
             }
         }
     } else {
-        // Proxy process crashed
-        QMetaObject::invokeMethod(pCore.get(), "displayBinLogMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Failed to analyse clip.")),
-                                  Q_ARG(int, int(KMessageWidget::Warning)), Q_ARG(QString, m_logDetails));
+        // A frame could not be decoded, the cuts of the remaining frames are unknown
+        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Failed to analyse clip.")),
+                                  Q_ARG(int, int(KMessageWidget::Warning)));
     }
 }
 
-void SceneSplitTask::processLogErr()
+QVector<int> SceneSplitTask::detectScenes(Mlt::Producer &producer, double threshold, bool detectFades, const std::function<void(int progress)> &progressCallback,
+                                          const QAtomicInt &isCanceled, bool *ok)
 {
-    const QString buffer = QString::fromUtf8(m_jobProcess->readAllStandardError());
-    qDebug() << "ERROR: ----\n" << buffer;
-}
-
-void SceneSplitTask::processLogInfo()
-{
-    const QString buffer = QString::fromUtf8(m_jobProcess->readAllStandardOutput());
-    m_logDetails.append(buffer);
-    int progress = 0;
-    // Parse FFmpeg output
-    qDebug() << "-------------\n" << buffer;
-    if (buffer.contains(QLatin1String("[Parsed_showinfo"))) {
-        QString timeMarker("pts_time:");
-        bool ok;
-        QStringList output = buffer.split("[Parsed_showinfo");
-        output.removeFirst();
-        for (const QString &o : std::as_const(output)) {
-            if (o.contains(timeMarker)) {
-                double res = o.section(timeMarker, 1).section(QLatin1Char(' '), 0, 0).toDouble(&ok);
-                if (ok) {
-                    m_results << res;
-                }
-            }
-        }
+    if (ok) {
+        *ok = true;
     }
-    if (m_jobDuration == 0) {
-        qDebug() << "=== NO DURATION!!!";
-        if (buffer.contains(QLatin1String("Duration:"))) {
-            QString data = buffer.section(QStringLiteral("Duration:"), 1, 1).section(QLatin1Char(','), 0, 0).simplified();
-            if (!data.isEmpty()) {
-                qDebug() << "==== GOT DURATION:" << data;
-                QStringList numbers = data.split(QLatin1Char(':'));
-                if (numbers.size() < 3) {
-                    return;
-                }
-                m_jobDuration = numbers.at(0).toInt() * 3600 + numbers.at(1).toInt() * 60 + numbers.at(2).toInt();
-            }
+    producer.set("audio_index", -1);
+    producer.set("cache", 0);
+    SceneChangeDetector detector(threshold, true, detectFades);
+    const int length = producer.get_length();
+    // The detector works on a small luma grid, so let MLT decode at a reduced size
+    const int analysisWidth = SceneChangeDetector::GridWidth * 4;
+    const int analysisHeight = SceneChangeDetector::GridHeight * 4;
+    for (int i = 0; i < length; ++i) {
+        if (isCanceled) {
+            break;
         }
-    } else if (buffer.contains(QLatin1String("time="))) {
-        QString time = buffer.section(QStringLiteral("time="), 1, 1).simplified().section(QLatin1Char(' '), 0, 0);
-        qDebug() << "=== GOT PROGRESS TIME: " << time;
-        if (!time.isEmpty()) {
-            QStringList numbers = time.split(QLatin1Char(':'));
-            if (numbers.size() < 3) {
-                progress = time.toInt();
-                if (progress == 0) {
-                    return;
-                }
-            } else {
-                progress = numbers.at(0).toInt() * 3600 + numbers.at(1).toInt() * 60 + qRound(numbers.at(2).toDouble());
+        std::unique_ptr<Mlt::Frame> frame(producer.get_frame());
+        if (frame == nullptr || !frame->is_valid()) {
+            if (ok) {
+                *ok = false;
             }
+            break;
         }
-        int val = 100 * progress / m_jobDuration;
-        if (m_progress != val) {
-            m_progress = val;
-            QMetaObject::invokeMethod(m_object, "updateJobProgress");
+        frame->set("consumer.rescale", "bilinear");
+        frame->set("consumer.deinterlacer", "onefield");
+        mlt_image_format format = mlt_image_yuv420p;
+        int width = analysisWidth;
+        int height = analysisHeight;
+        const uint8_t *image = frame->get_image(format, width, height);
+        if (format == mlt_image_yuv420p) {
+            detector.addFrame(frame->get_position(), image, width, height, width);
+        } else if (format == mlt_image_yuv422) {
+            detector.addFrame(frame->get_position(), image, width, height, width * 2, 2);
         }
-        // Q_EMIT jobProgress(int(100.0 * progress / m_jobDuration));
+        progressCallback(100 * i / length);
     }
+    return detector.cuts();
 }
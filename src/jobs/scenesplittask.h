@@ -8,29 +8,37 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #include "abstracttask.h"
 
-class QProcess;
+#include <QVector>
+#include <functional>
+
+namespace Mlt {
+class Producer;
+}
 
 class SceneSplitTask : public AbstractTask
 {
 public:
-    SceneSplitTask(const ObjectId &owner, double threshold, int markersCategory, bool addSubclips, int minDuration, QObject* object);
+    SceneSplitTask(const ObjectId &owner, double threshold, int markersCategory, bool addSubclips, int minDuration, bool detectFades, QObject *object);
     static void start(QObject* object, bool force = false);
+    /** @brief Decode all frames of a producer and return the positions of the detected scene cuts.
+     *  @param producer the producer to analyse, frames are requested at a reduced size
+     *  @param threshold the scene score above which a cut is reported, in the 0-1 range
+     *  @param detectFades if true, fades through black are also reported
+     *  @param progressCallback process callback function
+     *  @param isCanceled task cancelled semaphore, 0 = not cancelled, 1 = cancelled
+     *  @param ok if not null, set to false when a frame could not be decoded
+     */
+    static QVector<int> detectScenes(Mlt::Producer &producer, double threshold, bool detectFades, const std::function<void(int progress)> &progressCallback,
+                                     const QAtomicInt &isCanceled, bool *ok = nullptr);
 
 protected:
     void run() override;
 
-private Q_SLOTS:
-    void processLogInfo();
-    void processLogErr();
-
 private:
     double m_threshold;
-    int m_jobDuration;
     int m_markersType;
     bool m_subClips;
     int m_minInterval;
-    QProcess *m_jobProcess;
-    QString m_errorMessage;
-    QString m_logDetails;
-    QList<double> m_results;
+    bool m_detectFades;
+    QVector<int> m_results;
 };
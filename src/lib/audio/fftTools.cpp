@@ -8,17 +8,25 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "fftTools.h"
 
 #include <cmath>
-#include <iostream>
+#include <cstring>
 
 #include <QString>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FFTTOOLS_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define FFTTOOLS_NEON
+#include <arm_neon.h>
+#endif
+
 // Uncomment for debugging, like writing a GNU Octave .m file to /tmp
 //#define DEBUG_FFTTOOLS
 
 #ifdef DEBUG_FFTTOOLS
 #include "kdenlive_debug.h"
+#include <QElapsedTimer>
 #include <QTime>
-#include <fstream>
 #endif
 
 FFTTools::FFTTools()
@@ -28,21 +36,11 @@ FFTTools::FFTTools()
 }
 FFTTools::~FFTTools()
 {
-    QHash<QString, kiss_fftr_cfg>::iterator i;
-    for (i = m_fftCfgs.begin(); i != m_fftCfgs.end(); ++i) {
-        free(*i);
+    for (auto i = m_fftCfgs.begin(); i != m_fftCfgs.end(); ++i) {
+        kiss_fftr_free(*i);
     }
 }
 
-const QString FFTTools::windowSignature(const WindowType windowType, const int size, const float param)
-{
-    return QStringLiteral("s%1_t%2_p%3").arg(size).arg(windowType).arg(param, 0, 'f', 3);
-}
-const QString FFTTools::cfgSignature(const int size)
-{
-    return QStringLiteral("s%1").arg(size);
-}
-
 // https://cplusplus.syntaxerrors.info/index.php?title=Cannot_declare_member_function_%E2%80%98static_int_Foo::bar%28%29%E2%80%99_to_have_static_linkage
 const QVector<float> FFTTools::window(const WindowType windowType, const int size, const float param)
 {
@@ -105,124 +103,199 @@ const QVector<float> FFTTools::window(const WindowType windowType, const int siz
     return QVector<float>();
 }
 
-void FFTTools::fftNormalized(const audioShortVector &audioFrame, const uint channel, const uint numChannels, float *freqSpectrum, const WindowType windowType,
-                             const uint windowSize, const float param)
+kiss_fftr_cfg FFTTools::fftConfig(const int size)
 {
+    // Get the kiss_fft configuration from the config cache
+    // or build a new configuration if the requested one is not available.
+    auto it = m_fftCfgs.constFind(size);
+    if (it != m_fftCfgs.constEnd()) {
+        return it.value();
+    }
 #ifdef DEBUG_FFTTOOLS
-    QTime start = QTime::currentTime();
+    qCDebug(KDENLIVE_LOG) << "Creating FFT configuration with size " << size;
 #endif
+    kiss_fftr_cfg cfg = kiss_fftr_alloc(size, 0, nullptr, nullptr);
+    m_fftCfgs.insert(size, cfg);
+    return cfg;
+}
 
-    const uint numSamples = uint(audioFrame.size()) / numChannels;
-
-    if (((windowSize & 1) != 0u) || windowSize < 2) {
-        return;
+const QVector<float> &FFTTools::windowFunction(const WindowType windowType, const int size, const float param)
+{
+    const WindowKey key{windowType, size, param};
+    auto it = m_windowFunctions.find(key);
+    if (it == m_windowFunctions.end()) {
+#ifdef DEBUG_FFTTOOLS
+        qCDebug(KDENLIVE_LOG) << "Building new window function of type" << windowType << "with size" << size;
+#endif
+        it = m_windowFunctions.insert(key, FFTTools::window(windowType, size, param));
     }
+    return it.value();
+}
 
-    const QString cfgSig = cfgSignature(int(windowSize));
-    const QString winSig = windowSignature(windowType, int(windowSize), param);
+void FFTTools::deinterleave(const qint16 *in, const uint channel, const uint numChannels, float *out, const uint count)
+{
+    constexpr float factor = 1.f / 32767.f;
+    in += channel;
+    for (uint i = 0; i < count; ++i) {
+        out[i] = float(*in) * factor;
+        in += numChannels;
+    }
+}
 
-    // Get the kiss_fft configuration from the config cache
-    // or build a new configuration if the requested one is not available.
-    kiss_fftr_cfg myCfg;
-    if (m_fftCfgs.contains(cfgSig)) {
-#ifdef DEBUG_FFTTOOLS
-        qCDebug(KDENLIVE_LOG) << "Re-using FFT configuration with size " << windowSize;
+void FFTTools::applyWindow(float *data, const float *window, const uint count)
+{
+    uint i = 0;
+#if defined(FFTTOOLS_SSE)
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(window + i)));
+    }
+#elif defined(FFTTOOLS_NEON)
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), vld1q_f32(window + i)));
+    }
 #endif
-        myCfg = m_fftCfgs.value(cfgSig);
-    } else {
-#ifdef DEBUG_FFTTOOLS
-        qCDebug(KDENLIVE_LOG) << "Creating FFT configuration with size " << windowSize;
+    for (; i < count; ++i) {
+        data[i] *= window[i];
+    }
+}
+
+void FFTTools::magnitudeDb(const kiss_fft_cpx *in, float *out, const uint count, const float scale)
+{
+    // 20 * log10(scale * sqrt(r² + i²)) = 10 * log10(scale² * (r² + i²)), which avoids the square root.
+    // The squared magnitudes are computed in out first, then converted in place.
+    const float scale2 = scale * scale;
+    const float *values = reinterpret_cast<const float *>(in);
+    uint i = 0;
+#if defined(FFTTOOLS_SSE)
+    const __m128 vScale = _mm_set1_ps(scale2);
+    for (; i + 4 <= count; i += 4) {
+        // Two complex values per register, as r0 i0 r1 i1
+        const __m128 a = _mm_loadu_ps(values + 2 * i);
+        const __m128 b = _mm_loadu_ps(values + 2 * i + 4);
+        const __m128 a2 = _mm_mul_ps(a, a);
+        const __m128 b2 = _mm_mul_ps(b, b);
+        const __m128 re = _mm_shuffle_ps(a2, b2, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 im = _mm_shuffle_ps(a2, b2, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_add_ps(re, im), vScale));
+    }
+#elif defined(FFTTOOLS_NEON)
+    const float32x4_t vScale = vdupq_n_f32(scale2);
+    for (; i + 4 <= count; i += 4) {
+        const float32x4x2_t v = vld2q_f32(values + 2 * i);
+        const float32x4_t power = vmlaq_f32(vmulq_f32(v.val[0], v.val[0]), v.val[1], v.val[1]);
+        vst1q_f32(out + i, vmulq_f32(power, vScale));
+    }
 #endif
-        myCfg = kiss_fftr_alloc(int(windowSize), 0, nullptr, nullptr);
-        m_fftCfgs.insert(cfgSig, myCfg);
+    for (; i < count; ++i) {
+        out[i] = (in[i].r * in[i].r + in[i].i * in[i].i) * scale2;
+    }
+    for (i = 0; i < count; ++i) {
+        out[i] = 10.f * log10f(out[i]);
     }
+}
 
-    // Get the window function from the cache
-    // (except for a rectangular window; nothing to do there).
-    QVector<float> window;
-    float windowScaleFactor = 1;
-    if (windowType != FFTTools::Window_Rect) {
+void FFTTools::fftNormalized(const audioShortVector &audioFrame, const uint channel, const uint numChannels, float *freqSpectrum, const WindowType windowType,
+                             const uint windowSize, const float param)
+{
+    if (((windowSize & 1) != 0u) || windowSize < 2 || numChannels == 0) {
+        return;
+    }
+    const uint numSamples = qMin(uint(audioFrame.size()) / numChannels, windowSize);
+    if (m_timeData.size() < int(windowSize)) {
+        m_timeData.resize(int(windowSize));
+    }
+    // Copy the channel's audio into a vector for the FFT display
+    // Normalize signals to [-1,1] to get correct dB values later on
+    deinterleave(audioFrame.constData(), channel, numChannels, m_timeData.data(), numSamples);
+    fftNormalized(m_timeData.constData(), numSamples, freqSpectrum, windowType, windowSize, param);
+}
 
-        if (m_windowFunctions.contains(winSig)) {
-#ifdef DEBUG_FFTTOOLS
-            qCDebug(KDENLIVE_LOG) << "Re-using window function with signature " << winSig;
-#endif
-            window = m_windowFunctions.value(winSig);
-        } else {
+void FFTTools::fftNormalized(const float *samples, const uint numSamples, float *freqSpectrum, const WindowType windowType, const uint windowSize,
+                             const float param)
+{
 #ifdef DEBUG_FFTTOOLS
-            qCDebug(KDENLIVE_LOG) << "Building new window function with signature " << winSig;
+    QElapsedTimer timer;
+    timer.start();
 #endif
-            window = FFTTools::window(windowType, int(windowSize), 0);
-            m_windowFunctions.insert(winSig, window);
-        }
-        windowScaleFactor = 1.0f / window[int(windowSize)];
+
+    if (((windowSize & 1) != 0u) || windowSize < 2) {
+        return;
     }
 
-    // Prepare frequency space vector. The resulting FFT vector is only half as long.
-    auto *freqData = new kiss_fft_cpx[size_t(windowSize) / 2];
-    auto *data = new float[size_t(windowSize)];
+    kiss_fftr_cfg myCfg = fftConfig(int(windowSize));
 
-    // Copy the first channel's audio into a vector for the FFT display;
-    // Fill the data vector indices that cannot be covered with sample data with 0
-    if (numSamples < windowSize) {
-        std::fill(&data[numSamples], &data[windowSize - 1], 0);
+    // Prepare the input vector, which may be the one samples were already copied to.
+    // The resulting FFT vector is only half as long (plus the Nyquist frequency).
+    if (m_timeData.size() < int(windowSize)) {
+        m_timeData.resize(int(windowSize));
     }
-    // Normalize signals to [0,1] to get correct dB values later on
-    for (uint i = 0; i < numSamples && i < windowSize; ++i) {
-        // Performance note: Benchmarking has shown that using the if/else inside the loop
-        // does not do noticeable worse than keeping it outside (perhaps the branch predictor
-        // is good enough), so it remains in there for better readability.
-        if (windowType != FFTTools::Window_Rect) {
-            data[i] = float(audioFrame.data()[i * numChannels + channel]) / 32767.0f * window[int(i)];
-        } else {
-            data[i] = float(audioFrame.data()[i * numChannels + channel]) / 32767.0f;
-        }
+    if (m_freqData.size() < int(windowSize / 2 + 1)) {
+        m_freqData.resize(int(windowSize / 2 + 1));
+    }
+    float *data = m_timeData.data();
+    const uint count = qMin(numSamples, windowSize);
+    if (samples != data) {
+        memcpy(data, samples, count * sizeof(float));
+    }
+    // Fill the data vector indices that cannot be covered with sample data with 0
+    std::fill(data + count, data + windowSize, 0.f);
+
+    // Apply the window function (except for a rectangular window; nothing to do there).
+    float windowScaleFactor = 1;
+    if (windowType != FFTTools::Window_Rect) {
+        const QVector<float> &window = windowFunction(windowType, int(windowSize), param);
+        applyWindow(data, window.constData(), count);
+        windowScaleFactor = 1.0f / window[int(windowSize)];
     }
 
     // Calculate the Fast Fourier Transform for the input data
-    kiss_fftr(myCfg, data, freqData);
+    kiss_fftr(myCfg, data, m_freqData.data());
 
     // Logarithmic scale: 20 * log ( 2 * magnitude / N ) with magnitude = sqrt(r² + i²)
     // with N = FFT size (after FFT, 1/2 window size)
-    for (uint i = 0; i < windowSize / 2; ++i) {
-        // Logarithmic scale: 20 * log ( 2 * magnitude / N ) with magnitude = sqrt(r² + i²)
-        // with N = FFT size (after FFT, 1/2 window size)
-        freqSpectrum[i] =
-            20 *
-            logf(powf(powf(fabs(freqData[i].r * windowScaleFactor), 2) + powf(fabs(freqData[i].i * windowScaleFactor), 2), .5) / (float(windowSize) / 2.0f)) /
-            logf(10);
-        ;
-    }
+    magnitudeDb(m_freqData.constData(), freqSpectrum, windowSize / 2, windowScaleFactor / (float(windowSize) / 2.0f));
 
 #ifdef DEBUG_FFTTOOLS
-    std::ofstream mFile;
-    mFile.open("/tmp/freq.m");
-    if (!mFile) {
-        qCDebug(KDENLIVE_LOG) << "Opening file failed.";
-    } else {
-        mFile << "val = [ ";
-
-        for (int sample = 0; sample < 256; ++sample) {
-            mFile << data[sample] << ' ';
-        }
-        mFile << " ];\n";
+    qCDebug(KDENLIVE_LOG) << "Calculated FFT in " << timer.elapsed() << " ms.";
+#endif
+}
 
-        mFile << "freq = [ ";
-        for (int sample = 0; sample < 256; ++sample) {
-            mFile << freqData[sample].r << '+' << freqData[sample].i << "*i ";
-        }
-        mFile << " ];\n";
+QVector<QVector<float>> FFTTools::stft(const audioShortVector &audioFrame, const uint channel, const uint numChannels, const WindowType windowType,
+                                       const uint windowSize, const uint hopSize, const float param)
+{
+    QVector<QVector<float>> result;
+    if (((windowSize & 1) != 0u) || windowSize < 2 || hopSize == 0 || numChannels == 0) {
+        return result;
+    }
+    const int numSamples = int(uint(audioFrame.size()) / numChannels);
+    const int pending = m_stftPending.size();
+    m_stftPending.resize(pending + numSamples);
+    deinterleave(audioFrame.constData(), channel, numChannels, m_stftPending.data() + pending, uint(numSamples));
+
+    // Do not let the backlog grow if the scope cannot keep up, a few windows are enough
+    const int maxPending = int(windowSize + 8 * hopSize);
+    if (m_stftPending.size() > maxPending) {
+        m_stftPending.remove(0, m_stftPending.size() - maxPending);
+    }
 
-        mFile.close();
-        qCDebug(KDENLIVE_LOG) << "File written.";
+    int offset = 0;
+    if (m_stftSpectrum.size() < int(windowSize / 2)) {
+        m_stftSpectrum.resize(int(windowSize / 2));
     }
-#endif
+    while (offset + int(windowSize) <= m_stftPending.size()) {
+        fftNormalized(m_stftPending.constData() + offset, windowSize, m_stftSpectrum.data(), windowType, windowSize, param);
+        result << QVector<float>(m_stftSpectrum.constBegin(), m_stftSpectrum.constBegin() + int(windowSize / 2));
+        offset += int(hopSize);
+    }
+    if (offset > 0) {
+        m_stftPending.remove(0, qMin(offset, m_stftPending.size()));
+    }
+    return result;
+}
 
-#ifdef DEBUG_FFTTOOLS
-    qCDebug(KDENLIVE_LOG) << "Calculated FFT in " << start.elapsed() << " ms.";
-#endif
-    delete[] freqData;
-    delete[] data;
+void FFTTools::resetStft()
+{
+    m_stftPending.clear();
 }
 
 const QVector<float> FFTTools::interpolatePeakPreserving(const QVector<float> &in, const uint targetSize, uint left, uint right, float fill)
@@ -35,12 +35,6 @@ public:
     */
     static const QVector<float> window(const WindowType windowType, const int size, const float param = 0);
 
-    static const QString windowSignature(const WindowType windowType, const int size, const float param = 0);
-
-    /** Returns a signature for a kiss_fft configuration
-        used as a hash in the cache */
-    static const QString cfgSignature(const int size);
-
     /** Calculates the Fourier Transformation of the input audio frame.
         The resulting values will be given in relative decibel: The maximum power is 0 dB, lower powers have
         negative dB values.
@@ -53,6 +47,31 @@ public:
     void fftNormalized(const audioShortVector &audioFrame, const uint channel, const uint numChannels, float *freqSpectrum, const WindowType windowType,
                        const uint windowSize, const float param = 0);
 
+    /** Same as above for a single channel of samples already normalized to [-1,1].
+        * samples: windowSize values, or less in which case the remaining values are considered as silence
+    */
+    void fftNormalized(const float *samples, const uint numSamples, float *freqSpectrum, const WindowType windowType, const uint windowSize,
+                       const float param = 0);
+
+    /** Overlapped short-time Fourier transformation.
+        The samples of the given channel are appended to the samples left over from the previous call, and a
+        spectrum (see fftNormalized()) is calculated every hopSize samples, so that consecutive windows overlap
+        by windowSize - hopSize samples.
+        Returns the calculated spectra, the oldest first. Samples are kept for the next call until a full window
+        is available; if too many are pending, the oldest are dropped so that processing can keep up.
+    */
+    QVector<QVector<float>> stft(const audioShortVector &audioFrame, const uint channel, const uint numChannels, const WindowType windowType,
+                                 const uint windowSize, const uint hopSize, const float param = 0);
+    /** Discards the samples left over by stft() */
+    void resetStft();
+
+    /** Copies one channel of interleaved samples to out, normalized to [-1,1] */
+    static void deinterleave(const qint16 *in, const uint channel, const uint numChannels, float *out, const uint count);
+    /** Multiplies data with the window function, in place */
+    static void applyWindow(float *data, const float *window, const uint count);
+    /** Writes the power in relative decibel of count FFT bins, 20 * log10(scale * magnitude) */
+    static void magnitudeDb(const kiss_fft_cpx *in, float *out, const uint count, const float scale);
+
     /** This is linear interpolation with the special property that it preserves peaks, which is required
         for e.g. showing correct Decibel values (where the peak values are of interest because of clipping which
         may occur for too strong frequencies; The lower values are smeared by the window function anyway).
@@ -69,7 +88,28 @@ public:
         */
     static const QVector<float> interpolatePeakPreserving(const QVector<float> &in, const uint targetSize, uint left = 0, uint right = 0, float fill = 0.0);
 
+    /** Key of the window function cache */
+    struct WindowKey
+    {
+        WindowType type;
+        int size;
+        float param;
+        bool operator==(const WindowKey &other) const { return type == other.type && size == other.size && param == other.param; }
+    };
+
 private:
-    QHash<QString, kiss_fftr_cfg> m_fftCfgs;          // FFT cfg cache
-    QHash<QString, QVector<float>> m_windowFunctions; // Window function cache
+    QHash<int, kiss_fftr_cfg> m_fftCfgs;                // FFT cfg cache, by window size
+    QHash<WindowKey, QVector<float>> m_windowFunctions; // Window function cache
+    // Buffers reused between calls
+    QVector<float> m_timeData;
+    QVector<kiss_fft_cpx> m_freqData;
+    QVector<float> m_stftPending;
+    QVector<float> m_stftSpectrum;
+    kiss_fftr_cfg fftConfig(const int size);
+    const QVector<float> &windowFunction(const WindowType windowType, const int size, const float param);
 };
+
+inline size_t qHash(const FFTTools::WindowKey &key, size_t seed = 0)
+{
+    return qHashMulti(seed, int(key.type), key.size, key.param);
+}
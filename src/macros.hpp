@@ -55,6 +55,19 @@ reading a Read-protected property. In that case, we try to write lock it first (
         Q_ASSERT(false);                                                                                                                                       \
     }
 
+/** @brief Same as PUSH_UNDO, but consecutive commands with the same text pushed during a merge session of the undo stack
+ * (see DocUndoStack::beginMergeSession) are merged in one undo entry, to keep repeated edits compact in the undo history
+ */
+#define PUSH_UNDO_MERGEABLE(undo, redo, text)                                                                                                                  \
+    if (auto ptr = m_undoStack.lock()) {                                                                                                                       \
+        auto *mergeableCommand = new FunctionalUndoCommand(undo, redo, text);                                                                                  \
+        mergeableCommand->setMergeKey(ptr->mergeSession());                                                                                                    \
+        ptr->push(mergeableCommand);                                                                                                                           \
+    } else {                                                                                                                                                   \
+        qDebug() << "ERROR : unable to access undo stack";                                                                                                     \
+        Q_ASSERT(false);                                                                                                                                       \
+    }
+
 /** @brief This macro takes as parameter one atomic operation and its reverse, and update
  * the undo and redo functional stacks/queue accordingly
  * This should be used in the rare case where we don't need a lock mutex. In general, prefer the other version
@@ -17,6 +17,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "lib/localeHandling.h"
 #include "mainwindow.h"
 #include "render/renderrequest.h"
+#include "utils/startuptimer.h"
 #include <config-kdenlive.h>
 #include <project/projectmanager.h>
 
@@ -49,7 +50,10 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QCommandLineOption>
 #include <QCommandLineParser>
 #include <QDir>
+#include <QEventLoop>
 #include <QIcon>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QProcess>
 #include <QQmlEngine>
 #include <QQuickStyle>
@@ -58,6 +62,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QSplashScreen>
 #include <QUndoGroup>
 #include <QUrl> //new
+#include <algorithm>
 
 #ifdef Q_OS_WIN
 extern "C" {
@@ -165,6 +170,24 @@ static void resetConfig()
     }
 }
 
+/** @brief Returns true if Kdenlive was started to render a project from the command line */
+static bool isCommandLineRender(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (qstrcmp(argv[i], "--render") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief Print a render event as a JSON line on stdout, for unattended renders */
+static void printRenderEvent(const QJsonObject &event)
+{
+    fprintf(stdout, "%s\n", QJsonDocument(event).toJson(QJsonDocument::Compact).constData());
+    fflush(stdout);
+}
+
 class Application : public QApplication
 {
 public:
@@ -239,6 +262,14 @@ int main(int argc, char *argv[])
     // trigger initialisation of proper icon theme
     KIconTheme::initTheme();
 
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
+    if (isCommandLineRender(argc, argv) && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM") && qEnvironmentVariableIsEmpty("DISPLAY") &&
+        qEnvironmentVariableIsEmpty("WAYLAND_DISPLAY")) {
+        // Render farm without display server, the render processes inherit this
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+#endif
+
     Application app(argc, argv);
 
     // Default to org.kde.desktop style unless the user forces another style
@@ -347,6 +378,8 @@ int main(int argc, char *argv[])
     parser.addOption(mltLogLevelOption);
     QCommandLineOption clipsOption(QStringLiteral("i"), i18n("Comma separated list of files to add as clips to the bin."), QStringLiteral("clips"));
     parser.addOption(clipsOption);
+    QCommandLineOption startupTimingOption(QStringLiteral("startup-timing"), i18n("Print the time spent in each startup stage."));
+    parser.addOption(startupTimingOption);
 
     // render options
     QCommandLineOption renderOption(QStringLiteral("render"), i18n("Directly render the project and exit."));
@@ -360,12 +393,27 @@ int main(int argc, char *argv[])
                                   i18n("Exit after (detached) render process started, without this flag it exists only after it finished."));
     parser.addOption(exitOption);
 
+    QCommandLineOption proxyOption(QStringLiteral("render-proxy"), i18n("Use the proxy clips of the project when rendering."));
+    parser.addOption(proxyOption);
+
+    QCommandLineOption rangeOption(QStringLiteral("render-range"), i18n("Frame range to render, as in-out (the whole project if none given)."),
+                                   QStringLiteral("in-out"));
+    parser.addOption(rangeOption);
+
+    QCommandLineOption guidesOption(QStringLiteral("render-guides"), i18n("Render one file per section between the guides of this category."),
+                                    QStringLiteral("category"));
+    parser.addOption(guidesOption);
+
+    QCommandLineOption jsonOption(QStringLiteral("render-json"), i18n("Print the render progress as JSON lines on standard output."));
+    parser.addOption(jsonOption);
+
     parser.addPositionalArgument(QStringLiteral("file"), i18n("Kdenlive document to open."));
     parser.addPositionalArgument(QStringLiteral("rendering"), i18n("Output file for rendered video."));
 
     // Parse command line
     parser.process(app);
     aboutData.processCommandLine(&parser);
+    StartupTimer::setEnabled(parser.isSet(startupTimingOption));
 
     QUrl renderUrl;
     QString presetName;
@@ -417,14 +465,33 @@ int main(int argc, char *argv[])
         renderrequest->loadPresetParams(presetName);
         // request->setPresetParams(m_params);
         renderrequest->setDelayedRendering(false);
-        renderrequest->setProxyRendering(false);
+        renderrequest->setProxyRendering(parser.isSet(proxyOption));
         renderrequest->setEmbedSubtitles(false);
         renderrequest->setTwoPass(false);
         renderrequest->setAudioFilePerTrack(false);
 
-        /*bool guideMultiExport = false;
-        int guideCategory = m_view.guideCategoryChooser->currentCategory();
-        renderrequest->setGuideParams(m_guidesModel, guideMultiExport, guideCategory);*/
+        if (parser.isSet(rangeOption)) {
+            const QString range = parser.value(rangeOption);
+            bool inOk = false;
+            bool outOk = false;
+            int in = range.section(QLatin1Char('-'), 0, 0).toInt(&inOk);
+            int out = range.section(QLatin1Char('-'), 1, 1).toInt(&outOk);
+            if (!inOk || !outOk || out < in) {
+                qCritical() << "Invalid render range" << range << ", expected in-out frames.";
+                return EXIT_FAILURE;
+            }
+            renderrequest->setBounds(in, out);
+        }
+        if (parser.isSet(guidesOption)) {
+            bool ok = false;
+            int guideCategory = parser.value(guidesOption).toInt(&ok);
+            if (!ok) {
+                qCritical() << "Invalid guide category" << parser.value(guidesOption);
+                return EXIT_FAILURE;
+            }
+            renderrequest->setGuideParams(pCore->currentDoc()->getGuideModel(pCore->currentTimelineId()), true, guideCategory);
+        }
+        const bool jsonProgress = parser.isSet(jsonOption);
 
         renderrequest->setOverlayData(QString());
         std::vector<RenderRequest::RenderJob> renderjobs = renderrequest->process();
@@ -432,22 +499,64 @@ int main(int argc, char *argv[])
 
         if (!renderrequest->errorMessages().isEmpty()) {
             qInfo() << "The following errors occurred while trying to render:\n" << renderrequest->errorMessages().join(QLatin1Char('\n'));
+            if (jsonProgress) {
+                printRenderEvent({{QStringLiteral("event"), QStringLiteral("error")}, {QStringLiteral("message"), renderrequest->errorMessages().join(QLatin1Char('\n'))}});
+            }
         }
 
         int exitCode = EXIT_SUCCESS;
+        // Render jobs (for example guide sections) run in parallel, with the same limit as the render queue
+        const int maxJobs = RenderRequest::renderJobSlots();
+        std::vector<std::unique_ptr<QProcess>> runningJobs;
+        // Quit by the finished signal of the render processes
+        QEventLoop jobLoop;
+        auto waitForJob = [&runningJobs, &exitCode, &jobLoop]() {
+            auto isFinished = [](const std::unique_ptr<QProcess> &process) { return process->state() == QProcess::NotRunning; };
+            auto it = std::find_if(runningJobs.begin(), runningJobs.end(), isFinished);
+            if (it == runningJobs.end()) {
+                jobLoop.exec();
+                it = std::find_if(runningJobs.begin(), runningJobs.end(), isFinished);
+            }
+            if (it == runningJobs.end()) {
+                return;
+            }
+            if ((*it)->exitStatus() != QProcess::NormalExit || (*it)->exitCode() != EXIT_SUCCESS) {
+                exitCode = EXIT_FAILURE;
+            }
+            runningJobs.erase(it);
+        };
 
         for (const auto &job : renderjobs) {
             QStringList argsJob = RenderRequest::argsByJob(job, false);
             if (parser.value(mltLogLevelOption) == QStringLiteral("debug")) {
                 argsJob << "--debug";
             }
+            if (jsonProgress) {
+                argsJob << QStringLiteral("--json");
+            }
             qDebug() << "* CREATED JOB WITH ARGS: " << argsJob;
             qDebug() << "starting kdenlive_render process using: " << KdenliveSettings::kdenliverendererpath();
             if (!parser.isSet(exitOption)) {
-                if (QProcess::execute(KdenliveSettings::kdenliverendererpath(), argsJob) != EXIT_SUCCESS) {
+                while (int(runningJobs.size()) >= maxJobs) {
+                    waitForJob();
+                }
+                if (exitCode != EXIT_SUCCESS) {
+                    break;
+                }
+                auto process = std::make_unique<QProcess>();
+                // Forward the progress of the render process
+                process->setProcessChannelMode(QProcess::ForwardedChannels);
+                QObject::connect(process.get(), &QProcess::finished, &jobLoop, &QEventLoop::quit);
+                process->start(KdenliveSettings::kdenliverendererpath(), argsJob);
+                if (!process->waitForStarted()) {
+                    qCritical() << "Error starting render job" << argsJob;
                     exitCode = EXIT_FAILURE;
                     break;
                 }
+                if (jsonProgress) {
+                    printRenderEvent({{QStringLiteral("event"), QStringLiteral("started")}, {QStringLiteral("url"), job.outputFile}});
+                }
+                runningJobs.push_back(std::move(process));
             } else {
                 if (!QProcess::startDetached(KdenliveSettings::kdenliverendererpath(), argsJob)) {
                     qCritical() << "Error starting render job" << argsJob;
@@ -458,6 +567,12 @@ int main(int argc, char *argv[])
                 }
             }
         }
+        while (!runningJobs.empty()) {
+            waitForJob();
+        }
+        if (jsonProgress) {
+            printRenderEvent({{QStringLiteral("event"), QStringLiteral("done")}, {QStringLiteral("status"), exitCode}});
+        }
         /*QMapIterator<QString, QString> i(rendermanager->m_renderFiles);
         while (i.hasNext()) {
             i.next();
@@ -508,10 +623,12 @@ int main(int argc, char *argv[])
     }
     const QString clipsToLoad = parser.value(clipsOption);
     qApp->processEvents(QEventLoop::AllEvents);
+    StartupTimer::mark(QString(), QStringLiteral("Application setup"));
     if (!Core::build(packageType)) {
         // App is crashing, delete config files and restart
         result = EXIT_CLEAN_RESTART;
     } else {
+        StartupTimer::mark(QString(), QStringLiteral("Core build"));
         QObject::connect(pCore.get(), &Core::loadingMessageNewStage, &splash, &Splash::showProgressMessage, Qt::DirectConnection);
         QObject::connect(pCore.get(), &Core::loadingMessageIncrease, &splash, &Splash::increaseProgressMessage, Qt::DirectConnection);
         QObject::connect(pCore.get(), &Core::loadingMessageHide, &splash, &Splash::clearMessage, Qt::DirectConnection);
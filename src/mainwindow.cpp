@@ -11,6 +11,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "bin/generators/generators.h"
 #include "bin/mediabrowser.h"
 #include "bin/model/subtitlemodel.hpp"
+#include "bin/producerpool.h"
 #include "bin/projectclip.h"
 #include "bin/projectfolder.h"
 #include "bin/projectitemmodel.h"
@@ -88,6 +89,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <KCoreAddons>
 #include <KDualAction>
 #include <KEditToolBar>
+#include <KIO/Global>
 #include <KIconEffect>
 #include <KIconTheme>
 #include <KLocalizedString>
@@ -429,6 +431,33 @@ void MainWindow::init()
         }
     });
     m_undoView->setContextMenuPolicy(Qt::ActionsContextMenu);
+    // Display the undo history memory usage
+    auto updateUndoInfo = [this]() {
+        auto *stack = qobject_cast<DocUndoStack *>(m_commandStack->activeStack());
+        if (stack == nullptr) {
+            m_undoView->setToolTip(QString());
+            return;
+        }
+        QString info = i18n("Undo history: %1 entries, %2", stack->count(), KIO::convertSize(KIO::filesize_t(stack->memoryUsage())));
+        if (stack->releasedCount() > 0) {
+            info.append(QLatin1Char('\n'));
+            info.append(i18np("%1 older entry discarded to save memory", "%1 older entries discarded to save memory", stack->releasedCount()));
+        }
+        m_undoView->setToolTip(info);
+    };
+    connect(m_commandStack, &QUndoGroup::indexChanged, this, updateUndoInfo);
+    connect(m_commandStack, &QUndoGroup::activeStackChanged, this, [this, updateUndoInfo](QUndoStack *active) {
+        // Merged commands do not change the stack index, follow the memory usage of the active stack
+        for (auto &s : m_commandStack->stacks()) {
+            if (auto *stack = qobject_cast<DocUndoStack *>(s)) {
+                disconnect(stack, &DocUndoStack::memoryUsageChanged, this, nullptr);
+            }
+        }
+        if (auto *stack = qobject_cast<DocUndoStack *>(active)) {
+            connect(stack, &DocUndoStack::memoryUsageChanged, this, updateUndoInfo);
+        }
+        updateUndoInfo();
+    });
     m_undoViewDock = addDock(i18n("Undo History"), QStringLiteral("undo_history"), m_undoView);
 
     // Color and icon theme stuff
@@ -1900,6 +1929,9 @@ void MainWindow::setupActions()
     addAction(QStringLiteral("cut_timeline_all_clips"), i18n("Cut All Clips"), this, SLOT(slotCutTimelineAllClips()),
               QIcon::fromTheme(QStringLiteral("edit-cut")), Qt::CTRL | Qt::SHIFT | Qt::Key_R);
 
+    addAction(QStringLiteral("cut_timeline_all_clips_guides"), i18n("Cut All Clips at Guides"), this, SLOT(slotCutTimelineAllClipsAtGuides()),
+              QIcon::fromTheme(QStringLiteral("edit-cut")));
+
     addAction(QStringLiteral("delete_timeline_clip"), i18n("Delete Selected Item"), this, SLOT(slotDeleteItem()),
               QIcon::fromTheme(QStringLiteral("edit-delete")), Qt::Key_Delete);
 
@@ -2073,16 +2105,25 @@ void MainWindow::setupActions()
 
     QAction *undo = KStandardAction::undo(m_commandStack, SLOT(undo()), actionCollection());
     undo->setEnabled(false);
-    connect(m_commandStack, &QUndoGroup::canUndoChanged, undo, &QAction::setEnabled);
+    // Commands released to save memory cannot be undone
+    auto canUndo = [this]() {
+        QUndoStack *active = m_commandStack->activeStack();
+        if (auto *stack = qobject_cast<DocUndoStack *>(active)) {
+            return stack->undoAvailable();
+        }
+        return active != nullptr && active->canUndo();
+    };
+    connect(m_commandStack, &QUndoGroup::canUndoChanged, undo, [undo, canUndo]() { undo->setEnabled(canUndo()); });
+    connect(m_commandStack, &QUndoGroup::indexChanged, undo, [undo, canUndo]() { undo->setEnabled(canUndo()); });
 
     QAction *redo = KStandardAction::redo(m_commandStack, SLOT(redo()), actionCollection());
     redo->setEnabled(false);
     connect(m_commandStack, &QUndoGroup::canRedoChanged, redo, &QAction::setEnabled);
-    connect(this, &MainWindow::enableUndo, this, [this, undo, redo](bool enable) {
+    connect(this, &MainWindow::enableUndo, this, [this, undo, redo, canUndo](bool enable) {
         bool undoEnabled = enable;
         if (enable && m_commandStack->activeStack()) {
             enable = m_commandStack->activeStack()->canRedo();
-            undoEnabled = m_commandStack->activeStack()->canUndo();
+            undoEnabled = canUndo();
         }
         redo->setEnabled(enable);
         undo->setEnabled(undoEnabled);
@@ -2346,8 +2387,9 @@ void MainWindow::slotEditProjectSettings(int ix)
                     this, i18n("The current project has not been saved.<br/>This will first save the project, then move "
                                "all temporary files from <br/><b>%1</b> to <b>%2</b>,<br>and the project file will be reloaded",
                                project->projectTempFolder(), newProjectFolder));
-                if (answer == KMessageBox::Continue) {
-                    pCore->projectManager()->saveFile();
+                if (answer == KMessageBox::Continue && !pCore->projectManager()->saveFile(true)) {
+                    // The project file must be written before moving its data
+                    answer = KMessageBox::Cancel;
                 }
             } else {
                 answer = KMessageBox::warningContinueCancel(
@@ -2805,6 +2847,20 @@ void MainWindow::updateConfiguration()
     m_buttonVideoThumbs->setChecked(KdenliveSettings::videothumbnails());
     m_buttonShowMarkers->setChecked(KdenliveSettings::showmarkers());
 
+    // Apply the undo history memory limit
+    for (auto &s : m_commandStack->stacks()) {
+        if (auto *stack = qobject_cast<DocUndoStack *>(s)) {
+            stack->setMemoryBudget(qint64(KdenliveSettings::undomemorylimit()) * 1024 * 1024);
+        }
+    }
+
+    // Apply the open decoders limit
+    if (getCurrentTimeline() && getCurrentTimeline()->model()) {
+        ProducerPool::setDecoderLimitForTracks(getCurrentTimeline()->model()->getTracksCount());
+    } else {
+        ProducerPool::setDecoderLimit(KdenliveSettings::maxopendecoders());
+    }
+
     // Update list of transcoding profiles
     buildDynamicActions();
     loadClipActions();
@@ -3185,6 +3241,11 @@ void MainWindow::slotCutTimelineAllClips()
     getCurrentTimeline()->controller()->cutAllClipsUnderCursor();
 }
 
+void MainWindow::slotCutTimelineAllClipsAtGuides()
+{
+    getCurrentTimeline()->controller()->cutAllClipsAtGuides();
+}
+
 void MainWindow::slotInsertClipOverwrite()
 {
     const QString &binId = m_clipMonitor->activeClipId();
@@ -485,6 +485,7 @@ private Q_SLOTS:
     void slotAddMarkerWithCategory();
     void slotCutTimelineClip();
     void slotCutTimelineAllClips();
+    void slotCutTimelineAllClipsAtGuides();
     void slotInsertClipOverwrite();
     void slotInsertClipInsert();
     void slotExtractZone();
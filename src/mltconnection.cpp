@@ -5,6 +5,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 */
 
 #include "mltconnection.h"
+#include "bin/producerpool.h"
 #include "core.h"
 #include "kdenlivesettings.h"
 #include "mainwindow.h"
@@ -82,6 +83,8 @@ MltConnection::MltConnection(const QString &mltPath)
     KdenliveSettings::setProducerslist(producersList);
     mlt_log_set_level(MLT_LOG_ERROR);
     mlt_log_set_callback(mlt_log_handler);
+    // Limit the number of simultaneously open decoders, which each keep a file handle and their decoding buffers
+    ProducerPool::setDecoderLimit(KdenliveSettings::maxopendecoders());
     refreshLumas();
 }
 
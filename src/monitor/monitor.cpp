@@ -1757,6 +1757,11 @@ bool Monitor::monitorVisible() const
     return m_glWidget->isFullScreen() || !m_glWidget->visibleRegion().isEmpty();
 }
 
+void Monitor::invalidateFrameCache(int start, int end)
+{
+    m_glMonitor->invalidateFrameCache(start, end);
+}
+
 void Monitor::refreshMonitorIfActive(bool directUpdate)
 {
     if (!m_glMonitor->isReady() || !isActive()) {
@@ -404,6 +404,8 @@ public Q_SLOTS:
     void forceMonitorRefresh();
     /** @brief Clear read ahead cache, to ensure up to date audio */
     void purgeCache();
+    /** @brief Discard the cached rendered frames for a timeline range, end = -1 means until the end */
+    void invalidateFrameCache(int start, int end);
     /** @brief Stop displaying a  mask as overlay to the clip */
     void abortPreviewMask(bool rebuildProducer = true);
 
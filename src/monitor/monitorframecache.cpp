@@ -0,0 +1,214 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "monitorframecache.h"
+#include "core.h"
+#include "kdenlivesettings.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <mlt++/MltConsumer.h>
+#include <mlt++/MltFrame.h>
+#include <mlt++/MltProducer.h>
+
+// Number of frames rendered on each side of the parked position
+static const int prefetchRadius = 12;
+// Time without timeline change before copying the timeline again, in ms
+static const int rebuildDelay = 2000;
+
+MonitorFrameCache::MonitorFrameCache(QObject *parent)
+    : QObject(parent)
+    , m_generation(0)
+    , m_abortPrefetch(false)
+    , m_producerGeneration(0)
+    , m_rebuildGeneration(0)
+    , m_pendingPosition(0)
+{
+    m_rebuildTimer.setSingleShot(true);
+    m_rebuildTimer.setInterval(rebuildDelay);
+    connect(&m_rebuildTimer, &QTimer::timeout, this, &MonitorFrameCache::rebuildProducer);
+    updateBudget();
+}
+
+MonitorFrameCache::~MonitorFrameCache()
+{
+    abortPrefetch();
+}
+
+void MonitorFrameCache::updateBudget()
+{
+    QMutexLocker lk(&m_mutex);
+    m_frames.setMaxCost(qMax(0, KdenliveSettings::monitorframecache()) * 1024);
+}
+
+bool MonitorFrameCache::frame(int position, SharedFrame &frame)
+{
+    QMutexLocker lk(&m_mutex);
+    SharedFrame *cached = m_frames.object(position);
+    if (cached == nullptr) {
+        return false;
+    }
+    frame = *cached;
+    return true;
+}
+
+quint64 MonitorFrameCache::generation() const
+{
+    return m_generation;
+}
+
+void MonitorFrameCache::insert(const SharedFrame &frame, quint64 generation)
+{
+    if (!frame.is_valid() || m_frames.maxCost() == 0) {
+        return;
+    }
+    int width = frame.get_image_width();
+    int height = frame.get_image_height();
+    mlt_image_format format = frame.get_image_format();
+    if (width <= 0 || height <= 0 || format == mlt_image_none || format == mlt_image_movit) {
+        // No image data we can reuse (for example an OpenGL texture)
+        return;
+    }
+    // Only keep the image data, not the audio and the references held by the original frame
+    Mlt::Frame copy = frame.clone(false, true, false);
+    SharedFrame imageFrame(copy);
+    int cost = qMax(1, mlt_image_format_size(format, width, height, nullptr) / 1024);
+    QMutexLocker lk(&m_mutex);
+    if (generation != m_generation) {
+        // Timeline changed while this frame was rendered
+        return;
+    }
+    m_frames.insert(frame.get_position(), new SharedFrame(imageFrame), cost);
+}
+
+void MonitorFrameCache::invalidate(int start, int end)
+{
+    QMutexLocker lk(&m_mutex);
+    const QList<int> positions = m_frames.keys();
+    for (int pos : positions) {
+        if (pos >= start && (end < 0 || pos <= end)) {
+            m_frames.remove(pos);
+        }
+    }
+    // Frames currently being rendered might belong to the invalidated range
+    m_generation++;
+    m_abortPrefetch = true;
+}
+
+void MonitorFrameCache::invalidateAll()
+{
+    QMutexLocker lk(&m_mutex);
+    m_frames.clear();
+    m_generation++;
+    m_abortPrefetch = true;
+}
+
+void MonitorFrameCache::abortPrefetch()
+{
+    m_rebuildTimer.stop();
+    m_abortPrefetch = true;
+    m_prefetchTask.waitForFinished();
+}
+
+void MonitorFrameCache::prefetch(int position, const QSize &size)
+{
+    if (m_frames.maxCost() == 0 || !KdenliveSettings::monitorprefetch() || !size.isValid()) {
+        return;
+    }
+    abortPrefetch();
+    m_pendingPosition = position;
+    m_pendingSize = size;
+    if (m_prefetchProducer && m_producerGeneration == m_generation) {
+        startPrefetch(QString());
+        return;
+    }
+    // The timeline changed, copying it is proportional to the project size so wait for the edits to settle
+    m_rebuildGeneration = m_generation;
+    m_rebuildTimer.start();
+}
+
+void MonitorFrameCache::rebuildProducer()
+{
+    if (m_rebuildGeneration != m_generation) {
+        // Still editing
+        m_rebuildGeneration = m_generation;
+        m_rebuildTimer.start();
+        return;
+    }
+    // Serializing the tractor does not touch the project, so it cannot trigger another invalidation
+    const QString scene = pCore->getTimelineSceneCopy();
+    if (scene.isEmpty()) {
+        return;
+    }
+    abortPrefetch();
+    startPrefetch(scene);
+}
+
+void MonitorFrameCache::startPrefetch(const QString &scene)
+{
+    m_abortPrefetch = false;
+    quint64 generation = m_generation;
+    m_prefetchTask = QtConcurrent::run([this, scene, position = m_pendingPosition, size = m_pendingSize, generation]() {
+        if (!scene.isEmpty()) {
+            // Parsing the copy opens all the project media, keep it out of the GUI thread
+            m_prefetchProducer = std::make_unique<Mlt::Producer>(pCore->getProjectProfile(), "xml-string", scene.toUtf8().constData());
+            if (!m_prefetchProducer->is_valid()) {
+                m_prefetchProducer.reset();
+                return;
+            }
+            m_producerGeneration = generation;
+        }
+        prefetchFrames(position, size, generation);
+    });
+}
+
+void MonitorFrameCache::prefetchFrames(int position, QSize size, quint64 generation)
+{
+    int length = m_prefetchProducer->get_length();
+    // Pull the frames through a consumer so that they get the same normalization as the monitor frames
+    mlt_consumer baseConsumer = mlt_consumer_new(pCore->getProjectProfile().get_profile());
+    Mlt::Consumer consumer(baseConsumer);
+    mlt_consumer_close(baseConsumer);
+    consumer.set("real_time", 0);
+    consumer.set("rescale", "bilinear");
+    consumer.set("deinterlacer", "onefield");
+    consumer.set("width", size.width());
+    consumer.set("height", size.height());
+    consumer.connect(*m_prefetchProducer.get());
+    consumer.start();
+    // Render forward first, as that is the most likely direction
+    for (int offset = 1; offset <= prefetchRadius; ++offset) {
+        for (int pos : {position + offset, position - offset}) {
+            if (m_abortPrefetch || generation != m_generation) {
+                consumer.stop();
+                return;
+            }
+            if (pos < 0 || pos >= length) {
+                continue;
+            }
+            {
+                QMutexLocker lk(&m_mutex);
+                if (m_frames.contains(pos)) {
+                    continue;
+                }
+            }
+            m_prefetchProducer->seek(pos);
+            mlt_frame rendered = mlt_consumer_rt_frame(consumer.get_consumer());
+            if (rendered == nullptr) {
+                continue;
+            }
+            Mlt::Frame frame(rendered);
+            mlt_frame_close(rendered);
+            mlt_image_format format = mlt_image_yuv420p;
+            int width = size.width();
+            int height = size.height();
+            if (frame.get_image(format, width, height) == nullptr) {
+                continue;
+            }
+            SharedFrame shared(frame);
+            insert(shared, generation);
+        }
+    }
+    consumer.stop();
+}
@@ -0,0 +1,74 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include "scopes/sharedframe.h"
+
+#include <QCache>
+#include <QFuture>
+#include <QMutex>
+#include <QObject>
+#include <QSize>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+
+namespace Mlt {
+class Producer;
+}
+
+/** @class MonitorFrameCache
+    @brief A byte budgeted cache of the final frames displayed by the project monitor, keyed by timeline position.
+    It allows instant display when scrubbing back and forth over the same region. Every model change bumps a generation
+    counter that invalidates the stored frames. While the playhead is parked, neighbouring frames are rendered in a
+    background thread from an independent copy of the timeline. The copy is only rebuilt once the edits settle, and
+    its xml is parsed in the background thread.
+ */
+class MonitorFrameCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MonitorFrameCache(QObject *parent = nullptr);
+    ~MonitorFrameCache() override;
+    /** @brief Returns true if a cached frame matching the current generation exists for this position */
+    bool frame(int position, SharedFrame &frame);
+    /** @brief Store a rendered frame, only its image is kept. The frame is rejected if the timeline changed since generation */
+    void insert(const SharedFrame &frame, quint64 generation);
+    /** @brief Returns the current generation, incremented on each timeline change */
+    quint64 generation() const;
+    /** @brief Remove cached frames in the range. If end is -1, all frames after start are removed */
+    void invalidate(int start, int end);
+    /** @brief The timeline changed in an unknown way, drop all frames */
+    void invalidateAll();
+    /** @brief Render frames around position in a background thread, using images of the given size */
+    void prefetch(int position, const QSize &size);
+    /** @brief Stop the background rendering, for example when playback starts */
+    void abortPrefetch();
+    /** @brief Update the memory budget from the settings */
+    void updateBudget();
+
+private:
+    QMutex m_mutex;
+    /** @brief The cached frames, with their cost in kilobytes */
+    QCache<int, SharedFrame> m_frames;
+    std::atomic<quint64> m_generation;
+    std::atomic<bool> m_abortPrefetch;
+    QFuture<void> m_prefetchTask;
+    std::unique_ptr<Mlt::Producer> m_prefetchProducer;
+    /** @brief The generation of the timeline copy used for prefetching */
+    quint64 m_producerGeneration;
+    /** @brief Delays the copy of the timeline until it stops changing */
+    QTimer m_rebuildTimer;
+    quint64 m_rebuildGeneration;
+    int m_pendingPosition;
+    QSize m_pendingSize;
+    /** @brief Copy the timeline if it did not change since the timer started, and start prefetching */
+    void rebuildProducer();
+    /** @brief Start the background rendering, building the timeline copy from scene first if it is not empty */
+    void startPrefetch(const QString &scene);
+    void prefetchFrames(int position, QSize size, quint64 generation);
+};
@@ -39,6 +39,7 @@
 
 #include "bin/model/markersortmodel.h"
 #include "core.h"
+#include "monitorframecache.h"
 #include "monitorproxy.h"
 #include "profiles/profilemodel.hpp"
 #include "timeline2/view/qmltypes/thumbnailprovider.h"
@@ -125,6 +126,17 @@ VideoWidget::VideoWidget(int id, QObject *parent)
     m_blackClip->set("kdenlive:id", "black");
     m_blackClip->set("out", 3);
     connect(&m_refreshTimer, &QTimer::timeout, this, &VideoWidget::refresh);
+    if (m_id == Kdenlive::ProjectMonitor && !m_glslManager && KdenliveSettings::monitorframecache() > 0) {
+        // Frames rendered with GPU acceleration are textures that cannot be cached
+        m_frameCache = std::make_unique<MonitorFrameCache>();
+        m_prefetchTimer.setSingleShot(true);
+        m_prefetchTimer.setInterval(500);
+        connect(&m_prefetchTimer, &QTimer::timeout, this, [this]() {
+            if (m_frameCache && m_consumer && isPaused()) {
+                m_frameCache->prefetch(m_proxy->getPosition(), m_profileSize);
+            }
+        });
+    }
     m_producer = m_blackClip;
     rootContext()->setContextProperty("markersModel", nullptr);
     connect(pCore.get(), &Core::switchTimelineRecord, this, &VideoWidget::switchRecordState);
@@ -136,6 +148,8 @@ VideoWidget::VideoWidget(int id, QObject *parent)
 
 VideoWidget::~VideoWidget()
 {
+    m_prefetchTimer.stop();
+    m_frameCache.reset();
     stop();
     if (m_frameRenderer && m_frameRenderer->isRunning()) {
         m_frameRenderer->quit();
@@ -158,6 +172,9 @@ void VideoWidget::initialize()
     connect(m_frameRenderer, &FrameRenderer::frameDisplayed, this, &VideoWidget::onFrameDisplayed, Qt::QueuedConnection);
     connect(m_frameRenderer, &FrameRenderer::frameDisplayed, this, &VideoWidget::frameDisplayed, Qt::QueuedConnection);
     connect(m_frameRenderer, SIGNAL(imageReady()), SIGNAL(imageReady()));
+    if (m_frameCache) {
+        connect(m_frameRenderer, &FrameRenderer::frameDisplayed, this, &VideoWidget::cacheDisplayedFrame, Qt::QueuedConnection);
+    }
     m_initSem.release();
     m_isInitialized = true;
 }
@@ -311,6 +328,20 @@ void VideoWidget::requestSeek(int position, bool noAudioScrub)
     if (!m_consumer) {
         return;
     }
+    if (m_frameCache && isPaused()) {
+        bool scrubAudio = KdenliveSettings::audio_scrub() && !noAudioScrub;
+        SharedFrame cached;
+        // Don't use the cache while the consumer is still rendering a previous request, it would overwrite the cached frame
+        if (!scrubAudio && m_requestedCachePosition == -1 && m_frameCache->frame(position, cached)) {
+            onFrameDisplayed(cached);
+            Q_EMIT frameDisplayed(cached);
+            m_prefetchTimer.start();
+            return;
+        }
+        m_requestedCachePosition = position;
+        m_requestedCacheGeneration = m_frameCache->generation();
+        m_prefetchTimer.stop();
+    }
     if (!qFuzzyIsNull(m_producer->get_speed())) {
         m_consumer->purge();
     }
@@ -325,6 +356,8 @@ void VideoWidget::requestSeek(int position, bool noAudioScrub)
 
 void VideoWidget::requestRefresh(bool slowRefresh)
 {
+    // A refresh means the displayed content changed
+    invalidateFrameCache();
     if (m_refreshTimer.isActive()) {
         m_refreshTimer.start(slowRefresh ? 200 : 10);
     } else if (m_producer && qFuzzyIsNull(m_producer->get_speed())) {
@@ -341,8 +374,13 @@ QString VideoWidget::frameToTime(int frames) const
 void VideoWidget::refresh()
 {
     m_refreshTimer.stop();
+    invalidateFrameCache();
     QMutexLocker locker(&m_mltMutex);
     if (m_consumer) {
+        if (m_frameCache) {
+            m_requestedCachePosition = m_producer->position();
+            m_requestedCacheGeneration = m_frameCache->generation();
+        }
         restartConsumer();
         m_consumer->set("refresh", 1);
     }
@@ -617,6 +655,7 @@ int VideoWidget::setProducer(const std::shared_ptr<Mlt::Producer> &producer, boo
     }
     m_producer->set_speed(0);
     m_proxy->setSpeed(0);
+    invalidateFrameCache();
     error = reconfigure();
     if (error == 0) {
         // The profile display aspect ratio may have changed.
@@ -837,6 +876,7 @@ void VideoWidget::reloadProfile()
         m_consumer.reset();
         existingConsumer = true;
     }
+    invalidateFrameCache();
     m_blackClip.reset(new Mlt::Producer(pCore->getProjectProfile(), "color:0"));
     m_blackClip->set("kdenlive:id", "black");
     m_blackClip->set("mlt_image_format", "rgba");
@@ -882,6 +922,31 @@ void VideoWidget::setZoom(float zoom, bool force)
     resizeVideo(width(), height());
 }
 
+void VideoWidget::invalidateFrameCache(int start, int end)
+{
+    if (!m_frameCache) {
+        return;
+    }
+    m_prefetchTimer.stop();
+    if (start == 0 && end == -1) {
+        m_frameCache->invalidateAll();
+    } else {
+        m_frameCache->invalidate(start, end);
+    }
+}
+
+void VideoWidget::cacheDisplayedFrame(const SharedFrame &frame)
+{
+    if (m_requestedCachePosition == -1 || frame.get_position() != m_requestedCachePosition) {
+        return;
+    }
+    m_requestedCachePosition = -1;
+    if (isPaused()) {
+        m_frameCache->insert(frame, m_requestedCacheGeneration);
+        m_prefetchTimer.start();
+    }
+}
+
 void VideoWidget::onFrameDisplayed(const SharedFrame &frame)
 {
     m_mutex.lock();
@@ -1076,6 +1141,14 @@ bool VideoWidget::switchPlay(bool play, double speed)
     if (m_isZoneMode || m_isLoopMode) {
         resetZoneMode();
     }
+    if (m_frameCache) {
+        // Don't compete with playback for cpu
+        m_prefetchTimer.stop();
+        m_requestedCachePosition = -1;
+        if (play) {
+            m_frameCache->abortPrefetch();
+        }
+    }
     if (play) {
         if (m_consumer->position() >= m_maxProducerPosition && speed > 0) {
             // We are at the end of the clip / timeline
@@ -1351,6 +1424,7 @@ bool VideoWidget::updateScaling()
         return false;
     }
     m_profileSize = profileSize;
+    invalidateFrameCache();
     pCore->getMonitorProfile().set_width(m_profileSize.width());
     pCore->getMonitorProfile().set_height(m_profileSize.height());
     if (m_consumer) {
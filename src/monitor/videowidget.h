@@ -35,6 +35,7 @@ class Consumer;
 
 class RenderThread;
 class FrameRenderer;
+class MonitorFrameCache;
 class MonitorProxy;
 class MarkerSortModel;
 
@@ -122,6 +123,8 @@ public:
     virtual const QStringList getGPUInfo();
     /** @brief Returns the current frame as image */
     QImage image() const;
+    /** @brief Discard the cached rendered frames in the range, if end is -1 the whole cache is discarded */
+    void invalidateFrameCache(int start = 0, int end = -1);
 
 protected:
     void mouseReleaseEvent(QMouseEvent *event) override;
@@ -233,6 +236,13 @@ private:
     MonitorProxy *m_proxy;
     std::unique_ptr<RenderThread> m_renderThread;
     std::shared_ptr<Mlt::Producer> m_blackClip;
+    /** @brief Cache of rendered frames around the playhead, only used by the project monitor */
+    std::unique_ptr<MonitorFrameCache> m_frameCache;
+    /** @brief Triggers background rendering of the neighbour frames when parked on a position */
+    QTimer m_prefetchTimer;
+    /** @brief The position and cache generation of the last frame requested to the consumer */
+    int m_requestedCachePosition{-1};
+    quint64 m_requestedCacheGeneration{0};
     static void on_frame_show(mlt_consumer, VideoWidget *widget, mlt_event_data);
     static void on_frame_render(mlt_consumer, VideoWidget *widget, mlt_frame frame);
     /*static void on_gl_frame_show(mlt_consumer, VideoWidget *widget, mlt_event_data data);
@@ -262,6 +272,8 @@ private Q_SLOTS:
     void switchRecordState(bool on);
     /** @brief Enforce a zoom refresh, can be useful when switching to/from fullscreen to adjust image size/position */
     void forceRefreshZoom();
+    /** @brief Store a frame rendered by the consumer in the frame cache */
+    void cacheDisplayedFrame(const SharedFrame &frame);
 
 protected:
     void resizeEvent(QResizeEvent *event) override;
@@ -68,6 +68,12 @@ void ProfileRepository::refresh()
             m_profiles.insert(std::make_pair(file, std::move(profile)));
         }
     }
+    ++m_generation;
+}
+
+int ProfileRepository::generation() const
+{
+    return m_generation;
 }
 
 QVector<QPair<QString, QString>> ProfileRepository::getAllProfiles() const
@@ -9,6 +9,7 @@
 #include "profileinfo.hpp"
 #include <QReadWriteLock>
 #include <QString>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -30,6 +31,9 @@ public:
     /** @brief Reloads all the profiles from the disk */
     void refresh();
 
+    /** @brief Returns a counter that is increased each time the profiles are reloaded */
+    int generation() const;
+
     /** @brief Returns a list of all the pairs (description, path) of all the profiles loaded */
     QVector<QPair<QString, QString>> getAllProfiles() const;
 
@@ -73,6 +77,9 @@ protected:
 
     mutable QReadWriteLock m_mutex;
 
+    /** @brief Incremented by each refresh, lets callers caching profile values detect a reload */
+    std::atomic_int m_generation{0};
+
     /** @brief map from the profile path to the instance of the profile.
      * @details We use unordered_map because QMap and QHash currently don't support
      * move insertion, hence inserting unique_ptr is impossible.
@@ -6,6 +6,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #include "backupwidget.h"
 #include "core.h"
+#include "doc/documentwriter.h"
 #include "kdenlivesettings.h"
 
 #include <QDir>
@@ -32,12 +33,6 @@ BackupWidget::BackupWidget(const QUrl &projectUrl, QUrl projectFolder, const QSt
             m_projectWildcard.append(QLatin1Char('*'));
         }
     }
-    m_projectWildcard.append(QStringLiteral("-??"));
-    m_projectWildcard.append(QStringLiteral("??"));
-    m_projectWildcard.append(QStringLiteral("-??"));
-    m_projectWildcard.append(QStringLiteral("-??"));
-    m_projectWildcard.append(QStringLiteral("-??"));
-    m_projectWildcard.append(QStringLiteral("-??.kdenlive"));
     QAction *openContainingFolder = new QAction(QIcon::fromTheme(QStringLiteral("edit-find")), i18n("Open Containing Folder"), this);
     connect(openContainingFolder, &QAction::triggered, [&]() {
         if (backup_list->currentItem()) {
@@ -59,8 +54,8 @@ BackupWidget::~BackupWidget() = default;
 void BackupWidget::slotParseBackupFiles()
 {
     QLocale locale;
-    QStringList filter;
-    filter << m_projectWildcard;
+    // Backups can be compressed
+    const QStringList filter = DocumentWriter::backupFilters(m_projectWildcard);
     backup_list->clear();
 
     // Parse new XDG backup folder $HOME/.local/share/kdenlive/.backup
@@ -131,7 +126,7 @@ void BackupWidget::slotDisplayBackupPreview()
         return;
     }
     const QString path = backup_list->currentItem()->data(Qt::UserRole).toString();
-    QPixmap pix(path + QStringLiteral(".jpg"));
+    QPixmap pix(DocumentWriter::backupPreviewBase(path) + QStringLiteral(".jpg"));
     backup_preview->setPixmap(pix);
 }
 
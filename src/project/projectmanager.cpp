@@ -9,6 +9,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "bin/projectitemmodel.h"
 #include "core.h"
 #include "doc/docundostack.hpp"
+#include "doc/documentwriter.h"
 #include "doc/kdenlivedoc.h"
 #include "jobs/cliploadtask.h"
 #include "kdenlivesettings.h"
@@ -441,6 +442,10 @@ bool ProjectManager::closeCurrentDocument(bool saveChanges, bool quit)
     // Disable autosave
     m_autoSaveTimer.stop();
     m_autoSaveChangeCount = 0;
+    if (m_project != nullptr) {
+        // Get the result of pending background saves, the document state depends on it
+        m_project->waitForSave();
+    }
     if ((m_project != nullptr) && m_project->isModified() && saveChanges) {
         QString message;
         if (m_project->url().isEmpty()) {
@@ -451,8 +456,8 @@ bool ProjectManager::closeCurrentDocument(bool saveChanges, bool quit)
 
         switch (KMessageBox::warningTwoActionsCancel(pCore->window(), message, {}, KStandardGuiItem::save(), KStandardGuiItem::dontSave())) {
         case KMessageBox::PrimaryAction:
-            // save document here. If saving fails, return false;
-            if (!saveFile()) {
+            // save document here, the file must be written before closing. If saving fails, return false;
+            if (!saveFile(true)) {
                 return false;
             }
             break;
@@ -520,12 +525,14 @@ bool ProjectManager::closeCurrentDocument(bool saveChanges, bool quit)
         pCore->projectItemModel()->clean(true);
         m_project = nullptr;
     }
+    // Close the cached decoders, then restore the configured limit for the next project
     mlt_service_cache_set_size(nullptr, "producer_avformat", 0);
     ::mlt_pool_purge();
+    ProducerPool::setDecoderLimit(KdenliveSettings::maxopendecoders());
     return true;
 }
 
-bool ProjectManager::saveFileAs(const QString &outputFileName, bool saveOverExistingFile, bool saveACopy)
+bool ProjectManager::saveFileAs(const QString &outputFileName, bool saveOverExistingFile, bool saveACopy, bool synchronous)
 {
     // Disable autosave while saving
     m_autoSaveTimer.stop();
@@ -558,7 +565,8 @@ bool ProjectManager::saveFileAs(const QString &outputFileName, bool saveOverExis
         }
     }
     m_project->updateWorkFilesAfterSave();
-    if (!m_project->saveSceneList(outputFileName, scene, saveOverExistingFile)) {
+    // The document is marked clean and the success is notified once the file is written
+    if (!m_project->saveSceneList(outputFileName, scene, saveOverExistingFile, !saveACopy, synchronous)) {
         KNotification::event(QStringLiteral("ErrorMessage"), i18n("Saving project file <br><b>%1</B> failed", outputFileName), QPixmap());
         return false;
     }
@@ -590,9 +598,7 @@ bool ProjectManager::saveFileAs(const QString &outputFileName, bool saveOverExis
         }
 
         pCore->window()->setWindowTitle(m_project->description());
-        m_project->setModified(false);
     }
-    KNotification::event(QStringLiteral("SaveSuccess"), i18n("Saving successful"), QPixmap());
 
     m_recentFilesAction->addUrl(url);
     // remember folder for next project opening
@@ -600,7 +606,6 @@ bool ProjectManager::saveFileAs(const QString &outputFileName, bool saveOverExis
     saveRecentFiles();
     if (!saveACopy) {
         m_fileRevert->setEnabled(true);
-        pCore->window()->m_undoView->stack()->setClean();
         QString newProjectFolder(saveFolder + QStringLiteral("/cachefiles"));
         if (((oldProjectFolder.isEmpty() && m_project->m_sameProjectFolder) || m_project->projectTempFolder() == oldProjectFolder) &&
             newProjectFolder != m_project->projectTempFolder()) {
@@ -624,8 +629,8 @@ bool ProjectManager::saveFileAs(const QString &outputFileName, bool saveOverExis
                     if (newDir.exists(documentId)) {
                         KMessageBox::error(pCore->window(),
                                            i18n("Cannot perform operation, target directory already exists: %1", newDir.absoluteFilePath(documentId)));
-                    } else {
-                        // Proceed with the move
+                    } else if (m_project->waitForSave()) {
+                        // Proceed with the move, the project file will be reloaded so it must be written
                         moveProjectData(oldDir.absoluteFilePath(documentId), newDir.absolutePath());
                     }
                 }
@@ -673,7 +678,7 @@ bool ProjectManager::saveFileAs(bool saveACopy)
     return saveFileAs(outputFile, false, saveACopy);
 }
 
-bool ProjectManager::saveFile()
+bool ProjectManager::saveFile(bool synchronous)
 {
     if (!m_project) {
         // Calling saveFile before a project was created, something is wrong
@@ -683,7 +688,7 @@ bool ProjectManager::saveFile()
     if (m_project->url().isEmpty()) {
         return saveFileAs();
     }
-    bool result = saveFileAs(m_project->url().toLocalFile());
+    bool result = saveFileAs(m_project->url().toLocalFile(), true, false, synchronous);
     m_project->m_autosave->resize(0);
     return result;
 }
@@ -1178,12 +1183,17 @@ bool ProjectManager::slotOpenBackup(const QUrl &url)
     bool result = false;
     QPointer<BackupWidget> dia = new BackupWidget(projectFile, projectFolder, projectId, pCore->window());
     if (dia->exec() == QDialog::Accepted) {
-        QString requestedBackup = dia->selectedFile();
+        const QString selectedBackup = dia->selectedFile();
+        // Compressed backups are extracted to a temporary file
+        QString requestedBackup = DocumentWriter::uncompressedBackup(selectedBackup);
         if (m_project) {
             m_project->backupLastSavedVersion(projectFile.toLocalFile());
             closeCurrentDocument(false);
         }
         doOpenFile(QUrl::fromLocalFile(requestedBackup), nullptr, true);
+        if (requestedBackup != selectedBackup) {
+            QFile::remove(requestedBackup);
+        }
         if (m_project) {
             if (!m_project->url().isEmpty()) {
                 // Only update if restore succeeded
@@ -1519,7 +1529,11 @@ void ProjectManager::slotMoveFinished(KJob *job)
             m_replacementPattern.insert(m_project->projectTempFolder() + QStringLiteral("/proxy/"), newFolder + QStringLiteral("/proxy/"));
         }
         m_project->setProjectFolder(QUrl::fromLocalFile(newFolder));
-        saveFile();
+        // The project file is reloaded, it must be written first
+        if (!saveFile(true)) {
+            m_replacementPattern.clear();
+            return;
+        }
         m_replacementPattern.clear();
         slotRevert();
     } else {
@@ -1753,8 +1767,8 @@ void ProjectManager::saveWithUpdatedProfile(const QString &updatedProfile)
                 pCore->window(), i18n("The project <b>\"%1\"</b> has been changed.\nDo you want to save your changes?", m_project->url().fileName()), {},
                 KStandardGuiItem::save(), KStandardGuiItem::dontSave())) {
             case KMessageBox::PrimaryAction:
-                // save document here. If saving fails, return false;
-                if (!saveFile()) {
+                // save document here, it is reloaded afterwards. If saving fails, return false;
+                if (!saveFile(true)) {
                     Q_EMIT pCore->displayBinMessage(i18n("Project profile change aborted"), KMessageWidget::Information);
                     return;
                 }
@@ -171,7 +171,7 @@ public Q_SLOTS:
 
     /** @brief Checks whether a URL is available to save to.
      * @return Whether the file was saved. */
-    bool saveFile();
+    bool saveFile(bool synchronous = false);
 
     /** @brief Shows a save file dialog for saving the project.
      * @param saveACopy Default is false. If true, the file title of the dialog is set to "Save Copy…"
@@ -184,8 +184,9 @@ public Q_SLOTS:
      * that will be actually written in KdenliveDoc::slotAutoSave()
      * @param outputFileName The URL to save to / The document's URL.
      * @param saveACopy Default is false. If true, the file will be saved but isn’t opened afterwards. Besides no autosave version will be created
+     * @param synchronous If true, the file is written before returning even if background saving is enabled
      * @return Whether we had success. */
-    bool saveFileAs(const QString &outputFileName, bool saveOverExistingFile = true, bool saveACopy = false);
+    bool saveFileAs(const QString &outputFileName, bool saveOverExistingFile = true, bool saveACopy = false, bool synchronous = false);
 
     /** @brief Close currently opened document. Returns false if something went wrong (cannot save modifications, ...). */
     bool closeCurrentDocument(bool saveChanges = true, bool quit = false);
@@ -0,0 +1,164 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "speechaudiofeeder.h"
+#include "core.h"
+
+#include <QDebug>
+#include <QtConcurrent/QtConcurrentRun>
+#include <mlt++/MltFilter.h>
+#include <mlt++/MltFrame.h>
+#include <mlt++/MltProducer.h>
+
+// About one second of audio per chunk
+static constexpr int ChunkSize = SpeechAudioFeeder::SampleRate * 2;
+static constexpr int MaxPendingChunks = 8;
+
+SpeechAudioFeeder::SpeechAudioFeeder(std::unique_ptr<Mlt::Producer> producer, QObject *parent)
+    : QObject(parent)
+    , m_producer(std::move(producer))
+    , m_freeChunks(MaxPendingChunks)
+    , m_duration(m_producer ? m_producer->get_playtime() : 0)
+{
+    connect(this, &SpeechAudioFeeder::chunkReady, this, &SpeechAudioFeeder::writeChunk, Qt::QueuedConnection);
+    connect(this, &SpeechAudioFeeder::extracted, this, &SpeechAudioFeeder::extractionDone, Qt::QueuedConnection);
+}
+
+SpeechAudioFeeder::~SpeechAudioFeeder()
+{
+    abort();
+}
+
+void SpeechAudioFeeder::start(QProcess *process)
+{
+    if (m_future.isRunning() || !m_producer || !m_producer->is_valid()) {
+        Q_EMIT finished(false);
+        return;
+    }
+    m_process = process;
+    connect(process, &QProcess::bytesWritten, this, &SpeechAudioFeeder::processBytesWritten);
+    // Let MLT convert the audio to the format expected by the recognizer
+    auto resampler = std::make_unique<Mlt::Filter>(pCore->getProjectProfile(), "swresample");
+    if (!resampler->is_valid()) {
+        resampler = std::make_unique<Mlt::Filter>(pCore->getProjectProfile(), "resample");
+    }
+    if (resampler->is_valid()) {
+        m_producer->attach(*resampler.get());
+    }
+    Mlt::Filter converter(pCore->getProjectProfile(), "audioconvert");
+    if (converter.is_valid()) {
+        m_producer->attach(converter);
+    }
+    m_abort = 0;
+    m_position = 0;
+    m_future = QtConcurrent::run(&SpeechAudioFeeder::run, this);
+}
+
+void SpeechAudioFeeder::abort()
+{
+    if (!m_future.isRunning()) {
+        return;
+    }
+    m_abort = 1;
+    // Unblock the extraction thread if it waits for the recognizer
+    m_freeChunks.release(MaxPendingChunks);
+    m_future.waitForFinished();
+}
+
+int SpeechAudioFeeder::position() const
+{
+    return m_position;
+}
+
+int SpeechAudioFeeder::duration() const
+{
+    return m_duration;
+}
+
+void SpeechAudioFeeder::run()
+{
+    const double fps = m_producer->get_fps();
+    QByteArray chunk;
+    chunk.reserve(ChunkSize + SampleRate);
+    bool success = true;
+    for (int i = 0; i < m_duration && m_abort == 0; i++) {
+        m_producer->seek(i);
+        std::unique_ptr<Mlt::Frame> frame(m_producer->get_frame());
+        if (!frame || !frame->is_valid()) {
+            qWarning() << "Speech audio extraction failed at frame" << i;
+            success = false;
+            break;
+        }
+        mlt_audio_format format = mlt_audio_s16;
+        int frequency = SampleRate;
+        int channels = 1;
+        int samples = mlt_audio_calculate_frame_samples(float(fps), SampleRate, i);
+        const auto *buffer = static_cast<const int16_t *>(frame->get_audio(format, frequency, channels, samples));
+        if (buffer == nullptr || format != mlt_audio_s16 || frequency != SampleRate) {
+            // Keep the timing of the following frames with silence
+            chunk.append(QByteArray(samples * int(sizeof(int16_t)), '\0'));
+        } else if (channels == 1) {
+            chunk.append(reinterpret_cast<const char *>(buffer), samples * int(sizeof(int16_t)));
+        } else {
+            // Downmix if the channels could not be converted
+            const int offset = chunk.size();
+            chunk.resize(offset + samples * int(sizeof(int16_t)));
+            auto *mono = reinterpret_cast<int16_t *>(chunk.data() + offset);
+            for (int s = 0; s < samples; s++) {
+                int sum = 0;
+                for (int c = 0; c < channels; c++) {
+                    sum += buffer[s * channels + c];
+                }
+                mono[s] = int16_t(sum / channels);
+            }
+        }
+        m_position = i + 1;
+        if (chunk.size() >= ChunkSize) {
+            pushChunk(chunk);
+            chunk.clear();
+        }
+    }
+    if (!chunk.isEmpty() && m_abort == 0) {
+        pushChunk(chunk);
+    }
+    Q_EMIT extracted(success && m_abort == 0);
+}
+
+void SpeechAudioFeeder::pushChunk(const QByteArray &data)
+{
+    m_freeChunks.acquire();
+    if (m_abort == 0) {
+        Q_EMIT chunkReady(data);
+    }
+}
+
+void SpeechAudioFeeder::writeChunk(const QByteArray &data)
+{
+    if (m_process.isNull() || m_process->state() != QProcess::Running || m_process->write(data) < 0) {
+        // The recognizer exited, stop the extraction
+        m_abort = 1;
+        m_freeChunks.release();
+        return;
+    }
+    m_pendingChunks.enqueue(data.size());
+}
+
+void SpeechAudioFeeder::processBytesWritten(qint64 bytes)
+{
+    m_writtenBytes += bytes;
+    while (!m_pendingChunks.isEmpty() && m_writtenBytes >= m_pendingChunks.head()) {
+        m_writtenBytes -= m_pendingChunks.dequeue();
+        m_freeChunks.release();
+    }
+}
+
+void SpeechAudioFeeder::extractionDone(bool success)
+{
+    if (!m_process.isNull() && m_process->state() == QProcess::Running) {
+        // The recognizer stops when its input is closed, once the pending data is written
+        m_process->closeWriteChannel();
+    }
+    Q_EMIT finished(success);
+}
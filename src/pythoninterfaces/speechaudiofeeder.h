@@ -0,0 +1,70 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QFuture>
+#include <QObject>
+#include <QPointer>
+#include <QProcess>
+#include <QQueue>
+#include <QSemaphore>
+#include <memory>
+
+namespace Mlt {
+class Producer;
+}
+
+/** @class SpeechAudioFeeder
+    @brief Streams the audio of a producer to the standard input of a speech recognition process.
+    The audio is pulled from MLT in a separate thread and written as raw 16 kHz mono s16le samples, so that the
+    recognizer can start working before the whole audio is extracted and no temporary wav file is needed. Only a
+    few chunks are buffered, the extraction waits for the recognizer to read its input.
+ */
+class SpeechAudioFeeder : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** @brief Sample rate expected by the speech recognition scripts */
+    static constexpr int SampleRate = 16000;
+    /** @brief The feeder takes ownership of the producer, that must not be used elsewhere */
+    explicit SpeechAudioFeeder(std::unique_ptr<Mlt::Producer> producer, QObject *parent = nullptr);
+    ~SpeechAudioFeeder() override;
+    /** @brief Start streaming the audio to the process, that must be started in write mode */
+    void start(QProcess *process);
+    /** @brief Stop the extraction, the standard input of the process is not closed */
+    void abort();
+    /** @brief Number of frames already extracted */
+    int position() const;
+    /** @brief Duration of the streamed audio in frames */
+    int duration() const;
+
+private:
+    std::unique_ptr<Mlt::Producer> m_producer;
+    QPointer<QProcess> m_process;
+    QFuture<void> m_future;
+    QSemaphore m_freeChunks;
+    QAtomicInt m_abort;
+    QAtomicInt m_position;
+    int m_duration;
+    /** @brief Size of the chunks written to the process but not sent yet */
+    QQueue<qint64> m_pendingChunks;
+    qint64 m_writtenBytes{0};
+    /** @brief Pull the audio frames, runs in a separate thread */
+    void run();
+    void pushChunk(const QByteArray &data);
+
+private Q_SLOTS:
+    void writeChunk(const QByteArray &data);
+    void processBytesWritten(qint64 bytes);
+    void extractionDone(bool success);
+
+Q_SIGNALS:
+    void chunkReady(const QByteArray &data);
+    void extracted(bool success);
+    /** @brief All the audio was sent to the process, or the extraction failed */
+    void finished(bool success);
+};
@@ -22,9 +22,12 @@
 #include <QListWidget>
 #include <QListWidgetItem>
 #include <QPushButton>
+#include <QRegularExpression>
 #include <QStandardPaths>
 #include <QVBoxLayout>
 
+#include <algorithm>
+
 SpeechToText::SpeechToText(SpeechToTextEngine::EngineType engineType, QObject *parent)
     : AbstractPythonInterface(parent)
     , m_engineType(engineType)
@@ -82,3 +85,112 @@ bool SpeechToText::useSystemPython()
 {
     return KdenliveSettings::speech_system_python();
 }
+
+QVector<SpeechToText::Segment> SpeechToText::splitZone(const QPoint &zone, int count, int minLength, int overlap)
+{
+    const int length = zone.y() - zone.x();
+    count = qBound(1, count, qMax(1, length / qMax(1, minLength)));
+    QVector<Segment> segments;
+    for (int i = 0; i < count; i++) {
+        const int keepIn = zone.x() + int(qint64(length) * i / count);
+        const int keepOut = i == count - 1 ? zone.y() + 1 : zone.x() + int(qint64(length) * (i + 1) / count);
+        segments.append({QPoint(qMax(zone.x(), keepIn - overlap), qMin(zone.y(), keepOut + overlap)), keepIn, keepOut});
+    }
+    return segments;
+}
+
+static bool parseSrtTime(const QString &text, qint64 &ms)
+{
+    static const QRegularExpression timeExp(QStringLiteral("^(\\d+):(\\d+):(\\d+)[,.](\\d+)$"));
+    const QRegularExpressionMatch match = timeExp.match(text.trimmed());
+    if (!match.hasMatch()) {
+        return false;
+    }
+    ms = ((match.captured(1).toLongLong() * 60 + match.captured(2).toLongLong()) * 60 + match.captured(3).toLongLong()) * 1000 +
+         match.captured(4).left(3).leftJustified(3, QLatin1Char('0')).toLongLong();
+    return true;
+}
+
+static QString srtTime(qint64 ms)
+{
+    return QStringLiteral("%1:%2:%3,%4")
+        .arg(ms / 3600000, 2, 10, QLatin1Char('0'))
+        .arg(ms / 60000 % 60, 2, 10, QLatin1Char('0'))
+        .arg(ms / 1000 % 60, 2, 10, QLatin1Char('0'))
+        .arg(ms % 1000, 3, 10, QLatin1Char('0'));
+}
+
+QString SpeechToText::mergeSubtitles(const QVector<Segment> &segments, const QStringList &subtitles, double fps)
+{
+    if (segments.isEmpty() || fps <= 0) {
+        return QString();
+    }
+    struct Cue
+    {
+        qint64 start;
+        qint64 end;
+        int startFrame;
+        int segment;
+        QString text;
+    };
+    static const QRegularExpression blockSeparator(QStringLiteral("\\n\\s*\\n"));
+    const int zoneStart = segments.constFirst().zone.x();
+    // Subtitles starting in the part of a segment it is responsible for, and the ones recognized in the overlaps
+    QVector<Cue> cues;
+    QVector<Cue> overlapCues;
+    for (int i = 0; i < segments.count() && i < subtitles.count(); i++) {
+        const Segment &segment = segments.at(i);
+        const qint64 segmentOffset = qRound64((segment.zone.x() - zoneStart) * 1000. / fps);
+        QString content = subtitles.at(i);
+        content.replace(QLatin1String("\r\n"), QLatin1String("\n"));
+        const QStringList blocks = content.split(blockSeparator, Qt::SkipEmptyParts);
+        for (const QString &block : blocks) {
+            QStringList lines = block.split(QLatin1Char('\n'));
+            while (!lines.isEmpty() && !lines.constFirst().contains(QLatin1String("-->"))) {
+                // Drop the subtitle number
+                lines.removeFirst();
+            }
+            if (lines.isEmpty()) {
+                continue;
+            }
+            qint64 start, end;
+            const QString timing = lines.takeFirst();
+            if (!parseSrtTime(timing.section(QLatin1String("-->"), 0, 0), start) || !parseSrtTime(timing.section(QLatin1String("-->"), 1), end)) {
+                continue;
+            }
+            const int startFrame = segment.zone.x() + qRound(start * fps / 1000.);
+            const Cue cue{start + segmentOffset, end + segmentOffset, startFrame, i, lines.join(QLatin1Char('\n')).trimmed()};
+            if (startFrame < segment.keepIn || startFrame >= segment.keepOut) {
+                overlapCues.append(cue);
+            } else {
+                cues.append(cue);
+            }
+        }
+    }
+    // Both segments of an overlap may recognize the same words with slightly different timings, only keep them once
+    for (const Cue &cue : std::as_const(overlapCues)) {
+        const QPoint &zone = segments.at(cue.segment).zone;
+        bool duplicate = false;
+        for (const Cue &kept : std::as_const(cues)) {
+            if (qAbs(kept.segment - cue.segment) != 1 || kept.text != cue.text) {
+                continue;
+            }
+            const QPoint &otherZone = segments.at(kept.segment).zone;
+            const int sharedFrames = qMin(zone.y(), otherZone.y()) - qMax(zone.x(), otherZone.x());
+            if (qAbs(kept.startFrame - cue.startFrame) <= sharedFrames) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate) {
+            cues.append(cue);
+        }
+    }
+    std::stable_sort(cues.begin(), cues.end(), [](const Cue &a, const Cue &b) { return a.start < b.start; });
+    QString result;
+    int index = 1;
+    for (const Cue &cue : std::as_const(cues)) {
+        result.append(QStringLiteral("%1\n%2 --> %3\n%4\n\n").arg(index++).arg(srtTime(cue.start), srtTime(cue.end), cue.text));
+    }
+    return result;
+}
@@ -11,12 +11,22 @@
 #include "definitions.h"
 
 #include <QObject>
+#include <QPoint>
 #include <QProcess>
 
 class SpeechToText: public AbstractPythonInterface
 {
     Q_OBJECT
 public:
+    /** @brief A part of a zone analysed by its own recognizer. Segments overlap so that the words at their boundaries
+     *  are recognized with their context, the subtitles starting in [keepIn, keepOut[ are kept from this segment.
+     */
+    struct Segment
+    {
+        QPoint zone;
+        int keepIn;
+        int keepOut;
+    };
     SpeechToText(SpeechToTextEngine::EngineType engineType = SpeechToTextEngine::EngineNone, QObject *parent = nullptr);
     QString runSubtitleScript(QString modelDirectory, QString language, QString audio, QString speech);
     SpeechToTextEngine::EngineType engineType() const;
@@ -29,6 +39,12 @@ public:
     AbstractPythonInterface::PythonExec venvPythonExecs(bool checkPip = false) override;
     bool useSystemPython() override;
     QString featureName() override;
+    /** @brief Split a zone in at most count overlapping segments that are not shorter than minLength frames */
+    static QVector<Segment> splitZone(const QPoint &zone, int count, int minLength, int overlap);
+    /** @brief Merge the srt results of the segments, in order, to an srt relative to the start of the zone.
+     *  Subtitles recognized in an overlap by both segments with the same text are only kept once.
+     */
+    static QString mergeSubtitles(const QVector<Segment> &segments, const QStringList &subtitles, double fps);
 
 protected:
     SpeechToTextEngine::EngineType m_engineType;
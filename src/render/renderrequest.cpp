@@ -14,6 +14,7 @@
 #include "xml/xml.hpp"
 
 #include <QTemporaryFile>
+#include <QThread>
 
 // TODO: remove, see generatePlaylistFile()
 #include <KMessageBox>
@@ -25,7 +26,12 @@
 
 QStringList RenderRequest::argsByJob(const RenderJob &job, bool addPid)
 {
-    QStringList args = {QStringLiteral("delivery"), KdenliveSettings::meltpath(), job.playlistPath};
+    QStringList args;
+    if (job.audioStems) {
+        args = {QStringLiteral("audio-stems"), job.playlistPath};
+    } else {
+        args = {QStringLiteral("delivery"), KdenliveSettings::meltpath(), job.playlistPath};
+    }
     if (addPid) {
         args << QStringLiteral("--pid");
         args << QString::number(QCoreApplication::applicationPid());
@@ -36,6 +42,15 @@ QStringList RenderRequest::argsByJob(const RenderJob &job, bool addPid)
     return args;
 }
 
+int RenderRequest::renderJobSlots()
+{
+    if (KdenliveSettings::renderjobslots() > 0) {
+        return KdenliveSettings::renderjobslots();
+    }
+    // A render job already uses several threads, keep cores for each of them
+    return qMax(1, QThread::idealThreadCount() / 8);
+}
+
 RenderRequest::RenderRequest()
 {
     setBounds(-1, -1);
@@ -545,25 +560,38 @@ void RenderRequest::prepareMultiAudioFiles(std::vector<RenderJob> &jobs, const Q
         }
     }
 
-    for (int i = orginalTractors.size(); i >= 0; i--) {
-        // Create a render job for each track, muting others
-        auto originalTracktor = orginalTractors.at(i).toElement();
-        const QString processedTrackId = originalTracktor.attribute(QStringLiteral("id"));
+    // All stems are written by a single job, that renders the audio of each track from the same scene
+    QDomDocument docCopy = doc.cloneNode(true).toDocument();
+    QDomElement consumer = docCopy.elementsByTagName(QStringLiteral("consumer")).at(0).toElement();
+    bool switchToWav = !consumer.hasAttribute(QLatin1String("video_off"));
+    auto outputName = [switchToWav](const QString &path) {
+        if (!switchToWav) {
+            return path;
+        }
+        QFileInfo render(path);
+        return render.absoluteDir().absoluteFilePath(render.completeBaseName() + QStringLiteral(".wav"));
+    };
+    QDomNodeList tracktors = docCopy.elementsByTagName(QStringLiteral("tractor"));
+    Q_ASSERT(tracktors.size() == orginalTractors.size());
+    int stemsCount = 0;
+    for (int i = tracktors.size(); i >= 0; i--) {
+        auto tractor = tracktors.at(i).toElement();
+        const QString processedTrackId = tractor.attribute(QStringLiteral("id"));
         if (!trackIds.contains(processedTrackId)) {
             continue;
         }
-        QString trackName = Xml::getXmlProperty(originalTracktor, QStringLiteral("kdenlive:track_name"));
-        bool originalIsAudio = Xml::getXmlProperty(originalTracktor, QStringLiteral("kdenlive:audio_track")).toInt() == 1;
-        if (!originalIsAudio) {
+        QString trackName = Xml::getXmlProperty(tractor, QStringLiteral("kdenlive:track_name"));
+        bool isAudio = Xml::getXmlProperty(tractor, QStringLiteral("kdenlive:audio_track")).toInt() == 1;
+        if (!isAudio) {
             // Not an audio track, nothing to do
             continue;
         }
         audioCount++;
-        QDomNodeList originalTracks = originalTracktor.elementsByTagName(QStringLiteral("track"));
+        QDomNodeList tracks = tractor.elementsByTagName(QStringLiteral("track"));
         // Check that the track is not muted
         bool muted = true;
-        for (int l = 0; l < originalTracks.size(); l++) {
-            if (originalTracks.at(l).toElement().attribute(QStringLiteral("hide")) != QLatin1String("both")) {
+        for (int l = 0; l < tracks.size(); l++) {
+            if (tracks.at(l).toElement().attribute(QStringLiteral("hide")) != QLatin1String("both")) {
                 muted = false;
                 break;
             }
@@ -572,66 +600,34 @@ void RenderRequest::prepareMultiAudioFiles(std::vector<RenderJob> &jobs, const Q
             // Nothing to do for that track
             continue;
         }
-
-        // init doc copy
-        bool switchToWav = false;
-        QDomDocument docCopy = doc.cloneNode(true).toDocument();
-        QDomElement consumer = docCopy.elementsByTagName(QStringLiteral("consumer")).at(0).toElement();
-        if (!consumer.hasAttribute(QLatin1String("video_off"))) {
-            switchToWav = true;
-        }
-
         // setup filenames
         QString appendix = QStringLiteral("_A%1%2%3")
                                .arg(audioCount)
                                .arg(trackName.isEmpty() ? QString() : QStringLiteral("-"))
                                .arg(trackName.replace(QStringLiteral(" "), QStringLiteral("_")));
-        RenderJob job;
-        job.playlistPath = QStringUtils::appendToFilename(playlistFile, appendix);
-        job.outputPath = QStringUtils::appendToFilename(targetFile, appendix);
-        if (switchToWav) {
-            QFileInfo render(job.outputPath);
-            QString fileName = render.completeBaseName();
-            fileName.append(QStringLiteral(".wav"));
-            job.outputPath = render.absoluteDir().absoluteFilePath(fileName);
-        }
-        job.outputFile = job.outputPath;
-        jobs.push_back(job);
+        Xml::setXmlProperty(tractor, QStringLiteral("kdenlive:stem_target"), outputName(QStringUtils::appendToFilename(targetFile, appendix)));
+        stemsCount++;
+    }
+    if (stemsCount == 0) {
+        return;
+    }
 
-        consumer.setAttribute(QStringLiteral("target"), job.outputPath);
-        if (switchToWav) {
-            consumer.setAttribute(QStringLiteral("video_off"), QStringLiteral("1"));
-            consumer.setAttribute(QStringLiteral("vn"), QStringLiteral("1"));
-            consumer.setAttribute(QStringLiteral("acodec"), QStringLiteral("pcm_s16le"));
-            consumer.setAttribute(QStringLiteral("f"), QStringLiteral("wav"));
-        }
+    RenderJob job;
+    job.playlistPath = QStringUtils::appendToFilename(playlistFile, QStringLiteral("_stems"));
+    // The master mix is rendered to the requested file for audio exports, next to the video otherwise
+    job.outputPath = switchToWav ? outputName(QStringUtils::appendToFilename(targetFile, QStringLiteral("_master"))) : targetFile;
+    job.outputFile = job.outputPath;
+    job.audioStems = true;
+    jobs.push_back(job);
 
-        QDomNodeList tracktors = docCopy.elementsByTagName(QStringLiteral("tractor"));
-        Q_ASSERT(tracktors.size() == orginalTractors.size());
-        QDomNodeList mainTracks = docCopy.elementsByTagName(QStringLiteral("tractor"));
-        for (int j = 0; j < tracktors.size(); j++) {
-            auto tractor = tracktors.at(j).toElement();
-            const QString currentId = tractor.attribute(QStringLiteral("id"));
-            if (!trackIds.contains(currentId)) {
-                // Not a track in current timeline
-                continue;
-            }
-            if (processedTrackId == currentId) {
-                // This is the track we want
-                continue;
-            }
-            bool copyIsAudio = Xml::getXmlProperty(tractor, QStringLiteral("kdenlive:audio_track")).toInt() == 1;
-            if (!copyIsAudio) {
-                // Not an audio track, leave as is
-                continue;
-            }
-            QDomNodeList tracks = tractor.elementsByTagName(QStringLiteral("track"));
-            for (int l = 0; l < tracks.size(); l++) {
-                tracks.at(l).toElement().setAttribute(QStringLiteral("hide"), QStringLiteral("both"));
-            }
-        }
-        Xml::docContentToFile(docCopy, job.playlistPath);
+    consumer.setAttribute(QStringLiteral("target"), job.outputPath);
+    if (switchToWav) {
+        consumer.setAttribute(QStringLiteral("video_off"), QStringLiteral("1"));
+        consumer.setAttribute(QStringLiteral("vn"), QStringLiteral("1"));
+        consumer.setAttribute(QStringLiteral("acodec"), QStringLiteral("pcm_s16le"));
+        consumer.setAttribute(QStringLiteral("f"), QStringLiteral("wav"));
     }
+    Xml::docContentToFile(docCopy, job.playlistPath);
 }
 
 void RenderRequest::addErrorMessage(const QString &error)
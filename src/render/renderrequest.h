@@ -25,6 +25,8 @@ public:
         QString outputFile;
         /** @brief The path to the subtitle file used on rendering */
         QString subtitlePath;
+        /** @brief True if the job renders the audio of each track and the master mix in one pass, instead of using melt */
+        bool audioStems{false};
     };
 
     /** @brief Set frame range that should be rendered
@@ -50,6 +52,8 @@ public:
     QStringList errorMessages();
 
     static QStringList argsByJob(const RenderJob &job, bool addPid = true);
+    /** @brief Maximum number of render jobs running at the same time */
+    static int renderJobSlots();
 
     /** @brief Some methods used for tests */
     int guideSectionsCount();
@@ -49,12 +49,16 @@ Spectrogram::Spectrogram(QWidget *parent)
     m_aTrackMouse->setCheckable(true);
     m_aHighlightPeaks = new QAction(i18n("Highlight peaks"), this);
     m_aHighlightPeaks->setCheckable(true);
+    m_aOverlap = new QAction(i18n("Overlapped analysis"), this);
+    m_aOverlap->setCheckable(true);
+    m_aOverlap->setToolTip(i18n("Analyse all incoming samples with half overlapping windows, instead of the start of each frame"));
 
     m_menu->addSeparator();
     m_menu->addAction(m_aResetHz);
     m_menu->addAction(m_aTrackMouse);
     m_menu->addAction(m_aGrid);
     m_menu->addAction(m_aHighlightPeaks);
+    m_menu->addAction(m_aOverlap);
     m_menu->removeAction(m_aRealtime);
 
     m_ui->windowSize->addItem(QStringLiteral("256"), QVariant(256));
@@ -73,6 +77,7 @@ Spectrogram::Spectrogram(QWidget *parent)
                                           "smearing. See Window function on Wikipedia."));
 
     connect(m_aResetHz, &QAction::triggered, this, &Spectrogram::slotResetMaxFreq);
+    connect(m_aOverlap, &QAction::toggled, this, [this]() { m_fftTools.resetStft(); });
     connect(m_ui->windowFunction, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, [&](int) { Spectrogram::forceUpdate(); });
     connect(this, &Spectrogram::signalMousePositionChanged, this, &Spectrogram::forceUpdateHUD);
 
@@ -94,6 +99,7 @@ Spectrogram::~Spectrogram()
     delete m_aResetHz;
     delete m_aTrackMouse;
     delete m_aGrid;
+    delete m_aOverlap;
     delete m_ui;
 }
 
@@ -109,6 +115,7 @@ void Spectrogram::readConfig()
     m_aTrackMouse->setChecked(scopeConfig.readEntry("trackMouse", true));
     m_aGrid->setChecked(scopeConfig.readEntry("drawGrid", true));
     m_aHighlightPeaks->setChecked(scopeConfig.readEntry("highlightPeaks", true));
+    m_aOverlap->setChecked(scopeConfig.readEntry("overlappedAnalysis", false));
     m_dBmax = scopeConfig.readEntry("dBmax", 0);
     m_dBmin = scopeConfig.readEntry("dBmin", -70);
     m_freqMax = scopeConfig.readEntry("freqMax", 0);
@@ -130,6 +137,7 @@ void Spectrogram::writeConfig()
     scopeConfig.writeEntry("trackMouse", m_aTrackMouse->isChecked());
     scopeConfig.writeEntry("drawGrid", m_aGrid->isChecked());
     scopeConfig.writeEntry("highlightPeaks", m_aHighlightPeaks->isChecked());
+    scopeConfig.writeEntry("overlappedAnalysis", m_aOverlap->isChecked());
     scopeConfig.writeEntry("dBmax", m_dBmax);
     scopeConfig.writeEntry("dBmin", m_dBmin);
 
@@ -312,8 +320,10 @@ QImage Spectrogram::renderAudioScope(uint, const audioShortVector &audioFrame, c
         QElapsedTimer timer;
         timer.start();
 
+        const bool overlapped = m_aOverlap->isChecked();
         int fftWindow = m_ui->windowSize->itemData(m_ui->windowSize->currentIndex()).toInt();
-        if (fftWindow > num_samples) {
+        if (fftWindow > num_samples && !overlapped) {
+            // Overlapped analysis collects samples over several frames, so it is not limited by the frame size
             fftWindow = num_samples;
         }
         if ((fftWindow & 1) == 1) {
@@ -323,21 +333,26 @@ QImage Spectrogram::renderAudioScope(uint, const audioShortVector &audioFrame, c
         // Show the window size used, for information
         m_ui->labelFFTSizeNumber->setText(QVariant(fftWindow).toString());
 
+        // Number of spectra added to the history by this call
+        int newLines = 0;
         if (newDataAvailable) {
-
-            auto *freqSpectrum = new float[uint(fftWindow / 2)];
-
             // Get the spectral power distribution of the input samples,
             // using the given window size and function
             FFTTools::WindowType windowType = FFTTools::WindowType(m_ui->windowFunction->itemData(m_ui->windowFunction->currentIndex()).toInt());
-            m_fftTools.fftNormalized(audioFrame, 0, uint(num_channels), freqSpectrum, windowType, uint(fftWindow), 0);
-
-            // This method might be called also when a simple refresh is required.
-            // In this case there is no data to append to the history. Only append new data.
-            QVector<float> spectrumVector(fftWindow / 2);
-            memcpy(spectrumVector.data(), &freqSpectrum[0], uint(fftWindow) / 2 * sizeof(float));
-            m_fftHistory.prepend(spectrumVector);
-            delete[] freqSpectrum;
+            if (overlapped) {
+                const QVector<QVector<float>> spectra = m_fftTools.stft(audioFrame, 0, uint(num_channels), windowType, uint(fftWindow), uint(fftWindow / 2), 0);
+                for (const QVector<float> &spectrumVector : spectra) {
+                    m_fftHistory.prepend(spectrumVector);
+                }
+                newLines = spectra.size();
+            } else {
+                // This method might be called also when a simple refresh is required.
+                // In this case there is no data to append to the history. Only append new data.
+                QVector<float> spectrumVector(fftWindow / 2);
+                m_fftTools.fftNormalized(audioFrame, 0, uint(num_channels), spectrumVector.data(), windowType, uint(fftWindow), 0);
+                m_fftHistory.prepend(spectrumVector);
+                newLines = 1;
+            }
         }
 #ifdef DEBUG_SPECTROGRAM
         else {
@@ -372,7 +387,7 @@ QImage Spectrogram::renderAudioScope(uint, const audioShortVector &audioFrame, c
             // so we can re-use it, shift it by one pixel, and render the single remaining line. Usually about
             // 10 times faster for a widget height of around 400 px.
             if (newDataAvailable) {
-                davinci.drawImage(0, -1, m_fftHistoryImg);
+                davinci.drawImage(0, -newLines, m_fftHistoryImg);
             } else {
                 // spectrum = m_fftHistoryImg does NOT work, leads to segfaults (anyone knows why, please tell me)
                 davinci.drawImage(0, 0, m_fftHistoryImg);
@@ -395,6 +410,7 @@ QImage Spectrogram::renderAudioScope(uint, const audioShortVector &audioFrame, c
                 right = uint(m_freqMax / (m_freq / 2.f) * (windowSize - 1));
                 dbMap = FFTTools::interpolatePeakPreserving(it, uint(m_innerScopeRect.width()), 0, right, -180);
 
+                auto *line = reinterpret_cast<QRgb *>(spectrum.scanLine(topDist + h - 1 - y)) + leftDist;
                 for (int i = 0; i < dbMap.size(); ++i) {
                     float val;
                     val = dbMap[i];
@@ -408,17 +424,17 @@ QImage Spectrogram::renderAudioScope(uint, const audioShortVector &audioFrame, c
                         val = 1;
                     }
                     if (!peak || !m_aHighlightPeaks->isChecked()) {
-                        spectrum.setPixel(leftDist + i, topDist + h - 1 - y, m_colorMap[int(val * 255)]);
+                        line[i] = m_colorMap[int(val * 255)];
                     } else {
-                        spectrum.setPixel(leftDist + i, topDist + h - 1 - y, AbstractScopeWidget::colHighlightDark.rgba());
+                        line[i] = AbstractScopeWidget::colHighlightDark.rgba();
                     }
                 }
 
                 y++;
-                if (y >= topDist + m_innerScopeRect.height()) {
+                if (y >= h) {
                     break;
                 }
-                if (!completeRedraw) {
+                if (!completeRedraw && y >= newLines) {
                     break;
                 }
             }
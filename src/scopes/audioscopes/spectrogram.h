@@ -59,6 +59,7 @@ private:
     QAction *m_aGrid;
     QAction *m_aTrackMouse;
     QAction *m_aHighlightPeaks;
+    QAction *m_aOverlap;
 
     QList<QVector<float>> m_fftHistory;
     QImage m_fftHistoryImg;
@@ -120,6 +120,22 @@ void GroupsModel::createGroupItem(int id)
     Q_ASSERT(m_downLink.count(id) == 0);
     m_upLink[id] = -1;
     m_downLink[id] = std::unordered_set<int>();
+    hierarchyChanged();
+}
+
+void GroupsModel::hierarchyChanged()
+{
+    m_generation.fetchAndAddOrdered(1);
+}
+
+void GroupsModel::checkCacheGeneration() const
+{
+    const int generation = m_generation.loadAcquire();
+    if (m_cacheGeneration != generation) {
+        m_rootCache.clear();
+        m_leavesCache.clear();
+        m_cacheGeneration = generation;
+    }
 }
 
 Fun GroupsModel::destructGroupItem_lambda(int id)
@@ -131,6 +147,7 @@ Fun GroupsModel::destructGroupItem_lambda(int id)
         if (!ptr) Q_ASSERT(false);
         for (int child : m_downLink[id]) {
             m_upLink[child] = -1;
+            hierarchyChanged();
             QModelIndex ix;
             if (ptr->isClip(child)) {
                 ix = ptr->makeClipIndexFromID(child);
@@ -149,6 +166,7 @@ Fun GroupsModel::destructGroupItem_lambda(int id)
         }
         m_downLink.erase(id);
         m_upLink.erase(id);
+        hierarchyChanged();
         return true;
     };
 }
@@ -193,17 +211,35 @@ bool GroupsModel::destructGroupItem(int id)
 int GroupsModel::getRootId(int id) const
 {
     READ_LOCK();
-    std::unordered_set<int> seen; // we store visited ids to detect cycles
+    QMutexLocker cacheLocker(&m_cacheMutex);
+    checkCacheGeneration();
+    auto cached = m_rootCache.find(id);
+    if (cached != m_rootCache.end()) {
+        return cached->second;
+    }
+    const int item = id;
+    size_t depth = 0; // a path longer than the number of items means there is a cycle
     int father = -1;
     do {
         Q_ASSERT(m_upLink.count(id) > 0);
-        Q_ASSERT(seen.count(id) == 0);
-        seen.insert(id);
+        depth++;
+        Q_ASSERT(depth <= m_upLink.size());
         father = m_upLink.at(id);
         if (father != -1) {
             id = father;
+            cached = m_rootCache.find(id);
+            if (cached != m_rootCache.end()) {
+                id = cached->second;
+                break;
+            }
         }
     } while (father != -1);
+    Q_UNUSED(depth);
+    // All the ancestors share the same root
+    for (int current = item; current != id && current != -1; current = m_upLink.at(current)) {
+        m_rootCache[current] = id;
+    }
+    m_rootCache[id] = id;
     return id;
 }
 
@@ -265,6 +301,12 @@ std::unordered_set<int> GroupsModel::getSubtree(int id) const
 std::unordered_set<int> GroupsModel::getLeaves(int id) const
 {
     READ_LOCK();
+    QMutexLocker cacheLocker(&m_cacheMutex);
+    checkCacheGeneration();
+    auto cached = m_leavesCache.find(id);
+    if (cached != m_leavesCache.end()) {
+        return cached->second;
+    }
     std::unordered_set<int> result;
     std::queue<int> queue;
     queue.push(id);
@@ -278,6 +320,7 @@ std::unordered_set<int> GroupsModel::getLeaves(int id) const
             result.insert(current);
         }
     }
+    m_leavesCache[id] = result;
     return result;
 }
 
@@ -304,6 +347,7 @@ void GroupsModel::setGroup(int id, int groupId, bool changeState)
     m_upLink[id] = groupId;
     if (groupId != -1) {
         m_downLink[groupId].insert(id);
+        hierarchyChanged();
         auto ptr = m_parent.lock();
         if (changeState && ptr) {
             QModelIndex ix;
@@ -346,6 +390,8 @@ void GroupsModel::removeFromGroup(int id)
     if (parent != -1) {
         Q_ASSERT(getType(parent) != GroupType::Leaf);
         m_downLink[parent].erase(id);
+        m_upLink[id] = -1;
+        hierarchyChanged();
         QModelIndex ix;
         auto ptr = m_parent.lock();
         if (!ptr) Q_ASSERT(false);
@@ -7,6 +7,8 @@
 
 #include "definitions.h"
 #include "undohelper.hpp"
+#include <QAtomicInt>
+#include <QMutex>
 #include <QReadWriteLock>
 #include <memory>
 #include <unordered_map>
@@ -217,6 +219,9 @@ protected:
     */
     void adjustOffset(QJsonArray &updatedNodes, const QJsonObject &childObject, int offset, const QMap<int, int> &trackMap, double ratio = 1.);
 
+    /** @brief Invalidate the cached roots and leaves, must be called whenever the hierarchy links change */
+    void hierarchyChanged();
+
 private:
     std::weak_ptr<TimelineItemModel> m_parent;
 
@@ -228,4 +233,15 @@ private:
     std::unordered_map<int, GroupType> m_groupIds;
     /** @brief This is a lock that ensures safety in case of concurrent access */
     mutable QReadWriteLock m_lock;
+    /** @brief Cached root of the queried items, and flattened leaves of the queried groups.
+       They are filled on query and dropped when the hierarchy generation differs from the cache generation.
+    */
+    mutable std::unordered_map<int, int> m_rootCache;
+    mutable std::unordered_map<int, std::unordered_set<int>> m_leavesCache;
+    QAtomicInt m_generation{0};
+    mutable int m_cacheGeneration{0};
+    /** @brief Protects the caches, that are filled by concurrent readers */
+    mutable QMutex m_cacheMutex;
+    /** @brief Drop the caches if the hierarchy changed since they were filled. m_cacheMutex must be locked */
+    void checkCacheGeneration() const;
 };
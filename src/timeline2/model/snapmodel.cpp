@@ -4,6 +4,7 @@
 */
 #include "snapmodel.hpp"
 #include <QDebug>
+#include <algorithm>
 #include <climits>
 #include <cstdlib>
 
@@ -12,38 +13,195 @@ SnapInterface::~SnapInterface() = default;
 
 SnapModel::SnapModel() = default;
 
+int SnapModel::indexOf(int position) const
+{
+    auto it = std::lower_bound(m_positions.cbegin(), m_positions.cend(), position);
+    if (it == m_positions.cend() || *it != position) {
+        return -1;
+    }
+    return int(it - m_positions.cbegin());
+}
+
 void SnapModel::addPoint(int position)
 {
-    if (m_snaps.count(position) == 0) {
-        m_snaps[position] = 1;
-    } else {
-        m_snaps[position]++;
+    auto it = std::lower_bound(m_positions.begin(), m_positions.end(), position);
+    size_t index = size_t(it - m_positions.begin());
+    if (it != m_positions.end() && *it == position) {
+        if (m_counts[index] == 0 && m_ignoredCounts[index] == 0) {
+            m_emptySlots--;
+        }
+        m_counts[index]++;
+        updateVisibility(index);
+        return;
     }
+    m_positions.insert(it, position);
+    m_counts.insert(m_counts.begin() + index, 1);
+    m_ignoredCounts.insert(m_ignoredCounts.begin() + index, 0);
+    m_generation++;
 }
 
 void SnapModel::removePoint(int position)
 {
-    Q_ASSERT(m_snaps.count(position) > 0);
-    if (m_snaps[position] == 1) {
-        m_snaps.erase(position);
-    } else {
-        m_snaps[position]--;
+    int index = indexOf(position);
+    Q_ASSERT(index > -1 && m_counts[index] > m_ignoredCounts[index]);
+    if (index < 0 || m_counts[index] == 0) {
+        return;
+    }
+    m_counts[index]--;
+    if (m_counts[index] == 0 && m_ignoredCounts[index] == 0) {
+        // Keep the slot, the same position is often added again (cursor, moved clips)
+        m_emptySlots++;
+    }
+    updateVisibility(index);
+}
+
+void SnapModel::updateVisibility(size_t index)
+{
+    if (m_maskGeneration != m_generation) {
+        // The mask will be rebuilt on next query
+        return;
+    }
+    const bool visible = m_counts[index] > m_ignoredCounts[index];
+    for (auto &level : m_visibleMask) {
+        quint64 &word = level[index >> 6];
+        const bool wasEmpty = word == 0;
+        if (visible) {
+            word |= quint64(1) << (index & 63);
+        } else {
+            word &= ~(quint64(1) << (index & 63));
+        }
+        if (wasEmpty == (word == 0)) {
+            // Upper levels are unchanged
+            break;
+        }
+        index >>= 6;
+    }
+}
+
+void SnapModel::ensureMask()
+{
+    if (m_maskGeneration == m_generation) {
+        return;
+    }
+    if (m_emptySlots > 0 && 2 * m_emptySlots > m_positions.size()) {
+        // Drop the positions that have no element anymore
+        size_t kept = 0;
+        for (size_t i = 0; i < m_positions.size(); i++) {
+            if (m_counts[i] > 0 || m_ignoredCounts[i] > 0) {
+                m_positions[kept] = m_positions[i];
+                m_counts[kept] = m_counts[i];
+                m_ignoredCounts[kept] = m_ignoredCounts[i];
+                kept++;
+            }
+        }
+        m_positions.resize(kept);
+        m_counts.resize(kept);
+        m_ignoredCounts.resize(kept);
+        m_emptySlots = 0;
+    }
+    m_visibleMask.clear();
+    if (!m_positions.empty()) {
+        std::vector<quint64> level((m_positions.size() + 63) / 64, 0);
+        for (size_t i = 0; i < m_positions.size(); i++) {
+            if (m_counts[i] > m_ignoredCounts[i]) {
+                level[i >> 6] |= quint64(1) << (i & 63);
+            }
+        }
+        m_visibleMask.push_back(std::move(level));
+        while (m_visibleMask.back().size() > 1) {
+            const std::vector<quint64> &below = m_visibleMask.back();
+            std::vector<quint64> upper((below.size() + 63) / 64, 0);
+            for (size_t i = 0; i < below.size(); i++) {
+                if (below[i] != 0) {
+                    upper[i >> 6] |= quint64(1) << (i & 63);
+                }
+            }
+            m_visibleMask.push_back(std::move(upper));
+        }
     }
+    m_maskGeneration = m_generation;
+}
+
+int SnapModel::nextVisible(size_t index) const
+{
+    size_t level = 0;
+    size_t pos = index;
+    // Climb until a word has a set bit at or after pos
+    for (; level < m_visibleMask.size(); level++) {
+        const std::vector<quint64> &words = m_visibleMask[level];
+        const size_t word = pos >> 6;
+        if (word >= words.size()) {
+            return -1;
+        }
+        const quint64 bits = words[word] & (~quint64(0) << (pos & 63));
+        if (bits != 0) {
+            pos = (word << 6) + size_t(qCountTrailingZeroBits(bits));
+            break;
+        }
+        pos = word + 1;
+    }
+    if (level == m_visibleMask.size()) {
+        return -1;
+    }
+    // Descend to the first set bit of the found subtree
+    while (level > 0) {
+        level--;
+        pos = (pos << 6) + size_t(qCountTrailingZeroBits(m_visibleMask[level][pos]));
+    }
+    return int(pos);
+}
+
+int SnapModel::previousVisible(int index) const
+{
+    size_t level = 0;
+    qint64 pos = index;
+    // Climb until a word has a set bit at or before pos
+    for (; level < m_visibleMask.size(); level++) {
+        if (pos < 0) {
+            return -1;
+        }
+        const std::vector<quint64> &words = m_visibleMask[level];
+        size_t word = size_t(pos >> 6);
+        quint64 bits;
+        if (word >= words.size()) {
+            word = words.size() - 1;
+            bits = words[word];
+        } else {
+            bits = words[word] & (~quint64(0) >> (63 - (pos & 63)));
+        }
+        if (bits != 0) {
+            pos = qint64(word << 6) + 63 - qCountLeadingZeroBits(bits);
+            break;
+        }
+        pos = qint64(word) - 1;
+    }
+    if (level == m_visibleMask.size()) {
+        return -1;
+    }
+    // Descend to the last set bit of the found subtree
+    while (level > 0) {
+        level--;
+        pos = (pos << 6) + 63 - qCountLeadingZeroBits(m_visibleMask[level][size_t(pos)]);
+    }
+    return int(pos);
 }
 
 int SnapModel::getClosestPoint(int position)
 {
-    if (m_snaps.empty()) {
+    ensureMask();
+    auto it = std::lower_bound(m_positions.cbegin(), m_positions.cend(), position);
+    const int index = int(it - m_positions.cbegin());
+    const int nextIndex = nextVisible(size_t(index));
+    const int prevIndex = previousVisible(index - 1);
+    if (nextIndex < 0 && prevIndex < 0) {
         return -1;
     }
-    auto it = m_snaps.lower_bound(position);
     long long int prev = INT_MIN, next = INT_MAX;
-    if (it != m_snaps.end()) {
-        next = (*it).first;
+    if (nextIndex > -1) {
+        next = m_positions[size_t(nextIndex)];
     }
-    if (it != m_snaps.begin()) {
-        --it;
-        prev = (*it).first;
+    if (prevIndex > -1) {
+        prev = m_positions[size_t(prevIndex)];
     }
     if (std::llabs(position - prev) < std::llabs(position - next)) {
         return int(prev);
@@ -53,47 +211,67 @@ int SnapModel::getClosestPoint(int position)
 
 int SnapModel::getNextPoint(int position)
 {
-    if (m_snaps.empty()) {
+    ensureMask();
+    auto it = std::upper_bound(m_positions.cbegin(), m_positions.cend(), position);
+    const int nextIndex = nextVisible(size_t(it - m_positions.cbegin()));
+    if (nextIndex < 0) {
         return position;
     }
-    auto it = m_snaps.lower_bound(position + 1);
-    long long int next = position;
-    if (it != m_snaps.end()) {
-        next = (*it).first;
-    }
-    return int(next);
+    return m_positions[size_t(nextIndex)];
 }
 
 int SnapModel::getPreviousPoint(int position)
 {
-    if (m_snaps.empty()) {
+    ensureMask();
+    auto it = std::lower_bound(m_positions.cbegin(), m_positions.cend(), position);
+    const int prevIndex = previousVisible(int(it - m_positions.cbegin()) - 1);
+    if (prevIndex < 0) {
         return 0;
     }
-    auto it = m_snaps.lower_bound(position);
-    long long int prev = 0;
-    if (it != m_snaps.begin()) {
-        --it;
-        prev = (*it).first;
-    }
-    return int(prev);
+    return m_positions[size_t(prevIndex)];
 }
 
 void SnapModel::ignore(const std::vector<int> &pts)
 {
     for (int pt : pts) {
-        removePoint(pt);
+        int index = indexOf(pt);
+        Q_ASSERT(index > -1 && m_counts[index] > m_ignoredCounts[index]);
+        if (index < 0) {
+            continue;
+        }
+        m_ignoredCounts[index]++;
+        updateVisibility(size_t(index));
         m_ignore.push_back(pt);
     }
 }
 
 void SnapModel::unIgnore()
 {
-    for (const auto &pt : m_ignore) {
-        addPoint(pt);
+    for (int pt : m_ignore) {
+        int index = indexOf(pt);
+        if (index < 0 || m_ignoredCounts[index] == 0) {
+            continue;
+        }
+        m_ignoredCounts[index]--;
+        if (m_counts[index] == 0 && m_ignoredCounts[index] == 0) {
+            m_emptySlots++;
+        }
+        updateVisibility(size_t(index));
     }
     m_ignore.clear();
 }
 
+std::map<int, int> SnapModel::_snaps() const
+{
+    std::map<int, int> snaps;
+    for (size_t i = 0; i < m_positions.size(); i++) {
+        if (m_counts[i] > m_ignoredCounts[i]) {
+            snaps[m_positions[i]] = m_counts[i] - m_ignoredCounts[i];
+        }
+    }
+    return snaps;
+}
+
 int SnapModel::proposeSize(int in, int out, int size, bool right, int maxSnapDist)
 {
     ignore({in, out});
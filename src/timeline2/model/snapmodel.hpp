@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <QtGlobal>
 #include <map>
 #include <vector>
 
@@ -26,7 +27,10 @@ public:
 
 /** @class SnapModel
     @brief This class represents the snap points of the timeline.
-    Basically, one can add or remove snap points, and query the closest snap point to a given location
+    Basically, one can add or remove snap points, and query the closest snap point to a given location.
+    The points are stored in a sorted flat array with a reference count and an ignore count for each position. A
+    hierarchical bitset of the visible positions answers the nearest point queries in O(log n), whatever the number of
+    ignored points, so that ignoring the borders of a large group on each drag step does not touch the array.
  */
 class SnapModel : public virtual SnapInterface
 {
@@ -70,12 +74,31 @@ public:
     int proposeSize(int in, int out, const std::vector<int> &boundaries, int size, bool right, int maxSnapDist);
 
     // For testing only
-    std::map<int, int> _snaps() { return m_snaps; }
+    std::map<int, int> _snaps() const;
 
 private:
-    /** This represents the snappoints internally. The keys are the positions and the values are the number of elements at this
-     * position. Note that it is important that the datastructure is ordered. QMap is NOT ordered, and therefore not suitable.
-     */
-    std::map<int, int> m_snaps;
+    /** @brief Sorted positions of the snappoints. A position whose count dropped to 0 is kept until the next compaction */
+    std::vector<int> m_positions;
+    /** @brief Number of elements at each position */
+    std::vector<int> m_counts;
+    /** @brief Number of ignored elements at each position, a position is visible if it has more elements than ignored ones */
+    std::vector<int> m_ignoredCounts;
+    /** @brief Visible positions, level 0 has one bit per position and each upper level one bit per non empty word below */
+    std::vector<std::vector<quint64>> m_visibleMask;
+    /** @brief Incremented when positions are inserted or removed, the mask is rebuilt when its generation is outdated */
+    quint64 m_generation{0};
+    quint64 m_maskGeneration{0};
+    /** @brief Number of positions without any element */
+    size_t m_emptySlots{0};
     std::vector<int> m_ignore;
+    /** @brief Index of the given position in the array, or -1 */
+    int indexOf(int position) const;
+    /** @brief Update the mask after the counts of the given index changed */
+    void updateVisibility(size_t index);
+    /** @brief Rebuild the mask if positions were inserted or removed since it was built */
+    void ensureMask();
+    /** @brief Index of the first visible position at or after index, -1 if none */
+    int nextVisible(size_t index) const;
+    /** @brief Index of the last visible position at or before index, -1 if none */
+    int previousVisible(int index) const;
 };
@@ -16,6 +16,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "clipmodel.hpp"
 #include "compositionmodel.hpp"
 #include "core.h"
+#include "doc/docundostack.hpp"
 #include "doc/kdenlivedoc.h"
 #include "effects/effectstack/model/effectstackmodel.hpp"
 #include "groupsmodel.hpp"
@@ -34,7 +35,10 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QApplication>
 #include <QDebug>
 #include <QInputDialog>
+#include <QMimeData>
 #include <QSemaphore>
+#include <QtConcurrent/QtConcurrentMap>
+#include <map>
 #include <unordered_map>
 
 #ifdef CRASH_AUTO_TEST
@@ -76,6 +80,48 @@ QMap<int, int> spacerUngroupedItems;
 int spacerMinPosition(-1);
 int spacerMaxPosition(-1);
 QSemaphore semaphore(1);
+/** @brief The last copied items, kept in memory so that pasting in the same timeline does not need to parse the clipboard data */
+struct
+{
+    /** @brief The string representation of document, only generated when requested */
+    QString data;
+    QDomDocument document;
+    QUuid timelineUuid;
+    QUuid sessionId;
+    quint64 generation{0};
+} lastCopy;
+
+/** @class TimelineCopyMimeData
+    @brief Clipboard content of a timeline copy. The xml string is generated on the first request, pasting in Kdenlive reuses the document.
+ */
+class TimelineCopyMimeData : public QMimeData
+{
+public:
+    explicit TimelineCopyMimeData(const QDomDocument &document)
+        : m_document(document)
+    {
+    }
+    const QDomDocument &document() const { return m_document; }
+    QStringList formats() const override { return {QStringLiteral("text/plain")}; }
+    bool hasFormat(const QString &mimeType) const override { return mimeType == QLatin1String("text/plain"); }
+
+protected:
+    QVariant retrieveData(const QString &mimeType, QMetaType type) const override
+    {
+        Q_UNUSED(type)
+        if (mimeType != QLatin1String("text/plain")) {
+            return QVariant();
+        }
+        if (m_data.isEmpty()) {
+            m_data = m_document.toString();
+        }
+        return m_data;
+    }
+
+private:
+    QDomDocument m_document;
+    mutable QString m_data;
+};
 
 bool TimelineFunctions::cloneClip(const std::shared_ptr<TimelineItemModel> &timeline, int clipId, int &newId, PlaylistState::ClipState state, int audioStream,
                                   Fun &undo, Fun &redo)
@@ -135,6 +181,33 @@ bool TimelineFunctions::requestMultipleClipsInsertion(const std::shared_ptr<Time
     return true;
 }
 
+QList<std::pair<std::shared_ptr<ProjectClip>, int>> TimelineFunctions::missingTrackProducers(int trackId, const QStringList &binIds)
+{
+    QList<std::pair<std::shared_ptr<ProjectClip>, int>> clips;
+    QStringList processed;
+    for (const QString &binId : binIds) {
+        const QString id = binId.section(QLatin1Char('/'), 0, 0);
+        if (processed.contains(id)) {
+            continue;
+        }
+        processed << id;
+        std::shared_ptr<ProjectClip> clip = pCore->projectItemModel()->getClipByBinID(id);
+        if (clip && clip->statusReady()) {
+            int count = clip->missingTimelineProducers(trackId);
+            if (count > 0) {
+                clips.append({clip, count});
+            }
+        }
+    }
+    return clips;
+}
+
+QFuture<void> TimelineFunctions::prepareTrackProducers(const std::shared_ptr<QList<std::pair<std::shared_ptr<ProjectClip>, int>>> &clips)
+{
+    // The functor keeps the list alive while the worker threads use it
+    return QtConcurrent::map(*clips, [clips](const std::pair<std::shared_ptr<ProjectClip>, int> &clip) { clip.first->prepareTimelineProducers(clip.second); });
+}
+
 bool TimelineFunctions::processClipCut(const std::shared_ptr<TimelineItemModel> &timeline, int clipId, int position, int &newId, Fun &undo, Fun &redo)
 {
     bool isSubtitle = timeline->isSubTitle(clipId);
@@ -160,6 +233,8 @@ bool TimelineFunctions::processClipCut(const std::shared_ptr<TimelineItemModel>
         qDebug() << "// CLONING CLIP FAILED";
         return false;
     }
+    // Restore the previous state, a batch of cuts keeps the refresh blocked
+    const bool blockRefresh = timeline->m_blockRefresh;
     timeline->m_blockRefresh = true;
 
     int updatedDuration = position - start;
@@ -220,7 +295,7 @@ bool TimelineFunctions::processClipCut(const std::shared_ptr<TimelineItemModel>
         updateDuration();
         PUSH_LAMBDA(updateDuration, redo);
     }
-    timeline->m_blockRefresh = false;
+    timeline->m_blockRefresh = blockRefresh;
     return res;
 }
 
@@ -245,162 +320,179 @@ bool TimelineFunctions::requestClipCut(std::shared_ptr<TimelineItemModel> timeli
 
 bool TimelineFunctions::requestClipCut(const std::shared_ptr<TimelineItemModel> &timeline, int clipId, int position, Fun &undo, Fun &redo)
 {
-    const std::unordered_set<int> clipselect = timeline->getGroupElements(clipId);
-    // Remove locked items
-    std::unordered_set<int> clips;
-    for (int cid : clipselect) {
-        if (timeline->isSubTitle(cid)) {
-            clips.insert(cid);
-            continue;
-        }
-        if (!timeline->isClip(cid)) {
-            continue;
-        }
-        int tk = timeline->getClipTrackId(cid);
-        if (tk != -1 && !timeline->getTrackById_const(tk)->isLocked()) {
-            clips.insert(cid);
+    return requestClipsCut(timeline, {{clipId, position}}, undo, redo);
+}
+
+bool TimelineFunctions::requestClipsCut(const std::shared_ptr<TimelineItemModel> &timeline, const QVector<QPair<int, int>> &cuts, Fun &undo, Fun &redo)
+{
+    // Plan all cuts first, the items to cut are listed per position, grouped items included
+    std::map<int, std::unordered_set<int>, std::greater<int>> plannedCuts;
+    // Track and subtitle layer of the selected items to reselect after the split, per position
+    QVector<std::tuple<int, int, int>> toSelect;
+    for (const auto &cut : cuts) {
+        const int clipId = cut.first;
+        const int position = cut.second;
+        const std::unordered_set<int> clipselect = timeline->getGroupElements(clipId);
+        std::unordered_set<int> &clips = plannedCuts[position];
+        for (int cid : clipselect) {
+            if (!timeline->isSubTitle(cid)) {
+                // Remove locked items
+                if (!timeline->isClip(cid)) {
+                    continue;
+                }
+                int tk = timeline->getClipTrackId(cid);
+                if (tk == -1 || timeline->getTrackById_const(tk)->isLocked()) {
+                    continue;
+                }
+            }
+            int start = timeline->getItemPosition(cid);
+            int duration = timeline->getItemPlaytime(cid);
+            if (start < position && (start + duration) > position) {
+                clips.insert(cid);
+            }
         }
-    }
-    // Shall we reselect after the split
-    int trackToSelect = -1;
-    int subLayerToSelect = -1;
-    if (timeline->isClip(clipId) && timeline->m_allClips[clipId]->selected) {
-        int mainIn = timeline->getItemPosition(clipId);
-        int mainOut = mainIn + timeline->getItemPlaytime(clipId);
-        if (position > mainIn && position < mainOut) {
-            trackToSelect = timeline->getItemTrackId(clipId);
-            if (timeline->getSubtitleModel() != nullptr) subLayerToSelect = timeline->getSubtitleLayer(clipId);
+        // Shall we reselect after the split
+        if (timeline->isClip(clipId) && timeline->m_allClips[clipId]->selected) {
+            int mainIn = timeline->getItemPosition(clipId);
+            int mainOut = mainIn + timeline->getItemPlaytime(clipId);
+            if (position > mainIn && position < mainOut) {
+                int subLayerToSelect = timeline->getSubtitleModel() != nullptr ? timeline->getSubtitleLayer(clipId) : -1;
+                toSelect.append({timeline->getItemTrackId(clipId), subLayerToSelect, position});
+            }
         }
     }
     // We need to call clearSelection before attempting the split or the group split will be corrupted by the selection group (no undo support)
     timeline->requestClearSelection();
 
-    std::unordered_set<int> topElements;
-    std::transform(clips.begin(), clips.end(), std::inserter(topElements, topElements.begin()), [&](int id) { return timeline->m_groups->getRootId(id); });
-
-    int count = 0;
-    QList<int> newIds;
-    QList<int> clipsToCut;
-    bool subtitleItemSelected = false;
-    for (int cid : clips) {
-        if (!timeline->isClip(cid) && !timeline->isSubTitle(cid)) {
+    for (auto it = plannedCuts.begin(); it != plannedCuts.end();) {
+        if (it->second.empty()) {
+            it = plannedCuts.erase(it);
             continue;
         }
-        int start = timeline->getItemPosition(cid);
-        int duration = timeline->getItemPlaytime(cid);
-        if (start < position && (start + duration) > position) {
-            clipsToCut << cid;
-            if (timeline->isSubTitle(cid)) {
-                if (subtitleItemSelected) {
-                    // We cannot cut 2 overlapping subtitles at the same position
-                    pCore->displayMessage(i18nc("@info:status", "Cannot cut overlapping subtitles"), ErrorMessage, 500);
-                    bool undone = undo();
-                    Q_ASSERT(undone);
-                    return false;
-                }
-                subtitleItemSelected = true;
+        // We cannot cut 2 overlapping subtitles of the same layer at the same position
+        std::unordered_set<int> subtitleLayers;
+        bool overlappingSubtitles = false;
+        for (int cid : it->second) {
+            if (timeline->isSubTitle(cid) && !subtitleLayers.insert(timeline->getSubtitleLayer(cid)).second) {
+                overlappingSubtitles = true;
+                break;
             }
         }
-    }
-    if (clipsToCut.isEmpty()) {
-        return true;
-    }
-
-    for (int cid : std::as_const(clipsToCut)) {
-        count++;
-        int newId = -1;
-        bool res = processClipCut(timeline, cid, position, newId, undo, redo);
-        if (!res) {
+        if (overlappingSubtitles) {
+            pCore->displayMessage(i18nc("@info:status", "Cannot cut overlapping subtitles"), ErrorMessage, 500);
             bool undone = undo();
             Q_ASSERT(undone);
             return false;
         }
-        // splitted elements go temporarily in the same group as original ones.
-        timeline->m_groups->setInGroupOf(newId, cid, undo, redo);
-        newIds << newId;
+        ++it;
+    }
+    if (plannedCuts.empty()) {
+        return true;
     }
-    if (count > 0 && timeline->m_groups->isInGroup(clipId)) {
-        // we now split the group hierarchy.
-        // As a splitting criterion, we compare start point with split position
-        auto criterion = [timeline, position](int cid) { return timeline->getItemPosition(cid) < position; };
-        bool res = true;
-        for (const int topId : topElements) {
-            qDebug() << "// CHECKING REGROUP ELEMENT: " << topId << ", ISCLIP: " << timeline->isClip(topId) << timeline->isGroup(topId);
-            res = res && timeline->m_groups->split(topId, criterion, undo, redo);
+
+    // Refresh is blocked for the whole batch, cutting does not change the rendered frames
+    const bool blockRefresh = timeline->m_blockRefresh;
+    timeline->m_blockRefresh = true;
+    // Cut from the last position so that the planned ids still cover the previous positions
+    for (const auto &planned : plannedCuts) {
+        const int position = planned.first;
+        std::unordered_set<int> topElements;
+        bool grouped = false;
+        for (int cid : planned.second) {
+            topElements.insert(timeline->m_groups->getRootId(cid));
+            grouped = grouped || timeline->m_groups->isInGroup(cid);
+        }
+        for (int cid : planned.second) {
+            int newId = -1;
+            bool res = processClipCut(timeline, cid, position, newId, undo, redo);
+            if (!res) {
+                timeline->m_blockRefresh = blockRefresh;
+                bool undone = undo();
+                Q_ASSERT(undone);
+                return false;
+            }
+            // splitted elements go temporarily in the same group as original ones.
+            timeline->m_groups->setInGroupOf(newId, cid, undo, redo);
         }
-        if (!res) {
-            bool undone = undo();
-            Q_ASSERT(undone);
-            return false;
+        if (grouped) {
+            // we now split the group hierarchy.
+            // As a splitting criterion, we compare start point with split position
+            auto criterion = [timeline, position](int cid) { return timeline->getItemPosition(cid) < position; };
+            bool res = true;
+            for (const int topId : topElements) {
+                res = res && timeline->m_groups->split(topId, criterion, undo, redo);
+            }
+            if (!res) {
+                timeline->m_blockRefresh = blockRefresh;
+                bool undone = undo();
+                Q_ASSERT(undone);
+                return false;
+            }
         }
     }
-    if (count > 0 && trackToSelect > -1) {
-        int newClip = timeline->getClipByPosition(trackToSelect, position, subLayerToSelect);
+    timeline->m_blockRefresh = blockRefresh;
+
+    std::unordered_set<int> newSelection;
+    for (const auto &item : std::as_const(toSelect)) {
+        int newClip = timeline->getClipByPosition(std::get<0>(item), std::get<2>(item), std::get<1>(item));
         if (newClip > -1) {
-            timeline->requestSetSelection({newClip});
+            newSelection.insert(newClip);
         }
     }
-    return count > 0;
+    if (!newSelection.empty()) {
+        timeline->requestSetSelection(newSelection);
+    }
+    return true;
 }
 
 bool TimelineFunctions::requestClipCutAll(std::shared_ptr<TimelineItemModel> timeline, int position)
 {
-    QVector<std::shared_ptr<TrackModel>> affectedTracks;
+    return requestClipCutAll(timeline, QVector<int>{position});
+}
+
+bool TimelineFunctions::requestClipCutAll(const std::shared_ptr<TimelineItemModel> &timeline, const QVector<int> &positions)
+{
     std::function<bool(void)> undo = []() { return true; };
     std::function<bool(void)> redo = []() { return true; };
 
-    for (const auto &track : timeline->m_allTracks) {
-        if (track->shouldReceiveTimelineOp()) {
-            affectedTracks << track;
-        }
-    }
-
-    unsigned count = 0;
+    QVector<QPair<int, int>> cuts;
     auto subModel = timeline->getSubtitleModel();
-    if (subModel && !subModel->isLocked()) {
-        for (int layer = 0; layer < subModel->getMaxLayer(); layer++) {
-            int clipId = timeline->getClipByPosition(-2, position, layer);
-            if (clipId > -1) {
-                // Found subtitle clip at position in track, cut it. Update undo/redo as we go.
-                if (!TimelineFunctions::requestClipCut(timeline, clipId, position, undo, redo)) {
-                    qWarning() << "Failed to cut clip " << clipId << " at " << position;
-                    pCore->displayMessage(i18n("Failed to cut clip"), ErrorMessage, 500);
-                    // Undo all cuts made, assert successful undo.
-                    bool undone = undo();
-                    Q_ASSERT(undone);
-                    return false;
+    bool hasTracks = false;
+    for (int position : positions) {
+        if (subModel && !subModel->isLocked()) {
+            for (int layer = 0; layer <= subModel->getMaxLayer(); layer++) {
+                int clipId = timeline->getClipByPosition(-2, position, layer);
+                if (clipId > -1) {
+                    cuts.append({clipId, position});
+                }
+            }
+        }
+        for (const auto &track : timeline->m_allTracks) {
+            if (track->shouldReceiveTimelineOp()) {
+                hasTracks = true;
+                int clipId = track->getClipByPosition(position);
+                if (clipId > -1) {
+                    cuts.append({clipId, position});
                 }
-                count++;
             }
         }
     }
-    if (affectedTracks.isEmpty() && count == 0) {
+    if (!hasTracks && cuts.isEmpty()) {
         pCore->displayMessage(i18n("All tracks are locked"), ErrorMessage, 500);
         return false;
     }
-    for (auto track : std::as_const(affectedTracks)) {
-        int clipId = track->getClipByPosition(position);
-        if (clipId > -1) {
-            // Found clip at position in track, cut it. Update undo/redo as we go.
-            if (!TimelineFunctions::requestClipCut(timeline, clipId, position, undo, redo)) {
-                qWarning() << "Failed to cut clip " << clipId << " at " << position;
-                pCore->displayMessage(i18n("Failed to cut clip"), ErrorMessage, 500);
-                // Undo all cuts made, assert successful undo.
-                bool undone = undo();
-                Q_ASSERT(undone);
-                return false;
-            }
-            count++;
-        }
-    }
-
-    if (!count) {
+    if (cuts.isEmpty()) {
         pCore->displayMessage(i18n("No clips to cut"), ErrorMessage);
-    } else {
-        pCore->pushUndo(undo, redo, i18n("Cut all clips"));
+        return false;
     }
-
-    return count > 0;
+    // All clips are cut in one batch, with a single undo entry
+    if (!TimelineFunctions::requestClipsCut(timeline, cuts, undo, redo)) {
+        qWarning() << "Failed to cut clips at " << positions;
+        pCore->displayMessage(i18n("Failed to cut clip"), ErrorMessage, 500);
+        return false;
+    }
+    pCore->pushUndo(undo, redo, i18n("Cut all clips"));
+    return true;
 }
 
 std::pair<int, int> TimelineFunctions::requestSpacerStartOperation(const std::shared_ptr<TimelineItemModel> &timeline, int trackId, int position,
@@ -1744,6 +1836,19 @@ TimelineFunctions::TimelineTracksInfo TimelineFunctions::getAVTracksIds(const st
 }
 
 QString TimelineFunctions::copyClips(const std::shared_ptr<TimelineItemModel> &timeline, const std::unordered_set<int> &itemIds, int mainClip)
+{
+    storeCopy(timeline, buildCopy(timeline, itemIds, mainClip));
+    lastCopy.data = lastCopy.document.toString();
+    return lastCopy.data;
+}
+
+QMimeData *TimelineFunctions::copyClipsMimeData(const std::shared_ptr<TimelineItemModel> &timeline, const std::unordered_set<int> &itemIds, int mainClip)
+{
+    storeCopy(timeline, buildCopy(timeline, itemIds, mainClip));
+    return new TimelineCopyMimeData(lastCopy.document);
+}
+
+QDomDocument TimelineFunctions::buildCopy(const std::shared_ptr<TimelineItemModel> &timeline, const std::unordered_set<int> &itemIds, int mainClip)
 {
     int mainId = *(itemIds.begin());
     // We need to retrieve ALL the involved clips, ie those who are also grouped with the given clips
@@ -1857,7 +1962,7 @@ QString TimelineFunctions::copyClips(const std::shared_ptr<TimelineItemModel> &t
     container.setAttribute(QStringLiteral("videoTracks"), avTracks.second);
     if (timeline->singleSelectionMode()) {
         // Don't include group info
-        return copiedItems.toString();
+        return copiedItems;
     }
     QDomElement grp = copiedItems.createElement(QStringLiteral("groups"));
     container.appendChild(grp);
@@ -1886,9 +1991,30 @@ QString TimelineFunctions::copyClips(const std::shared_ptr<TimelineItemModel> &t
     }
     qDebug() << "\n=======";
     grp.appendChild(copiedItems.createTextNode(timeline->m_groups->toJson(groupRoots)));
+    return copiedItems;
+}
+
+void TimelineFunctions::storeCopy(const std::shared_ptr<TimelineItemModel> &timeline, const QDomDocument &copiedItems)
+{
+    lastCopy.data.clear();
+    lastCopy.document = copiedItems;
+    lastCopy.timelineUuid = timeline->uuid();
+    lastCopy.sessionId = pCore->currentDoc()->sessionId();
+    lastCopy.generation = pCore->undoStack()->generation();
+}
 
-    qDebug() << " / // / PASTED DOC: \n\n" << copiedItems.toString() << "\n\n------------";
-    return copiedItems.toString();
+bool TimelineFunctions::canPasteDirectly(const std::shared_ptr<TimelineItemModel> &timeline, int inPos, int duration)
+{
+    // Partial pastes and pastes in another sequence or project go through the xml data
+    if (inPos != 0 || duration != -1 || lastCopy.timelineUuid != timeline->uuid()) {
+        return false;
+    }
+    // Uuids and undo generations are reused when the project is reopened or reverted, the copied ids only make sense in the same session
+    if (lastCopy.sessionId != pCore->currentDoc()->sessionId()) {
+        return false;
+    }
+    // Any change in the project since the copy could have modified the copied items
+    return lastCopy.generation == pCore->undoStack()->generation();
 }
 
 bool TimelineFunctions::pasteClips(const std::shared_ptr<TimelineItemModel> &timeline, const QString &pasteString, int trackId, int position)
@@ -1896,7 +2022,8 @@ bool TimelineFunctions::pasteClips(const std::shared_ptr<TimelineItemModel> &tim
     std::function<bool(void)> undo = []() { return true; };
     std::function<bool(void)> redo = []() { return true; };
     if (TimelineFunctions::pasteClips(timeline, pasteString, trackId, position, undo, redo)) {
-        pCore->pushUndo(undo, redo, i18n("Paste clips"));
+        // The pasted xml data is captured by the bin clip creation lambdas
+        pCore->pushUndo(undo, redo, i18n("Paste clips"), 2 * pasteString.size());
         return true;
     }
     return false;
@@ -1976,6 +2103,38 @@ bool TimelineFunctions::pasteClipsWithUndo(const std::shared_ptr<TimelineItemMod
 
 bool TimelineFunctions::pasteClips(const std::shared_ptr<TimelineItemModel> &timeline, const QString &pasteString, int trackId, int position, Fun &undo,
                                    Fun &redo, int inPos, int duration)
+{
+    QDomDocument copiedItems;
+    bool directPaste = !lastCopy.data.isEmpty() && pasteString.size() == lastCopy.data.size() && pasteString == lastCopy.data &&
+                       canPasteDirectly(timeline, inPos, duration);
+    if (directPaste) {
+        // Our own copy, reuse the parsed data. The document is modified while pasting, so work on a copy
+        copiedItems = lastCopy.document.cloneNode(true).toDocument();
+    } else {
+        copiedItems.setContent(pasteString);
+    }
+    return pasteCopiedItems(timeline, copiedItems, directPaste, trackId, position, undo, redo, inPos, duration);
+}
+
+bool TimelineFunctions::pasteClipboard(const std::shared_ptr<TimelineItemModel> &timeline, const QMimeData *mimeData, int trackId, int position)
+{
+    auto *copy = dynamic_cast<const TimelineCopyMimeData *>(mimeData);
+    if (copy == nullptr) {
+        return pasteClips(timeline, mimeData == nullptr ? QString() : mimeData->text(), trackId, position);
+    }
+    Fun undo = []() { return true; };
+    Fun redo = []() { return true; };
+    // The clipboard content is a copy made in this Kdenlive instance. The document is modified while pasting, so work on a copy
+    bool directPaste = copy->document() == lastCopy.document && canPasteDirectly(timeline, 0, -1);
+    if (pasteCopiedItems(timeline, copy->document().cloneNode(true).toDocument(), directPaste, trackId, position, undo, redo, 0, -1)) {
+        pCore->pushUndo(undo, redo, i18n("Paste clips"));
+        return true;
+    }
+    return false;
+}
+
+bool TimelineFunctions::pasteCopiedItems(const std::shared_ptr<TimelineItemModel> &timeline, QDomDocument copiedItems, bool directPaste, int trackId,
+                                         int position, Fun &undo, Fun &redo, int inPos, int duration)
 {
     timeline->requestClearSelection();
     if (!semaphore.tryAcquire(1)) {
@@ -1986,8 +2145,6 @@ bool TimelineFunctions::pasteClips(const std::shared_ptr<TimelineItemModel> &tim
     }
     waitingBinIds.clear();
     sequencesToInit.clear();
-    QDomDocument copiedItems;
-    copiedItems.setContent(pasteString);
     if (copiedItems.documentElement().tagName() == QLatin1String("kdenlive-scene")) {
         qDebug() << " / / READING CLIPS FROM CLIPBOARD";
     } else {
@@ -2192,6 +2349,8 @@ bool TimelineFunctions::pasteClips(const std::shared_ptr<TimelineItemModel> &tim
                 }
                 waitingBinIds << updatedId;
                 clipsImported = true;
+                // The timeline clips will use the new bin clip, they cannot be cloned from the source
+                directPaste = false;
                 pCore->projectItemModel()->requestAddBinClip(updatedId, currentProd, folderId, undo, redo, callBack);
             }
         }
@@ -2482,7 +2641,7 @@ bool TimelineFunctions::pasteClips(const std::shared_ptr<TimelineItemModel> &tim
 
     if (!clipsImported) {
         // Clips from same document, directly proceed to pasting
-        bool result = TimelineFunctions::pasteTimelineClips(timeline, copiedItems, position, undo, redo, false, inPos, duration);
+        bool result = TimelineFunctions::pasteTimelineClips(timeline, copiedItems, position, undo, redo, false, inPos, duration, directPaste);
         if (result && updatedPosition > 0) {
             pCore->seekMonitor(Kdenlive::ProjectMonitor, updatedPosition);
         }
@@ -2493,15 +2652,15 @@ bool TimelineFunctions::pasteClips(const std::shared_ptr<TimelineItemModel> &tim
 }
 
 bool TimelineFunctions::pasteTimelineClips(const std::shared_ptr<TimelineItemModel> &timeline, const QDomDocument &copiedItems, int position, int inPos,
-                                           int duration)
+                                           int duration, bool directPaste)
 {
     std::function<bool(void)> timeline_undo = []() { return true; };
     std::function<bool(void)> timeline_redo = []() { return true; };
-    return TimelineFunctions::pasteTimelineClips(timeline, copiedItems, position, timeline_undo, timeline_redo, true, inPos, duration);
+    return TimelineFunctions::pasteTimelineClips(timeline, copiedItems, position, timeline_undo, timeline_redo, true, inPos, duration, directPaste);
 }
 
 bool TimelineFunctions::pasteTimelineClips(const std::shared_ptr<TimelineItemModel> &timeline, QDomDocument copiedItems, int position, Fun &timeline_undo,
-                                           Fun &timeline_redo, bool pushToStack, int inPos, int duration)
+                                           Fun &timeline_redo, bool pushToStack, int inPos, int duration, bool directPaste)
 {
     // Wait until all bin clips are inserted
     QDomNodeList clips = copiedItems.documentElement().elementsByTagName(QStringLiteral("clip"));
@@ -2517,138 +2676,154 @@ bool TimelineFunctions::pasteTimelineClips(const std::shared_ptr<TimelineItemMod
     }
 
     QDomElement documentMixes = copiedItems.createElement(QStringLiteral("mixes"));
-    for (int i = 0; i < clips.count(); i++) {
-        QDomElement prod = clips.at(i).toElement();
-        QString originalId = prod.attribute(QStringLiteral("binid"));
-        if (mappedIds.contains(originalId)) {
-            // Map id
-            originalId = mappedIds.value(originalId);
-        }
-        if (!pCore->projectItemModel()->hasClip(originalId)) {
-            // Clip import was not successful, continue
-            pCore->displayMessage(i18n("All clips were not successfully copied"), ErrorMessage, 500);
-            continue;
-        }
-        int in = prod.attribute(QStringLiteral("in")).toInt();
-        int out = prod.attribute(QStringLiteral("out")).toInt();
-        int curTrackId = tracksMap.value(prod.attribute(QStringLiteral("track")).toInt());
-        if (!timeline->isTrack(curTrackId)) {
-            // Something is broken
-            pCore->displayMessage(i18n("Not enough tracks to paste clipboard"), ErrorMessage, 500);
-            timeline_undo();
-            semaphore.release(1);
-            return false;
-        }
-        int pos = prod.attribute(QStringLiteral("position")).toInt();
-        if (ratio != 1.0) {
-            in = in * ratio;
-            out = out * ratio;
-            pos = pos * ratio;
-        }
-        int newIn = in;
-        int newOut = out;
-        if ((inPos > 0 && pos + (out - in) < inPos + offset) || (duration > -1 && (pos > inPos + duration + offset))) {
-            // Clip outside paste range
-            continue;
-        }
-        if (inPos > 0) {
-            pos -= inPos;
-            if (pos < offset) {
-                newIn = in + (offset - pos);
-                pos = offset;
+    for (int i = 0; directPaste && i < clips.count(); i++) {
+        if (clips.at(i).toElement().hasAttribute(QStringLiteral("timemap"))) {
+            // Time remapped clips are rebuilt from their xml description
+            directPaste = false;
+        }
+    }
+    if (directPaste && !pasteClipsDirect(timeline, clips, position - offset, correspondingIds, documentMixes, timeline_undo, timeline_redo)) {
+        // pasteClipsDirect rolled back its changes, rebuild the clips from their xml description
+        correspondingIds.clear();
+        while (documentMixes.hasChildNodes()) {
+            documentMixes.removeChild(documentMixes.firstChild());
+        }
+        directPaste = false;
+    }
+    if (!directPaste) {
+        for (int i = 0; i < clips.count(); i++) {
+            QDomElement prod = clips.at(i).toElement();
+            QString originalId = prod.attribute(QStringLiteral("binid"));
+            if (mappedIds.contains(originalId)) {
+                // Map id
+                originalId = mappedIds.value(originalId);
+            }
+            if (!pCore->projectItemModel()->hasClip(originalId)) {
+                // Clip import was not successful, continue
+                pCore->displayMessage(i18n("All clips were not successfully copied"), ErrorMessage, 500);
+                continue;
             }
-        }
-        if (duration > -1) {
-            if (pos + (out - in) > inPos + duration + offset) {
-                newOut = out - (pos + (out - in) - (inPos + duration + offset));
+            int in = prod.attribute(QStringLiteral("in")).toInt();
+            int out = prod.attribute(QStringLiteral("out")).toInt();
+            int curTrackId = tracksMap.value(prod.attribute(QStringLiteral("track")).toInt());
+            if (!timeline->isTrack(curTrackId)) {
+                // Something is broken
+                pCore->displayMessage(i18n("Not enough tracks to paste clipboard"), ErrorMessage, 500);
+                timeline_undo();
+                semaphore.release(1);
+                return false;
+            }
+            int pos = prod.attribute(QStringLiteral("position")).toInt();
+            if (ratio != 1.0) {
+                in = in * ratio;
+                out = out * ratio;
+                pos = pos * ratio;
+            }
+            int newIn = in;
+            int newOut = out;
+            if ((inPos > 0 && pos + (out - in) < inPos + offset) || (duration > -1 && (pos > inPos + duration + offset))) {
+                // Clip outside paste range
+                continue;
+            }
+            if (inPos > 0) {
+                pos -= inPos;
+                if (pos < offset) {
+                    newIn = in + (offset - pos);
+                    pos = offset;
+                }
+            }
+            if (duration > -1) {
+                if (pos + (out - in) > inPos + duration + offset) {
+                    newOut = out - (pos + (out - in) - (inPos + duration + offset));
+                }
             }
-        }
 
-        pos -= offset;
-        double speed = prod.attribute(QStringLiteral("speed")).toDouble();
-        bool warp_pitch = false;
-        if (!qFuzzyCompare(speed, 1.)) {
-            warp_pitch = prod.attribute(QStringLiteral("warp_pitch")).toInt();
-        }
-        int audioStream = prod.attribute(QStringLiteral("audioStream")).toInt();
-        int newId;
-        bool created = timeline->requestClipCreation(originalId, newId, timeline->getTrackById_const(curTrackId)->trackType(), audioStream, speed, warp_pitch,
-                                                     timeline_undo, timeline_redo);
-        if (!created) {
-            // Something is broken
-            pCore->displayMessage(i18n("Could not paste items in timeline"), ErrorMessage, 500);
-            timeline_undo();
-            semaphore.release(1);
-            return false;
-        }
-        if (prod.hasAttribute(QStringLiteral("timemap"))) {
-            // This is a timeremap
-            timeline->m_allClips[newId]->useTimeRemapProducer(true, timeline_undo, timeline_redo);
-            if (timeline->m_allClips[newId]->m_producer->parent().type() == mlt_service_chain_type) {
-                Mlt::Chain fromChain(timeline->m_allClips[newId]->m_producer->parent());
-                int count = fromChain.link_count();
-                for (int i = 0; i < count; i++) {
-                    QScopedPointer<Mlt::Link> fromLink(fromChain.link(i));
-                    if (fromLink && fromLink->is_valid() && fromLink->get("mlt_service")) {
-                        if (fromLink->get("mlt_service") == QLatin1String("timeremap")) {
-                            // Found a timeremap effect, read params
-                            fromLink->set("time_map", prod.attribute(QStringLiteral("timemap")).toUtf8().constData());
-                            fromLink->set("pitch", prod.attribute(QStringLiteral("timepitch")).toInt());
-                            fromLink->set("image_mode", prod.attribute(QStringLiteral("timeblend")).toUtf8().constData());
-                            break;
+            pos -= offset;
+            double speed = prod.attribute(QStringLiteral("speed")).toDouble();
+            bool warp_pitch = false;
+            if (!qFuzzyCompare(speed, 1.)) {
+                warp_pitch = prod.attribute(QStringLiteral("warp_pitch")).toInt();
+            }
+            int audioStream = prod.attribute(QStringLiteral("audioStream")).toInt();
+            int newId;
+            bool created = timeline->requestClipCreation(originalId, newId, timeline->getTrackById_const(curTrackId)->trackType(), audioStream, speed, warp_pitch,
+                                                         timeline_undo, timeline_redo);
+            if (!created) {
+                // Something is broken
+                pCore->displayMessage(i18n("Could not paste items in timeline"), ErrorMessage, 500);
+                timeline_undo();
+                semaphore.release(1);
+                return false;
+            }
+            if (prod.hasAttribute(QStringLiteral("timemap"))) {
+                // This is a timeremap
+                timeline->m_allClips[newId]->useTimeRemapProducer(true, timeline_undo, timeline_redo);
+                if (timeline->m_allClips[newId]->m_producer->parent().type() == mlt_service_chain_type) {
+                    Mlt::Chain fromChain(timeline->m_allClips[newId]->m_producer->parent());
+                    int count = fromChain.link_count();
+                    for (int i = 0; i < count; i++) {
+                        QScopedPointer<Mlt::Link> fromLink(fromChain.link(i));
+                        if (fromLink && fromLink->is_valid() && fromLink->get("mlt_service")) {
+                            if (fromLink->get("mlt_service") == QLatin1String("timeremap")) {
+                                // Found a timeremap effect, read params
+                                fromLink->set("time_map", prod.attribute(QStringLiteral("timemap")).toUtf8().constData());
+                                fromLink->set("pitch", prod.attribute(QStringLiteral("timepitch")).toInt());
+                                fromLink->set("image_mode", prod.attribute(QStringLiteral("timeblend")).toUtf8().constData());
+                                break;
+                            }
                         }
                     }
                 }
             }
-        }
-        if (timeline->m_allClips[newId]->m_endlessResize) {
-            out = out - in;
-            in = 0;
-            timeline->m_allClips[newId]->m_producer->set("length", out + 1);
-            timeline->m_allClips[newId]->m_producer->set("out", out);
-        }
-        timeline->m_allClips[newId]->setInOut(in, out);
-        int targetId = prod.attribute(QStringLiteral("id")).toInt();
-        int targetPlaylist = prod.attribute(QStringLiteral("playlist")).toInt();
-        if (targetPlaylist > 0) {
-            timeline->m_allClips[newId]->setSubPlaylistIndex(targetPlaylist, curTrackId);
-        }
-        correspondingIds[targetId] = newId;
-        std::shared_ptr<EffectStackModel> destStack = timeline->getClipEffectStackModel(newId);
-        destStack->fromXml(prod.firstChildElement(QStringLiteral("effects")), timeline_undo, timeline_redo);
-        if (newIn != in) {
-            int newSize = out - newIn + 1;
-            res = res && timeline->requestItemResize(newId, newSize, false, true, timeline_undo, timeline_redo);
-            if (res) {
-                std::shared_ptr<EffectStackModel> sourceStack = timeline->getClipEffectStackModel(newId);
-                sourceStack->cleanFadeEffects(true, timeline_undo, timeline_redo);
-            }
-            // TODO manage mixes
-        }
-        if (newOut != out) {
-            int newSize = newOut - newIn;
-            res = res && timeline->requestItemResize(newId, newSize, true, true, timeline_undo, timeline_redo);
-            if (res) {
-                std::shared_ptr<EffectStackModel> sourceStack = timeline->getClipEffectStackModel(newId);
-                sourceStack->cleanFadeEffects(false, timeline_undo, timeline_redo);
+            if (timeline->m_allClips[newId]->m_endlessResize) {
+                out = out - in;
+                in = 0;
+                timeline->m_allClips[newId]->m_producer->set("length", out + 1);
+                timeline->m_allClips[newId]->m_producer->set("out", out);
+            }
+            timeline->m_allClips[newId]->setInOut(in, out);
+            int targetId = prod.attribute(QStringLiteral("id")).toInt();
+            int targetPlaylist = prod.attribute(QStringLiteral("playlist")).toInt();
+            if (targetPlaylist > 0) {
+                timeline->m_allClips[newId]->setSubPlaylistIndex(targetPlaylist, curTrackId);
+            }
+            correspondingIds[targetId] = newId;
+            std::shared_ptr<EffectStackModel> destStack = timeline->getClipEffectStackModel(newId);
+            destStack->fromXml(prod.firstChildElement(QStringLiteral("effects")), timeline_undo, timeline_redo);
+            if (newIn != in) {
+                int newSize = out - newIn + 1;
+                res = res && timeline->requestItemResize(newId, newSize, false, true, timeline_undo, timeline_redo);
+                if (res) {
+                    std::shared_ptr<EffectStackModel> sourceStack = timeline->getClipEffectStackModel(newId);
+                    sourceStack->cleanFadeEffects(true, timeline_undo, timeline_redo);
+                }
+                // TODO manage mixes
+            }
+            if (newOut != out) {
+                int newSize = newOut - newIn;
+                res = res && timeline->requestItemResize(newId, newSize, true, true, timeline_undo, timeline_redo);
+                if (res) {
+                    std::shared_ptr<EffectStackModel> sourceStack = timeline->getClipEffectStackModel(newId);
+                    sourceStack->cleanFadeEffects(false, timeline_undo, timeline_redo);
+                }
+                // TODO manage mixes
+            }
+            res = res && timeline->getTrackById(curTrackId)->requestClipInsertion(newId, position + pos, true, true, timeline_undo, timeline_redo);
+            // paste effects
+            if (!res) {
+                qDebug() << "=== COULD NOT PASTE CLIP: " << newId << " ON TRACK: " << curTrackId << " AT: " << position;
+                break;
             }
-            // TODO manage mixes
-        }
-        res = res && timeline->getTrackById(curTrackId)->requestClipInsertion(newId, position + pos, true, true, timeline_undo, timeline_redo);
-        // paste effects
-        if (!res) {
-            qDebug() << "=== COULD NOT PASTE CLIP: " << newId << " ON TRACK: " << curTrackId << " AT: " << position;
-            break;
-        }
-        // Mixes (same track transitions)
-        if (prod.hasChildNodes()) {
-            // TODO: adjust position/duration with inPos / duration
-            QDomNodeList mixes = prod.elementsByTagName(QLatin1String("mix"));
-            if (!mixes.isEmpty()) {
-                QDomElement mix = mixes.at(0).toElement();
-                if (mix.tagName() == QLatin1String("mix")) {
-                    mix.setAttribute(QStringLiteral("tid"), curTrackId);
-                    documentMixes.appendChild(mix);
+            // Mixes (same track transitions)
+            if (prod.hasChildNodes()) {
+                // TODO: adjust position/duration with inPos / duration
+                QDomNodeList mixes = prod.elementsByTagName(QLatin1String("mix"));
+                if (!mixes.isEmpty()) {
+                    QDomElement mix = mixes.at(0).toElement();
+                    if (mix.tagName() == QLatin1String("mix")) {
+                        mix.setAttribute(QStringLiteral("tid"), curTrackId);
+                        documentMixes.appendChild(mix);
+                    }
                 }
             }
         }
@@ -2783,6 +2958,89 @@ bool TimelineFunctions::pasteTimelineClips(const std::shared_ptr<TimelineItemMod
     return true;
 }
 
+bool TimelineFunctions::pasteClipsDirect(const std::shared_ptr<TimelineItemModel> &timeline, const QDomNodeList &clips, int offset,
+                                         std::unordered_map<int, int> &correspondingIds, QDomElement &documentMixes, Fun &undo, Fun &redo)
+{
+    struct PasteItem
+    {
+        int sourceId;
+        int trackId;
+        int position;
+        QDomElement xml;
+    };
+    std::vector<PasteItem> items;
+    items.reserve(size_t(clips.count()));
+    for (int i = 0; i < clips.count(); i++) {
+        QDomElement prod = clips.at(i).toElement();
+        int sourceId = prod.attribute(QStringLiteral("id")).toInt();
+        int trackId = tracksMap.value(prod.attribute(QStringLiteral("track")).toInt());
+        if (!timeline->isClip(sourceId) || !timeline->isTrack(trackId)) {
+            return false;
+        }
+        items.push_back({sourceId, trackId, prod.attribute(QStringLiteral("position")).toInt() + offset, prod});
+    }
+    // Insert track by track, from left to right so that the playlists are filled without splitting blanks
+    std::sort(items.begin(), items.end(), [](const PasteItem &a, const PasteItem &b) {
+        return a.trackId < b.trackId || (a.trackId == b.trackId && a.position < b.position);
+    });
+    // Keep a flat list of operations instead of nesting one lambda per pasted clip
+    std::vector<Fun> undos;
+    std::vector<Fun> redos;
+    undos.reserve(items.size());
+    redos.reserve(items.size());
+    auto rollback = [&undos]() {
+        for (auto it = undos.rbegin(); it != undos.rend(); ++it) {
+            (*it)();
+        }
+    };
+    for (const auto &item : items) {
+        Fun local_undo = []() { return true; };
+        Fun local_redo = []() { return true; };
+        int newId;
+        std::shared_ptr<TrackModel> track = timeline->getTrackById(item.trackId);
+        bool res = cloneClip(timeline, item.sourceId, newId, track->trackType(), -1, local_undo, local_redo);
+        if (res) {
+            int subPlaylist = timeline->m_allClips[item.sourceId]->getSubPlaylistIndex();
+            if (subPlaylist > 0) {
+                timeline->m_allClips[newId]->setSubPlaylistIndex(subPlaylist, item.trackId);
+            }
+            res = track->requestClipInsertion(newId, item.position, true, true, local_undo, local_redo);
+        }
+        undos.push_back(local_undo);
+        redos.push_back(local_redo);
+        if (!res) {
+            qDebug() << "=== COULD NOT PASTE CLIP: " << item.sourceId << " ON TRACK: " << item.trackId << " AT: " << item.position;
+            rollback();
+            return false;
+        }
+        correspondingIds[item.sourceId] = newId;
+        // Mixes (same track transitions)
+        QDomElement mix = item.xml.firstChildElement(QStringLiteral("mix"));
+        if (!mix.isNull()) {
+            // Keep the clip xml intact in case we have to fall back to the xml paste
+            QDomElement mixCopy = mix.cloneNode(true).toElement();
+            mixCopy.setAttribute(QStringLiteral("tid"), item.trackId);
+            documentMixes.appendChild(mixCopy);
+        }
+    }
+    Fun batch_undo = [undos]() {
+        bool result = true;
+        for (auto it = undos.rbegin(); it != undos.rend(); ++it) {
+            result = (*it)() && result;
+        }
+        return result;
+    };
+    Fun batch_redo = [redos]() {
+        bool result = true;
+        for (const auto &operation : redos) {
+            result = operation() && result;
+        }
+        return result;
+    };
+    UPDATE_UNDO_REDO_NOLOCK(batch_redo, batch_undo, undo, redo);
+    return true;
+}
+
 bool TimelineFunctions::requestDeleteBlankAt(const std::shared_ptr<TimelineItemModel> &timeline, int trackId, int position, bool affectAllTracks)
 {
     // Check we have blank at position
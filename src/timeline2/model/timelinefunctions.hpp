@@ -15,7 +15,10 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <unordered_map>
 
 #include <QDir>
+#include <QFuture>
 
+class ProjectClip;
+class QMimeData;
 class TimelineItemModel;
 
 /** @namespace TimelineFunction
@@ -40,11 +43,18 @@ struct TimelineFunctions
     static bool requestClipCut(std::shared_ptr<TimelineItemModel> timeline, int clipId, int position);
     /** @brief This is the same function, except that it accumulates undo/redo */
     static bool requestClipCut(const std::shared_ptr<TimelineItemModel> &timeline, int clipId, int position, Fun &undo, Fun &redo);
+    /** @brief Cuts several clips (clip id, position) in one batch, accumulating undo/redo.
+       All cuts are planned before the timeline is modified, the selection is cleared once and the monitor refresh stays blocked until the end.
+       Each split still goes through the clip model operations so that the undo lambdas and view notifications stay consistent.
+    */
+    static bool requestClipsCut(const std::shared_ptr<TimelineItemModel> &timeline, const QVector<QPair<int, int>> &cuts, Fun &undo, Fun &redo);
     /** @brief This is the same function, except that it accumulates undo/redo and do not deal with groups. Do not call directly */
     static bool processClipCut(const std::shared_ptr<TimelineItemModel> &timeline, int clipId, int position, int &newId, Fun &undo, Fun &redo);
 
     /** @brief Cuts all clips at given position */
     static bool requestClipCutAll(std::shared_ptr<TimelineItemModel> timeline, int position);
+    /** @brief Cuts all clips at each of the given positions, in one batch with a single undo entry */
+    static bool requestClipCutAll(const std::shared_ptr<TimelineItemModel> &timeline, const QVector<int> &positions);
 
     /** @brief Makes a perfect clone of a given clip, but do not insert it */
     static bool cloneClip(const std::shared_ptr<TimelineItemModel> &timeline, int clipId, int &newId, PlaylistState::ClipState state, int audioStream,
@@ -53,16 +63,40 @@ struct TimelineFunctions
     /** @brief Creates a string representation of the given clips, that can then be pasted using pasteClips(). Return an empty string on failure */
     static QString copyClips(const std::shared_ptr<TimelineItemModel> &timeline, const std::unordered_set<int> &itemIds, int mainClip = -1);
 
+    /** @brief Same as copyClips, for the clipboard. The string representation is only generated if another application or project requests it */
+    static QMimeData *copyClipsMimeData(const std::shared_ptr<TimelineItemModel> &timeline, const std::unordered_set<int> &itemIds, int mainClip = -1);
+
     /** @brief Paste the clips as described by the string. Returns true on success*/
     static bool pasteClips(const std::shared_ptr<TimelineItemModel> &timeline, const QString &pasteString, int trackId, int position);
     static bool pasteClips(const std::shared_ptr<TimelineItemModel> &timeline, const QString &pasteString, int trackId, int position, Fun &undo, Fun &redo,
                            int inPos = 0, int duration = -1);
+    /** @brief Paste the clipboard content. Our own last copy is pasted from memory, without generating and parsing its string representation */
+    static bool pasteClipboard(const std::shared_ptr<TimelineItemModel> &timeline, const QMimeData *mimeData, int trackId, int position);
     static bool pasteClipsWithUndo(const std::shared_ptr<TimelineItemModel> &timeline, const QString &pasteString, int trackId, int position, Fun &undo,
                                    Fun &redo);
+    /** @param directPaste if true, the clips are cloned from the copied timeline clips instead of being rebuilt from their xml description */
     static bool pasteTimelineClips(const std::shared_ptr<TimelineItemModel> &timeline, const QDomDocument &copiedItems, int position, int inPos = 0,
-                                   int duration = -1);
+                                   int duration = -1, bool directPaste = false);
     static bool pasteTimelineClips(const std::shared_ptr<TimelineItemModel> &timeline, QDomDocument copiedItems, int position, Fun &timeline_undo,
-                                   Fun &timeline_redo, bool pushToStack, int inPos = 0, int duration = -1);
+                                   Fun &timeline_redo, bool pushToStack, int inPos = 0, int duration = -1, bool directPaste = false);
+    /** @brief Build the description of the given clips, used by copyClips */
+    static QDomDocument buildCopy(const std::shared_ptr<TimelineItemModel> &timeline, const std::unordered_set<int> &itemIds, int mainClip);
+    /** @brief Store the copied items description so that a paste in the same timeline can clone them directly */
+    static void storeCopy(const std::shared_ptr<TimelineItemModel> &timeline, const QDomDocument &copiedItems);
+    /** @brief Returns true if the last copy was made in this timeline and the project did not change since */
+    static bool canPasteDirectly(const std::shared_ptr<TimelineItemModel> &timeline, int inPos, int duration);
+    /** @brief Paste a parsed copy description, shared by pasteClips and pasteClipboard
+       @param directPaste is true if copiedItems is our last copy and its clips can be cloned
+    */
+    static bool pasteCopiedItems(const std::shared_ptr<TimelineItemModel> &timeline, QDomDocument copiedItems, bool directPaste, int trackId, int position,
+                                 Fun &undo, Fun &redo, int inPos, int duration);
+    /** @brief Fast path for same timeline paste: clone the source clips instead of rebuilding them from xml, and insert them track by track
+       @param offset is added to the copied clips positions
+       @param correspondingIds is filled with the source id -> new id map
+       @param documentMixes receives the mixes that have to be created once all clips are inserted
+    */
+    static bool pasteClipsDirect(const std::shared_ptr<TimelineItemModel> &timeline, const QDomNodeList &clips, int offset,
+                                 std::unordered_map<int, int> &correspondingIds, QDomElement &documentMixes, Fun &undo, Fun &redo);
 
     /** @brief Request the addition of multiple clips to the timeline
      * If the addition of any of the clips fails, the entire operation is undone.
@@ -74,6 +108,15 @@ struct TimelineFunctions
      */
     static bool requestMultipleClipsInsertion(const std::shared_ptr<TimelineItemModel> &timeline, const QStringList &binIds, int trackId, int position,
                                               QList<int> &clipIds, bool logUndo, bool refreshView);
+    /** @brief Lists the bin clips that need new track producers to be inserted in a track, with the number of producers to create.
+     * @param trackId the track where the insertion will happen
+     * @param binIds the list of bin ids to be inserted
+     */
+    static QList<std::pair<std::shared_ptr<ProjectClip>, int>> missingTrackProducers(int trackId, const QStringList &binIds);
+    /** @brief Creates the listed track producers in worker threads, they are used by the next insertions of these clips.
+     * Canceling the returned future stops before the next clip, the producers that were prepared have to be discarded by the caller.
+     */
+    static QFuture<void> prepareTrackProducers(const std::shared_ptr<QList<std::pair<std::shared_ptr<ProjectClip>, int>>> &clips);
 
     /** @brief This function will find the blank located in the given track at the given position and remove it
         @returns true on success, false otherwise
@@ -24,6 +24,7 @@
 #include "transitions/transitionsrepository.hpp"
 #include <QDebug>
 #include <QFileInfo>
+#include <map>
 #include <mlt++/MltField.h>
 #include <mlt++/MltProfile.h>
 #include <mlt++/MltTractor.h>
@@ -55,6 +56,14 @@ RTTR_REGISTRATION
 TimelineItemModel::TimelineItemModel(const QUuid &uuid, std::weak_ptr<DocUndoStack> undo_stack)
     : TimelineModel(uuid, std::move(undo_stack))
 {
+    // Queued changes are sent at most once per displayed frame
+    m_pendingChangesTimer.setSingleShot(true);
+    m_pendingChangesTimer.setInterval(16);
+    connect(&m_pendingChangesTimer, &QTimer::timeout, this, &TimelineItemModel::flushPendingChanges);
+    // Don't wait for the next frame once an undo command is complete
+    if (auto stack = m_undoStack.lock()) {
+        connect(stack.get(), &QUndoStack::indexChanged, this, &TimelineItemModel::flushPendingChanges);
+    }
 }
 
 void TimelineItemModel::finishConstruct(const std::shared_ptr<TimelineItemModel> &ptr)
@@ -853,6 +862,81 @@ void TimelineItemModel::notifyChange(const QModelIndex &topleft, const QModelInd
     Q_EMIT dataChanged(topleft, bottomright, {role});
 }
 
+void TimelineItemModel::queueChange(int itemId, const QVector<int> &roles)
+{
+    QVector<int> &pending = m_pendingChanges[itemId];
+    for (int role : roles) {
+        auto it = std::lower_bound(pending.begin(), pending.end(), role);
+        if (it == pending.end() || *it != role) {
+            pending.insert(it, role);
+        }
+    }
+    if (!m_pendingChangesTimer.isActive()) {
+        m_pendingChangesTimer.start();
+    }
+}
+
+void TimelineItemModel::flushPendingChanges()
+{
+    m_pendingChangesTimer.stop();
+    if (m_pendingChanges.empty()) {
+        return;
+    }
+    std::unordered_map<int, QVector<int>> pending;
+    std::swap(pending, m_pendingChanges);
+    if (m_closing) {
+        return;
+    }
+    struct ChangedRange
+    {
+        QModelIndex first;
+        QModelIndex last;
+        QVector<int> roles;
+    };
+    std::vector<ChangedRange> ranges;
+    {
+        READ_LOCK();
+        // Resolve the rows now, items might have moved or been deleted since the change was queued
+        std::map<int, std::vector<std::pair<int, const QVector<int> *>>> rowsByTrack;
+        for (const auto &change : pending) {
+            int itemId = change.first;
+            int trackId = -1;
+            int row = -1;
+            if (isClip(itemId)) {
+                trackId = m_allClips.at(itemId)->getCurrentTrackId();
+                if (trackId != -1) {
+                    row = getTrackById_const(trackId)->getRowfromClip(itemId);
+                }
+            } else if (isComposition(itemId)) {
+                trackId = m_allCompositions.at(itemId)->getCurrentTrackId();
+                if (trackId != -1) {
+                    row = getTrackById_const(trackId)->getRowfromComposition(itemId);
+                }
+            }
+            if (row > -1) {
+                rowsByTrack[trackId].emplace_back(row, &change.second);
+            }
+        }
+        for (auto &track : rowsByTrack) {
+            auto &rows = track.second;
+            std::sort(rows.begin(), rows.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+            QModelIndex trackIndex = makeTrackIndexFromID(track.first);
+            // Merge contiguous rows sharing the same roles in a single notification
+            size_t start = 0;
+            for (size_t i = 1; i <= rows.size(); ++i) {
+                if (i < rows.size() && rows[i].first == rows[i - 1].first + 1 && *rows[i].second == *rows[start].second) {
+                    continue;
+                }
+                ranges.push_back({index(rows[start].first, 0, trackIndex), index(rows[i - 1].first, 0, trackIndex), *rows[start].second});
+                start = i;
+            }
+        }
+    }
+    for (const auto &range : ranges) {
+        Q_EMIT dataChanged(range.first, range.last, range.roles);
+    }
+}
+
 void TimelineItemModel::_beginRemoveRows(const QModelIndex &i, int j, int k)
 {
     beginRemoveRows(i, j, k);
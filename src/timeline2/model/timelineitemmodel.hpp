@@ -9,6 +9,8 @@
 #include "timelinemodel.hpp"
 #include "undohelper.hpp"
 
+#include <QTimer>
+
 class MarkerListModel;
 
 /** @class TimelineItemModel
@@ -85,6 +87,9 @@ public:
     void notifyChange(const QModelIndex &topleft, const QModelIndex &bottomright, bool start, bool duration, bool updateThumb) override;
     void notifyChange(const QModelIndex &topleft, const QModelIndex &bottomright, const QVector<int> &roles) override;
     void notifyChange(const QModelIndex &topleft, const QModelIndex &bottomright, int role) override;
+    void queueChange(int itemId, const QVector<int> &roles) override;
+    /** @brief Send the queued data changes now, as contiguous ranges of rows sharing the same roles */
+    void flushPendingChanges();
 
     /** @brief Import track effects */
     void importTrackEffects(int tid, std::weak_ptr<Mlt::Service> service);
@@ -123,6 +128,11 @@ protected:
     /** @brief This is an helper function that finishes a construction of a freshly created TimelineItemModel */
     static void finishConstruct(const std::shared_ptr<TimelineItemModel> &ptr);
 
+private:
+    /** @brief Queued data changes: item id and the sorted list of changed roles */
+    std::unordered_map<int, QVector<int>> m_pendingChanges;
+    QTimer m_pendingChangesTimer;
+
 Q_SIGNALS:
     /** @brief Triggered when a video track visibility changed */
     void trackVisibilityChanged();
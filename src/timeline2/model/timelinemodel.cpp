@@ -10,6 +10,7 @@
 #include "bin/model/subtitlemodel.hpp"
 #include "bin/projectclip.h"
 #include "bin/projectitemmodel.h"
+#include "bin/sequenceprerender.h"
 #include "clipmodel.hpp"
 #include "compositionmodel.hpp"
 #include "core.h"
@@ -1306,7 +1307,7 @@ bool TimelineModel::requestFakeClipMove(int clipId, int trackId, int position, b
     std::function<bool(void)> redo = []() { return true; };
     bool res = requestFakeClipMove(clipId, trackId, position, updateView, invalidateTimeline, undo, redo);
     if (res && logUndo) {
-        PUSH_UNDO(undo, redo, i18n("Move clip"));
+        PUSH_UNDO_MERGEABLE(undo, redo, i18n("Move clip"));
     }
     TRACE_RES(res);
     return res;
@@ -1342,7 +1343,7 @@ bool TimelineModel::requestClipMove(int clipId, int trackId, int position, bool
     bool res = requestClipMove(clipId, trackId, position, moveMirrorTracks, updateView, invalidateTimeline, logUndo, undo, redo, revertMove) ==
                TimelineModel::MoveSuccess;
     if (res && logUndo) {
-        PUSH_UNDO(undo, redo, i18n("Move clip"));
+        PUSH_UNDO_MERGEABLE(undo, redo, i18n("Move clip"));
     }
     TRACE_RES(res);
     return res;
@@ -1382,7 +1383,7 @@ bool TimelineModel::requestSubtitleMove(int clipId, int layer, int position, boo
     std::function<bool(void)> redo = []() { return true; };
     bool res = requestSubtitleMove(clipId, layer, position, updateView, logUndo, logUndo, finalMove, undo, redo);
     if (res && logUndo) {
-        PUSH_UNDO(undo, redo, i18n("Move subtitle"));
+        PUSH_UNDO_MERGEABLE(undo, redo, i18n("Move subtitle"));
     }
     return res;
 }
@@ -2447,7 +2448,7 @@ bool TimelineModel::requestFakeGroupMove(int clipId, int groupId, int delta_trac
     std::function<bool(void)> redo = []() { return true; };
     bool res = requestFakeGroupMove(clipId, groupId, delta_track, delta_pos, updateView, logUndo, undo, redo);
     if (res && logUndo) {
-        PUSH_UNDO(undo, redo, i18n("Move group"));
+        PUSH_UNDO_MERGEABLE(undo, redo, i18n("Move group"));
     }
     TRACE_RES(res);
     return res;
@@ -2748,7 +2749,7 @@ bool TimelineModel::requestGroupMove(int itemId, int groupId, int delta_track, i
         res = requestGroupMove(itemId, groupId, delta_track, delta_pos, updateView, logUndo, undo, redo, revertMove, moveMirrorTracks);
     }
     if (res && logUndo) {
-        PUSH_UNDO(undo, redo, i18n("Move group"));
+        PUSH_UNDO_MERGEABLE(undo, redo, i18n("Move group"));
     }
     TRACE_RES(res);
     return res;
@@ -4025,11 +4026,11 @@ int TimelineModel::requestItemResize(int itemId, int size, bool right, bool logU
         if (isClip(itemId)) {
             adjust_mix();
             PUSH_LAMBDA(adjust_mix, redo);
-            PUSH_UNDO(undo, redo, i18n("Resize clip"))
+            PUSH_UNDO_MERGEABLE(undo, redo, i18n("Resize clip"))
         } else if (isComposition(itemId)) {
-            PUSH_UNDO(undo, redo, i18n("Resize composition"))
+            PUSH_UNDO_MERGEABLE(undo, redo, i18n("Resize composition"))
         } else if (isSubTitle(itemId)) {
-            PUSH_UNDO(undo, redo, i18n("Resize subtitle"))
+            PUSH_UNDO_MERGEABLE(undo, redo, i18n("Resize subtitle"))
         }
     }
     int res = result ? size : -1;
@@ -4974,8 +4975,7 @@ void TimelineModel::registerTrack(std::shared_ptr<TrackModel> track, int pos, bo
     Q_ASSERT(m_iteratorTable.count(id) == 0); // check that id is not used (shouldn't happen)
     m_iteratorTable[id] = it;
     endInsertRows();
-    int cache = int(QThread::idealThreadCount()) + int(m_allTracks.size() + 1) * 2;
-    mlt_service_cache_set_size(nullptr, "producer_avformat", qMax(4, cache));
+    ProducerPool::setDecoderLimitForTracks(int(m_allTracks.size()));
 }
 
 void TimelineModel::registerClip(const std::shared_ptr<ClipModel> &clip, bool registerProducer)
@@ -5015,8 +5015,7 @@ Fun TimelineModel::deregisterTrack_lambda(int id)
         if (!m_closing) {
             // Finish operation
             endRemoveRows();
-            int cache = int(QThread::idealThreadCount()) + int(m_allTracks.size() + 1) * 2;
-            mlt_service_cache_set_size(nullptr, "producer_avformat", qMax(4, cache));
+            ProducerPool::setDecoderLimitForTracks(int(m_allTracks.size()));
         }
         return true;
     };
@@ -5756,7 +5755,7 @@ bool TimelineModel::requestCompositionMove(int compoId, int trackId, int positio
     }
 
     if (res && logUndo) {
-        PUSH_UNDO(undo, redo, i18n("Move composition"));
+        PUSH_UNDO_MERGEABLE(undo, redo, i18n("Move composition"));
         checkRefresh(min, max);
     }
     return res;
@@ -6060,7 +6059,7 @@ bool TimelineModel::checkConsistency(const std::vector<int> &guideSnaps)
     // First step: all clips referenced by the bin model exist and are inserted
     for (const auto &binClip : binClips) {
         auto projClip = pCore->projectItemModel()->getClipByBinID(binClip);
-        const QList<int> referenced = projClip->m_registeredClipsByUuid.value(uuid());
+        const QList<int> referenced = projClip->m_registeredClipsByUuid.instances(uuid());
         for (const int &cid : referenced) {
             if (!isClip(cid)) {
                 qWarning() << "Bin model registers a bad clip ID" << cid;
@@ -6077,7 +6076,7 @@ bool TimelineModel::checkConsistency(const std::vector<int> &guideSnaps)
     for (const auto &clip : m_allClips) {
         auto binId = clip.second->m_binClipId;
         auto projClip = pCore->projectItemModel()->getClipByBinID(binId);
-        if (!projClip->m_registeredClipsByUuid.contains(uuid()) || !projClip->m_registeredClipsByUuid.value(uuid()).contains(clip.first)) {
+        if (!projClip->m_registeredClipsByUuid.contains(uuid(), clip.first)) {
             qWarning() << "Clip " << clip.first << "not registered in bin";
             return false;
         }
@@ -6215,7 +6214,13 @@ const QString TimelineModel::sceneList(const QString &root, const QString &fullP
     if (filter) {
         s.detach(*filter.get());
     }
-    playlist = fullPath.isEmpty() ? QString::fromUtf8(xmlConsumer.get("kdenlive_playlist")) : fullPath;
+    // Pre-rendered nested sequences are only used for playback
+    if (fullPath.isEmpty()) {
+        playlist = SequencePreRender::restoreSequences(QString::fromUtf8(xmlConsumer.get("kdenlive_playlist")));
+    } else {
+        SequencePreRender::restoreSequencesInFile(fullPath);
+        playlist = fullPath;
+    }
     return playlist;
 }
 
@@ -6421,7 +6426,6 @@ void TimelineModel::replugClip(int clipId)
 
 void TimelineModel::requestClipUpdate(int clipId, const QVector<int> &roles)
 {
-    QModelIndex modelIndex = makeClipIndexFromID(clipId);
     if (roles.contains(TimelineModel::ReloadAudioThumbRole)) {
         m_allClips[clipId]->forceThumbReload = !m_allClips[clipId]->forceThumbReload;
     }
@@ -6429,7 +6433,8 @@ void TimelineModel::requestClipUpdate(int clipId, const QVector<int> &roles)
         int in = getClipPosition(clipId);
         Q_EMIT invalidateZone(in, in + getClipPlaytime(clipId));
     }
-    notifyChange(modelIndex, modelIndex, roles);
+    // A bin clip change can update thousands of instances, let the QML reevaluate them in a few merged notifications
+    queueChange(clipId, roles);
 }
 
 bool TimelineModel::requestClipTimeWarp(int clipId, double speed, bool pitchCompensate, bool changeDuration, Fun &undo, Fun &redo)
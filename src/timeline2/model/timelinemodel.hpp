@@ -1135,6 +1135,8 @@ protected:
     virtual void notifyChange(const QModelIndex &topleft, const QModelIndex &bottomright, bool start, bool duration, bool updateThumb) = 0;
     virtual void notifyChange(const QModelIndex &topleft, const QModelIndex &bottomright, const QVector<int> &roles) = 0;
     virtual void notifyChange(const QModelIndex &topleft, const QModelIndex &bottomright, int role) = 0;
+    /** @brief Queue a data change for an item, merged with other queued changes and notified once per frame */
+    virtual void queueChange(int itemId, const QVector<int> &roles) = 0;
     virtual QModelIndex makeClipIndexFromID(int) const = 0;
     virtual QModelIndex makeCompositionIndexFromID(int) const = 0;
     virtual QModelIndex makeTrackIndexFromID(int) const = 0;
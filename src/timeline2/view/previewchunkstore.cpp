@@ -0,0 +1,171 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "previewchunkstore.h"
+#include "core.h"
+
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <mlt++/MltProducer.h>
+
+const QString PreviewChunkStore::IndexName = QStringLiteral("chunks.json");
+// Increase when the index format changes, older indexes are then discarded
+static constexpr int IndexVersion = 1;
+
+void PreviewChunkStore::setDirectory(const QDir &dir, const QString &extension)
+{
+    if (dir == m_dir && extension == m_extension) {
+        return;
+    }
+    save();
+    m_chunks.clear();
+    m_modified = false;
+    m_dir = dir;
+    m_extension = extension;
+    load();
+}
+
+QString PreviewChunkStore::chunkName(int frame) const
+{
+    return QStringLiteral("%1.%2").arg(frame).arg(m_extension);
+}
+
+bool PreviewChunkStore::fileInfo(int frame, Entry &entry) const
+{
+    const QFileInfo info(m_dir.absoluteFilePath(chunkName(frame)));
+    if (!info.isFile()) {
+        return false;
+    }
+    entry.size = info.size();
+    entry.modified = info.lastModified().toMSecsSinceEpoch();
+    return true;
+}
+
+bool PreviewChunkStore::isValid(int frame)
+{
+    Entry current;
+    if (!fileInfo(frame, current) || current.size == 0) {
+        remove(frame);
+        return false;
+    }
+    auto it = m_chunks.find(frame);
+    if (it == m_chunks.end()) {
+        m_chunks.insert(frame, current);
+        m_modified = true;
+        return true;
+    }
+    if (it->size != current.size || it->modified != current.modified) {
+        // The file was replaced or truncated since it was indexed
+        remove(frame);
+        return false;
+    }
+    return true;
+}
+
+void PreviewChunkStore::add(int frame, const Mlt::Producer &producer)
+{
+    Entry entry;
+    if (!fileInfo(frame, entry)) {
+        remove(frame);
+        return;
+    }
+    entry.producer = std::make_shared<Mlt::Producer>(producer);
+    m_chunks.insert(frame, entry);
+    m_modified = true;
+}
+
+std::shared_ptr<Mlt::Producer> PreviewChunkStore::producer(int frame)
+{
+    if (!isValid(frame)) {
+        return nullptr;
+    }
+    Entry &entry = m_chunks[frame];
+    if (entry.producer) {
+        return entry.producer;
+    }
+    auto prod = std::make_shared<Mlt::Producer>(pCore->getProjectProfile(),
+                                                QStringLiteral("avformat:%1").arg(m_dir.absoluteFilePath(chunkName(frame))).toUtf8().constData());
+    if (!prod->is_valid()) {
+        remove(frame);
+        return nullptr;
+    }
+    prod->set("mlt_service", "avformat-novalidate");
+    entry.producer = prod;
+    return prod;
+}
+
+void PreviewChunkStore::remove(int frame)
+{
+    if (m_chunks.remove(frame) > 0) {
+        m_modified = true;
+    }
+}
+
+int PreviewChunkStore::count() const
+{
+    return m_chunks.count();
+}
+
+void PreviewChunkStore::clear()
+{
+    m_chunks.clear();
+    m_modified = true;
+}
+
+void PreviewChunkStore::load()
+{
+    QFile file(m_dir.absoluteFilePath(IndexName));
+    if (m_extension.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QJsonObject index = QJsonDocument::fromJson(file.readAll()).object();
+    if (index.value(QLatin1String("version")).toInt() != IndexVersion || index.value(QLatin1String("extension")).toString() != m_extension) {
+        // Outdated index, existing chunks will be indexed again on validation
+        m_modified = true;
+        return;
+    }
+    const QJsonArray chunks = index.value(QLatin1String("chunks")).toArray();
+    for (const auto &value : chunks) {
+        const QJsonObject chunk = value.toObject();
+        Entry entry;
+        entry.size = chunk.value(QLatin1String("size")).toInteger();
+        entry.modified = chunk.value(QLatin1String("modified")).toInteger();
+        m_chunks.insert(chunk.value(QLatin1String("frame")).toInt(), entry);
+    }
+}
+
+bool PreviewChunkStore::save()
+{
+    if (!m_modified || m_extension.isEmpty() || !m_dir.exists()) {
+        return false;
+    }
+    if (m_chunks.isEmpty()) {
+        // Don't leave an index in an otherwise empty folder, so that it can be cleaned up
+        m_modified = false;
+        return m_dir.remove(IndexName);
+    }
+    QJsonArray chunks;
+    for (auto it = m_chunks.constBegin(); it != m_chunks.constEnd(); ++it) {
+        QJsonObject chunk;
+        chunk.insert(QLatin1String("frame"), it.key());
+        chunk.insert(QLatin1String("size"), it->size);
+        chunk.insert(QLatin1String("modified"), it->modified);
+        chunks.append(chunk);
+    }
+    QJsonObject index;
+    index.insert(QLatin1String("version"), IndexVersion);
+    index.insert(QLatin1String("extension"), m_extension);
+    index.insert(QLatin1String("chunks"), chunks);
+    QSaveFile file(m_dir.absoluteFilePath(IndexName));
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(index).toJson(QJsonDocument::Compact)) < 0 || !file.commit()) {
+        qWarning() << "Cannot write timeline preview index" << file.fileName();
+        return false;
+    }
+    m_modified = false;
+    return true;
+}
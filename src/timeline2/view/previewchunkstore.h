@@ -0,0 +1,64 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QDir>
+#include <QMap>
+#include <QString>
+#include <memory>
+
+namespace Mlt {
+class Producer;
+}
+
+/** @class PreviewChunkStore
+    @brief Index of the rendered timeline preview chunks of a cache folder.
+    The size and modification time of each rendered chunk are stored in an index file next to the chunks, so that
+    the chunks of a project can be validated on load without opening every file. The producers of the chunks are
+    kept in a pool, so that rebuilding the preview track (for example when it is disabled and enabled again) does
+    not reopen the files. The number of open decoders is bounded by the MLT decoder cache.
+ */
+class PreviewChunkStore
+{
+public:
+    /** @brief Name of the index file in the cache folder */
+    static const QString IndexName;
+
+    /** @brief Set the cache folder and extension of the chunks, and read the index of the folder. The previous index is saved */
+    void setDirectory(const QDir &dir, const QString &extension);
+    /** @brief Returns the file name of a chunk, relative to the cache folder */
+    QString chunkName(int frame) const;
+    /** @brief Returns true if the chunk file matches its index entry. Existing chunks that are not indexed yet, for example
+     *  in a project created by an older version, are added to the index.
+     */
+    bool isValid(int frame);
+    /** @brief Register a chunk that was just rendered and checked */
+    void add(int frame, const Mlt::Producer &producer);
+    /** @brief Returns the pooled producer of a valid chunk, opening it if needed. Returns nullptr if the chunk is invalid */
+    std::shared_ptr<Mlt::Producer> producer(int frame);
+    /** @brief The chunk file was moved or deleted */
+    void remove(int frame);
+    /** @brief Number of indexed chunks */
+    int count() const;
+    /** @brief Write the index file if it changed */
+    bool save();
+    void clear();
+
+private:
+    struct Entry
+    {
+        qint64 size{0};
+        qint64 modified{0};
+        std::shared_ptr<Mlt::Producer> producer;
+    };
+    QDir m_dir;
+    QString m_extension;
+    QMap<int, Entry> m_chunks;
+    bool m_modified{false};
+    /** @brief Read the size and modification time of a chunk file, returns false if it does not exist */
+    bool fileInfo(int frame, Entry &entry) const;
+    void load();
+};
@@ -58,6 +58,7 @@ PreviewManager::~PreviewManager()
 {
     if (m_initialized) {
         abortRendering();
+        m_chunkStore.save();
         if (m_undoDir.dirName() == QLatin1String("undo")) {
             m_undoDir.removeRecursively();
         }
@@ -114,6 +115,7 @@ bool PreviewManager::initialize()
         pCore->displayMessage(i18n("Something is wrong with cache folders"), ErrorMessage);
         return false;
     }
+    m_chunkStore.setDirectory(m_cacheDir, m_extension);
 
     connect(this, &PreviewManager::cleanupOldPreviews, this, &PreviewManager::doCleanupOldPreviews);
     connect(doc, &KdenliveDoc::removeInvalidUndo, this, &PreviewManager::slotRemoveInvalidUndo, Qt::DirectConnection);
@@ -150,18 +152,26 @@ void PreviewManager::loadChunks(QVariantList previewChunks, QVariantList dirtyCh
         dirtyChunks = m_dirtyChunks;
     }
 
-    QStringList existingChuncks;
-    if (!previewChunks.isEmpty()) {
-        existingChuncks = m_cacheDir.entryList(QDir::Files);
-    }
-
     int max = playlist.count();
     std::shared_ptr<Mlt::Producer> clip;
     m_tractor->lock();
     if (max == 0) {
-        // Empty timeline preview, mark all as dirty
+        // Empty timeline preview, reuse the pooled producers of the chunks that are still valid
         for (auto &prev : previewChunks) {
-            dirtyChunks << prev;
+            int position = prev.toInt();
+            if (!m_previewTrack->is_blank_at(position)) {
+                continue;
+            }
+            clip = m_chunkStore.producer(position);
+            if (clip) {
+                if (!m_renderedChunks.contains(position)) {
+                    m_renderedChunks << position;
+                }
+                m_previewTrack->insert_at(position, clip.get(), 1);
+            } else {
+                m_renderedChunks.removeAll(prev);
+                dirtyChunks << prev;
+            }
         }
     }
     for (int i = 0; i < max; i++) {
@@ -170,10 +180,12 @@ void PreviewManager::loadChunks(QVariantList previewChunks, QVariantList dirtyCh
         }
         int position = playlist.clip_start(i);
         if (previewChunks.contains(QString::number(position))) {
-            if (existingChuncks.contains(QStringLiteral("%1.%2").arg(position).arg(m_extension))) {
+            // Only compare the chunk file with its index entry instead of opening it
+            if (m_chunkStore.isValid(position)) {
                 clip.reset(playlist.get_clip(i));
                 m_renderedChunks << position;
                 m_previewTrack->insert_at(position, clip.get(), 1);
+                m_chunkStore.add(position, clip->parent());
             } else {
                 dirtyChunks << position;
             }
@@ -181,6 +193,7 @@ void PreviewManager::loadChunks(QVariantList previewChunks, QVariantList dirtyCh
     }
     m_previewTrack->consolidate_blanks();
     m_tractor->unlock();
+    m_chunkStore.save();
     if (!dirtyChunks.isEmpty()) {
         std::sort(dirtyChunks.begin(), dirtyChunks.end(), chunkSort);
         QMutexLocker lock(&m_dirtyMutex);
@@ -283,36 +296,47 @@ void PreviewManager::enable()
 }
 
 bool PreviewManager::loadParams()
+{
+    if (!renderParameters(m_extension, m_consumerParams)) {
+        return false;
+    }
+    if (m_initialized) {
+        m_chunkStore.setDirectory(m_cacheDir, m_extension);
+    }
+    return true;
+}
+
+bool PreviewManager::renderParameters(QString &extension, QStringList &consumerParams)
 {
     KdenliveDoc *doc = pCore->currentDoc();
-    m_extension = doc->getDocumentProperty(QStringLiteral("previewextension"));
-    m_consumerParams = doc->getDocumentProperty(QStringLiteral("previewparameters")).split(QLatin1Char(' '), Qt::SkipEmptyParts);
+    extension = doc->getDocumentProperty(QStringLiteral("previewextension"));
+    consumerParams = doc->getDocumentProperty(QStringLiteral("previewparameters")).split(QLatin1Char(' '), Qt::SkipEmptyParts);
 
-    if (m_consumerParams.isEmpty() || m_extension.isEmpty()) {
+    if (consumerParams.isEmpty() || extension.isEmpty()) {
         doc->selectPreviewProfile();
-        m_consumerParams = doc->getDocumentProperty(QStringLiteral("previewparameters")).split(QLatin1Char(' '), Qt::SkipEmptyParts);
-        m_extension = doc->getDocumentProperty(QStringLiteral("previewextension"));
+        consumerParams = doc->getDocumentProperty(QStringLiteral("previewparameters")).split(QLatin1Char(' '), Qt::SkipEmptyParts);
+        extension = doc->getDocumentProperty(QStringLiteral("previewextension"));
     }
-    if (m_consumerParams.isEmpty() || m_extension.isEmpty()) {
+    if (consumerParams.isEmpty() || extension.isEmpty()) {
         return false;
     }
     // Remove the r= and s= parameter (forcing framerate / frame size) as it causes rendering failure.
     // These parameters should be provided by MLT's profile
     // NOTE: this is still required for DNxHD so leave it
-    /*for (int i = 0; i < m_consumerParams.count(); i++) {
-        if (m_consumerParams.at(i).startsWith(QStringLiteral("r=")) || m_consumerParams.at(i).startsWith(QStringLiteral("s="))) {
-            m_consumerParams.removeAt(i);
+    /*for (int i = 0; i < consumerParams.count(); i++) {
+        if (consumerParams.at(i).startsWith(QStringLiteral("r=")) || consumerParams.at(i).startsWith(QStringLiteral("s="))) {
+            consumerParams.removeAt(i);
             i--;
         }
     }*/
     if (doc->getDocumentProperty(QStringLiteral("resizepreview")).toInt() != 0) {
         int resizeWidth = doc->getDocumentProperty(QStringLiteral("previewheight")).toInt();
-        m_consumerParams << QStringLiteral("s=%1x%2").arg(int(resizeWidth * pCore->getCurrentDar())).arg(resizeWidth);
+        consumerParams << QStringLiteral("s=%1x%2").arg(int(resizeWidth * pCore->getCurrentDar())).arg(resizeWidth);
     }
-    m_consumerParams << QStringLiteral("an=1");
-    m_consumerParams << QStringLiteral("audio_off=1");
+    consumerParams << QStringLiteral("an=1");
+    consumerParams << QStringLiteral("audio_off=1");
     if (KdenliveSettings::gpu_accel()) {
-        m_consumerParams << QStringLiteral("glsl.=1");
+        consumerParams << QStringLiteral("glsl.=1");
     }
     return true;
 }
@@ -336,6 +360,7 @@ void PreviewManager::invalidatePreviews()
         for (const auto &i : m_dirtyChunks) {
             QString current = QStringLiteral("%1.%2").arg(i.toInt()).arg(m_extension);
             if (m_cacheDir.rename(current, QStringLiteral("undo/%1/%2").arg(ix).arg(current))) {
+                m_chunkStore.remove(i.toInt());
                 foundPreviews = true;
             }
         }
@@ -365,6 +390,7 @@ void PreviewManager::invalidatePreviews()
                 for (const auto &i : m_dirtyChunks) {
                     QString current = QStringLiteral("%1.%2").arg(i.toInt()).arg(m_extension);
                     if (m_cacheDir.rename(current, QStringLiteral("undo/%1/%2").arg(stackMax).arg(current))) {
+                        m_chunkStore.remove(i.toInt());
                         foundPreviews = true;
                     }
                 }
@@ -383,6 +409,7 @@ void PreviewManager::invalidatePreviews()
             QString cacheFileName = QStringLiteral("%1.%2").arg(i.toInt()).arg(m_extension);
             if (!lastUndo) {
                 m_cacheDir.remove(cacheFileName);
+                m_chunkStore.remove(i.toInt());
             }
             if (moveFile) {
                 if (QFile::copy(tmpDir.absoluteFilePath(cacheFileName), m_cacheDir.absoluteFilePath(cacheFileName))) {
@@ -412,6 +439,7 @@ void PreviewManager::invalidatePreviews()
             reloadChunks(foundChunks);
         }
     }
+    m_chunkStore.save();
     doc->setModified(true);
     if (timer) {
         m_previewTimer.start();
@@ -694,11 +722,13 @@ void PreviewManager::processEnded(int exitCode, QProcess::ExitStatus status)
             if (m_cacheDir.exists(fileName)) {
                 m_cacheDir.remove(fileName);
             }
+            m_chunkStore.remove(workingPreview);
         }
     } else {
         // Normal exit and exit code 0: everything okay
         pCore->currentDoc()->previewProgress(1000);
     }
+    m_chunkStore.save();
     workingPreview = -1;
     m_warnOnCrash = true;
     Q_EMIT workingPreviewChanged();
@@ -812,13 +842,10 @@ void PreviewManager::reloadChunks(const QVariantList &chunks)
     m_tractor->lock();
     for (const auto &ix : chunks) {
         if (m_previewTrack->is_blank_at(ix.toInt())) {
-            QString fileName = m_cacheDir.absoluteFilePath(QStringLiteral("%1.%2").arg(ix.toInt()).arg(m_extension));
-            fileName.prepend(QStringLiteral("avformat:"));
-            Mlt::Producer prod(pCore->getProjectProfile(), fileName.toUtf8().constData());
-            if (prod.is_valid()) {
-                // m_ruler->updatePreview(ix, true);
-                prod.set("mlt_service", "avformat-novalidate");
-                m_previewTrack->insert_at(ix.toInt(), &prod, 1);
+            // The chunk file was restored from the undo folder, it is indexed again when opened
+            std::shared_ptr<Mlt::Producer> prod = m_chunkStore.producer(ix.toInt());
+            if (prod) {
+                m_previewTrack->insert_at(ix.toInt(), prod.get(), 1);
             }
         }
     }
@@ -857,6 +884,7 @@ void PreviewManager::gotPreviewRender(int frame, const QString &file, int progre
             m_renderedChunks << frame;
             Q_EMIT renderedChunksChanged();
             prod.set("mlt_service", "avformat-novalidate");
+            m_chunkStore.add(frame, prod);
             m_tractor->lock();
             m_previewTrack->insert_at(frame, &prod, 1);
             m_previewTrack->consolidate_blanks();
@@ -882,6 +910,7 @@ void PreviewManager::corruptedChunk(int frame, const QString &fileName)
     }
     Q_EMIT previewRender(0, m_errorLog, -1);
     m_cacheDir.remove(fileName);
+    m_chunkStore.remove(frame);
     if (!m_dirtyChunks.contains(frame)) {
         QMutexLocker lock(&m_dirtyMutex);
         m_dirtyChunks << frame;
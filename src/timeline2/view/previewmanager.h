@@ -7,6 +7,7 @@
 #pragma once
 
 #include "definitions.h"
+#include "previewchunkstore.h"
 
 #include <QDir>
 #include <QFuture>
@@ -53,6 +54,8 @@ public:
     void abortRendering();
     /** @brief: rendering parameters have changed, reload them. */
     bool loadParams();
+    /** @brief: Read the preview file extension and encoding parameters of the current document, return false if they are invalid. */
+    static bool renderParameters(QString &extension, QStringList &consumerParams);
     /** @brief: Create the preview track if not existing. */
     bool buildPreviewTrack();
     /** @brief: Delete the preview track. */
@@ -93,6 +96,8 @@ private:
     QDir m_cacheDir;
     /** @brief: The directory used to store undo history of preview files (child of m_cacheDir). */
     QDir m_undoDir;
+    /** @brief: Index and pooled producers of the rendered chunks. */
+    PreviewChunkStore m_chunkStore;
     QMutex m_previewMutex;
     QStringList m_consumerParams;
     QString m_extension;
@@ -79,11 +79,17 @@ Rectangle
             event.accepted = true
         }
         if ((event.key === Qt.Key_Plus) && !(event.modifiers & Qt.ControlModifier)) {
+            if (!event.isAutoRepeat) {
+                kfrModel.setMergeUpdates(true)
+            }
             var newVal = Math.min(keyframes.itemAt(activeIndex).value / parent.height + .05, 1)
             kfrModel.updateKeyframe(kfrModel.activeKeyframe(), newVal)
             event.accepted = true
         }
         else if ((event.key === Qt.Key_Minus) && !(event.modifiers & Qt.ControlModifier)) {
+            if (!event.isAutoRepeat) {
+                kfrModel.setMergeUpdates(true)
+            }
             var newVal = Math.max(keyframes.itemAt(activeIndex).value / parent.height - .05, 0)
             kfrModel.updateKeyframe(kfrModel.activeKeyframe(), newVal)
             event.accepted = true
@@ -91,6 +97,12 @@ Rectangle
             event.accepted = false
         }
     }
+    Keys.onReleased: event => {
+        if ((event.key === Qt.Key_Plus || event.key === Qt.Key_Minus) && !event.isAutoRepeat) {
+            // Updates done while the key was held are a single undo entry
+            kfrModel.setMergeUpdates(false)
+        }
+    }
     Item {
         // Keyframes container
         anchors.fill: parent
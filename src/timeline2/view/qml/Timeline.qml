@@ -829,7 +829,7 @@ function getTrackColor(audio, header) {
                     }
                 } else {
                     if (controller.normalEdit()) {
-                        timeline.insertClips(track, frame, binIds, true, true)
+                        timeline.insertClipsAsync(track, frame, binIds)
                     } else {
                         // TODO
                         console.log('multiple clips insert/overwrite not supported yet')
@@ -19,6 +19,7 @@
 #include "dialogs/managesubtitles.h"
 #include "dialogs/speechdialog.h"
 #include "dialogs/timeremap.h"
+#include "doc/docundostack.hpp"
 #include "doc/kdenlivedoc.h"
 #include "effects/effectsrepository.hpp"
 #include "effects/effectstack/model/effectstackmodel.hpp"
@@ -51,12 +52,17 @@
 #include <KUrlRequesterDialog>
 #include <QClipboard>
 #include <QFontDatabase>
+#include <QFutureWatcher>
 #include <QJsonArray>
+#include <QProgressDialog>
 #include <QQuickItem>
 #include <QtMath>
 
 #include <memory>
 
+// Below this number of clips, preparing the track producers in parallel is not worth it
+static constexpr int AsyncInsertionThreshold = 10;
+
 TimelineController::TimelineController(QObject *parent)
     : QObject(parent)
     , multicamIn(-1)
@@ -531,11 +537,60 @@ QList<int> TimelineController::insertClips(int tid, int position, const QStringL
     if (position == -1) {
         position = pCore->getMonitorPosition();
     }
+    std::shared_ptr<QList<std::pair<std::shared_ptr<ProjectClip>, int>>> clips;
+    if (!logUndo && binIds.size() >= AsyncInsertionThreshold) {
+        // Drag preview of many clips, create the producers in parallel before the insertion. The drop then reuses them
+        clips = std::make_shared<QList<std::pair<std::shared_ptr<ProjectClip>, int>>>(TimelineFunctions::missingTrackProducers(tid, binIds));
+        TimelineFunctions::prepareTrackProducers(clips).waitForFinished();
+    }
     TimelineFunctions::requestMultipleClipsInsertion(m_model, binIds, tid, position, clipIds, logUndo, refreshView);
+    if (clips) {
+        for (const auto &clip : std::as_const(*clips)) {
+            clip.first->discardPreparedProducers();
+        }
+    }
     // we don't need to check the return value of the above function, in case of failure it will return an empty list of ids.
     return clipIds;
 }
 
+void TimelineController::insertClipsAsync(int tid, int position, const QStringList &binIds)
+{
+    if (tid == -1) {
+        tid = m_activeTrack;
+    }
+    if (position == -1) {
+        position = pCore->getMonitorPosition();
+    }
+    // The producers created by the drag preview are reused, only prepare the missing ones
+    auto clips = std::make_shared<QList<std::pair<std::shared_ptr<ProjectClip>, int>>>(TimelineFunctions::missingTrackProducers(tid, binIds));
+    if (binIds.size() < AsyncInsertionThreshold || clips->isEmpty() || pCore->window() == nullptr) {
+        insertClips(tid, position, binIds, true, true);
+        return;
+    }
+    auto *dialog = new QProgressDialog(i18np("Preparing %1 clip…", "Preparing %1 clips…", binIds.size()), i18n("Cancel"), 0, clips->size(), pCore->window());
+    dialog->setWindowTitle(i18nc("@title:window", "Inserting Clips"));
+    dialog->setWindowModality(Qt::WindowModal);
+    dialog->setMinimumDuration(500);
+    auto *watcher = new QFutureWatcher<void>(this);
+    connect(watcher, &QFutureWatcher<void>::progressValueChanged, dialog, &QProgressDialog::setValue);
+    connect(dialog, &QProgressDialog::canceled, watcher, &QFutureWatcher<void>::cancel);
+    connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, dialog, clips, tid, position, binIds, uuid = m_model->uuid()]() {
+        const bool canceled = watcher->isCanceled();
+        dialog->deleteLater();
+        watcher->deleteLater();
+        if (!canceled && m_model->uuid() == uuid && m_model->isTrack(tid)) {
+            // All clips are inserted in one operation, using the prepared producers
+            if (insertClips(tid, position, binIds, true, true).isEmpty()) {
+                pCore->displayMessage(i18n("Cannot insert clips"), ErrorMessage, 500);
+            }
+        }
+        for (const auto &clip : std::as_const(*clips)) {
+            clip.first->discardPreparedProducers();
+        }
+    });
+    watcher->setFuture(TimelineFunctions::prepareTrackProducers(clips));
+}
+
 void TimelineController::insertNewMix(int tid, int position, const QString &transitionId)
 {
     int clipId = m_model->getTrackById_const(tid)->getClipByPosition(position);
@@ -854,9 +909,8 @@ int TimelineController::copyItem()
         return -1;
     }
     int clipId = *(selectedIds.begin());
-    const QString copyString = TimelineFunctions::copyClips(m_model, selectedIds, getMainSelectedClip());
     QClipboard *clipboard = QApplication::clipboard();
-    clipboard->setText(copyString);
+    clipboard->setMimeData(TimelineFunctions::copyClipsMimeData(m_model, selectedIds, getMainSelectedClip()));
     m_root->setProperty("copiedClip", clipId);
     return clipId;
 }
@@ -881,14 +935,13 @@ std::pair<int, QString> TimelineController::getCopyItemData()
 bool TimelineController::pasteItem(int position, int tid)
 {
     QClipboard *clipboard = QApplication::clipboard();
-    QString txt = clipboard->text();
     if (tid == -1) {
         tid = m_activeTrack;
     }
     if (position == -1) {
         position = getMenuOrTimelinePos();
     }
-    return TimelineFunctions::pasteClips(m_model, txt, tid, position);
+    return TimelineFunctions::pasteClipboard(m_model, clipboard->mimeData(), tid, position);
 }
 
 void TimelineController::triggerAction(const QString &name)
@@ -1940,6 +1993,17 @@ void TimelineController::cutAllClipsUnderCursor(int position)
     TimelineFunctions::requestClipCutAll(m_model, position);
 }
 
+void TimelineController::cutAllClipsAtGuides()
+{
+    const std::vector<int> guides = m_model->getGuideModel()->getSnapPoints();
+    if (guides.empty()) {
+        pCore->displayMessage(i18n("No guides found"), ErrorMessage, 500);
+        return;
+    }
+    QMutexLocker lk(&m_metaMutex);
+    TimelineFunctions::requestClipCutAll(m_model, QVector<int>(guides.cbegin(), guides.cend()));
+}
+
 int TimelineController::requestSpacerStartOperation(int trackId, int position)
 {
     QMutexLocker lk(&m_metaMutex);
@@ -4127,6 +4191,12 @@ void TimelineController::grabCurrent()
             m_model->getSubtitleModel()->switchGrab(mainId);
         }
     }
+    // Keyboard moves of the grabbed items are merged in one undo entry
+    if (grabIsActive()) {
+        pCore->undoStack()->beginMergeSession();
+    } else {
+        pCore->undoStack()->endMergeSession();
+    }
 }
 
 bool TimelineController::grabIsActive() const
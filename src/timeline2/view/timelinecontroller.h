@@ -235,6 +235,7 @@ public:
      */
     Q_INVOKABLE int insertClip(int tid, int position, const QString &xml, bool logUndo, bool refreshView, bool useTargets);
     /** @brief Request inserting multiple clips into the timeline (dragged from bin or monitor)
+     * When many clips are inserted without undo, as for the drag preview, their missing track producers are first created in parallel.
      * @param tid is the destination track
      * @param position is the timeline position
      * @param binIds the IDs of the bins being dropped
@@ -242,6 +243,14 @@ public:
      * @return the ids of the inserted clips
      */
     Q_INVOKABLE QList<int> insertClips(int tid, int position, const QStringList &binIds, bool logUndo, bool refreshView);
+    /** @brief Insert multiple clips dropped from the bin, with a single undo entry.
+     * The track producers created by the drag preview are reused. For large drops, the missing ones are first prepared
+     * in worker threads with a cancelable progress dialog and the clips are inserted once they are all ready.
+     * @param tid is the destination track
+     * @param position is the timeline position
+     * @param binIds the IDs of the bins being dropped
+     */
+    Q_INVOKABLE void insertClipsAsync(int tid, int position, const QStringList &binIds);
     Q_INVOKABLE int copyItem();
     void cutItem();
     std::pair<int, QString> getCopyItemData();
@@ -416,6 +425,9 @@ public:
     /** @brief Cuts all clips at timeline position
      */
     Q_INVOKABLE void cutAllClipsUnderCursor(int position = -1);
+    /** @brief Cuts all clips at every guide position, with a single undo entry
+     */
+    Q_INVOKABLE void cutAllClipsAtGuides();
     /** @brief Request a spacer operation
      */
     Q_INVOKABLE int requestSpacerStartOperation(int trackId, int position);
@@ -47,13 +47,8 @@ Mlt::Properties *TransitionsRepository::getMetadata(const QString &assetId) cons
     return pCore->getMltRepository()->metadata(mlt_service_transition_type, assetId.toLatin1().data());
 }
 
-void TransitionsRepository::parseCustomAssetFile(const QString &file_name, std::unordered_map<QString, Info> &customAssets) const
+void TransitionsRepository::parseCustomAssetFile(const QString &file_name, QDomDocument &doc, std::unordered_map<QString, Info> &customAssets) const
 {
-    QDomDocument doc;
-    if (!Xml::docContentFromFile(doc, file_name, false)) {
-        return;
-    }
-
     QDomElement base = doc.documentElement();
     QDomNodeList transitions = doc.elementsByTagName(QStringLiteral("transition"));
 
@@ -156,6 +151,11 @@ QString TransitionsRepository::assetPreferredListPath() const
     return QLatin1String("");
 }
 
+QString TransitionsRepository::assetCacheName() const
+{
+    return QStringLiteral("transitions");
+}
+
 std::unique_ptr<Mlt::Transition> TransitionsRepository::getTransition(const QString &transitionId) const
 {
     qDebug() << "===== QUERYING TRANSITION: " << transitionId;
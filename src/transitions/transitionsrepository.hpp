@@ -46,7 +46,7 @@ protected:
     /** @brief Retrieves additional info about effects from a custom XML file
        The resulting assets are stored in customAssets
      */
-    void parseCustomAssetFile(const QString &file_name, std::unordered_map<QString, Info> &customAssets) const override;
+    void parseCustomAssetFile(const QString &file_name, QDomDocument &doc, std::unordered_map<QString, Info> &customAssets) const override;
 
     /** @brief Returns the paths where the custom transitions' descriptions are stored */
     QStringList assetDirs() const override;
@@ -60,6 +60,8 @@ protected:
     /** @brief Returns the path to the effects' preferred list*/
     QString assetPreferredListPath() const override;
 
+    QString assetCacheName() const override;
+
     void parseType(Mlt::Properties *metadata, Info &res) override;
 
     /** @brief Returns the metadata associated with the given asset*/
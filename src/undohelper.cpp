@@ -10,13 +10,22 @@
 #include <QDebug>
 #include <QTime>
 #include <utility>
+
+// Unique id used by QUndoStack to try merging consecutive functional commands
+static const int functionalCommandId = 0x4b46;
+// Rough cost of the lambda chains built through PUSH_LAMBDA / UPDATE_UNDO_REDO, which allocate on the heap and cannot be inspected
+static const qint64 baseLambdaCost = 512;
+
 FunctionalUndoCommand::FunctionalUndoCommand(Fun undo, Fun redo, const QString &text, QUndoCommand *parent)
     : QUndoCommand(parent)
     , m_undo(std::move(undo))
     , m_redo(std::move(redo))
     , m_undone(false)
+    , m_released(false)
+    , m_mergeKey(-1)
 {
     setText(QStringLiteral("%1 %2").arg(QTime::currentTime().toString("hh:mm")).arg(text));
+    m_memoryCost = qint64(sizeof(FunctionalUndoCommand)) + baseLambdaCost + 2 * this->text().size();
 }
 
 void FunctionalUndoCommand::undo()
@@ -25,6 +34,10 @@ void FunctionalUndoCommand::undo()
     Logger::log_undo(true);
 #endif
     m_undone = true;
+    if (m_released) {
+        QUndoCommand::undo();
+        return;
+    }
     bool res = m_undo();
     Q_ASSERT(res);
     QUndoCommand::undo();
@@ -32,7 +45,7 @@ void FunctionalUndoCommand::undo()
 
 void FunctionalUndoCommand::redo()
 {
-    if (m_undone) {
+    if (m_undone && !m_released) {
 #ifdef CRASH_AUTO_TEST
         Logger::log_undo(false);
 #endif
@@ -41,3 +54,86 @@ void FunctionalUndoCommand::redo()
     }
     QUndoCommand::redo();
 }
+
+int FunctionalUndoCommand::id() const
+{
+    return m_mergeKey < 0 || m_released ? -1 : functionalCommandId;
+}
+
+bool FunctionalUndoCommand::mergeWith(const QUndoCommand *other)
+{
+    auto *command = dynamic_cast<const FunctionalUndoCommand *>(other);
+    if (command == nullptr || command->m_mergeKey != m_mergeKey || command->childCount() > 0 || childCount() > 0) {
+        return false;
+    }
+    // Compare the operation names without the time prefix
+    if (command->text().section(QLatin1Char(' '), 1) != text().section(QLatin1Char(' '), 1)) {
+        return false;
+    }
+    Fun undo = m_undo;
+    Fun redo = m_redo;
+    Fun otherUndo = command->m_undo;
+    Fun otherRedo = command->m_redo;
+    m_undo = [undo, otherUndo]() {
+        bool v = otherUndo();
+        return undo() && v;
+    };
+    m_redo = [redo, otherRedo]() {
+        bool v = redo();
+        return otherRedo() && v;
+    };
+    // The merged command keeps both lambdas alive, but only one command object
+    m_memoryCost += command->m_memoryCost - qint64(sizeof(FunctionalUndoCommand));
+    return true;
+}
+
+void FunctionalUndoCommand::addMemoryCost(qint64 bytes)
+{
+    m_memoryCost += bytes;
+}
+
+qint64 FunctionalUndoCommand::memoryCost() const
+{
+    qint64 cost = m_memoryCost;
+    for (int i = 0; i < childCount(); ++i) {
+        cost += estimateCost(child(i));
+    }
+    return cost;
+}
+
+void FunctionalUndoCommand::setMergeKey(int key)
+{
+    m_mergeKey = key;
+}
+
+void FunctionalUndoCommand::releaseMemory()
+{
+    if (m_released) {
+        return;
+    }
+    m_released = true;
+    m_undo = []() { return true; };
+    m_redo = []() { return true; };
+    m_memoryCost = qint64(sizeof(FunctionalUndoCommand)) + 2 * text().size();
+}
+
+bool FunctionalUndoCommand::isReleased() const
+{
+    return m_released;
+}
+
+qint64 FunctionalUndoCommand::estimateCost(const QUndoCommand *command)
+{
+    if (command == nullptr) {
+        return 0;
+    }
+    if (auto *functional = dynamic_cast<const FunctionalUndoCommand *>(command)) {
+        return functional->memoryCost();
+    }
+    // Macro or generic command, count its children
+    qint64 cost = qint64(sizeof(QUndoCommand)) + 2 * command->text().size();
+    for (int i = 0; i < command->childCount(); ++i) {
+        cost += estimateCost(command->child(i));
+    }
+    return cost;
+}
@@ -38,8 +38,25 @@ public:
     FunctionalUndoCommand(Fun undo, Fun redo, const QString &text, QUndoCommand *parent = nullptr);
     void undo() override;
     void redo() override;
+    int id() const override;
+    /** @brief Merge a consecutive command operating on the same item (same merge key and text) into this one */
+    bool mergeWith(const QUndoCommand *other) override;
+    /** @brief Add an estimation of the data captured by the lambdas (xml strings, copied lists, ...) to the memory cost of this command */
+    void addMemoryCost(qint64 bytes);
+    /** @brief Returns the estimated memory used by this command and its children, in bytes */
+    qint64 memoryCost() const;
+    /** @brief Consecutive commands with the same positive key and text can be merged together on push */
+    void setMergeKey(int key);
+    /** @brief Drop the stored lambdas to free memory. The command becomes a no-op and cannot be undone anymore */
+    void releaseMemory();
+    bool isReleased() const;
+    /** @brief Returns the estimated memory used by a command, including its children */
+    static qint64 estimateCost(const QUndoCommand *command);
 
 private:
     Fun m_undo, m_redo;
     bool m_undone;
+    bool m_released;
+    int m_mergeKey;
+    qint64 m_memoryCost;
 };
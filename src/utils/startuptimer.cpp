@@ -0,0 +1,79 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "startuptimer.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+
+bool StartupTimer::m_enabled = false;
+QElapsedTimer StartupTimer::m_timer;
+QVector<StartupTimer::Mark> StartupTimer::m_marks;
+QHash<QString, qint64> StartupTimer::m_categoryStarts;
+QMutex StartupTimer::m_mutex;
+
+void StartupTimer::setEnabled(bool enabled)
+{
+    QMutexLocker lock(&m_mutex);
+    m_enabled = enabled;
+    m_marks.clear();
+    m_categoryStarts.clear();
+    if (enabled) {
+        m_timer.start();
+    }
+}
+
+bool StartupTimer::isEnabled()
+{
+    QMutexLocker lock(&m_mutex);
+    return m_enabled;
+}
+
+void StartupTimer::start(const QString &category)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_enabled) {
+        return;
+    }
+    m_categoryStarts.insert(category, m_timer.elapsed());
+}
+
+void StartupTimer::mark(const QString &category, const QString &stage)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_enabled) {
+        return;
+    }
+    qint64 elapsed = m_timer.elapsed();
+    // The first stage of a category is measured from the category start
+    qint64 previous = m_categoryStarts.value(category, 0);
+    for (auto it = m_marks.crbegin(); it != m_marks.crend(); ++it) {
+        if (it->category == category) {
+            // The category might have been started again after this mark
+            previous = qMax(previous, it->elapsed);
+            break;
+        }
+    }
+    m_marks.append({category, stage, elapsed, elapsed - previous});
+}
+
+void StartupTimer::report()
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_enabled) {
+        return;
+    }
+    m_enabled = false;
+    qInfo().noquote() << QStringLiteral("Startup timing breakdown (ms):");
+    for (const auto &m : std::as_const(m_marks)) {
+        qInfo().noquote() << QStringLiteral("  %1 %2 %3: %4")
+                                 .arg(m.elapsed, 6)
+                                 .arg(m.duration, 6)
+                                 .arg(m.category.isEmpty() ? m.stage : QStringLiteral("%1 / %2").arg(m.category, m.stage));
+    }
+    qInfo().noquote() << QStringLiteral("Startup finished after %1 ms").arg(m_timer.elapsed());
+    m_marks.clear();
+    m_categoryStarts.clear();
+}
@@ -0,0 +1,50 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+/** @class StartupTimer
+    @brief Collects the duration of the different application startup stages.
+    Timing is disabled by default and enabled with the --startup-timing command line option,
+    in which case the breakdown is printed once the main window is shown.
+ */
+class StartupTimer
+{
+public:
+    /** @brief Enable timing and start the reference clock */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+    /** @brief Record the start of a category, its first stage duration is computed from this point */
+    static void start(const QString &category);
+    /** @brief Record the end of a startup stage, the stage duration is computed from the previous mark in the same category,
+       or from the category start
+       @param category is used to group stages, for example the name of an asset repository
+       @param stage is the name of the stage that just finished
+    */
+    static void mark(const QString &category, const QString &stage);
+    /** @brief Print the timing breakdown and disable further recording */
+    static void report();
+
+private:
+    struct Mark
+    {
+        QString category;
+        QString stage;
+        qint64 elapsed;
+        qint64 duration;
+    };
+    static bool m_enabled;
+    static QElapsedTimer m_timer;
+    static QVector<Mark> m_marks;
+    /** @brief Elapsed time when each category started */
+    static QHash<QString, qint64> m_categoryStarts;
+    static QMutex m_mutex;
+};
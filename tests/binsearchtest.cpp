@@ -0,0 +1,136 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+#include "test_utils.hpp"
+// test specific headers
+#include "bin/binsearchindex.h"
+
+/** @brief Index clipsCount clips with generated names, descriptions and markers, returning the indexed text of each clip */
+static QStringList fillIndex(BinSearchIndex &index, int clipsCount)
+{
+    QStringList texts;
+    texts.reserve(clipsCount);
+    for (int i = 0; i < clipsCount; ++i) {
+        const QString binId = QString::number(i);
+        const QString name = QStringLiteral("Camera %1 clip %2.mov").arg(i % 4).arg(i);
+        const QString description =
+            QStringLiteral("A long description of the shot number %1, recorded on day %2 with a lot of details about the scene").arg(i).arg(i % 30);
+        const QString markers = QStringLiteral("Marker %1 take %2 good").arg(i % 100).arg(i % 7);
+        index.setText(binId, BinSearchIndex::Name, name);
+        index.setText(binId, BinSearchIndex::Description, description);
+        index.setText(binId, BinSearchIndex::Markers, markers);
+        texts << QStringList({name, description, markers}).join(QLatin1Char(' '));
+    }
+    return texts;
+}
+
+TEST_CASE("Bin search index", "[BinSearch]")
+{
+    BinSearchIndex index;
+
+    SECTION("Text is split in lowercase words")
+    {
+        REQUIRE(BinSearchIndex::tokenize(QStringLiteral("Interview_Take-02.MP4")) == QStringList({"interview", "take", "02", "mp4"}));
+        REQUIRE(BinSearchIndex::tokenize(QStringLiteral("  été,  Été ")) == QStringList({"été"}));
+        REQUIRE(BinSearchIndex::tokenize(QString()).isEmpty());
+    }
+
+    SECTION("Prefix search on all fields")
+    {
+        index.setText(QStringLiteral("2"), BinSearchIndex::Name, QStringLiteral("Interview take 1.mp4"));
+        index.setText(QStringLiteral("2"), BinSearchIndex::Description, QStringLiteral("Outdoor shot"));
+        index.setText(QStringLiteral("3"), BinSearchIndex::Name, QStringLiteral("Interview take 2.mp4"));
+        index.setText(QStringLiteral("3"), BinSearchIndex::Markers, QStringLiteral("Good laugh"));
+        index.setText(QStringLiteral("4"), BinSearchIndex::Name, QStringLiteral("Music.flac"));
+        index.setText(QStringLiteral("4"), BinSearchIndex::Tags, QStringLiteral("#ff0000:Final"));
+        REQUIRE(index.count() == 3);
+
+        REQUIRE(index.search(QStringLiteral("inter")) == QSet<QString>({"2", "3"}));
+        REQUIRE(index.search(QStringLiteral("INTERVIEW outdoor")) == QSet<QString>({"2"}));
+        REQUIRE(index.search(QStringLiteral("laugh")) == QSet<QString>({"3"}));
+        REQUIRE(index.search(QStringLiteral("final")) == QSet<QString>({"4"}));
+        REQUIRE(index.search(QStringLiteral("take 2")) == QSet<QString>({"3"}));
+        REQUIRE(index.search(QStringLiteral("missing")).isEmpty());
+        REQUIRE(index.search(QStringLiteral("interview missing")).isEmpty());
+
+        SECTION("Updating a field only replaces its words")
+        {
+            const int revision = index.revision();
+            index.setText(QStringLiteral("2"), BinSearchIndex::Description, QStringLiteral("Studio shot"));
+            REQUIRE(index.revision() != revision);
+            REQUIRE(index.search(QStringLiteral("outdoor")).isEmpty());
+            REQUIRE(index.search(QStringLiteral("studio")) == QSet<QString>({"2"}));
+            REQUIRE(index.search(QStringLiteral("interview")) == QSet<QString>({"2", "3"}));
+
+            // A word present in two fields is kept until removed from both
+            index.setText(QStringLiteral("3"), BinSearchIndex::Markers, QStringLiteral("Interview end"));
+            index.setText(QStringLiteral("3"), BinSearchIndex::Name, QStringLiteral("Take 2.mp4"));
+            REQUIRE(index.search(QStringLiteral("interview")) == QSet<QString>({"2", "3"}));
+            index.setText(QStringLiteral("3"), BinSearchIndex::Markers, QString());
+            REQUIRE(index.search(QStringLiteral("interview")) == QSet<QString>({"2"}));
+
+            // Setting the same text does not change the revision
+            const int current = index.revision();
+            index.setText(QStringLiteral("3"), BinSearchIndex::Name, QStringLiteral("take 2.MP4"));
+            REQUIRE(index.revision() == current);
+        }
+
+        SECTION("Removed items are not found anymore")
+        {
+            index.removeItem(QStringLiteral("2"));
+            REQUIRE(index.count() == 2);
+            REQUIRE(index.search(QStringLiteral("inter")) == QSet<QString>({"3"}));
+            REQUIRE(index.search(QStringLiteral("outdoor")).isEmpty());
+            index.clear();
+            REQUIRE(index.count() == 0);
+            REQUIRE(index.search(QStringLiteral("music")).isEmpty());
+        }
+    }
+
+    SECTION("Searching 10k clips matches a linear scan")
+    {
+        const int clipsCount = 10000;
+        const QStringList texts = fillIndex(index, clipsCount);
+        // Simulate typing a query letter by letter
+        const QString query = QStringLiteral("camera 2 take 3");
+        QSet<QString> results;
+        for (int i = 1; i <= query.size(); ++i) {
+            results = index.search(query.left(i));
+        }
+
+        // Compare with a linear scan
+        QSet<QString> expected;
+        const QStringList words = BinSearchIndex::tokenize(query);
+        for (int i = 0; i < clipsCount; ++i) {
+            const QStringList tokens = BinSearchIndex::tokenize(texts.at(i));
+            bool match = true;
+            for (const QString &word : words) {
+                match = match && std::any_of(tokens.cbegin(), tokens.cend(), [&word](const QString &token) { return token.startsWith(word); });
+            }
+            if (match) {
+                expected.insert(QString::number(i));
+            }
+        }
+        REQUIRE_FALSE(expected.isEmpty());
+        REQUIRE(results == expected);
+    }
+}
+
+TEST_CASE("Bin search index benchmark", "[BinSearch][.benchmark]")
+{
+    BinSearchIndex index;
+    const int clipsCount = 10000;
+    BenchmarkTimer timer;
+    timer.measure(QStringLiteral("Indexed %1 clips").arg(clipsCount), [&]() { fillIndex(index, clipsCount); });
+    const QString query = QStringLiteral("camera 2 take 3");
+    QSet<QString> results;
+    timer.measure(QStringLiteral("searched %1 prefixes").arg(query.size()), [&]() {
+        for (int i = 1; i <= query.size(); ++i) {
+            results = index.search(query.left(i));
+        }
+    });
+    timer.report();
+    REQUIRE_FALSE(results.isEmpty());
+}
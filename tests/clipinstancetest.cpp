@@ -0,0 +1,129 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+#include "test_utils.hpp"
+// test specific headers
+#include "bin/clipinstanceindex.h"
+#include "doc/kdenlivedoc.h"
+
+TEST_CASE("Clip instance index", "[ClipInstance]")
+{
+    ClipInstanceIndex index;
+    const QUuid first = QUuid::createUuid();
+    const QUuid second = QUuid::createUuid();
+
+    SECTION("Counts are kept in sync")
+    {
+        REQUIRE(index.isEmpty());
+        REQUIRE(index.insert(first, 3));
+        REQUIRE(index.insert(first, 1));
+        REQUIRE(index.insert(second, 2));
+        REQUIRE_FALSE(index.insert(first, 3));
+        REQUIRE(index.count(first) == 2);
+        REQUIRE(index.count(second) == 1);
+        REQUIRE(index.totalCount() == 3);
+        REQUIRE(index.instances(first) == QList<int>({1, 3}));
+        REQUIRE(index.contains(first, 3));
+        REQUIRE_FALSE(index.contains(second, 3));
+
+        REQUIRE(index.remove(first, 3));
+        REQUIRE_FALSE(index.remove(first, 3));
+        REQUIRE(index.totalCount() == 2);
+        REQUIRE(index.remove(second, 2));
+        REQUIRE_FALSE(index.contains(second));
+        REQUIRE(index.timelines() == QList<QUuid>({first}));
+
+        REQUIRE(index.insert(second, 4));
+        REQUIRE(index.removeTimeline(first) == 1);
+        REQUIRE(index.totalCount() == 1);
+        index.clear();
+        REQUIRE(index.isEmpty());
+        REQUIRE(index.totalCount() == 0);
+    }
+
+    SECTION("Bounds are sorted and merged")
+    {
+        QVector<QPoint> bounds = {{50, 10}, {0, 10}, {5, 10}, {0, 10}, {15, 5}, {40, 10}, {80, 0}};
+        const QVector<QPoint> merged = ClipInstanceIndex::mergeBounds(bounds);
+        REQUIRE(merged == QVector<QPoint>({{0, 20}, {40, 20}, {80, 0}}));
+        REQUIRE(ClipInstanceIndex::mergeBounds({}).isEmpty());
+    }
+
+    SECTION("Registering 10k instances")
+    {
+        const int instancesCount = 10000;
+        for (int i = 0; i < instancesCount; ++i) {
+            REQUIRE(index.insert(i % 2 == 0 ? first : second, i));
+        }
+        REQUIRE(index.totalCount() == instancesCount);
+        REQUIRE(index.count(first) == instancesCount / 2);
+        QVector<QPoint> bounds;
+        bounds.reserve(instancesCount);
+        for (int cid : index.instances(first)) {
+            bounds << QPoint((cid * 7) % 5000, 25);
+        }
+        const QVector<QPoint> merged = ClipInstanceIndex::mergeBounds(bounds);
+        REQUIRE(merged.size() == 1);
+        REQUIRE(merged.first() == QPoint(0, 4998 + 25));
+        for (int i = 0; i < instancesCount; ++i) {
+            REQUIRE(index.remove(i % 2 == 0 ? first : second, i));
+        }
+        REQUIRE(index.isEmpty());
+    }
+}
+
+TEST_CASE("Clip instance index benchmark", "[ClipInstance][.benchmark]")
+{
+    ClipInstanceIndex index;
+    const QUuid first = QUuid::createUuid();
+    const QUuid second = QUuid::createUuid();
+    const int instancesCount = 100000;
+    BenchmarkTimer timer;
+    timer.measure(QStringLiteral("Registered %1 instances").arg(instancesCount), [&]() {
+        for (int i = 0; i < instancesCount; ++i) {
+            index.insert(i % 2 == 0 ? first : second, i);
+        }
+    });
+    timer.measure(QStringLiteral("removed them"), [&]() {
+        for (int i = 0; i < instancesCount; ++i) {
+            index.remove(i % 2 == 0 ? first : second, i);
+        }
+    });
+    REQUIRE(index.isEmpty());
+
+    // Refresh the monitor bounds of a bin clip used many times in the timeline, all the instance ranges overlap and are merged
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    KdenliveDoc document(undoStack);
+    pCore->projectManager()->testSetDocument(&document);
+    QDateTime documentDate = QDateTime::currentDateTime();
+    KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->testSetActiveTimeline(timeline);
+
+    const QString binId = KdenliveTests::createProducer(pCore->getProjectProfile(), "red", binModel);
+    std::shared_ptr<ProjectClip> clip = binModel->getClipByBinID(binId);
+    int tid = timeline->getTrackIndexFromPosition(timeline->getTracksCount() - 1);
+    const int clipsCount = 2000;
+    const int length = 20;
+    for (int i = 0; i < clipsCount; ++i) {
+        int cid = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+        REQUIRE(timeline->requestClipMove(cid, tid, i * length));
+        if (i % 2 == 1) {
+            REQUIRE(timeline->requestItemResize(cid, length / 2, false) == length / 2);
+        }
+    }
+    QVector<QPoint> bounds;
+    QObject::connect(clip.get(), &ProjectClip::boundsChanged, clip.get(), [&bounds](const QVector<QPoint> &newBounds) { bounds = newBounds; });
+    timer.measure(QStringLiteral("refreshed the bounds of %1 timeline clips 100 times").arg(clipsCount), [&]() {
+        for (int i = 0; i < 100; ++i) {
+            clip->refreshBounds();
+        }
+    });
+    timer.report();
+    REQUIRE(bounds == QVector<QPoint>({{0, length}}));
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
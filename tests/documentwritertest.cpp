@@ -0,0 +1,45 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+#include "test_utils.hpp"
+// test specific headers
+#include "doc/documentwriter.h"
+#include <QTemporaryDir>
+
+TEST_CASE("Background project save", "[DocumentWriter]")
+{
+    DocumentWriter writer;
+    QList<int> progress;
+    QStringList errors;
+    // The jobs are processed one at a time and waitForFinished synchronizes with the writer thread
+    QObject::connect(&writer, &DocumentWriter::progress, [&progress](int percent) { progress << percent; });
+    QObject::connect(&writer, &DocumentWriter::saved, [&errors](const QString &, const QString &error) { errors << error; });
+    const QByteArray data("<mlt/>");
+
+    SECTION("A saved file is reported once written")
+    {
+        QTemporaryDir dir;
+        const QString path = dir.filePath(QStringLiteral("test.kdenlive"));
+        writer.save({path, data, QString(), {}});
+        REQUIRE(writer.waitForFinished());
+        REQUIRE(errors == QStringList({QString()}));
+        REQUIRE(progress.last() == 100);
+        QFile file(path);
+        REQUIRE(file.open(QIODevice::ReadOnly));
+        REQUIRE(file.readAll() == data);
+    }
+
+    SECTION("A file that cannot be opened reports an error")
+    {
+        writer.save({QStringLiteral("/nonexistent-kdenlive-folder/test.kdenlive"), data, QString(), {}});
+        REQUIRE_FALSE(writer.waitForFinished());
+        REQUIRE(errors.size() == 1);
+        REQUIRE_FALSE(errors.first().isEmpty());
+        // The progress report is ended as well
+        REQUIRE(progress.last() == 100);
+        // The failure is only reported once
+        REQUIRE(writer.waitForFinished());
+    }
+}
@@ -0,0 +1,107 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+#include "test_utils.hpp"
+// test specific headers
+#include "lib/audio/fftTools.h"
+#include <cmath>
+
+/** @brief Interleaved sine wave, channel c having the frequency frequencies[c] */
+static audioShortVector sineFrame(const QVector<double> &frequencies, int sampleRate, int samples, int offset = 0)
+{
+    const int channels = frequencies.size();
+    audioShortVector frame(samples * channels);
+    for (int i = 0; i < samples; ++i) {
+        for (int c = 0; c < channels; ++c) {
+            frame[i * channels + c] = qint16(16000. * std::sin(2. * M_PI * frequencies.at(c) * (i + offset) / sampleRate));
+        }
+    }
+    return frame;
+}
+
+static int peakBin(const float *spectrum, int count)
+{
+    return int(std::max_element(spectrum, spectrum + count) - spectrum);
+}
+
+TEST_CASE("FFT tools", "[FFT]")
+{
+    FFTTools fftTools;
+
+    SECTION("Kernels match the scalar computation")
+    {
+        QVector<float> data(37), window(37);
+        QVector<kiss_fft_cpx> bins(37);
+        for (int i = 0; i < data.size(); ++i) {
+            data[i] = float(i) / 10.f - 1.f;
+            window[i] = float(i % 7) / 7.f;
+            bins[i].r = float(i) * .5f + 1.f;
+            bins[i].i = -float(i) * .25f;
+        }
+        QVector<float> windowed(data);
+        FFTTools::applyWindow(windowed.data(), window.constData(), uint(data.size()));
+        QVector<float> db(bins.size());
+        FFTTools::magnitudeDb(bins.constData(), db.data(), uint(bins.size()), .5f);
+        for (int i = 0; i < data.size(); ++i) {
+            REQUIRE(windowed.at(i) == Approx(data.at(i) * window.at(i)));
+            const float expected = 20.f * std::log10(.5f * std::sqrt(bins.at(i).r * bins.at(i).r + bins.at(i).i * bins.at(i).i));
+            REQUIRE(db.at(i) == Approx(expected).margin(1e-4));
+        }
+
+        const audioShortVector interleaved = {100, -32767, 32767, 0, -100, 16384};
+        QVector<float> channel(3);
+        FFTTools::deinterleave(interleaved.constData(), 1, 2, channel.data(), 3);
+        REQUIRE(channel.at(0) == Approx(-1.f));
+        REQUIRE(channel.at(1) == Approx(0.f));
+        REQUIRE(channel.at(2) == Approx(0.5f).epsilon(0.001));
+    }
+
+    SECTION("Sine peaks are found in the requested channel")
+    {
+        const int sampleRate = 48000;
+        const int windowSize = 1024;
+        // Frequencies matching bins 64 and 200
+        const audioShortVector frame = sineFrame({64. * sampleRate / windowSize, 200. * sampleRate / windowSize}, sampleRate, windowSize);
+        QVector<float> spectrum(windowSize / 2);
+        for (auto windowType : {FFTTools::Window_Rect, FFTTools::Window_Triangle, FFTTools::Window_Hamming}) {
+            fftTools.fftNormalized(frame, 0, 2, spectrum.data(), windowType, windowSize);
+            REQUIRE(peakBin(spectrum.constData(), spectrum.size()) == 64);
+            fftTools.fftNormalized(frame, 1, 2, spectrum.data(), windowType, windowSize);
+            REQUIRE(peakBin(spectrum.constData(), spectrum.size()) == 200);
+        }
+        // Full scale sine is close to 0 dB once the window function is compensated
+        fftTools.fftNormalized(frame, 0, 2, spectrum.data(), FFTTools::Window_Hamming, windowSize);
+        REQUIRE(spectrum.at(64) == Approx(20. * std::log10(16000. / 32767.)).margin(1.));
+    }
+
+    SECTION("Overlapped STFT analyses all samples at 96 kHz")
+    {
+        const int sampleRate = 96000;
+        const int channels = 6;
+        const int samplesPerFrame = sampleRate / 25;
+        const uint windowSize = 2048;
+        const uint hopSize = windowSize / 2;
+        const QVector<double> frequencies = {1000., 2000., 3000., 4000., 5000., 6000.};
+
+        // The first frame does not fill enough windows, leftover samples are used by the next one
+        int spectraCount = 0;
+        const int frames = 250;
+        for (int i = 0; i < frames; ++i) {
+            const audioShortVector frame = sineFrame(frequencies, sampleRate, samplesPerFrame, i * samplesPerFrame);
+            const QVector<QVector<float>> spectra = fftTools.stft(frame, 2, channels, FFTTools::Window_Hamming, windowSize, hopSize);
+            for (const auto &spectrum : spectra) {
+                REQUIRE(spectrum.size() == int(windowSize / 2));
+                REQUIRE(qAbs(peakBin(spectrum.constData(), spectrum.size()) - qRound(3000. * windowSize / sampleRate)) <= 1);
+            }
+            spectraCount += spectra.size();
+        }
+        // All samples are analysed: one spectrum per hop, minus the first incomplete window
+        const int totalSamples = frames * samplesPerFrame;
+        REQUIRE(spectraCount == int((totalSamples - windowSize) / hopSize) + 1);
+
+        fftTools.resetStft();
+        REQUIRE(fftTools.stft(sineFrame(frequencies, sampleRate, 100), 0, channels, FFTTools::Window_Rect, windowSize, hopSize).isEmpty());
+    }
+}
@@ -460,6 +460,155 @@ TEST_CASE("Orphan groups deletion", "[GroupsModel]")
     pCore->projectManager()->closeCurrentDocument(false, false);
 }
 
+// Leaves are 0..leavesCount-1, followed by depth nested groups. Each level contains some leaves and the next level
+static void buildDeepHierarchy(GroupsModel *groups, int leavesCount, int depth)
+{
+    const int perLevel = leavesCount / depth;
+    for (int i = 0; i < leavesCount + depth; i++) {
+        groups->createGroupItem(i);
+    }
+    for (int level = 0; level < depth; level++) {
+        int gid = leavesCount + level;
+        for (int i = level * perLevel; i < (level + 1) * perLevel; i++) {
+            groups->setGroup(i, gid, false);
+        }
+        if (level > 0) {
+            groups->setGroup(gid, gid - 1, false);
+        }
+    }
+}
+
+TEST_CASE("Group hierarchy cache stress test", "[GroupsModel]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+
+    // Create document
+    KdenliveDoc document(undoStack);
+    pCore->projectManager()->testSetDocument(&document);
+    QDateTime documentDate = QDateTime::currentDateTime();
+    KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->testSetActiveTimeline(timeline);
+
+    KdenliveTests::resetNextId();
+    GroupsModel *groups = KdenliveTests::groupsModel(timeline);
+
+    const int leavesCount = 2000;
+    const int depth = 200;
+    buildDeepHierarchy(groups, leavesCount, depth);
+    const int root = leavesCount;
+    auto walkToRoot = [&](int id) {
+        while (groups->getDirectAncestor(id) != -1) {
+            id = groups->getDirectAncestor(id);
+        }
+        return id;
+    };
+
+    SECTION("Deep hierarchy")
+    {
+        for (int i = 0; i < leavesCount + depth; i++) {
+            REQUIRE(groups->getRootId(i) == root);
+        }
+        REQUIRE(groups->getLeaves(root).size() == size_t(leavesCount));
+
+        // Cutting the chain in the middle creates a new root
+        const int middle = leavesCount + depth / 2;
+        groups->removeFromGroup(middle);
+        for (int i = 0; i < leavesCount + depth; i++) {
+            CAPTURE(i);
+            REQUIRE(groups->getRootId(i) == walkToRoot(i));
+        }
+        REQUIRE(groups->getRootId(0) == root);
+        REQUIRE(groups->getRootId(leavesCount - 1) == middle);
+        REQUIRE(groups->getLeaves(root).size() == size_t(leavesCount / 2));
+        REQUIRE(groups->getLeaves(middle).size() == size_t(leavesCount / 2));
+
+        // Attaching it again restores the whole tree
+        groups->setGroup(middle, middle - 1, false);
+        REQUIRE(groups->getRootId(leavesCount - 1) == root);
+        REQUIRE(groups->getLeaves(root).size() == size_t(leavesCount));
+        REQUIRE(groups->checkConsistency(false));
+    }
+
+    SECTION("Wide hierarchy")
+    {
+        // A single group containing many leaves, next to the deep one
+        const int wideCount = 5000;
+        const int firstWide = leavesCount + depth;
+        const int wideGroup = firstWide + wideCount;
+        for (int i = firstWide; i <= wideGroup; i++) {
+            groups->createGroupItem(i);
+        }
+        for (int i = firstWide; i < wideGroup; i++) {
+            groups->setGroup(i, wideGroup, false);
+        }
+        for (int i = firstWide; i < wideGroup; i++) {
+            REQUIRE(groups->getRootId(i) == wideGroup);
+        }
+        REQUIRE(groups->getLeaves(wideGroup).size() == size_t(wideCount));
+        REQUIRE(groups->getLeaves(root).size() == size_t(leavesCount));
+
+        // Nest the wide group in the deep one
+        groups->setGroup(wideGroup, leavesCount + depth - 1, false);
+        REQUIRE(groups->getRootId(firstWide) == root);
+        REQUIRE(groups->getLeaves(root).size() == size_t(leavesCount + wideCount));
+
+        // Remove every other leaf from the wide group
+        for (int i = firstWide; i < wideGroup; i += 2) {
+            groups->removeFromGroup(i);
+        }
+        for (int i = firstWide; i < wideGroup; i++) {
+            CAPTURE(i);
+            REQUIRE(groups->getRootId(i) == ((i - firstWide) % 2 == 0 ? i : root));
+        }
+        REQUIRE(groups->getLeaves(wideGroup).size() == size_t(wideCount / 2));
+        REQUIRE(groups->getLeaves(root).size() == size_t(leavesCount + wideCount / 2));
+        REQUIRE(groups->checkConsistency(false));
+    }
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
+
+TEST_CASE("Group hierarchy benchmark", "[GroupsModel][.benchmark]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    KdenliveDoc document(undoStack);
+    pCore->projectManager()->testSetDocument(&document);
+    QDateTime documentDate = QDateTime::currentDateTime();
+    KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->testSetActiveTimeline(timeline);
+    KdenliveTests::resetNextId();
+    GroupsModel *groups = KdenliveTests::groupsModel(timeline);
+
+    const int leavesCount = 2000;
+    const int depth = 200;
+    buildDeepHierarchy(groups, leavesCount, depth);
+    const int root = leavesCount;
+    BenchmarkTimer timer;
+    int resolved = 0;
+    timer.measure(QStringLiteral("Resolved %1 roots").arg(10 * (leavesCount + depth)), [&]() {
+        for (int pass = 0; pass < 10; pass++) {
+            for (int i = 0; i < leavesCount + depth; i++) {
+                resolved += groups->getRootId(i) == root ? 1 : 0;
+            }
+        }
+    });
+    size_t leaves = 0;
+    timer.measure(QStringLiteral("listed leaves 100 times"), [&]() {
+        for (int pass = 0; pass < 100; pass++) {
+            leaves += groups->getLeaves(root).size();
+        }
+    });
+    timer.report();
+    REQUIRE(resolved == 10 * (leavesCount + depth));
+    REQUIRE(leaves == size_t(100 * leavesCount));
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
+
 TEST_CASE("Integration with timeline", "[GroupsModel]")
 {
     qDebug() << "STARTING PASS";
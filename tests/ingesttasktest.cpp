@@ -0,0 +1,65 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+#include "test_utils.hpp"
+// test specific headers
+#include "doc/kdenlivedoc.h"
+#include "jobs/ingesttask.h"
+#include "kdenlivesettings.h"
+
+TEST_CASE("Single pass ingest eligibility", "[IngestTask]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    pCore->setCurrentProfile(QStringLiteral("dv_pal"));
+    KdenliveDoc document(undoStack);
+    pCore->projectManager()->testSetDocument(&document);
+    QDateTime documentDate = QDateTime::currentDateTime();
+    KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->testSetActiveTimeline(timeline);
+
+    const bool singlePass = KdenliveSettings::singlepassingest();
+    KdenliveSettings::setSinglepassingest(true);
+    const QString colorId = KdenliveTests::createProducer(pCore->getProjectProfile(), "red", binModel);
+    const QString avId = KdenliveTests::createAVProducer(pCore->getProjectProfile(), binModel);
+    std::shared_ptr<ProjectClip> avClip = binModel->getClipByBinID(avId);
+    // Without avformat support, the test clip is replaced by a blipflash producer
+    const bool hasAvformat = avClip->clipType() == ClipType::AV;
+
+    SECTION("Only video clips are ingested")
+    {
+        REQUIRE_FALSE(IngestTask::canIngest(nullptr));
+        REQUIRE_FALSE(IngestTask::canIngest(binModel->getClipByBinID(colorId)));
+    }
+
+    if (hasAvformat) {
+        SECTION("The FFmpeg job is used when single pass ingest is disabled")
+        {
+            KdenliveSettings::setSinglepassingest(false);
+            REQUIRE_FALSE(IngestTask::canIngest(avClip));
+        }
+
+        SECTION("Clips with a rotation override are left to the FFmpeg job")
+        {
+            avClip->setProducerProperty(QStringLiteral("autorotate"), 0);
+            REQUIRE_FALSE(IngestTask::canIngest(avClip));
+            avClip->resetProducerProperty(QStringLiteral("autorotate"));
+            avClip->setProducerProperty(QStringLiteral("rotate"), 90);
+            REQUIRE_FALSE(IngestTask::canIngest(avClip));
+            avClip->resetProducerProperty(QStringLiteral("rotate"));
+        }
+
+        SECTION("Thumbnails and levels require the project frame rate")
+        {
+            REQUIRE(IngestTask::canIngest(avClip) == qFuzzyCompare(avClip->getOriginalFps(), pCore->getCurrentFps()));
+        }
+    }
+
+    KdenliveSettings::setSinglepassingest(singlePass);
+    binModel->clean();
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
@@ -264,3 +264,61 @@ TEST_CASE("Keyframe model", "[KeyframeModel]")
     timeline.reset();
     pCore->projectManager()->closeCurrentDocument(false, false);
 }
+
+TEST_CASE("Keyframe model benchmark", "[KeyframeModel][.benchmark]")
+{
+    auto binModel = pCore->projectItemModel();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    KdenliveDoc document(undoStack);
+    pCore->projectManager()->testSetDocument(&document);
+    QDateTime documentDate = QDateTime::currentDateTime();
+    KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->testSetActiveTimeline(timeline);
+
+    const int keyframesCount = 1000;
+    const int spacing = 5;
+    const QString binId = KdenliveTests::createProducer(pCore->getProjectProfile(), "red", binModel, keyframesCount * spacing, false);
+    std::shared_ptr<ProjectClip> clip = binModel->getClipByBinID(binId);
+    auto effectstack = clip->getEffectStack();
+    effectstack->appendEffect(QStringLiteral("audiobalance"));
+    auto effect = std::dynamic_pointer_cast<EffectItemModel>(effectstack->getEffectStackRow(0));
+    effect->prepareKeyframes();
+    auto model = std::make_shared<KeyframeModel>(effect, effect->index(0, 0), undoStack);
+
+    const double fps = pCore->getCurrentFps();
+    BenchmarkTimer timer;
+    timer.measure(QStringLiteral("Inserted %1 keyframes").arg(keyframesCount), [&]() {
+        for (int i = 1; i < keyframesCount; ++i) {
+            KdenliveTests::addKeyframe(model, GenTime(i * spacing, fps), KeyframeType::Linear, i % 100);
+        }
+    });
+    int found = 0;
+    timer.measure(QStringLiteral("checked every frame"), [&]() {
+        for (int frame = 0; frame < keyframesCount * spacing; ++frame) {
+            if (model->hasKeyframe(frame)) {
+                found++;
+            }
+        }
+    });
+    timer.measure(QStringLiteral("found closest keyframes"), [&]() {
+        bool ok;
+        for (int frame = 0; frame < keyframesCount * spacing; ++frame) {
+            model->getClosestKeyframe(GenTime(frame, fps), &ok);
+        }
+    });
+    QString anim;
+    timer.measure(QStringLiteral("serialized 100 times"), [&]() {
+        for (int i = 0; i < 100; ++i) {
+            anim = model->getAnimProperty();
+        }
+    });
+    timer.report();
+    REQUIRE(found == keyframesCount);
+    REQUIRE_FALSE(anim.isEmpty());
+
+    model.reset();
+    clip.reset();
+    timeline.reset();
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
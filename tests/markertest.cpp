@@ -198,6 +198,23 @@ TEST_CASE("Marker model", "[MarkerListModel]")
         checkMarkerList(model, {}, snaps);
     }
 
+    SECTION("Range queries on many markers")
+    {
+        // One marker every 10 frames
+        const int markersCount = 2000;
+        for (int i = 0; i < markersCount; ++i) {
+            REQUIRE(model->addMarker(GenTime(10 * i, fps), QStringLiteral("marker %1").arg(i), 0));
+        }
+        REQUIRE(model->getMarkersIdInRange(0, -1).size() == markersCount);
+        REQUIRE(model->getMarkersIdInRange(95, 125).size() == 3);
+        REQUIRE(model->getMarkersIdInRange(10 * markersCount - 15, -1).size() == 1);
+        QList<CommentedTime> markers = model->getMarkersInRange(95, 125);
+        REQUIRE(markers.size() == 3);
+        REQUIRE(markers.first().time().frames(fps) == 100);
+        REQUIRE(model->removeAllMarkers());
+        checkMarkerList(model, {}, snaps);
+    }
+
     SECTION("Json identity test")
     {
         std::vector<Marker> list;
@@ -264,3 +281,42 @@ TEST_CASE("Marker model", "[MarkerListModel]")
     // undoStack->clear();
     pCore->projectManager()->closeCurrentDocument(false, false);
 }
+
+TEST_CASE("Marker model benchmark", "[MarkerListModel][.benchmark]")
+{
+    fps = pCore->getCurrentFps();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    KdenliveDoc document(undoStack);
+    pCore->projectManager()->testSetDocument(&document);
+    QDateTime documentDate = QDateTime::currentDateTime();
+    KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->testSetActiveTimeline(timeline);
+    std::shared_ptr<MarkerListModel> model = timeline->getGuideModel();
+
+    const int markersCount = 5000;
+    BenchmarkTimer timer;
+    timer.measure(QStringLiteral("Inserted %1 markers").arg(markersCount), [&]() {
+        for (int i = 0; i < markersCount; ++i) {
+            model->addMarker(GenTime(10 * i, fps), QStringLiteral("marker %1").arg(i), 0);
+        }
+    });
+    int found = 0;
+    timer.measure(QStringLiteral("checked every frame"), [&]() {
+        for (int frame = 0; frame < 10 * markersCount; ++frame) {
+            if (model->hasMarker(frame)) {
+                found++;
+            }
+        }
+    });
+    int inRange = 0;
+    timer.measure(QStringLiteral("queried ranges"), [&]() {
+        for (int i = 0; i < markersCount; i += 10) {
+            inRange += model->getMarkersIdInRange(10 * i, 10 * i + 100).size();
+        }
+    });
+    timer.report();
+    REQUIRE(found == markersCount);
+    REQUIRE(inRange > 0);
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
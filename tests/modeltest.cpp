@@ -2163,6 +2163,94 @@ TEST_CASE("Operations under locked tracks", "[Locked]")
     pCore->projectManager()->closeCurrentDocument(false, false);
 }
 
+TEST_CASE("Queued clip updates are coalesced", "[ClipModel]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+
+    KdenliveDoc document(undoStack, {1, 1});
+    pCore->projectManager()->testSetDocument(&document);
+    QDateTime documentDate = QDateTime::currentDateTime();
+    KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->testSetActiveTimeline(timeline);
+
+    QString binId = KdenliveTests::createProducer(pCore->getProjectProfile(), "red", binModel);
+    int tid1 = timeline->getTrackIndexFromPosition(0);
+    if (timeline->isAudioTrack(tid1)) {
+        tid1 = timeline->getTrackIndexFromPosition(1);
+    }
+    int cid1 = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+    int cid2 = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+    int cid3 = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+    int length = timeline->getClipPlaytime(cid1);
+    REQUIRE(timeline->requestClipMove(cid1, tid1, 0));
+    REQUIRE(timeline->requestClipMove(cid2, tid1, length));
+    REQUIRE(timeline->requestClipMove(cid3, tid1, 2 * length));
+    // Discard the notifications queued by the insertions
+    timeline->flushPendingChanges();
+
+    struct Notification
+    {
+        QModelIndex first;
+        QModelIndex last;
+        QList<int> roles;
+    };
+    std::vector<Notification> notifications;
+    QObject::connect(timeline.get(), &TimelineItemModel::dataChanged, timeline.get(),
+                     [&notifications](const QModelIndex &first, const QModelIndex &last, const QList<int> &roles) {
+                         notifications.push_back({first, last, roles});
+                     });
+    QModelIndex trackIndex = timeline->makeTrackIndexFromID(tid1);
+    QVector<int> rows = {timeline->makeClipIndexFromID(cid1).row(), timeline->makeClipIndexFromID(cid2).row(),
+                         timeline->makeClipIndexFromID(cid3).row()};
+    std::sort(rows.begin(), rows.end());
+    REQUIRE(rows.last() - rows.first() == 2);
+
+    SECTION("Adjacent clips with the same roles are flushed in one notification")
+    {
+        timeline->requestClipUpdate(cid1, {TimelineModel::StartRole, TimelineModel::DurationRole});
+        timeline->requestClipUpdate(cid2, {TimelineModel::DurationRole});
+        timeline->requestClipUpdate(cid3, {TimelineModel::DurationRole, TimelineModel::StartRole});
+        timeline->requestClipUpdate(cid2, {TimelineModel::StartRole, TimelineModel::DurationRole});
+        timeline->requestClipUpdate(cid1, {TimelineModel::DurationRole});
+        // Nothing is emitted until the queue is flushed
+        REQUIRE(notifications.empty());
+
+        timeline->flushPendingChanges();
+        REQUIRE(notifications.size() == 1);
+        REQUIRE(notifications.front().first == timeline->index(rows.first(), 0, trackIndex));
+        REQUIRE(notifications.front().last == timeline->index(rows.last(), 0, trackIndex));
+        REQUIRE(notifications.front().roles == QList<int>({TimelineModel::StartRole, TimelineModel::DurationRole}));
+
+        // The queue is emptied by the flush
+        timeline->flushPendingChanges();
+        REQUIRE(notifications.size() == 1);
+    }
+
+    SECTION("Clips with different roles are notified separately")
+    {
+        timeline->requestClipUpdate(cid1, {TimelineModel::NameRole});
+        timeline->requestClipUpdate(cid2, {TimelineModel::NameRole});
+        timeline->requestClipUpdate(cid3, {TimelineModel::NameRole, TimelineModel::MarkersRole});
+        timeline->requestClipUpdate(cid1, {TimelineModel::NameRole});
+        REQUIRE(notifications.empty());
+
+        timeline->flushPendingChanges();
+        REQUIRE(notifications.size() == 2);
+        for (const auto &notification : notifications) {
+            REQUIRE(notification.first.parent() == trackIndex);
+            REQUIRE(notification.roles.contains(TimelineModel::NameRole));
+            REQUIRE(std::is_sorted(notification.roles.cbegin(), notification.roles.cend()));
+        }
+        timeline->flushPendingChanges();
+        REQUIRE(notifications.size() == 2);
+    }
+
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
+
 TEST_CASE("New KdenliveDoc activeTrack", "KdenliveDoc")
 {
     auto binModel = pCore->projectItemModel();
@@ -6,12 +6,16 @@
 #include "test_utils.hpp"
 // test specific headers
 #include "bin/binplaylist.hpp"
+#include "bin/sequenceprerender.h"
 #include "doc/kdenlivedoc.h"
+#include "kdenlivesettings.h"
 #include "timeline2/model/builders/meltBuilder.hpp"
 #include "xml/xml.hpp"
 
 #include <QTemporaryFile>
 #include <QUndoGroup>
+#include <mlt++/MltConsumer.h>
+#include <mlt++/MltPlaylist.h>
 
 using namespace fakeit;
 
@@ -610,3 +614,113 @@ TEST_CASE("Check nested sequences on opening", "[NEST]")
         pCore->projectManager()->closeCurrentDocument(false, false);
     }
 }
+
+TEST_CASE("Save a pre-rendered nested sequence", "[NEST]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    const QString saveFile = QDir::temp().absoluteFilePath(QStringLiteral("test-prerender.kdenlive"));
+    const QString intermediate = QDir::temp().absoluteFilePath(QStringLiteral("test-prerender-intermediate.mlt"));
+    const bool preRender = KdenliveSettings::nestedprerender();
+
+    SECTION("The intermediate is played but not saved")
+    {
+        pCore->setCurrentProfile(QStringLiteral("dv_pal"));
+        KdenliveDoc document(undoStack);
+        pCore->projectManager()->testSetDocument(&document);
+        QDateTime documentDate = QDateTime::currentDateTime();
+        KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+        auto timeline = document.getTimeline(document.uuid());
+        pCore->projectManager()->testSetActiveTimeline(timeline);
+        KdenliveTests::resetNextId();
+        QString binId = KdenliveTests::createProducer(pCore->getProjectProfile(), "red", binModel, 20, false);
+
+        // Create a sequence with a clip
+        std::pair<int, int> tracks = {1, 1};
+        const QString seqId = ClipCreator::createPlaylistClip(QStringLiteral("Seq 2"), tracks, QStringLiteral("-1"), binModel);
+        REQUIRE(seqId != QLatin1String("-1"));
+        QUuid uuid = binModel->getAllSequenceClips().key(seqId);
+        REQUIRE(!uuid.isNull());
+        auto sequence = document.getTimeline(uuid);
+        int cid1 = -1;
+        REQUIRE(sequence->requestClipInsertion(binId, sequence->getTrackIndexFromPosition(1), 0, cid1, true, true, false));
+        sequence.reset();
+
+        // Fake a finished pre-render of the sequence
+        Mlt::Playlist playlist(pCore->getProjectProfile());
+        Mlt::Producer color(pCore->getProjectProfile(), "color:blue");
+        REQUIRE(color.is_valid());
+        color.set("length", 500);
+        playlist.append(color, 0, 499);
+        Mlt::Consumer xmlConsumer(pCore->getProjectProfile(), "xml", intermediate.toUtf8().constData());
+        xmlConsumer.connect(playlist);
+        xmlConsumer.run();
+        REQUIRE(QFile::exists(intermediate));
+        std::shared_ptr<ProjectClip> seqClip = binModel->getClipByBinID(seqId);
+        KdenliveTests::setSequenceIntermediate(seqClip, intermediate);
+        KdenliveSettings::setNestedprerender(true);
+
+        // Insert the sequence in the main timeline, it plays the intermediate
+        timeline = document.getTimeline(document.uuid());
+        pCore->projectManager()->testSetActiveTimeline(timeline);
+        int tid1 = timeline->getTrackIndexFromPosition(2);
+        KdenliveTests::setVideoTargets(timeline, tid1);
+        int cid2 = -1;
+        REQUIRE(timeline->requestClipInsertion(seqId, tid1, 10, cid2, true, true, false));
+        const QString sequenceId = KdenliveTests::preRenderedSequence(timeline, cid2);
+        REQUIRE_FALSE(sequenceId.isEmpty());
+        REQUIRE(timeline->getClipBinId(cid2) == seqId);
+
+        // The saved project references the sequence, not the intermediate
+        REQUIRE(pCore->projectManager()->testSaveFileAs(saveFile));
+        QFile file(saveFile);
+        REQUIRE(file.open(QIODevice::ReadOnly));
+        const QString content = QString::fromUtf8(file.readAll());
+        REQUIRE_FALSE(content.contains(intermediate));
+        REQUIRE_FALSE(content.contains(QLatin1String(SequencePreRender::SequenceProperty)));
+        REQUIRE(content.contains(QStringLiteral("producer=\"%1\"").arg(sequenceId)));
+        // Playback still uses the intermediate
+        REQUIRE(KdenliveTests::preRenderedSequence(timeline, cid2) == sequenceId);
+        KdenliveSettings::setNestedprerender(preRender);
+        timeline.reset();
+        pCore->projectManager()->closeCurrentDocument(false, false);
+    }
+
+    SECTION("Reopen and check the nested sequence")
+    {
+        KdenliveTests::resetNextId();
+        REQUIRE(QFile::exists(saveFile));
+        QUrl openURL = QUrl::fromLocalFile(saveFile);
+        QUndoGroup *undoGroup = new QUndoGroup();
+        undoGroup->addStack(undoStack.get());
+        DocOpenResult openResults = KdenliveDoc::Open(openURL, QDir::temp().path(), undoGroup, false, nullptr);
+        REQUIRE(openResults.isSuccessful() == true);
+        std::unique_ptr<KdenliveDoc> openedDoc = openResults.getDocument();
+
+        pCore->projectManager()->testSetDocument(openedDoc.get());
+        const QUuid uuid = openedDoc->uuid();
+        QDateTime documentDate = QFileInfo(openURL.toLocalFile()).lastModified();
+        KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+        QMap<QUuid, QString> allSequences = binModel->getAllSequenceClips();
+        const QString firstSeqId = allSequences.take(uuid);
+        REQUIRE(allSequences.size() == 1);
+        pCore->projectManager()->openTimeline(firstSeqId, -1, uuid);
+        std::shared_ptr<TimelineItemModel> timeline = openedDoc->getTimeline(uuid);
+        pCore->projectManager()->testSetActiveTimeline(timeline);
+        REQUIRE(openedDoc->checkConsistency());
+
+        int tid1 = timeline->getTrackIndexFromPosition(2);
+        int cid2 = timeline->getClipByStartPosition(tid1, 10);
+        REQUIRE(cid2 > -1);
+        REQUIRE(timeline->getClipBinId(cid2) == allSequences.first());
+        REQUIRE(KdenliveTests::preRenderedSequence(timeline, cid2).isEmpty());
+        std::shared_ptr<TimelineItemModel> sequence = openedDoc->getTimeline(allSequences.firstKey());
+        REQUIRE(sequence->getClipsCount() == 1);
+        timeline.reset();
+        sequence.reset();
+        pCore->projectManager()->closeCurrentDocument(false, false);
+        QFile::remove(saveFile);
+        QFile::remove(intermediate);
+    }
+}
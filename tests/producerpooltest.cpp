@@ -0,0 +1,225 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+#include "test_utils.hpp"
+// test specific headers
+#include "bin/producerpool.h"
+#include "doc/docundostack.hpp"
+#include "doc/kdenlivedoc.h"
+#include "kdenlivesettings.h"
+#include <QThread>
+
+#include "core.h"
+#include "definitions.h"
+
+TEST_CASE("Producer pool reference counting", "[ProducerPool]")
+{
+    ProducerPool pool;
+    const ProducerPool::Key videoKey{QStringLiteral("2"), false, 5};
+    const ProducerPool::Key audioKey{QStringLiteral("2"), true, 4};
+    const ProducerPool::Key otherKey{QStringLiteral("3"), false, 5};
+
+    SECTION("Producers are shared by the clips of a track")
+    {
+        REQUIRE(pool.acquire(videoKey, 10));
+        REQUIRE_FALSE(pool.acquire(videoKey, 11));
+        REQUIRE(pool.acquire(audioKey, 12));
+        REQUIRE(pool.acquire(otherKey, 13));
+        REQUIRE(pool.users(videoKey) == 2);
+        REQUIRE(pool.metrics().producers == 3);
+        REQUIRE(pool.metrics().users == 4);
+        REQUIRE(pool.metrics().reused == 1);
+
+        // Releasing a clip only frees the producer with its last user
+        REQUIRE_FALSE(pool.release(10).has_value());
+        REQUIRE(pool.release(11) == videoKey);
+        REQUIRE_FALSE(pool.release(11).has_value());
+        REQUIRE(pool.users(videoKey) == 0);
+        REQUIRE(pool.metrics().producers == 2);
+        REQUIRE(pool.metrics().released == 1);
+        REQUIRE(pool.metrics().peakProducers == 3);
+        // A producer kept idle is reused by its next user
+        REQUIRE(pool.idleProducers().contains(videoKey));
+        REQUIRE_FALSE(pool.acquire(videoKey, 14));
+        REQUIRE_FALSE(pool.idleProducers().contains(videoKey));
+        REQUIRE(pool.metrics().reused == 2);
+    }
+
+    SECTION("Removing a bin clip forgets its producers")
+    {
+        pool.acquire(videoKey, 10);
+        pool.acquire(audioKey, 11);
+        pool.acquire(otherKey, 12);
+        pool.removeBinClip(QStringLiteral("2"));
+        REQUIRE_FALSE(pool.keyOf(10).has_value());
+        REQUIRE(pool.keyOf(12) == otherKey);
+        REQUIRE(pool.metrics().producers == 1);
+        REQUIRE(pool.metrics().users == 1);
+        // The clips can use a new producer after the reset
+        REQUIRE(pool.acquire(videoKey, 10));
+        pool.clear();
+        REQUIRE(pool.metrics().producers == 0);
+        REQUIRE(pool.users(otherKey) == 0);
+    }
+
+    SECTION("Decoder limit")
+    {
+        const int previous = ProducerPool::decoderLimit();
+        ProducerPool::setDecoderLimit(8);
+        REQUIRE(ProducerPool::decoderLimit() == 8);
+        ProducerPool::setDecoderLimit(0);
+        REQUIRE(ProducerPool::decoderLimit() == 1);
+        // The timeline cannot raise the limit above the user setting
+        const int previousSetting = KdenliveSettings::maxopendecoders();
+        KdenliveSettings::setMaxopendecoders(6);
+        ProducerPool::setDecoderLimitForTracks(20);
+        REQUIRE(ProducerPool::decoderLimit() == 6);
+        KdenliveSettings::setMaxopendecoders(200);
+        ProducerPool::setDecoderLimitForTracks(1);
+        REQUIRE(ProducerPool::decoderLimit() == qMax(4, QThread::idealThreadCount() + 4));
+        KdenliveSettings::setMaxopendecoders(previousSetting);
+        ProducerPool::setDecoderLimit(previous);
+    }
+}
+
+TEST_CASE("Track producers are released with their last clip", "[ProducerPool]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+
+    KdenliveDoc document(undoStack);
+    pCore->projectManager()->testSetDocument(&document);
+    QDateTime documentDate = QDateTime::currentDateTime();
+    KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->testSetActiveTimeline(timeline);
+    ProducerPool &pool = binModel->producerPool();
+
+    int tid1 = timeline->getTrackIndexFromPosition(1);
+    int tid2 = timeline->getTrackIndexFromPosition(2);
+    QString binId = KdenliveTests::createProducerWithSound(pCore->getProjectProfile(), binModel, 100);
+    QMap<int, QString> audioInfo;
+    audioInfo.insert(1, QStringLiteral("stream1"));
+    KdenliveTests::setAudioTargets(timeline, audioInfo);
+
+    int cid1;
+    REQUIRE(timeline->requestClipInsertion(binId, tid2, 100, cid1));
+    int cid2 = timeline->getClipSplitPartner(cid1);
+    int cid3;
+    REQUIRE(timeline->requestClipInsertion(binId, tid2, 300, cid3));
+    int cid4 = timeline->getClipSplitPartner(cid3);
+    REQUIRE(timeline->getItemTrackId(cid2) == tid1);
+
+    // Both audio clips share the producer of the audio track
+    const auto key = pool.keyOf(cid2);
+    REQUIRE(key.has_value());
+    REQUIRE(key->audio);
+    REQUIRE(pool.keyOf(cid4) == key);
+    REQUIRE(pool.users(*key) == 2);
+
+    REQUIRE(timeline->requestItemDeletion(cid1));
+    REQUIRE(pool.users(*key) == 1);
+    REQUIRE(timeline->requestItemDeletion(cid3));
+    REQUIRE(pool.users(*key) == 0);
+    REQUIRE_FALSE(pool.keyOf(cid4).has_value());
+    // The deleted clips kept by the undo stack still use the producer
+    binModel->releaseIdleProducers();
+    REQUIRE(pool.idleProducers().contains(*key));
+
+    // Undo recreates the track producer
+    undoStack->undo();
+    REQUIRE(pool.users(*key) == 1);
+    undoStack->undo();
+    REQUIRE(pool.users(*key) == 2);
+    REQUIRE_FALSE(pool.idleProducers().contains(*key));
+
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
+
+TEST_CASE("Track producers prepared for a bulk insertion", "[ProducerPool]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+
+    KdenliveDoc document(undoStack);
+    pCore->projectManager()->testSetDocument(&document);
+    QDateTime documentDate = QDateTime::currentDateTime();
+    KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->testSetActiveTimeline(timeline);
+    ProducerPool &pool = binModel->producerPool();
+
+    int tid2 = timeline->getTrackIndexFromPosition(2);
+    QMap<int, QString> audioInfo;
+    audioInfo.insert(1, QStringLiteral("stream1"));
+    KdenliveTests::setAudioTargets(timeline, audioInfo);
+    QStringList binIds;
+    for (int i = 0; i < 12; i++) {
+        binIds << KdenliveTests::createProducerWithSound(pCore->getProjectProfile(), binModel, 20);
+    }
+    // Each clip needs a video producer and an audio producer
+    auto clips = std::make_shared<QList<std::pair<std::shared_ptr<ProjectClip>, int>>>(TimelineFunctions::missingTrackProducers(tid2, binIds));
+    REQUIRE(clips->size() == binIds.size());
+    for (const auto &clip : std::as_const(*clips)) {
+        REQUIRE(clip.second == 2);
+    }
+
+    SECTION("Prepared producers are used by the insertion")
+    {
+        TimelineFunctions::prepareTrackProducers(clips).waitForFinished();
+        for (const auto &clip : std::as_const(*clips)) {
+            REQUIRE(KdenliveTests::preparedProducersCount(clip.first) == 2);
+        }
+        QList<int> clipIds;
+        REQUIRE(TimelineFunctions::requestMultipleClipsInsertion(timeline, binIds, tid2, 0, clipIds, true, true));
+        REQUIRE(clipIds.size() == binIds.size());
+        for (const auto &clip : std::as_const(*clips)) {
+            REQUIRE(KdenliveTests::preparedProducersCount(clip.first) == 0);
+        }
+        REQUIRE(TimelineFunctions::missingTrackProducers(tid2, binIds).isEmpty());
+    }
+
+    SECTION("Canceled preparation")
+    {
+        QFuture<void> future = TimelineFunctions::prepareTrackProducers(clips);
+        future.cancel();
+        future.waitForFinished();
+        for (const auto &clip : std::as_const(*clips)) {
+            // Clips processed before the cancellation keep their producers until discarded
+            REQUIRE(KdenliveTests::preparedProducersCount(clip.first) <= 2);
+            clip.first->discardPreparedProducers();
+            REQUIRE(KdenliveTests::preparedProducersCount(clip.first) == 0);
+            // The clip can be prepared again after a discard
+            clip.first->prepareTimelineProducers(1);
+            REQUIRE(KdenliveTests::preparedProducersCount(clip.first) == 1);
+            clip.first->discardPreparedProducers();
+        }
+        // The insertion still creates the producers it needs
+        QList<int> clipIds;
+        REQUIRE(TimelineFunctions::requestMultipleClipsInsertion(timeline, binIds, tid2, 0, clipIds, true, true));
+        REQUIRE(TimelineFunctions::missingTrackProducers(tid2, binIds).isEmpty());
+    }
+
+    SECTION("A drop replacing its preview reuses the preview producers")
+    {
+        QList<int> clipIds;
+        REQUIRE(TimelineFunctions::requestMultipleClipsInsertion(timeline, binIds, tid2, 0, clipIds, false, true));
+        const quint64 created = pool.metrics().created;
+        for (int cid : std::as_const(clipIds)) {
+            if (timeline->isClip(cid)) {
+                REQUIRE(timeline->requestItemDeletion(cid, false));
+            }
+        }
+        // The producers stay available until the operation is recorded in the undo stack
+        REQUIRE(TimelineFunctions::missingTrackProducers(tid2, binIds).isEmpty());
+        clipIds.clear();
+        REQUIRE(TimelineFunctions::requestMultipleClipsInsertion(timeline, binIds, tid2, 0, clipIds, true, true));
+        REQUIRE(pool.metrics().created == created);
+    }
+
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
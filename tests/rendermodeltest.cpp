@@ -8,6 +8,8 @@
 #include "render/renderrequest.h"
 #include "renderpresets/renderpresetmodel.hpp"
 #include "renderpresets/renderpresetrepository.hpp"
+#include "xml/xml.hpp"
+#include <QTemporaryDir>
 
 TEST_CASE("Basic tests of the render preset model", "[RenderPresets]")
 {
@@ -279,3 +281,75 @@ TEST_CASE("Tests of the render functions to use guides for sections", "[RenderRe
         CHECK(sections.at(2).second == out);
     }
 }
+
+TEST_CASE("Render job arguments", "[RenderRequest]")
+{
+    RenderRequest::RenderJob job;
+    job.playlistPath = QStringLiteral("/tmp/render.mlt");
+    job.outputPath = QStringLiteral("/tmp/render.mp4");
+    job.outputFile = job.outputPath;
+
+    SECTION("Delivery through melt")
+    {
+        const QStringList args = RenderRequest::argsByJob(job, false);
+        CHECK(args.first() == QStringLiteral("delivery"));
+        CHECK(args.at(2) == job.playlistPath);
+    }
+
+    SECTION("Audio stems are rendered in one pass")
+    {
+        job.audioStems = true;
+        const QStringList args = RenderRequest::argsByJob(job, false);
+        CHECK(args == QStringList({QStringLiteral("audio-stems"), job.playlistPath}));
+        CHECK(RenderRequest::argsByJob(job, true).contains(QStringLiteral("--pid")));
+    }
+}
+
+TEST_CASE("Audio stems of the timeline tracks", "[RenderRequest]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const QUuid uuid = QUuid::createUuid();
+    const QString scene = QStringLiteral("<mlt><playlist id=\"playlist0\"/><playlist id=\"playlist1\"/><playlist id=\"playlist2\"/>"
+                                         "<tractor id=\"tractor0\"><property name=\"kdenlive:audio_track\">1</property>"
+                                         "<property name=\"kdenlive:track_name\">Voice over</property><track producer=\"playlist0\"/></tractor>"
+                                         "<tractor id=\"tractor1\"><property name=\"kdenlive:audio_track\">1</property>"
+                                         "<track producer=\"playlist1\" hide=\"both\"/></tractor>"
+                                         "<tractor id=\"tractor2\"><track producer=\"playlist2\"/></tractor>"
+                                         "<tractor id=\"main\"><property name=\"kdenlive:uuid\">%1</property><track producer=\"tractor0\"/>"
+                                         "<track producer=\"tractor1\"/><track producer=\"tractor2\"/></tractor>"
+                                         "<consumer mlt_service=\"avformat\" target=\"render.mp4\"/></mlt>")
+                                .arg(uuid.toString());
+    QDomDocument doc;
+    REQUIRE(doc.setContent(scene));
+    const QString playlistFile = dir.filePath(QStringLiteral("render.mlt"));
+    const QString targetFile = dir.filePath(QStringLiteral("render.mp4"));
+    std::vector<RenderRequest::RenderJob> jobs;
+    KdenliveTests::prepareMultiAudioFiles(jobs, doc, playlistFile, targetFile, uuid);
+
+    // A single job renders all stems and the master mix
+    REQUIRE(jobs.size() == 1);
+    REQUIRE(jobs.front().audioStems);
+    REQUIRE(jobs.front().outputPath == dir.filePath(QStringLiteral("render_master.wav")));
+    QFile file(jobs.front().playlistPath);
+    REQUIRE(file.open(QIODevice::ReadOnly));
+    QDomDocument stems;
+    REQUIRE(stems.setContent(&file));
+    QMap<QString, QString> targets;
+    const QDomNodeList tractors = stems.elementsByTagName(QStringLiteral("tractor"));
+    for (int i = 0; i < tractors.count(); i++) {
+        const QDomElement tractor = tractors.at(i).toElement();
+        const QString target = Xml::getXmlProperty(tractor, QStringLiteral("kdenlive:stem_target"));
+        if (!target.isEmpty()) {
+            targets.insert(tractor.attribute(QStringLiteral("id")), target);
+        }
+    }
+    // Muted and video tracks are not exported, tracks are numbered from the top
+    REQUIRE(targets.size() == 1);
+    REQUIRE(targets.value(QStringLiteral("tractor0")) == dir.filePath(QStringLiteral("render_A2-Voice_over.wav")));
+    const QDomElement consumer = stems.documentElement().firstChildElement(QStringLiteral("consumer"));
+    REQUIRE(consumer.attribute(QStringLiteral("target")) == jobs.front().outputPath);
+    REQUIRE(consumer.attribute(QStringLiteral("video_off")) == QStringLiteral("1"));
+    // The original document is not modified
+    REQUIRE(doc.toString().indexOf(QStringLiteral("kdenlive:stem_target")) == -1);
+}
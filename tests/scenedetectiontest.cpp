@@ -0,0 +1,247 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+#include "test_utils.hpp"
+// test specific headers
+#include "jobs/scenechangedetector.h"
+#include "jobs/scenesplittask.h"
+#include "kdenlivesettings.h"
+#include <QProcess>
+#include <QRegularExpression>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <mlt++/MltPlaylist.h>
+#include <cmath>
+
+static constexpr int FrameWidth = 256;
+static constexpr int FrameHeight = 144;
+
+/** @brief Fill a luma frame with a moving pattern, each scene using a different pattern */
+static void renderFrame(std::vector<uint8_t> &frame, int scene, int position, double brightness = 1.)
+{
+    for (int y = 0; y < FrameHeight; ++y) {
+        for (int x = 0; x < FrameWidth; ++x) {
+            int value = 0;
+            switch (scene % 3) {
+            case 0:
+                value = 40 + ((x + 2 * position) % 64) * 2;
+                break;
+            case 1:
+                value = 120 + int(60. * std::sin((y + position) / 10.));
+                break;
+            default:
+                value = (((x + position) / 16 + y / 16) % 2) ? 220 : 90;
+                break;
+            }
+            frame[size_t(y * FrameWidth + x)] = uint8_t(qBound(0, int(value * brightness), 255));
+        }
+    }
+}
+
+static bool hasCutNear(const QVector<int> &cuts, int position)
+{
+    for (int cut : cuts) {
+        if (qAbs(cut - position) <= 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST_CASE("Scene change detector", "[SceneDetection]")
+{
+    std::vector<uint8_t> frame(size_t(FrameWidth * FrameHeight));
+
+    SECTION("SIMD kernels match the scalar result")
+    {
+        std::vector<uint8_t> a(1000), b(1000);
+        std::vector<uint16_t> ha(70), hb(70);
+        uint32_t expectedSad = 0, expectedSum = 0, expectedHistogram = 0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            a[i] = uint8_t((i * 37) % 256);
+            b[i] = uint8_t((i * 91 + 13) % 256);
+            expectedSad += uint32_t(qAbs(int(a[i]) - int(b[i])));
+            expectedSum += a[i];
+        }
+        for (size_t i = 0; i < ha.size(); ++i) {
+            ha[i] = uint16_t((i * 517) % 2304);
+            hb[i] = uint16_t((i * 211 + 7) % 2304);
+            expectedHistogram += uint32_t(qAbs(int(ha[i]) - int(hb[i])));
+        }
+        REQUIRE(SceneChangeDetector::sad(a.data(), b.data(), int(a.size())) == expectedSad);
+        REQUIRE(SceneChangeDetector::sum(a.data(), int(a.size())) == expectedSum);
+        REQUIRE(SceneChangeDetector::histogramSad(ha.data(), hb.data(), int(ha.size())) == expectedHistogram);
+    }
+
+    SECTION("Hard cuts are detected")
+    {
+        SceneChangeDetector detector(0.3);
+        const QVector<int> expected = {50, 100, 150, 200};
+        for (int i = 0; i < 250; ++i) {
+            renderFrame(frame, i / 50, i);
+            detector.addFrame(i, frame.data(), FrameWidth, FrameHeight, FrameWidth);
+        }
+        REQUIRE(detector.cuts() == expected);
+
+        detector.reset();
+        REQUIRE(detector.cuts().isEmpty());
+    }
+
+    SECTION("Packed formats are supported")
+    {
+        std::vector<uint8_t> packed(size_t(FrameWidth * FrameHeight * 2), 128);
+        SceneChangeDetector detector(0.3);
+        for (int i = 0; i < 100; ++i) {
+            renderFrame(frame, i / 50, i);
+            for (size_t j = 0; j < frame.size(); ++j) {
+                packed[j * 2] = frame[j];
+            }
+            detector.addFrame(i, packed.data(), FrameWidth, FrameHeight, FrameWidth * 2, 2);
+        }
+        REQUIRE(detector.cuts() == QVector<int>({50}));
+    }
+
+    SECTION("Fades through black are only reported when requested")
+    {
+        // Scene 0 fades out from frame 40 to 50, black until 55, then scene 1 fades in until 65
+        auto brightness = [](int i) {
+            if (i < 40 || i >= 65) {
+                return 1.;
+            }
+            if (i < 50) {
+                return (50 - i) / 10.;
+            }
+            if (i < 55) {
+                return 0.;
+            }
+            return (i - 55) / 10.;
+        };
+        SceneChangeDetector detector(0.3, true, false);
+        SceneChangeDetector fadeDetector(0.3, true, true);
+        for (int i = 0; i < 100; ++i) {
+            renderFrame(frame, i < 55 ? 0 : 1, i, brightness(i));
+            detector.addFrame(i, frame.data(), FrameWidth, FrameHeight, FrameWidth);
+            fadeDetector.addFrame(i, frame.data(), FrameWidth, FrameHeight, FrameWidth);
+        }
+        REQUIRE(detector.cuts().isEmpty());
+        REQUIRE(fadeDetector.cuts().size() == 1);
+        REQUIRE(fadeDetector.cuts().first() > 50);
+        REQUIRE(fadeDetector.cuts().first() < 60);
+    }
+
+    SECTION("Fast motion does not trigger cuts with the adaptive threshold")
+    {
+        SceneChangeDetector detector(0.1);
+        for (int i = 0; i < 100; ++i) {
+            // Large shift of the same pattern on every frame
+            renderFrame(frame, 2, i * 10);
+            detector.addFrame(i, frame.data(), FrameWidth, FrameHeight, FrameWidth);
+        }
+        REQUIRE(detector.cuts().isEmpty());
+    }
+}
+
+TEST_CASE("Scene detection on a decoded clip", "[SceneDetection]")
+{
+    // 3 scenes of 2 seconds with distinct luma levels, cuts at frames 50 and 100
+    Mlt::Profile profile;
+    profile.set_frame_rate(25, 1);
+    profile.set_width(320);
+    profile.set_height(180);
+    profile.set_explicit(1);
+    Mlt::Playlist playlist(profile);
+    for (const char *color : {"color:#202020", "color:#808080", "color:#e0e0e0"}) {
+        Mlt::Producer scene(profile, color);
+        REQUIRE(scene.is_valid());
+        playlist.append(scene, 0, 49);
+    }
+    REQUIRE(playlist.get_playtime() == 150);
+    const QVector<int> expected = {50, 100};
+
+    SECTION("Cuts are found")
+    {
+        QAtomicInt canceled(0);
+        bool ok = false;
+        const QVector<int> cuts = SceneSplitTask::detectScenes(playlist, 0.3, false, [](int) {}, canceled, &ok);
+        REQUIRE(ok);
+        for (int cut : expected) {
+            REQUIRE(hasCutNear(cuts, cut));
+        }
+        REQUIRE(cuts.size() == expected.size());
+    }
+
+    SECTION("Canceled detection stops without failing")
+    {
+        QAtomicInt canceled(1);
+        bool ok = false;
+        const QVector<int> cuts = SceneSplitTask::detectScenes(playlist, 0.3, false, [](int) {}, canceled, &ok);
+        REQUIRE(ok);
+        REQUIRE(cuts.isEmpty());
+    }
+}
+
+TEST_CASE("Scene detection compared to FFmpeg", "[SceneDetection][.benchmark]")
+{
+    QString ffmpegPath = KdenliveSettings::ffmpegpath();
+    if (ffmpegPath.isEmpty()) {
+        ffmpegPath = QStandardPaths::findExecutable(QStringLiteral("ffmpeg"));
+    }
+    if (ffmpegPath.isEmpty()) {
+        WARN("FFmpeg not found, skipping comparison");
+        return;
+    }
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const QString source = dir.filePath(QStringLiteral("cuts.mkv"));
+    // 3 synthetic scenes of 2 seconds at 25fps, cuts at frames 50 and 100
+    QProcess generate;
+    generate.start(ffmpegPath, {QStringLiteral("-hide_banner"), QStringLiteral("-y"), QStringLiteral("-filter_complex"),
+                                QStringLiteral("testsrc2=s=320x180:r=25:d=2[a];smptebars=s=320x180:r=25:d=2[b];mandelbrot=s=320x180:r=25,trim=duration=2[c];"
+                                               "[a][b][c]concat=n=3:v=1:a=0,format=yuv420p"),
+                                QStringLiteral("-c:v"), QStringLiteral("mpeg4"), QStringLiteral("-q:v"), QStringLiteral("2"), source});
+    generate.waitForFinished(-1);
+    REQUIRE(generate.exitCode() == 0);
+    const QVector<int> expected = {50, 100};
+    BenchmarkTimer timer;
+
+    // Reference: FFmpeg scene filter in a separate process, as previously done by the scene split job
+    QVector<int> ffmpegCuts;
+    timer.measure(QStringLiteral("FFmpeg scene filter"), [&]() {
+        QProcess ffmpeg;
+        ffmpeg.start(ffmpegPath, {QStringLiteral("-hide_banner"), QStringLiteral("-i"), source, QStringLiteral("-an"), QStringLiteral("-vf"),
+                                  QStringLiteral("select='gt(scene,0.3)',showinfo"), QStringLiteral("-f"), QStringLiteral("null"), QStringLiteral("-")});
+        ffmpeg.waitForFinished(-1);
+        static const QRegularExpression ptsTime(QStringLiteral("pts_time:\\s*([0-9.]+)"));
+        QRegularExpressionMatchIterator it = ptsTime.globalMatch(QString::fromUtf8(ffmpeg.readAllStandardError()));
+        while (it.hasNext()) {
+            ffmpegCuts << qRound(it.next().captured(1).toDouble() * 25.);
+        }
+    });
+
+    // Native detector, decoding through MLT in the source profile
+    Mlt::Profile profile;
+    std::unique_ptr<Mlt::Producer> probe(new Mlt::Producer(profile, "avformat", source.toUtf8().constData()));
+    REQUIRE(probe->is_valid());
+    profile.from_producer(*probe.get());
+    profile.set_explicit(1);
+    probe.reset();
+    Mlt::Producer producer(profile, "avformat", source.toUtf8().constData());
+    REQUIRE(producer.is_valid());
+    QVector<int> nativeCuts;
+    bool ok = false;
+    timer.measure(QStringLiteral("native detector"), [&]() {
+        QAtomicInt canceled(0);
+        nativeCuts = SceneSplitTask::detectScenes(producer, 0.3, false, [](int) {}, canceled, &ok);
+    });
+    timer.report();
+    WARN("FFmpeg found " << ffmpegCuts.size() << " cuts, native detector found " << nativeCuts.size() << " cuts");
+
+    REQUIRE(ok);
+    for (int cut : expected) {
+        CHECK(hasCutNear(ffmpegCuts, cut));
+        REQUIRE(hasCutNear(nativeCuts, cut));
+    }
+    CHECK(nativeCuts.size() == expected.size());
+}
@@ -7,6 +7,23 @@
 // test specific headers
 #include "timeline2/model/snapmodel.hpp"
 
+// Adds the borders of clips of 40 frames every 50 frames, and a guide every 7 frames. Returns the clip borders
+static std::vector<int> fillSnaps(SnapModel &snap, int clipsCount)
+{
+    std::vector<int> borders;
+    for (int i = 0; i < clipsCount; ++i) {
+        borders.push_back(i * 50);
+        borders.push_back(i * 50 + 40);
+    }
+    for (int pos : borders) {
+        snap.addPoint(pos);
+    }
+    for (int i = 0; i < clipsCount * 50; i += 7) {
+        snap.addPoint(i);
+    }
+    return borders;
+}
+
 TEST_CASE("Snap points model test", "[SnapModel]")
 {
     SnapModel snap;
@@ -127,4 +144,45 @@ TEST_CASE("Snap points model test", "[SnapModel]")
         REQUIRE(snap.getClosestPoint(9) == 15);
         REQUIRE(snap.getClosestPoint(999) == 15);
     }
+    SECTION("Ignoring a large group")
+    {
+        const int clipsCount = 10000;
+        const std::vector<int> borders = fillSnaps(snap, clipsCount);
+        // Simulate dragging a group of half the clips
+        std::vector<int> group(borders.begin(), borders.begin() + clipsCount);
+        for (int step = 0; step < 100; ++step) {
+            snap.ignore(group);
+            REQUIRE(snap.getClosestPoint(step * 3 + 1) == (step * 3 + 1) / 7 * 7 + ((step * 3 + 1) % 7 > 3 ? 7 : 0));
+            snap.unIgnore();
+        }
+        // Ignored positions shared with a guide are still available
+        snap.ignore(group);
+        REQUIRE(snap.getClosestPoint(0) == 0);
+        REQUIRE(snap.getClosestPoint(41) == 42);
+        REQUIRE(snap.getNextPoint(0) == 7);
+        REQUIRE(snap.getPreviousPoint(42) == 35);
+        snap.unIgnore();
+        REQUIRE(snap.getClosestPoint(39) == 40);
+        // Clip border and guide at the same position
+        REQUIRE(snap._snaps().at(0) == 2);
+    }
+}
+
+TEST_CASE("Snap model benchmark", "[SnapModel][.benchmark]")
+{
+    SnapModel snap;
+    const int clipsCount = 10000;
+    const std::vector<int> borders = fillSnaps(snap, clipsCount);
+    std::vector<int> group(borders.begin(), borders.begin() + clipsCount);
+    BenchmarkTimer timer;
+    int snapped = 0;
+    timer.measure(QStringLiteral("Ignored %1 points 100 times").arg(group.size()), [&]() {
+        for (int step = 0; step < 100; ++step) {
+            snap.ignore(group);
+            snapped += snap.getClosestPoint(step * 3 + 1) > -1 ? 1 : 0;
+            snap.unIgnore();
+        }
+    });
+    timer.report();
+    REQUIRE(snapped == 100);
 }
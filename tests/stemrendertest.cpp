@@ -0,0 +1,69 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+#include "test_utils.hpp"
+// test specific headers
+#include "renderer/stemrenderjob.h"
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QTimer>
+
+TEST_CASE("Audio stems rendering", "[StemRender]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const QString shortStem = dir.filePath(QStringLiteral("short.wav"));
+    const QString longStem = dir.filePath(QStringLiteral("long.wav"));
+    const QString master = dir.filePath(QStringLiteral("master.wav"));
+    // Two audio tracks of different durations, the render range starts after the end of the short one
+    const QString scene =
+        QStringLiteral("<mlt><profile width=\"320\" height=\"180\" frame_rate_num=\"25\" frame_rate_den=\"1\" sample_aspect_num=\"1\" "
+                       "sample_aspect_den=\"1\" display_aspect_num=\"16\" display_aspect_den=\"9\" progressive=\"1\"/>"
+                       "<producer id=\"noise0\" in=\"0\" out=\"49\"><property name=\"mlt_service\">noise</property></producer>"
+                       "<producer id=\"noise1\" in=\"0\" out=\"149\"><property name=\"mlt_service\">noise</property></producer>"
+                       "<playlist id=\"playlist0\"><entry producer=\"noise0\" in=\"0\" out=\"49\"/></playlist>"
+                       "<playlist id=\"playlist1\"><entry producer=\"noise1\" in=\"0\" out=\"149\"/></playlist>"
+                       "<tractor id=\"tractor0\"><property name=\"kdenlive:stem_target\">%1</property><track producer=\"playlist0\"/></tractor>"
+                       "<tractor id=\"tractor1\"><property name=\"kdenlive:stem_target\">%2</property><track producer=\"playlist1\"/></tractor>"
+                       "<tractor id=\"main\"><track producer=\"tractor0\"/><track producer=\"tractor1\"/></tractor>"
+                       "<consumer mlt_service=\"avformat\" target=\"%3\" in=\"%4\" out=\"%5\" f=\"wav\" acodec=\"pcm_s16le\" video_off=\"1\" vn=\"1\"/></mlt>");
+
+    auto render = [&dir](const QString &content) {
+        const QString sceneFile = dir.filePath(QStringLiteral("stems.mlt"));
+        QFile file(sceneFile);
+        REQUIRE(file.open(QIODevice::WriteOnly));
+        file.write(content.toUtf8());
+        file.close();
+        StemRenderJob job(sceneFile);
+        QEventLoop loop;
+        QObject::connect(&job, &StemRenderJob::renderingFinished, &loop, &QEventLoop::quit);
+        QTimer::singleShot(60000, &loop, &QEventLoop::quit);
+        QTimer::singleShot(0, &job, &StemRenderJob::start);
+        loop.exec();
+    };
+    auto duration = [](const QString &path) {
+        Mlt::Profile profile;
+        Mlt::Producer producer(profile, "avformat", path.toUtf8().constData());
+        return producer.is_valid() ? producer.get_playtime() : -1;
+    };
+
+    SECTION("Stems are padded to the render range")
+    {
+        render(scene.arg(shortStem, longStem, master).arg(0).arg(99));
+        const int length = duration(master);
+        REQUIRE(qAbs(length - 100) <= 1);
+        REQUIRE(duration(longStem) == length);
+        REQUIRE(duration(shortStem) == length);
+    }
+
+    SECTION("A stem ending before the render range is silent")
+    {
+        render(scene.arg(shortStem, longStem, master).arg(75).arg(124));
+        const int length = duration(master);
+        REQUIRE(qAbs(length - 50) <= 1);
+        REQUIRE(duration(longStem) == length);
+        REQUIRE(duration(shortStem) == length);
+    }
+}
@@ -10,9 +10,23 @@
 #include "definitions.h"
 #include "doc/docundostack.hpp"
 #include "doc/kdenlivedoc.h"
+#include "pythoninterfaces/speechtotext.h"
 
 using namespace fakeit;
 
+// Adds subtitles of 10 frames every 20 frames, alternating on 2 layers
+static void addSubtitles(const std::shared_ptr<SubtitleModel> &subtitleModel, int count)
+{
+    double fps = pCore->getCurrentFps();
+    subtitleModel->setMaxLayer(1);
+    for (int i = 0; i < count; ++i) {
+        int layer = i % 2;
+        REQUIRE(subtitleModel->addSubtitle(KdenliveTests::getNextId(), {layer, GenTime(20 * i, fps)},
+                                           SubtitleEvent(true, GenTime(20 * i + 10, fps), "Default", "", 0, 0, 0, "", QStringLiteral("Sub %1").arg(i)),
+                                           false, false));
+    }
+}
+
 TEST_CASE("Read subtitle file", "[Subtitles]")
 {
     // Create timeline
@@ -213,6 +227,24 @@ TEST_CASE("Read subtitle file", "[Subtitles]")
         REQUIRE(subtitleModel->rowCount() == 0);
     }
 
+    SECTION("Overlapping subtitles on different layers are cut together")
+    {
+        int subId = KdenliveTests::getNextId();
+        int subId2 = KdenliveTests::getNextId();
+        double fps = pCore->getCurrentFps();
+        subtitleModel->setMaxLayer(1);
+        REQUIRE(subtitleModel->addSubtitle(subId, {0, GenTime(50, fps)},
+                                           SubtitleEvent(true, GenTime(70, fps), "Default", "", 0, 0, 0, "", QStringLiteral("Hello")), false, false));
+        REQUIRE(subtitleModel->addSubtitle(subId2, {1, GenTime(60, fps)},
+                                           SubtitleEvent(true, GenTime(90, fps), "Default", "", 0, 0, 0, "", QStringLiteral("Hello2")), false, false));
+        REQUIRE(TimelineFunctions::requestClipCutAll(timeline, 65));
+        REQUIRE(subtitleModel->rowCount() == 4);
+        REQUIRE(timeline->getClipByPosition(-2, 66, 0) != subId);
+        REQUIRE(timeline->getClipByPosition(-2, 66, 1) != subId2);
+        subtitleModel->removeAllSubtitles();
+        REQUIRE(subtitleModel->rowCount() == 0);
+    }
+
     SECTION("Read start/end time of the subtitles")
     {
         // srt
@@ -272,6 +304,108 @@ TEST_CASE("Read subtitle file", "[Subtitles]")
         REQUIRE(subtitleModel->rowCount() == 0);
     }
 
+    SECTION("Querying many subtitles")
+    {
+        const int subtitlesCount = 5000;
+        addSubtitles(subtitleModel, subtitlesCount);
+        REQUIRE(subtitleModel->rowCount() == subtitlesCount);
+        double fps = pCore->getCurrentFps();
+        for (int i = 0; i < subtitlesCount; ++i) {
+            REQUIRE(subtitleModel->getIdForStartPos(i % 2, GenTime(20 * i, fps)) > -1);
+        }
+        for (int i = 0; i + 1 < subtitlesCount / 2; i += 5) {
+            REQUIRE(subtitleModel->getBlankEnd(0, 40 * i + 15) == 40 * i + 40);
+        }
+        // Range queries on one layer only return the subtitles of that layer
+        REQUIRE(subtitleModel->getItemsInRange(0, 95, 125).size() == 1);
+        REQUIRE(subtitleModel->getItemsInRange(-1, 95, 125).size() == 2);
+        subtitleModel->removeAllSubtitles();
+        REQUIRE(subtitleModel->rowCount() == 0);
+    }
+
+    binModel->clean();
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
+
+TEST_CASE("Subtitle model benchmark", "[Subtitles][.benchmark]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    pCore->setCurrentProfile(QStringLiteral("dv_pal"));
+    KdenliveDoc document(undoStack);
+    pCore->projectManager()->testSetDocument(&document);
+    QDateTime documentDate = QDateTime::currentDateTime();
+    KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->testSetActiveTimeline(timeline);
+    KdenliveTests::resetNextId();
+    std::shared_ptr<SubtitleModel> subtitleModel = timeline->createSubtitleModel();
+
+    const int subtitlesCount = 5000;
+    double fps = pCore->getCurrentFps();
+    BenchmarkTimer timer;
+    timer.measure(QStringLiteral("Inserted %1 subtitles").arg(subtitlesCount), [&]() { addSubtitles(subtitleModel, subtitlesCount); });
+    int found = 0;
+    timer.measure(QStringLiteral("looked up all start positions"), [&]() {
+        for (int i = 0; i < subtitlesCount; ++i) {
+            if (subtitleModel->getIdForStartPos(i % 2, GenTime(20 * i, fps)) > -1) {
+                found++;
+            }
+        }
+    });
+    size_t inRange = 0;
+    timer.measure(QStringLiteral("queried ranges"), [&]() {
+        for (int i = 0; i < subtitlesCount; i += 10) {
+            inRange += subtitleModel->getItemsInRange(0, 20 * i, 20 * i + 100).size();
+        }
+    });
+    timer.measure(QStringLiteral("found blanks"), [&]() {
+        for (int i = 0; i + 1 < subtitlesCount / 2; i += 5) {
+            subtitleModel->getBlankEnd(0, 40 * i + 15);
+        }
+    });
+    timer.report();
+    REQUIRE(found == subtitlesCount);
+    REQUIRE(inRange > 0);
+
+    subtitleModel->removeAllSubtitles();
     binModel->clean();
     pCore->projectManager()->closeCurrentDocument(false, false);
 }
+
+TEST_CASE("Merge speech recognition segments", "[Subtitles]")
+{
+    SECTION("Split a zone in overlapping segments")
+    {
+        // Short zone, not split
+        QVector<SpeechToText::Segment> segments = SpeechToText::splitZone(QPoint(0, 999), 4, 500, 10);
+        REQUIRE(segments.count() == 1);
+        REQUIRE(segments.at(0).zone == QPoint(0, 999));
+        REQUIRE(segments.at(0).keepIn == 0);
+        REQUIRE(segments.at(0).keepOut == 1000);
+
+        segments = SpeechToText::splitZone(QPoint(0, 999), 3, 100, 10);
+        REQUIRE(segments.count() == 3);
+        REQUIRE(segments.at(0).zone == QPoint(0, 343));
+        REQUIRE(segments.at(1).zone == QPoint(323, 676));
+        REQUIRE(segments.at(2).zone == QPoint(656, 999));
+        REQUIRE(segments.at(0).keepOut == segments.at(1).keepIn);
+        REQUIRE(segments.at(1).keepOut == segments.at(2).keepIn);
+        REQUIRE(segments.at(2).keepOut == 1000);
+    }
+
+    SECTION("Subtitles of the overlaps are only kept once")
+    {
+        const QVector<SpeechToText::Segment> segments = SpeechToText::splitZone(QPoint(0, 999), 3, 100, 10);
+        // At 25fps, the second segment starts at 12.92s and owns the subtitles starting after 13.32s.
+        // Both segments recognize "second" in their overlap, with different timings
+        const QStringList subtitles = {QStringLiteral("1\r\n00:00:01,000 --> 00:00:02,000\r\nfirst\r\n\r\n2\r\n00:00:13,600 --> 00:00:13,700\r\nsecond\r\n"),
+                                       QStringLiteral("1\n00:00:00,200 --> 00:00:00,700\nsecond\n\n2\n00:00:01,000 --> 00:00:01,500\nthird\nline\n"),
+                                       QString()};
+        const QString merged = SpeechToText::mergeSubtitles(segments, subtitles, 25.);
+        REQUIRE(merged ==
+                QStringLiteral(
+                    "1\n00:00:01,000 --> 00:00:02,000\nfirst\n\n2\n00:00:13,600 --> 00:00:13,700\nsecond\n\n3\n00:00:13,920 --> 00:00:14,420\nthird\nline\n\n"));
+    }
+}
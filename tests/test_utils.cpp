@@ -4,6 +4,8 @@
     SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 */
 #include "test_utils.hpp"
+#include "bin/sequenceclip.h"
+#include "bin/sequenceprerender.h"
 #include "doc/documentchecker.h"
 #include "doc/kdenlivedoc.h"
 #include "src/assets/keyframes/model/keyframemodel.hpp"
@@ -271,6 +273,29 @@ void KdenliveTests::setRenderRequestBounds(RenderRequest *r, int in, int out)
     r->m_boundingOut = out;
 }
 
+void KdenliveTests::prepareMultiAudioFiles(std::vector<RenderRequest::RenderJob> &jobs, const QDomDocument &doc, const QString &playlistFile,
+                                           const QString &targetFile, const QUuid &uuid)
+{
+    RenderRequest::prepareMultiAudioFiles(jobs, doc, playlistFile, targetFile, uuid);
+}
+
+int KdenliveTests::preparedProducersCount(const std::shared_ptr<ProjectClip> &clip)
+{
+    QMutexLocker lk(&clip->m_producerMutex);
+    return int(clip->m_preparedProducers.size());
+}
+
+void KdenliveTests::setSequenceIntermediate(const std::shared_ptr<ProjectClip> &clip, const QString &intermediate)
+{
+    auto sequence = std::static_pointer_cast<SequenceClip>(clip);
+    sequence->m_preRender->m_intermediate = intermediate;
+}
+
+QString KdenliveTests::preRenderedSequence(std::shared_ptr<TimelineItemModel> timeline, int clipId)
+{
+    return QString(timeline->getClipPtr(clipId)->getProducer()->parent().get(SequencePreRender::SequenceProperty));
+}
+
 void KdenliveTests::initRenderRepository()
 {
     RenderPresetRepository::m_acodecsList = QStringList(QStringLiteral("libvorbis"));
@@ -292,3 +317,12 @@ bool KdenliveTests::effectFilterName(EffectFilter &filter, std::shared_ptr<TreeI
 {
     return filter.filterName(item);
 }
+
+void BenchmarkTimer::report() const
+{
+    QStringList stages;
+    for (const auto &stage : m_stages) {
+        stages << QStringLiteral("%1 in %2ms").arg(stage.first).arg(stage.second);
+    }
+    WARN(stages.join(QStringLiteral(", ")).toStdString());
+}
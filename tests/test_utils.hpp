@@ -7,6 +7,7 @@
 #include "abortutil.hpp"
 #include "catch.hpp"
 #include "tests_definitions.h"
+#include <QElapsedTimer>
 #include <QString>
 #include <iostream>
 #include <memory>
@@ -141,8 +142,35 @@ public:
                                     int audioStream, double speed, bool warp_pitch, Fun &undo, Fun &redo);
     static void makeFiniteClipEnd(std::shared_ptr<TimelineItemModel> timeline, int cid);
     static void setRenderRequestBounds(RenderRequest *r, int in, int out);
+    static void prepareMultiAudioFiles(std::vector<RenderRequest::RenderJob> &jobs, const QDomDocument &doc, const QString &playlistFile,
+                                       const QString &targetFile, const QUuid &uuid);
     static void initRenderRepository();
+    static int preparedProducersCount(const std::shared_ptr<ProjectClip> &clip);
+    static void setSequenceIntermediate(const std::shared_ptr<ProjectClip> &clip, const QString &intermediate);
+    /** @brief The id of the sequence replaced by the producer of a timeline clip, empty if it is not a pre-rendered intermediate */
+    static QString preRenderedSequence(std::shared_ptr<TimelineItemModel> timeline, int clipId);
     static bool checkModelConsistency(std::shared_ptr<AbstractTreeModel> model);
     static int modelSize(std::shared_ptr<AbstractTreeModel> model);
     static bool effectFilterName(EffectFilter &filter, std::shared_ptr<TreeItem> item);
 };
+
+/** @brief Times the successive stages of a benchmark and reports them in a single warning.
+ *  Benchmark test cases are tagged [.benchmark] so that they are hidden from the default run.
+ */
+class BenchmarkTimer
+{
+public:
+    /** @brief Runs @p stage and records its duration under @p label */
+    template <typename F> void measure(const QString &label, F &&stage)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        stage();
+        m_stages.append({label, timer.elapsed()});
+    }
+    /** @brief Emits a warning listing the duration of every measured stage */
+    void report() const;
+
+private:
+    QList<QPair<QString, qint64>> m_stages;
+};
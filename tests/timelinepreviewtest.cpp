@@ -7,6 +7,7 @@
 #include "test_utils.hpp"
 // test specific headers
 #include <QString>
+#include <QTemporaryDir>
 #include <cmath>
 #include <iostream>
 #include <tuple>
@@ -16,9 +17,11 @@
 #include <thread>
 
 #include "bin/binplaylist.hpp"
+#include "bin/sequenceprerender.h"
 #include "definitions.h"
 #include "doc/kdenlivedoc.h"
 #include "timeline2/model/builders/meltBuilder.hpp"
+#include "timeline2/view/previewchunkstore.h"
 #include "timeline2/view/previewmanager.h"
 #include "xml/xml.hpp"
 
@@ -103,3 +106,82 @@ TEST_CASE("Timeline preview insert-remove", "[TimelinePreview]")
     REQUIRE(dir.exists() == false);
     pCore->projectManager()->closeCurrentDocument(false, false);
 }
+
+TEST_CASE("Nested sequence pre-render", "[TimelinePreview]")
+{
+    SECTION("Chunks cover the whole sequence")
+    {
+        REQUIRE(SequencePreRender::chunkRange(0, 25).isEmpty());
+        REQUIRE(SequencePreRender::chunkRange(1, 25) == QStringLiteral("0"));
+        REQUIRE(SequencePreRender::chunkRange(25, 25) == QStringLiteral("0"));
+        REQUIRE(SequencePreRender::chunkRange(26, 25) == QStringLiteral("0-25"));
+        REQUIRE(SequencePreRender::chunkRange(251, 25) == QStringLiteral("0-250"));
+    }
+
+    SECTION("Cache folder follows the sequence content")
+    {
+        const QStringList params = {QStringLiteral("vcodec=mpeg2video"), QStringLiteral("an=1")};
+        const QString key = SequencePreRender::contentKey(QStringLiteral("<mlt><tractor/></mlt>"), params);
+        REQUIRE(key.startsWith(QStringLiteral("nested-")));
+        REQUIRE(key == SequencePreRender::contentKey(QStringLiteral("<mlt><tractor/></mlt>"), params));
+        REQUIRE(key != SequencePreRender::contentKey(QStringLiteral("<mlt><tractor in=\"1\"/></mlt>"), params));
+        REQUIRE(key != SequencePreRender::contentKey(QStringLiteral("<mlt><tractor/></mlt>"), {QStringLiteral("vcodec=mjpeg")}));
+    }
+}
+
+TEST_CASE("Preview chunk index", "[TimelinePreview]")
+{
+    QTemporaryDir tmp;
+    REQUIRE(tmp.isValid());
+    QDir dir(tmp.path());
+    auto writeChunk = [&dir](int frame, const QByteArray &data) {
+        QFile file(dir.absoluteFilePath(QStringLiteral("%1.mkv").arg(frame)));
+        REQUIRE(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    };
+    writeChunk(0, QByteArray(100, 'a'));
+    writeChunk(25, QByteArray(100, 'b'));
+
+    PreviewChunkStore store;
+    store.setDirectory(dir, QStringLiteral("mkv"));
+    REQUIRE(store.count() == 0);
+    // Chunks without index entry are adopted
+    REQUIRE(store.isValid(0));
+    REQUIRE(store.isValid(25));
+    REQUIRE_FALSE(store.isValid(50));
+    REQUIRE(store.save());
+    REQUIRE(dir.exists(PreviewChunkStore::IndexName));
+
+    SECTION("Index is reloaded")
+    {
+        PreviewChunkStore other;
+        other.setDirectory(dir, QStringLiteral("mkv"));
+        REQUIRE(other.count() == 2);
+        REQUIRE(other.isValid(0));
+    }
+
+    SECTION("Modified chunk is rejected")
+    {
+        writeChunk(25, QByteArray(40, 'c'));
+        PreviewChunkStore other;
+        other.setDirectory(dir, QStringLiteral("mkv"));
+        REQUIRE(other.isValid(0));
+        REQUIRE_FALSE(other.isValid(25));
+        REQUIRE(other.count() == 1);
+    }
+
+    SECTION("Index of another format is discarded")
+    {
+        PreviewChunkStore other;
+        other.setDirectory(dir, QStringLiteral("mp4"));
+        REQUIRE(other.count() == 0);
+    }
+
+    SECTION("Empty index is removed")
+    {
+        store.remove(0);
+        store.remove(25);
+        store.save();
+        REQUIRE_FALSE(dir.exists(PreviewChunkStore::IndexName));
+    }
+}
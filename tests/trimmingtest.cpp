@@ -8,6 +8,7 @@
 // test specific headers
 #include "doc/kdenlivedoc.h"
 #include "timeline2/model/timelinefunctions.hpp"
+#include <QMimeData>
 
 using namespace fakeit;
 
@@ -115,6 +116,80 @@ TEST_CASE("Simple trimming operations", "[Trimming]")
         state2();
     }
 
+    SECTION("Batch clip cutting")
+    {
+        REQUIRE(timeline->requestClipMove(cid1, tid1, 0));
+        REQUIRE(timeline->requestClipMove(cid3, tid2, 0));
+        int l = timeline->getClipPlaytime(cid1);
+        REQUIRE(l > 10);
+        auto state = [&]() {
+            REQUIRE(timeline->checkConsistency());
+            REQUIRE(timeline->getTrackClipsCount(tid1) == 1);
+            REQUIRE(timeline->getTrackClipsCount(tid2) == 1);
+            REQUIRE(timeline->getClipPlaytime(cid1) == l);
+            REQUIRE(timeline->getClipPlaytime(cid3) == l);
+        };
+        state();
+
+        // Two cuts in the same clip and one on another track, in a single undo entry
+        Fun undo = []() { return true; };
+        Fun redo = []() { return true; };
+        REQUIRE(TimelineFunctions::requestClipsCut(timeline, {{cid1, 3}, {cid1, 7}, {cid3, 5}}, undo, redo));
+        pCore->pushUndo(undo, redo, QString());
+        auto state2 = [&]() {
+            REQUIRE(timeline->checkConsistency());
+            REQUIRE(timeline->getTrackClipsCount(tid1) == 3);
+            REQUIRE(timeline->getTrackClipsCount(tid2) == 2);
+            REQUIRE(timeline->getClipPlaytime(cid1) == 3);
+            REQUIRE(timeline->getClipPlaytime(timeline->getClipByPosition(tid1, 3)) == 4);
+            REQUIRE(timeline->getClipPlaytime(timeline->getClipByPosition(tid1, 7)) == l - 7);
+            REQUIRE(timeline->getClipPlaytime(cid3) == 5);
+            REQUIRE(timeline->getClipPosition(timeline->getClipByPosition(tid2, 5)) == 5);
+            REQUIRE(KdenliveTests::getClipPtr(timeline, timeline->getClipByPosition(tid1, 7))->getIn() == 7);
+        };
+        state2();
+
+        undoStack->undo();
+        state();
+        undoStack->redo();
+        state2();
+    }
+
+    SECTION("Cut all clips at several positions")
+    {
+        REQUIRE(timeline->requestClipMove(cid1, tid1, 0));
+        REQUIRE(timeline->requestClipMove(cid3, tid2, 0));
+        int l = timeline->getClipPlaytime(cid1);
+        REQUIRE(l > 10);
+        auto state = [&]() {
+            REQUIRE(timeline->checkConsistency());
+            REQUIRE(timeline->getTrackClipsCount(tid1) == 1);
+            REQUIRE(timeline->getTrackClipsCount(tid2) == 1);
+            REQUIRE(timeline->getClipPlaytime(cid1) == l);
+            REQUIRE(timeline->getClipPlaytime(cid3) == l);
+        };
+        state();
+
+        // Positions outside of the clips are ignored
+        REQUIRE(TimelineFunctions::requestClipCutAll(timeline, {3, 7, 5 * l}));
+        auto state2 = [&]() {
+            REQUIRE(timeline->checkConsistency());
+            for (int tid : {tid1, tid2}) {
+                REQUIRE(timeline->getTrackClipsCount(tid) == 3);
+                REQUIRE(timeline->getClipPlaytime(timeline->getClipByPosition(tid, 0)) == 3);
+                REQUIRE(timeline->getClipPlaytime(timeline->getClipByPosition(tid, 3)) == 4);
+                REQUIRE(timeline->getClipPlaytime(timeline->getClipByPosition(tid, 7)) == l - 7);
+            }
+        };
+        state2();
+
+        // A single undo entry restores all clips
+        undoStack->undo();
+        state();
+        undoStack->redo();
+        state2();
+    }
+
     SECTION("Cut and resize")
     {
         REQUIRE(timeline->requestClipMove(cid1, tid1, 5));
@@ -1070,6 +1145,33 @@ TEST_CASE("Copy/paste", "[CP]")
         state3();
     }
 
+    SECTION("Paste a copy from the clipboard data")
+    {
+        int cid1 = -1;
+        REQUIRE(timeline->requestClipInsertion(binId2, tid1, 3, cid1, true, true, false));
+        int l = timeline->getClipPlaytime(cid1);
+
+        std::unique_ptr<QMimeData> copy(TimelineFunctions::copyClipsMimeData(timeline, {cid1}));
+        REQUIRE(copy->hasText());
+        // Pasting our own copy does not need its string representation
+        REQUIRE(TimelineFunctions::pasteClipboard(timeline, copy.get(), tid1, 3 + l));
+        int cid2 = timeline->getClipByPosition(tid1, 3 + l + 1);
+        REQUIRE(cid2 != -1);
+        REQUIRE(timeline->checkConsistency());
+        REQUIRE(timeline->getTrackClipsCount(tid1) == 2);
+        undoStack->undo();
+        REQUIRE(timeline->getTrackClipsCount(tid1) == 1);
+        undoStack->redo();
+        REQUIRE(timeline->getTrackClipsCount(tid1) == 2);
+
+        // The string representation is generated on request and can be pasted as well
+        const QString text = copy->text();
+        REQUIRE(text.contains(QLatin1String("kdenlive-scene")));
+        REQUIRE(TimelineFunctions::pasteClips(timeline, text, tid1b, 0));
+        REQUIRE(timeline->getTrackClipsCount(tid1b) == 1);
+        REQUIRE(timeline->checkConsistency());
+    }
+
     SECTION("Copy paste groups")
     {
 
@@ -0,0 +1,120 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+#include "test_utils.hpp"
+// test specific headers
+#include "doc/docundostack.hpp"
+#include "undohelper.hpp"
+
+TEST_CASE("Undo history memory accounting", "[UndoStack]")
+{
+    DocUndoStack stack(nullptr);
+    stack.setMemoryBudget(0);
+    int value = 0;
+
+    auto pushIncrement = [&stack, &value](qint64 cost, int mergeKey) {
+        value++;
+        Fun undo = [&value]() {
+            value--;
+            return true;
+        };
+        Fun redo = [&value]() {
+            value++;
+            return true;
+        };
+        auto *command = new FunctionalUndoCommand(undo, redo, QStringLiteral("Increment"));
+        command->addMemoryCost(cost);
+        command->setMergeKey(mergeKey);
+        stack.push(command);
+    };
+
+    SECTION("Memory usage includes cost hints")
+    {
+        pushIncrement(0, -1);
+        qint64 baseCost = stack.memoryUsage();
+        REQUIRE(baseCost > 0);
+        pushIncrement(1024 * 1024, -1);
+        REQUIRE(stack.memoryUsage() >= baseCost + 1024 * 1024);
+        stack.clear();
+        REQUIRE(stack.memoryUsage() == 0);
+    }
+
+    SECTION("Consecutive commands of a merge session are merged")
+    {
+        int session = stack.beginMergeSession();
+        pushIncrement(0, session);
+        pushIncrement(0, session);
+        pushIncrement(0, session);
+        REQUIRE(stack.count() == 1);
+        stack.endMergeSession();
+        pushIncrement(0, stack.mergeSession());
+        REQUIRE(stack.count() == 2);
+        // The running memory total matches the commands
+        qint64 total = 0;
+        for (int i = 0; i < stack.count(); i++) {
+            total += FunctionalUndoCommand::estimateCost(stack.command(i));
+        }
+        REQUIRE(stack.memoryUsage() == total);
+        REQUIRE(value == 4);
+        stack.undo();
+        REQUIRE(value == 3);
+        stack.undo();
+        REQUIRE(value == 0);
+        stack.redo();
+        REQUIRE(value == 3);
+        stack.clear();
+    }
+
+    SECTION("Memory usage is reported when commands are merged")
+    {
+        int session = stack.beginMergeSession();
+        pushIncrement(0, session);
+        qint64 reported = 0;
+        QObject::connect(&stack, &DocUndoStack::memoryUsageChanged, [&reported](qint64 bytes) { reported = bytes; });
+        pushIncrement(1024, session);
+        REQUIRE(stack.count() == 1);
+        REQUIRE(reported == stack.memoryUsage());
+        REQUIRE(reported >= 1024);
+        stack.endMergeSession();
+        stack.clear();
+    }
+
+    SECTION("Oldest commands are released when over budget")
+    {
+        stack.setMemoryBudget(4 * 1024 * 1024);
+        for (int i = 0; i < 30; i++) {
+            pushIncrement(1024 * 1024, -1);
+        }
+        REQUIRE(value == 30);
+        REQUIRE(stack.count() == 30);
+        REQUIRE(stack.releasedCount() == 20);
+        // Recent commands can still be undone
+        for (int i = 0; i < 10; i++) {
+            stack.undo();
+        }
+        REQUIRE(value == 20);
+        // Released commands cannot be undone and stay on the stack, keeping indexes stable
+        REQUIRE_FALSE(stack.undoAvailable());
+        stack.undo();
+        REQUIRE(value == 20);
+        REQUIRE(stack.count() == 30);
+        REQUIRE(stack.index() == 20);
+        REQUIRE(stack.releasedCount() == 20);
+        stack.setIndex(5);
+        REQUIRE(stack.index() == 20);
+        REQUIRE(value == 20);
+        stack.redo();
+        REQUIRE(value == 21);
+        REQUIRE(stack.undoAvailable());
+        // The memory usage matches the remaining commands
+        qint64 total = 0;
+        for (int i = 0; i < stack.count(); i++) {
+            total += FunctionalUndoCommand::estimateCost(stack.command(i));
+        }
+        REQUIRE(stack.memoryUsage() == total);
+        stack.clear();
+        REQUIRE(stack.releasedCount() == 0);
+    }
+}